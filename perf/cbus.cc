@@ -0,0 +1,225 @@
+#include <atomic>
+#include <vector>
+
+#include "core/cbus.h"
+#include "core/fiber.h"
+#include "core/memory.h"
+#include "core/say.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * This suite contains benchmarks for cbus - the message bus between
+ * cords.
+ *
+ * The main thread sends messages to the consumer cord that runs
+ * cbus_loop() and gets them back by polling its own endpoint, so the
+ * round trip includes a wakeup of the consumer if it has gone to
+ * sleep. In the multi-producer benchmark several producer cords
+ * send messages to the consumer at once.
+ */
+
+/** Number of messages sent by each producer cord. */
+static constexpr std::size_t producer_msg_count = 1 << 15;
+/** Number of messages a producer cord flushes at once. */
+static constexpr std::size_t producer_batch_size = 64;
+
+/** The pipe from the main thread to the consumer. */
+static struct cpipe consumer_pipe;
+/** The pipe from the consumer to the main thread. */
+static struct cpipe main_pipe;
+/** Number of messages that have returned to the main thread. */
+static std::size_t reply_count;
+
+static void
+nop_f(struct cmsg *)
+{
+}
+
+static void
+reply_f(struct cmsg *)
+{
+	++reply_count;
+}
+
+static const struct cmsg_hop ping_route[] = {
+	{nop_f, &main_pipe},
+	{reply_f, nullptr},
+};
+
+/** A message counting its delivery to the consumer. */
+struct CountMsg {
+	struct cmsg base;
+	std::atomic<std::size_t> *counter;
+};
+
+static void
+count_f(struct cmsg *msg)
+{
+	reinterpret_cast<CountMsg *>(msg)->counter->fetch_add(
+		1, std::memory_order_release);
+}
+
+static const struct cmsg_hop count_route[] = {
+	{count_f, nullptr},
+};
+
+static void
+main_cb(ev_loop *, ev_watcher *, int)
+{
+}
+
+static int
+consumer_f(va_list)
+{
+	cpipe_create(&main_pipe, "main");
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "consumer", fiber_schedule_cb,
+			     fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&main_pipe);
+	return 0;
+}
+
+/**
+ * The bus singleton starts the consumer cord and connects the main
+ * thread to it.
+ */
+class Bus final {
+public:
+	Bus(Bus &other) = delete;
+	Bus &operator=(Bus &other) = delete;
+
+	static Bus &
+	instance()
+	{
+		static Bus singleton;
+		return singleton;
+	}
+
+	/**
+	 * Send the messages to the consumer and wait until all of them
+	 * return.
+	 */
+	void
+	round_trip(std::vector<struct cmsg> &msgs)
+	{
+		reply_count = 0;
+		for (auto &msg : msgs) {
+			::cmsg_init(&msg, ping_route);
+			::cpipe_push(&consumer_pipe, &msg);
+		}
+		::cpipe_flush(&consumer_pipe);
+		while (reply_count < msgs.size())
+			::cbus_process(&endpoint);
+	}
+
+private:
+	Bus()
+	{
+		::memory_init();
+		::fiber_init(fiber_c_invoke);
+		::cbus_init();
+		::cbus_endpoint_create(&endpoint, "main", main_cb, nullptr);
+		if (::cord_costart(&consumer, "consumer", consumer_f,
+				   nullptr) != 0)
+			panic("failed to start the consumer cord");
+		::cpipe_create_noev(&consumer_pipe, "consumer");
+	}
+
+	~Bus()
+	{
+		::cbus_stop_loop(&consumer_pipe);
+		::cpipe_destroy(&consumer_pipe);
+		if (::cord_join(&consumer) != 0)
+			panic("failed to join the consumer cord");
+		::cbus_endpoint_destroy(&endpoint, ::cbus_process);
+		::cbus_free();
+		::fiber_free();
+		::memory_free();
+	}
+
+	/** The endpoint of the main thread. */
+	struct cbus_endpoint endpoint;
+	/** The consumer cord. */
+	struct cord consumer;
+};
+
+/** A producer cord of the multi-producer benchmark. */
+struct Producer {
+	struct cord cord;
+	std::vector<CountMsg> msgs;
+	std::atomic<std::size_t> delivered;
+};
+
+static int
+producer_f(va_list ap)
+{
+	Producer *producer = va_arg(ap, Producer *);
+	struct cpipe pipe;
+	::cpipe_create_noev(&pipe, "consumer");
+	std::size_t count = producer->msgs.size();
+	for (std::size_t i = 0; i < count; i++) {
+		CountMsg *msg = &producer->msgs[i];
+		msg->counter = &producer->delivered;
+		::cmsg_init(&msg->base, count_route);
+		::cpipe_push(&pipe, &msg->base);
+		if ((i + 1) % producer_batch_size == 0)
+			::cpipe_flush(&pipe);
+	}
+	::cpipe_flush(&pipe);
+	while (producer->delivered.load(std::memory_order_acquire) < count)
+		;
+	::cpipe_destroy(&pipe);
+	return 0;
+}
+
+/**
+ * Benchmark the round trip of a batch of messages between the main
+ * thread and the consumer, the batch size is the argument.
+ */
+static void
+RoundTrip(benchmark::State &state)
+{
+	Bus &bus = Bus::instance();
+	std::vector<struct cmsg> msgs(state.range(0));
+	for (MAYBE_UNUSED auto _ : state)
+		bus.round_trip(msgs);
+	state.SetItemsProcessed(state.iterations() * msgs.size());
+}
+
+BENCHMARK(RoundTrip)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+/**
+ * Benchmark the throughput of the consumer fed by several producer
+ * cords at once, the number of producers is the argument.
+ */
+static void
+MultiProducer(benchmark::State &state)
+{
+	Bus::instance();
+	std::vector<Producer> producers(state.range(0));
+	for (auto &producer : producers)
+		producer.msgs.resize(producer_msg_count);
+	for (MAYBE_UNUSED auto _ : state) {
+		for (auto &producer : producers) {
+			producer.delivered.store(0, std::memory_order_relaxed);
+			if (::cord_costart(&producer.cord, "producer",
+					   producer_f, &producer) != 0)
+				panic("failed to start a producer cord");
+		}
+		for (auto &producer : producers) {
+			if (::cord_join(&producer.cord) != 0)
+				panic("failed to join a producer cord");
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * producers.size() *
+				producer_msg_count);
+}
+
+BENCHMARK(MultiProducer)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
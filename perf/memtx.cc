@@ -125,6 +125,9 @@ class Memtx final {
 					   memtx_tuple_arena_max_size,
 					   memtx_objsize_min,
 					   /*dontdump=*/true,
+					   MEMTX_HUGE_PAGES_OFF,
+					   /*mlock=*/false,
+					   /*prefault=*/false,
 					   memtx_granularity, "small",
 					   memtx_alloc_factor,
 					   /*threads_num=*/0,
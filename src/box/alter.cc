@@ -246,6 +246,25 @@ index_opts_validate(struct index_opts *opts)
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->compaction_policy == index_compaction_policy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_policy must be either 'leveled', "
+			 "'tiered' or 'time_window'");
+		return -1;
+	}
+	if (opts->compaction_window <= 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_window must be greater than 0");
+		return -1;
+	}
+	if (opts->page_dict_size != 0 &&
+	    opts->page_dict_size < INDEX_PAGE_DICT_SIZE_MIN) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 tt_sprintf("page_dict_size must be 0 or greater "
+				    "than or equal to %d",
+				    INDEX_PAGE_DICT_SIZE_MIN));
+		return -1;
+	}
 	int rc = -1;
 	struct region *gc = &fiber()->gc;
 	size_t gc_svp = region_used(gc);
@@ -986,6 +1005,7 @@ alter_space_rollback(struct trigger *trigger, void * /* event */)
 	space_pin_defaults(alter->old_space);
 	space_cache_replace(alter->new_space, alter->old_space);
 	SWAP(alter->new_space->sequence_path, alter->old_space->sequence_path);
+	SWAP(alter->new_space->latency, alter->old_space->latency);
 	alter_space_delete(alter);
 	return 0;
 }
@@ -1075,6 +1095,7 @@ alter_space_do(struct txn_stmt *stmt, struct alter_space *alter)
 	alter->new_space->sequence = alter->old_space->sequence;
 	alter->new_space->sequence_fieldno = alter->old_space->sequence_fieldno;
 	SWAP(alter->new_space->sequence_path, alter->old_space->sequence_path);
+	SWAP(alter->new_space->latency, alter->old_space->latency);
 	memcpy(alter->new_space->access, alter->old_space->access,
 	       sizeof(alter->old_space->access));
 
@@ -2638,6 +2659,16 @@ on_replace_dd_index(struct trigger * /* trigger */, void *event)
 	if (old_index != NULL && new_tuple == NULL) {
 		if (alter_space_move_indexes(alter, 0, iid) != 0)
 			return -1;
+		/*
+		 * Drop statistics of the index collected for the SQL
+		 * query planner. No-op on recovery because it's not
+		 * safe to write to space during recovery and the
+		 * deletion is recovered from the log along with the
+		 * index drop.
+		 */
+		if (recovery_state == FINISHED_RECOVERY &&
+		    sql_index_stat_erase(id, iid) != 0)
+			return -1;
 		try {
 			(void) new DropIndex(alter, old_index);
 		} catch (Exception *e) {
@@ -103,6 +103,8 @@
 #include "event.h"
 #include "tweaks.h"
 #include "memtx_tx.h"
+#include "clock.h"
+#include "numa.h"
 
 static char status[64] = "unconfigured";
 
@@ -551,6 +553,14 @@ box_process_rw(struct request *request, struct space *space,
 		return -1;
 	assert(iproto_type_is_dml(request->type));
 	rmean_collect(rmean_box, request->type, 1);
+	/* The space may be freed while the commit yields. */
+	uint32_t space_id = space->def->id;
+	/*
+	 * A before_replace trigger may turn the request into NOP,
+	 * so account the latency to the original type.
+	 */
+	uint16_t type = request->type;
+	double start = clock_monotonic();
 	if (access_check_space(space, PRIV_W) != 0)
 		goto rollback;
 	if (txn_begin_stmt(txn, space, request->type) != 0)
@@ -581,6 +591,7 @@ box_process_rw(struct request *request, struct space *space,
 		tuple_bless(tuple);
 		tuple_unref(tuple);
 	}
+	space_latency_collect(space_id, type, clock_monotonic() - start);
 	return 0;
 
 rollback:
@@ -589,6 +600,7 @@ box_process_rw(struct request *request, struct space *space,
 error:
 	if (return_tuple)
 		tuple_unref(tuple);
+	space_latency_collect(space_id, type, clock_monotonic() - start);
 	return -1;
 }
 
@@ -1796,6 +1808,19 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+/** Check busy_poll_timeout option validity. */
+static double
+box_check_busy_poll_timeout(void)
+{
+	double timeout = cfg_getd("busy_poll_timeout");
+	if (timeout < 0) {
+		diag_set(ClientError, ER_CFG, "busy_poll_timeout",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return timeout;
+}
+
 /** Check replication_synchro_queue_max_size option validity. */
 static int64_t
 box_check_replication_synchro_queue_max_size(void)
@@ -1956,6 +1981,50 @@ box_check_allocator(void)
 	return 0;
 }
 
+static enum memtx_huge_pages
+box_check_memtx_huge_pages(void)
+{
+	const char *str = cfg_gets("memtx_huge_pages");
+	enum memtx_huge_pages huge_pages = (enum memtx_huge_pages)strindex(
+		memtx_huge_pages_strs, str, memtx_huge_pages_MAX);
+	if (huge_pages == memtx_huge_pages_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_huge_pages",
+			 "expected 'off', 'transparent', '2M' or '1G'");
+	}
+	return huge_pages;
+}
+
+/**
+ * Check the NUMA options and return the policy and the node mask
+ * to apply. A zero node mask stands for all online nodes.
+ */
+static int
+box_check_numa(enum numa_policy *policy, uint64_t *nodes)
+{
+	const char *policy_str = cfg_gets("numa_policy");
+	*policy = (enum numa_policy)strindex(numa_policy_strs, policy_str,
+					     numa_policy_MAX);
+	if (*policy == numa_policy_MAX) {
+		diag_set(ClientError, ER_CFG, "numa_policy",
+			 "expected 'default', 'local', 'interleave' or "
+			 "'bind'");
+		return -1;
+	}
+	*nodes = 0;
+	const char *nodes_str = cfg_gets("numa_nodes");
+	if (nodes_str != NULL && numa_nodes_parse(nodes_str, nodes) != 0) {
+		diag_set(ClientError, ER_CFG, "numa_nodes",
+			 diag_last_error(diag_get())->errmsg);
+		return -1;
+	}
+	if (*policy == NUMA_POLICY_BIND && *nodes == 0) {
+		diag_set(ClientError, ER_CFG, "numa_nodes",
+			 "the nodes must be set for the 'bind' policy");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_small_alloc_options(void)
 {
@@ -2159,6 +2228,8 @@ box_check_config(void)
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
+	if (box_check_busy_poll_timeout() < 0)
+		diag_raise();
 	if (box_check_replication_synchro_queue_max_size() < 0)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
@@ -2170,6 +2241,12 @@ box_check_config(void)
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
 	if (box_check_allocator() != 0)
 		diag_raise();
+	if (box_check_memtx_huge_pages() == memtx_huge_pages_MAX)
+		diag_raise();
+	enum numa_policy numa_policy;
+	uint64_t numa_nodes;
+	if (box_check_numa(&numa_policy, &numa_nodes) != 0)
+		diag_raise();
 	box_check_small_alloc_options();
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
@@ -3460,6 +3537,16 @@ box_set_io_collect_interval(void)
 	ev_set_io_collect_interval(loop(), cfg_getd("io_collect_interval"));
 }
 
+int
+box_set_busy_poll_timeout(void)
+{
+	double timeout = box_check_busy_poll_timeout();
+	if (timeout < 0)
+		return -1;
+	cbus_set_busy_poll_timeout(timeout);
+	return 0;
+}
+
 void
 box_set_snap_io_rate_limit(void)
 {
@@ -3635,6 +3722,24 @@ box_set_vinyl_timeout(void)
 	vinyl_engine_set_timeout(vinyl,	cfg_getd("vinyl_timeout"));
 }
 
+void
+box_set_vinyl_dump_io_rate_limit(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_dump_io_rate_limit(vinyl,
+			cfg_getd("vinyl_dump_io_rate_limit"));
+}
+
+void
+box_set_vinyl_compaction_io_rate_limit(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_compaction_io_rate_limit(vinyl,
+			cfg_getd("vinyl_compaction_io_rate_limit"));
+}
+
 void
 box_set_force_recovery(void)
 {
@@ -4158,6 +4263,7 @@ box_select(uint32_t space_id, uint32_t index_id,
 	assert(packed_pos == NULL || packed_pos_end != NULL);
 
 	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	double start = clock_monotonic();
 
 	if (iterator < 0 || iterator >= iterator_type_MAX) {
 		diag_set(IllegalParams, "Invalid iterator type");
@@ -4240,10 +4346,14 @@ box_select(uint32_t space_id, uint32_t index_id,
 					   packed_pos, packed_pos_end);
 	}
 	iterator_delete(it);
+	space_latency_collect(space_id, IPROTO_SELECT,
+			      clock_monotonic() - start);
 	return 0;
 fail:
 	iterator_delete(it);
 	port_destroy(port);
+	space_latency_collect(space_id, IPROTO_SELECT,
+			      clock_monotonic() - start);
 	return -1;
 }
 
@@ -5439,11 +5549,16 @@ engine_init()
 	 * so it must be registered first.
 	 */
 	struct memtx_engine *memtx;
+	enum memtx_huge_pages huge_pages = box_check_memtx_huge_pages();
+	assert(huge_pages != memtx_huge_pages_MAX);
 	memtx = memtx_engine_new_xc(cfg_gets("memtx_dir"),
 				    box_is_force_recovery,
 				    cfg_getd("memtx_memory"),
 				    cfg_geti("memtx_min_tuple_size"),
 				    cfg_geti("strip_core"),
+				    huge_pages,
+				    cfg_geti("memtx_mlock"),
+				    cfg_geti("memtx_prefault"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"),
@@ -5465,6 +5580,8 @@ engine_init()
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
 	box_set_vinyl_timeout();
+	box_set_vinyl_dump_io_rate_limit();
+	box_set_vinyl_compaction_io_rate_limit();
 
 	quiver_engine_register();
 
@@ -6391,6 +6508,7 @@ box_reset_space_stat(struct space *space, void *arg)
 	(void)arg;
 	for (uint32_t i = 0; i < space->index_count; i++)
 		index_reset_stat(space->index[i]);
+	space_latency_reset(space);
 	return 0;
 }
 
@@ -6610,10 +6728,22 @@ box_storage_init(void)
 	/* Add an extra endpoint for WAL wake up/rollback messages. */
 	cbus_endpoint_create(&tx_prio_endpoint, "tx_prio", tx_prio_cb,
 			     &tx_prio_endpoint);
+	cbus_endpoint_enable_busy_poll(&tx_fiber_pool.endpoint);
+	cbus_endpoint_enable_busy_poll(&tx_prio_endpoint);
 
 	rmean_box = rmean_new(iproto_type_strs, IPROTO_TYPE_STAT_MAX);
 	rmean_error = rmean_new(rmean_error_strings, RMEAN_ERROR_LAST);
 
+	/*
+	 * The NUMA policy must be set before the memtx arena is created
+	 * and the iproto and WAL threads are started.
+	 */
+	enum numa_policy numa_policy;
+	uint64_t numa_nodes;
+	if (box_check_numa(&numa_policy, &numa_nodes) != 0)
+		diag_raise();
+	numa_set_policy(numa_policy, numa_nodes);
+
 	gc_init(on_garbage_collection);
 	engine_init();
 	schema_init();
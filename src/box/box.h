@@ -382,6 +382,7 @@ box_check_config(void);
 int box_listen(void);
 void box_set_replication(void);
 void box_set_io_collect_interval(void);
+int box_set_busy_poll_timeout(void);
 void box_set_snap_io_rate_limit(void);
 void box_set_too_long_threshold(void);
 void box_set_readahead(void);
@@ -398,6 +399,8 @@ void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
 void box_set_vinyl_timeout(void);
+void box_set_vinyl_dump_io_rate_limit(void);
+void box_set_vinyl_compaction_io_rate_limit(void);
 void box_set_force_recovery(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
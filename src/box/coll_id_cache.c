@@ -38,6 +38,8 @@ static struct mh_strnptr_t *coll_cache_name = NULL;
 /** mhash table (id -> collation) */
 static struct mh_i32ptr_t *coll_id_cache = NULL;
 
+uint32_t coll_id_cache_version;
+
 const char *coll_id_holder_type_strs[COLL_ID_HOLDER_MAX] = {
 	[COLL_ID_HOLDER_SPACE_FORMAT] = "space format",
 	[COLL_ID_HOLDER_INDEX] = "index",
@@ -80,6 +82,7 @@ coll_id_cache_replace(struct coll_id *coll_id, struct coll_id **replaced_id)
 	assert(repl_id_node.val == repl_name_node.val);
 	assert(repl_id_node.val == NULL);
 	*replaced_id = repl_id_node.val;
+	coll_id_cache_version++;
 	return 0;
 }
 
@@ -92,6 +95,7 @@ coll_id_cache_delete(struct coll_id *coll_id)
 	mh_int_t name_i = mh_strnptr_find_str(coll_cache_name, coll_id->name,
 					      coll_id->name_len);
 	mh_strnptr_del(coll_cache_name, name_i, NULL);
+	coll_id_cache_version++;
 }
 
 struct coll_id *
@@ -73,6 +73,12 @@ struct coll_id_cache_holder {
 	enum coll_id_holder_type type;
 };
 
+/**
+ * Change counter of the collation cache. Compiled SQL statements
+ * refer to collations directly and are recompiled if it changes.
+ */
+extern uint32_t coll_id_cache_version;
+
 /**
  * Create global hash tables.
  */
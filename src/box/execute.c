@@ -110,12 +110,6 @@ sql_row_to_port(struct Vdbe *stmt, struct region *region, struct port *port)
 	return -1;
 }
 
-static bool
-sql_stmt_schema_version_is_valid(struct Vdbe *stmt)
-{
-	return sql_stmt_schema_version(stmt) == box_schema_version();
-}
-
 /**
  * Re-compile statement and refresh global prepared statement
  * cache with the newest value.
@@ -153,7 +147,7 @@ sql_prepare(const char *sql, int len, struct port *port)
 			return -1;
 		}
 	} else {
-		if (!sql_stmt_schema_version_is_valid(stmt) &&
+		if (!sql_stmt_schema_is_valid(stmt) &&
 		    !sql_stmt_busy(stmt)) {
 			if (sql_reprepare(&stmt) != 0)
 				return -1;
@@ -236,7 +230,7 @@ sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 	}
 	struct Vdbe *stmt = sql_stmt_cache_find(stmt_id);
 	assert(stmt != NULL);
-	if (!sql_stmt_schema_version_is_valid(stmt)) {
+	if (!sql_stmt_schema_is_valid(stmt)) {
 		diag_set(ClientError, ER_SQL_EXECUTE, "statement has expired");
 		return -1;
 	}
@@ -252,6 +246,8 @@ sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 	sql_unbind(stmt);
 	if (sql_bind(stmt, bind, bind_count) != 0)
 		return -1;
+	if (sql_stmt_reoptimize(stmt) != 0)
+		return -1;
 	sql_reset_autoinc_id_list(stmt);
 	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
 					       DQL_EXECUTE : DML_EXECUTE;
@@ -266,11 +262,103 @@ sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 	return 0;
 }
 
+/**
+ * Execute an SQL statement using the plan cache: the literals of
+ * the statement are replaced with parameters and the statement
+ * compiled from the resulting string is shared with statements
+ * differing only in literals, see sql_normalize().
+ *
+ * @retval 0 Success.
+ * @retval -1 Execution error.
+ * @retval 1 The statement must be compiled as is.
+ */
+static int
+sql_execute_plan(const char *sql, int len, struct port *port,
+		 struct region *region)
+{
+	size_t svp = region_used(region);
+	char *norm_sql;
+	uint32_t norm_len;
+	struct sql_bind *bind;
+	uint32_t bind_count;
+	if (sql_normalize(sql, len, region, &norm_sql, &norm_len,
+			  &bind, &bind_count) != 0) {
+		region_truncate(region, svp);
+		return 1;
+	}
+	uint32_t sql_flags = current_session()->sql_flags;
+	struct Vdbe *stmt = sql_plan_cache_find(norm_sql, norm_len, sql_flags);
+	bool is_cached = stmt != NULL && !sql_stmt_busy(stmt);
+	if (is_cached) {
+		if (sql_bind(stmt, bind, bind_count) != 0)
+			goto error;
+		/*
+		 * Recompile the plan if the schema has changed. Let
+		 * the original statement report the error if any.
+		 */
+		if (!sql_stmt_schema_is_valid(stmt) &&
+		    sqlReprepare(stmt) != 0) {
+			diag_clear(diag_get());
+			sql_unbind(stmt);
+			region_truncate(region, svp);
+			return 1;
+		}
+	} else {
+		bool is_busy = stmt != NULL;
+		if (sql_stmt_compile(norm_sql, norm_len, NULL, &stmt,
+				     NULL) != 0) {
+			/*
+			 * Parameters may be not allowed where the
+			 * literals are, so compile the original string.
+			 */
+			diag_clear(diag_get());
+			region_truncate(region, svp);
+			return 1;
+		}
+		if (sql_bind(stmt, bind, bind_count) != 0) {
+			sql_stmt_finalize(stmt);
+			return -1;
+		}
+		if (!is_busy)
+			is_cached = sql_plan_cache_insert(stmt, sql_flags);
+	}
+	if (sql_stmt_reoptimize(stmt) != 0) {
+		if (!is_cached)
+			sql_stmt_finalize(stmt);
+		goto error;
+	}
+	sql_reset_autoinc_id_list(stmt);
+	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
+					       DQL_EXECUTE : DML_EXECUTE;
+	port_sql_create(port, stmt, format, !is_cached);
+	if (sql_execute(stmt, port, region) != 0) {
+		port_destroy(port);
+		goto error;
+	}
+	if (is_cached) {
+		sql_stmt_reset(stmt);
+		sql_unbind(stmt);
+	}
+	return 0;
+error:
+	if (is_cached) {
+		sql_stmt_reset(stmt);
+		sql_unbind(stmt);
+	}
+	return -1;
+}
+
 int
 sql_prepare_and_execute(const char *sql, int len, const struct sql_bind *bind,
 			uint32_t bind_count, struct port *port,
 			struct region *region)
 {
+	if (bind_count == 0 &&
+	    (current_session()->sql_flags & SQL_PlanCache) != 0) {
+		int rc = sql_execute_plan(sql, len, port, region);
+		if (rc <= 0)
+			return rc;
+	}
 	struct Vdbe *stmt;
 	if (sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
 		return -1;
@@ -306,21 +394,27 @@ box_process_sql(const struct sql_request *request, struct port *port)
 	 * 4. Execute prepared query (IPROTO_EXECUTE + stmt id).
 	 */
 	if (request->execute) {
+		int rc;
 		if (request->sql_text != NULL) {
 			assert(request->stmt_id == NULL);
 			const char *sql = request->sql_text;
 			uint32_t len;
 			sql = mp_decode_str(&sql, &len);
-			return sql_prepare_and_execute(sql, len,
-						       bind, bind_count,
-						       port, region);
+			rc = sql_prepare_and_execute(sql, len, bind, bind_count,
+						     port, region);
 		} else {
 			assert(request->stmt_id != NULL);
 			const char *data = request->stmt_id;
 			uint32_t stmt_id = mp_decode_uint(&data);
-			return sql_execute_prepared(stmt_id, bind, bind_count,
-						    port, region);
+			rc = sql_execute_prepared(stmt_id, bind, bind_count,
+						  port, region);
 		}
+		/* Only a result set can be returned in Arrow format. */
+		struct port_sql *port_sql = (struct port_sql *)port;
+		if (rc == 0 && request->arrow &&
+		    port_sql->serialization_format == DQL_EXECUTE)
+			port_sql->serialization_format = DQL_EXECUTE_ARROW;
+		return rc;
 	} else {
 		if (request->sql_text != NULL) {
 			assert(request->stmt_id == NULL);
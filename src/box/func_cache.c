@@ -14,6 +14,8 @@ static struct mh_i32ptr_t *funcs;
 /** Name -> func dictionary. */
 static struct mh_strnptr_t *funcs_by_name;
 
+uint32_t func_cache_version;
+
 const char *func_cache_holder_type_strs[FUNC_HOLDER_MAX] = {
 	[FUNC_HOLDER_CONSTRAINT] = "constraint",
 	[FUNC_HOLDER_SPACE_UPGRADE] = "space upgrade",
@@ -55,6 +57,7 @@ func_cache_insert(struct func *func)
 	const struct mh_strnptr_node_t strnode = {
 		func->def->name, def_name_len, name_hash, func };
 	mh_strnptr_put(funcs_by_name, &strnode, NULL, NULL);
+	func_cache_version++;
 }
 
 void
@@ -70,6 +73,7 @@ func_cache_delete(uint32_t fid)
 				strlen(func->def->name));
 	if (k != mh_end(funcs_by_name))
 		mh_strnptr_del(funcs_by_name, k, NULL);
+	func_cache_version++;
 }
 
 struct func *
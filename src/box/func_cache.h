@@ -48,6 +48,13 @@ struct func_cache_holder {
 	enum func_holder_type type;
 };
 
+/**
+ * Change counter of the function cache. Compiled SQL statements
+ * depend on signatures of the functions they call and are
+ * recompiled if it changes.
+ */
+extern uint32_t func_cache_version;
+
 /**
  * Initialize function cache storage.
  */
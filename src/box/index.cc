@@ -42,6 +42,7 @@
 #include "box.h"
 #include "base64.h"
 #include "scoped_guard.h"
+#include "clock.h"
 
 struct rlist box_on_select = RLIST_HEAD_INITIALIZER(box_on_select);
 
@@ -515,6 +516,7 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	if (exact_key_validate(index->def, key, part_count) != 0)
 		return -1;
 	box_run_on_select(space, index, ITER_EQ, key_array);
+	double start = clock_monotonic();
 	/* Start transaction in the engine. */
 	struct txn *txn;
 	struct txn_ro_savepoint svp;
@@ -522,6 +524,8 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 		return -1;
 	int rc = index_get(index, key, part_count, result);
 	txn_end_ro_stmt(txn, &svp);
+	space_latency_collect(space_id, IPROTO_SELECT,
+			      clock_monotonic() - start);
 	if (rc != 0)
 		return -1;
 	/* Count statistics. */
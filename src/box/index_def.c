@@ -40,6 +40,10 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_compaction_policy_strs[] = {
+	"leveled", "tiered", "time_window"
+};
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -49,6 +53,11 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .compaction_policy   = */ INDEX_COMPACTION_POLICY_LEVELED,
+	/* .compaction_window   = */ 86400,
+	/* .blob_threshold      = */ 0,
+	/* .page_restart_interval = */ 0,
+	/* .page_dict_size      = */ 0,
 	/* .lsn                 = */ 0,
 	/* .func                = */ 0,
 	/* .hint                = */ INDEX_HINT_DEFAULT,
@@ -175,6 +184,16 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("compaction_policy", index_compaction_policy,
+		     struct index_opts, compaction_policy, NULL),
+	OPT_DEF("compaction_window", OPT_FLOAT, struct index_opts,
+		compaction_window),
+	OPT_DEF("blob_threshold", OPT_UINT32, struct index_opts,
+		blob_threshold),
+	OPT_DEF("page_restart_interval", OPT_UINT32, struct index_opts,
+		page_restart_interval),
+	OPT_DEF("page_dict_size", OPT_UINT32, struct index_opts,
+		page_dict_size),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
@@ -67,6 +67,39 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl LSM tree compaction policy. */
+enum index_compaction_policy {
+	/**
+	 * Runs are organized in levels, each subsequent level being
+	 * run_size_ratio times larger than the previous one. A level
+	 * is compacted when it has more than run_count_per_level runs.
+	 * The last level never has more than one run.
+	 */
+	INDEX_COMPACTION_POLICY_LEVELED,
+	/**
+	 * Runs of similar size (within run_size_ratio) are grouped in
+	 * tiers. A tier is compacted when it has more than
+	 * run_count_per_level runs. There may be several runs at the
+	 * last tier so the policy trades space amplification for less
+	 * write amplification.
+	 */
+	INDEX_COMPACTION_POLICY_TIERED,
+	/**
+	 * Runs are grouped in windows by dump time, each window
+	 * spanning compaction_window seconds. Runs of the current
+	 * window are compacted as in the tiered policy, and once
+	 * a window is over, all its runs are merged into one run
+	 * that is never compacted with runs of other windows again.
+	 * Suits time-series data that is never updated.
+	 */
+	INDEX_COMPACTION_POLICY_TIME_WINDOW,
+	index_compaction_policy_MAX
+};
+extern const char *index_compaction_policy_strs[];
+
+/** Min size of a zstd dictionary, see index_opts::page_dict_size. */
+enum { INDEX_PAGE_DICT_SIZE_MIN = 256 };
+
 /** Index options */
 struct index_opts {
 	/**
@@ -100,6 +133,30 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Vinyl compaction policy. */
+	enum index_compaction_policy compaction_policy;
+	/**
+	 * Size of a time window, in seconds, used by the time window
+	 * compaction policy.
+	 */
+	double compaction_window;
+	/**
+	 * Vinyl primary index only: tuples whose size is greater
+	 * than or equal to this value are stored in blob files
+	 * separately from keys. 0 disables the feature.
+	 */
+	uint32_t blob_threshold;
+	/**
+	 * Vinyl index only: if not 0, rows of new run pages are
+	 * prefix-compressed, with a full row stored every
+	 * page_restart_interval rows.
+	 */
+	uint32_t page_restart_interval;
+	/**
+	 * Vinyl index only: max size of a zstd dictionary trained
+	 * for each compacted run. 0 disables dictionaries.
+	 */
+	uint32_t page_dict_size;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -176,6 +233,16 @@ index_opts_is_equal(const struct index_opts *o1, const struct index_opts *o2)
 		return false;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return false;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return false;
+	if (o1->compaction_window != o2->compaction_window)
+		return false;
+	if (o1->blob_threshold != o2->blob_threshold)
+		return false;
+	if (o1->page_restart_interval != o2->page_restart_interval)
+		return false;
+	if (o1->page_dict_size != o2->page_dict_size)
+		return false;
 	if (o1->func_id != o2->func_id)
 		return false;
 	if (o1->hint != o2->hint)
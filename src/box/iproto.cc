@@ -68,6 +68,7 @@
 #include "rmean.h"
 #include "execute.h"
 #include "errinj.h"
+#include "numa.h"
 #include "tt_static.h"
 #include "trivia/util.h"
 #include "salad/stailq.h"
@@ -79,6 +80,8 @@
 #include "box/mp_box_ctx.h"
 #include "box/tuple.h"
 #include "mpstream/mpstream.h"
+#include "clock.h"
+#include "latency.h"
 
 enum {
 	IPROTO_PACKET_SIZE_MAX = 2UL * 1024 * 1024 * 1024,
@@ -357,6 +360,13 @@ struct iproto_req_handlers {
  */
 static mh_i32ptr_t *tx_req_handlers;
 
+/**
+ * Latency of requests by type, from the moment a request is read
+ * from the socket to the moment its reply is ready. Accessed in the
+ * TX thread only.
+ */
+static struct latency tx_request_latency[IPROTO_TYPE_STAT_MAX];
+
 /**
  * If set then iproto shutdown is started and we should not accept new
  * connections.
@@ -612,6 +622,8 @@ struct iproto_msg
 	struct rlist in_inprogress;
 	/** TX thread fiber that processing this message. */
 	struct fiber *fiber;
+	/** Monotonic time when the request was read from the socket. */
+	double start_time;
 };
 
 /**
@@ -1012,6 +1024,7 @@ iproto_msg_new(struct iproto_connection *con)
 	msg->connection = con;
 	msg->stream = NULL;
 	msg->fiber = NULL;
+	msg->start_time = clock_monotonic();
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	con->request_count++;
 	return msg;
@@ -2229,6 +2242,7 @@ tx_accept_msg(struct cmsg *m)
 		return msg;
 	tx_accept_wpos(msg->connection, &msg->wpos);
 	tx_fiber_init(msg->connection->session, msg->header.sync);
+	fiber()->storage.net.request_type = iproto_type_name(msg->header.type);
 	tx_prepare_transaction_for_request(msg);
 	msg->connection->iproto_thread->tx.requests_in_progress++;
 	rlist_add_entry(&msg->connection->tx.inprogress, msg,
@@ -2287,10 +2301,15 @@ tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 	msg->connection->iproto_thread->tx.requests_in_progress--;
 	rlist_del(&msg->in_inprogress);
 	msg->fiber = NULL;
+	fiber()->storage.net.request_type = NULL;
 	struct obuf *out = msg->connection->tx.p_obuf;
 	if (msg->connection->tx.p_obuf->used != svp->used)
 		/* Log response to the flight recorder. */
 		flightrec_write_response(out, svp);
+	if (msg->header.type < IPROTO_TYPE_STAT_MAX) {
+		latency_collect(&tx_request_latency[msg->header.type],
+				clock_monotonic() - msg->start_time);
+	}
 }
 
 /**
@@ -3448,6 +3467,8 @@ net_cord_f(va_list  ap)
 	struct iproto_thread *iproto_thread =
 		va_arg(ap, struct iproto_thread *);
 
+	/* Keep the slab caches and buffers on the configured NUMA nodes. */
+	numa_bind_thread();
 	mempool_create(&iproto_thread->iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
 	mempool_create(&iproto_thread->iproto_connection_pool, &cord()->slabc,
@@ -3466,6 +3487,7 @@ net_cord_f(va_list  ap)
 	/* Create "net" endpoint. */
 	cbus_endpoint_create(&endpoint, endpoint_name,
 			     fiber_schedule_cb, fiber());
+	cbus_endpoint_enable_busy_poll(&endpoint);
 	/* Create a pipe to "tx" thread. */
 	cpipe_create(&iproto_thread->tx_pipe, "tx");
 	cpipe_set_max_input(&iproto_thread->tx_pipe, iproto_msg_max / 2);
@@ -3909,6 +3931,10 @@ iproto_init(int threads_count)
 	 */
 	tx_req_handlers = mh_i32ptr_new();
 	event_foreach(iproto_override_event_init, NULL);
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++) {
+		if (latency_create(&tx_request_latency[i]) != 0)
+			panic("failed to initialize request latency");
+	}
 
 	for (int i = 0; i < threads_count; i++) {
 		struct iproto_thread *iproto_thread = &iproto_threads[i];
@@ -4241,6 +4267,16 @@ iproto_reset_stat(void)
 		rmean_cleanup(iproto_threads[i].rmean);
 		rmean_cleanup(iproto_threads[i].tx.rmean);
 	}
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++)
+		latency_reset(&tx_request_latency[i]);
+}
+
+struct latency *
+iproto_request_latency(uint32_t type)
+{
+	if (type >= IPROTO_TYPE_STAT_MAX)
+		return NULL;
+	return &tx_request_latency[type];
 }
 
 int
@@ -4370,6 +4406,8 @@ iproto_free(void)
 		iproto_req_handlers_delete(handlers);
 	}
 	mh_i32ptr_delete(tx_req_handlers);
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++)
+		latency_destroy(&tx_request_latency[i]);
 	fiber_cond_destroy(&drop_finished_cond);
 
 	/*
@@ -40,6 +40,7 @@ struct uri_set;
 struct session;
 struct user;
 struct iostream;
+struct latency;
 
 #if defined(__cplusplus)
 extern "C" {
@@ -109,6 +110,15 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 void
 iproto_reset_stat(void);
 
+/**
+ * Return the latency of requests of the given type, from the moment
+ * a request is read from the socket to the moment its reply is ready,
+ * or NULL if requests of the type aren't accounted. Must be called
+ * from the TX thread.
+ */
+struct latency *
+iproto_request_latency(uint32_t type);
+
 /**
  * Return count of the addresses currently served by iproto.
  */
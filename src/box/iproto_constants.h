@@ -170,6 +170,8 @@ extern const char *iproto_flag_bit_strs[];
 	 */								\
 	_(SQL_INFO, 0x42, MP_MAP)					\
 	_(STMT_ID, 0x43, MP_UINT)					\
+	/** Return the result of IPROTO_EXECUTE as IPROTO_ARROW. */	\
+	_(SQL_ARROW, 0x44, MP_BOOL)					\
 	/* Leave a gap between SQL keys and additional request keys */	\
 	_(REPLICA_ANON, 0x50, MP_BOOL)					\
 	_(ID_FILTER, 0x51, MP_ARRAY)					\
@@ -619,6 +621,14 @@ request_replace_body_create(struct request_replace_body *body,
 	_(STMT_STAT, 8)							\
 	/** Bloom filter for keys. */					\
 	_(BLOOM_FILTER, 9)						\
+	/** Time of the most recent dump stored in the run. */		\
+	_(DUMP_TIME, 10)						\
+	/** Blob files referenced by the run. */			\
+	_(BLOBS, 11)							\
+	/** Restart interval of prefix-compressed page rows. */		\
+	_(RESTART_INTERVAL, 12)						\
+	/** Zstd dictionary pages are compressed with. */		\
+	_(DICTIONARY, 13)						\
 
 #define VY_RUN_INFO_KEY_MEMBER(s, v) VY_RUN_INFO_ ## s = v,
 
@@ -37,7 +37,7 @@
 #include "lua/utils.h"
 
 #include "box/box.h"
-#include "libeio/eio.h"
+#include "coio_task.h"
 
 extern "C" {
 	#include <lua.h>
@@ -122,6 +122,14 @@ lbox_cfg_set_io_collect_interval(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_busy_poll_timeout(struct lua_State *L)
+{
+	if (box_set_busy_poll_timeout() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_too_long_threshold(struct lua_State *L)
 {
@@ -290,6 +298,22 @@ lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_dump_io_rate_limit(struct lua_State *L)
+{
+	(void)L;
+	box_set_vinyl_dump_io_rate_limit();
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_compaction_io_rate_limit(struct lua_State *L)
+{
+	(void)L;
+	box_set_vinyl_compaction_io_rate_limit();
+	return 0;
+}
+
 static int
 lbox_cfg_set_force_recovery(struct lua_State *L)
 {
@@ -321,8 +345,7 @@ static int
 lbox_cfg_set_worker_pool_threads(struct lua_State *L)
 {
 	(void) L;
-	eio_set_min_parallel(cfg_geti("worker_pool_threads"));
-	eio_set_max_parallel(cfg_geti("worker_pool_threads"));
+	coio_set_worker_count(cfg_geti("worker_pool_threads"));
 	return 0;
 }
 
@@ -555,6 +578,7 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_worker_pool_threads", lbox_cfg_set_worker_pool_threads},
 		{"cfg_set_readahead", lbox_cfg_set_readahead},
 		{"cfg_set_io_collect_interval", lbox_cfg_set_io_collect_interval},
+		{"cfg_set_busy_poll_timeout", lbox_cfg_set_busy_poll_timeout},
 		{"cfg_set_too_long_threshold", lbox_cfg_set_too_long_threshold},
 		{"cfg_set_snap_io_rate_limit", lbox_cfg_set_snap_io_rate_limit},
 		{"cfg_set_checkpoint_count", lbox_cfg_set_checkpoint_count},
@@ -572,6 +596,10 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
+		{"cfg_set_vinyl_dump_io_rate_limit",
+		 lbox_cfg_set_vinyl_dump_io_rate_limit},
+		{"cfg_set_vinyl_compaction_io_rate_limit",
+		 lbox_cfg_set_vinyl_compaction_io_rate_limit},
 		{"cfg_set_force_recovery", lbox_cfg_set_force_recovery},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
@@ -1285,6 +1285,14 @@ I['fiber'] = format_text([[
     and cooperative multitasking.
 ]])
 
+I['fiber.busy_poll_timeout'] = format_text([[
+    The time period (in seconds) the tx, iproto and WAL threads keep
+    polling for messages from other threads before they go to sleep.
+    Busy polling reduces the latency of requests under high load at the
+    cost of CPU usage, so it makes sense when the threads have dedicated
+    CPU cores. By default, busy polling is disabled.
+]])
+
 I['fiber.io_collect_interval'] = format_text([[
     The time period (in seconds) a fiber sleeps between iterations of the
     event loop.
@@ -1653,6 +1661,22 @@ I['log'] = format_text([[
     To handle logging in your application, use the log module.
 ]])
 
+I['log.async'] = format_text([[
+    Write the log in a dedicated thread. Formatted log entries are put
+    into an in-memory buffer, so logging doesn't wait for a slow disk or
+    a slow reader of the pipe. Only a log written to a file or a pipe can
+    be asynchronous.
+]])
+
+I['log.async_overflow'] = format_text([[
+    Specify the logging behavior if the buffer of the asynchronous log
+    (`log.async`) is full:
+
+    - `drop`: drop the log entry. The number of dropped entries is
+      written to the log later.
+    - `block`: wait until the log thread writes out some entries.
+]])
+
 I['log.file'] = format_text([[
     Specify a file for logs destination. To write logs to a file, you need
     to set `log.to` to file. Otherwise, `log.file` is ignored.
@@ -1788,6 +1812,19 @@ I['memtx.allocator'] = format_text([[
       switch to `system` in such cases.
 ]])
 
+I['memtx.huge_pages'] = format_text([[
+    Specify the pages that back the preallocated memtx arena, which stores
+    tuples and index extents. Possible values:
+
+    - `off` - regular pages.
+    - `transparent` - ask the kernel to use transparent huge pages.
+    - `2M`, `1G` - explicit huge pages of the given size reserved in the
+      hugetlb pool of the system.
+
+    If huge pages can't be used, the arena falls back to regular pages,
+    which is reported by `box.slab.info().arena_huge_fallback`.
+]])
+
 I['memtx.max_tuple_size'] = format_text([[
     Size of the largest allocation unit for the memtx storage engine in bytes.
     It can be increased if it is necessary to store large tuples.
@@ -1806,6 +1843,18 @@ I['memtx.min_tuple_size'] = format_text([[
     most of the tuples are very small.
 ]])
 
+I['memtx.mlock'] = format_text([[
+    Lock the preallocated memtx arena in memory on startup so that it is
+    never swapped out. Requires the `RLIMIT_MEMLOCK` limit or the
+    `CAP_IPC_LOCK` capability large enough for `memtx.memory`.
+]])
+
+I['memtx.prefault'] = format_text([[
+    Fault in all pages of the preallocated memtx arena on startup so that
+    there are no page faults on first access to the memory later. It
+    takes time proportional to `memtx.memory`.
+]])
+
 I['memtx.slab_alloc_factor'] = format_text([[
     The multiplier for computing the sizes of memory chunks that tuples
     are stored in. A lower value may result in less wasted memory depending
@@ -1904,6 +1953,25 @@ I['process.coredump'] = format_text([[
     to man 2 prctl, see PR_SET_DUMPABLE).
 ]])
 
+I['process.numa_nodes'] = format_text([[
+    A list of NUMA nodes used by `process.numa_policy`, for example,
+    `0,2-3`. If not set, all online nodes are used.
+]])
+
+I['process.numa_policy'] = format_text([[
+    Specify the NUMA placement of the memtx arena and of the memory of the
+    iproto and WAL threads:
+
+    - `default`: keep the policy inherited from the parent process.
+    - `local`: allocate memory on the node of the CPU that touches it first.
+    - `interleave`: spread memory over the `process.numa_nodes` nodes page
+      by page.
+    - `bind`: allocate memory on the `process.numa_nodes` nodes only.
+
+    If a policy is set, `box.slab.info()` reports the memory of the memtx
+    arena on each node in `arena_numa_used`.
+]])
+
 I['process.pid_file'] = format_text([[
     Store the process id in this file.
 
@@ -2639,6 +2707,11 @@ I['vinyl.cache'] = format_text([[
     be resized dynamically.
 ]])
 
+I['vinyl.compaction_io_rate_limit'] = format_text([[
+    The maximum number of megabytes per second that vinyl compactions can
+    read from and write to disk. By default, the bandwidth is unlimited.
+]])
+
 I['vinyl.defer_deletes'] = format_text([[
     Enable the deferred DELETE optimization in vinyl. It was disabled by
     default since Tarantool version 2.10 to avoid possible performance
@@ -2651,6 +2724,11 @@ I['vinyl.dir'] = format_text([[
     relative to `process.work_dir`.
 ]])
 
+I['vinyl.dump_io_rate_limit'] = format_text([[
+    The maximum number of megabytes per second that vinyl dumps can write
+    to disk. By default, the bandwidth is unlimited.
+]])
+
 I['vinyl.max_tuple_size'] = format_text([[
     The size of the largest allocation unit, for the vinyl storage engine.
     It can be increased if it is necessary to store large tuples.
@@ -480,6 +480,22 @@ return schema.new('instance_config', schema.record({
             mk_parent_dir = true,
             default = 'var/run/{{ instance_name }}/tarantool.pid',
         }),
+        numa_policy = schema.enum({
+            'default',
+            'local',
+            'interleave',
+            'bind',
+        }, {
+            box_cfg = 'numa_policy',
+            box_cfg_nondynamic = true,
+            default = 'default',
+        }),
+        numa_nodes = schema.scalar({
+            type = 'string',
+            box_cfg = 'numa_nodes',
+            box_cfg_nondynamic = true,
+            default = box.NULL,
+        }),
     }),
     lua = schema.record({
         -- Maximum allowed memory allocated by Lua.
@@ -507,6 +523,11 @@ return schema.new('instance_config', schema.record({
         }),
     }),
     fiber = schema.record({
+        busy_poll_timeout = schema.scalar({
+            type = 'number',
+            box_cfg = 'busy_poll_timeout',
+            default = 0,
+        }),
         io_collect_interval = schema.scalar({
             type = 'number',
             box_cfg = 'io_collect_interval',
@@ -615,6 +636,18 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'log_format',
             default = 'plain',
         }),
+        async = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'log_async',
+            default = false,
+        }),
+        async_overflow = schema.enum({
+            'drop',
+            'block',
+        }, {
+            box_cfg = 'log_async_overflow',
+            default = 'drop',
+        }),
         -- box.cfg({log_modules = <...>}) replaces the previous
         -- value without any merging.
         --
@@ -915,6 +948,28 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 'small',
         }),
+        huge_pages = schema.enum({
+            'off',
+            'transparent',
+            '2M',
+            '1G',
+        }, {
+            box_cfg = 'memtx_huge_pages',
+            box_cfg_nondynamic = true,
+            default = 'off',
+        }),
+        mlock = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_mlock',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
+        prefault = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_prefault',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
         slab_alloc_granularity = schema.scalar({
             type = 'integer',
             box_cfg = 'slab_alloc_granularity',
@@ -962,6 +1017,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'vinyl_cache',
             default = 128 * 1024 * 1024,
         }),
+        compaction_io_rate_limit = schema.scalar({
+            type = 'number',
+            box_cfg = 'vinyl_compaction_io_rate_limit',
+            default = box.NULL,
+        }),
         defer_deletes = schema.scalar({
             type = 'boolean',
             box_cfg = 'vinyl_defer_deletes',
@@ -974,6 +1034,11 @@ return schema.new('instance_config', schema.record({
             mkdir = true,
             default = 'var/lib/{{ instance_name }}',
         }),
+        dump_io_rate_limit = schema.scalar({
+            type = 'number',
+            box_cfg = 'vinyl_dump_io_rate_limit',
+            default = box.NULL,
+        }),
         max_tuple_size = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_max_tuple_size',
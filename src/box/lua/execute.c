@@ -515,6 +515,32 @@ lbox_prepare(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Collect statistics of an index for the SQL query planner,
+ * see sql_index_analyze().
+ */
+static int
+lbox_sql_analyze(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2))
+		return luaL_error(L, "Usage: sql_analyze(space_id, index_id)");
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	/* Statistics are stored in the _sql_stat space. */
+	if (schema_check_feature(SCHEMA_FEATURE_SQL_STAT) != 0)
+		return luaT_error(L);
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *data, *data_end;
+	if (sql_index_analyze(space_id, index_id, &data, &data_end) != 0) {
+		region_truncate(&fiber()->gc, region_svp);
+		return luaT_error(L);
+	}
+	luamp_decode(L, luaL_msgpack_default, &data);
+	assert(data == data_end);
+	region_truncate(&fiber()->gc, region_svp);
+	return 1;
+}
+
 void
 box_lua_sql_init(struct lua_State *L)
 {
@@ -532,4 +558,9 @@ box_lua_sql_init(struct lua_State *L)
 	lua_settable(L, -3);
 
 	lua_pop(L, 1);
+
+	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal", 0);
+	lua_pushcfunction(L, lbox_sql_analyze);
+	lua_setfield(L, -2, "sql_analyze");
+	lua_pop(L, 1);
 }
@@ -489,6 +489,48 @@ lbox_info_memory(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_fiber_stack_pool_call(struct lua_State *L)
+{
+	struct fiber_stack_pool_stat stat;
+	fiber_stack_pool_stat(&stat);
+
+	lua_createtable(L, 0, 4);
+
+	lua_pushstring(L, "count");
+	luaL_pushuint64(L, stat.count);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "size");
+	luaL_pushuint64(L, stat.size);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "hits");
+	luaL_pushuint64(L, stat.hits);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "misses");
+	luaL_pushuint64(L, stat.misses);
+	lua_settable(L, -3);
+
+	return 1;
+}
+
+static int
+lbox_info_fiber_stack_pool(struct lua_State *L)
+{
+	lua_newtable(L);
+
+	lua_newtable(L); /* metatable */
+
+	lua_pushstring(L, "__call");
+	lua_pushcfunction(L, lbox_info_fiber_stack_pool_call);
+	lua_settable(L, -3);
+
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
 static int
 lbox_info_gc_call(struct lua_State *L)
 {
@@ -818,6 +860,7 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"pid", lbox_info_pid},
 	{"cluster", lbox_info_cluster},
 	{"memory", lbox_info_memory},
+	{"fiber_stack_pool", lbox_info_fiber_stack_pool},
 	{"gc", lbox_info_gc},
 	{"vinyl", lbox_info_vinyl},
 	{"sql", lbox_info_sql},
@@ -100,6 +100,11 @@ local default_cfg = {
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
     memtx_allocator     = "small",
+    memtx_huge_pages    = "off",
+    memtx_mlock         = false,
+    memtx_prefault      = false,
+    numa_policy         = "default",
+    numa_nodes          = nil,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -111,6 +116,8 @@ local default_cfg = {
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
     vinyl_timeout       = 60,
+    vinyl_dump_io_rate_limit = nil, -- no limit
+    vinyl_compaction_io_rate_limit = nil, -- no limit
     vinyl_defer_deletes = false,
     vinyl_run_count_per_level = 2,
     vinyl_run_size_ratio      = 3.5,
@@ -127,6 +134,8 @@ local default_cfg = {
     log_level           = log.cfg.level,
     log_modules         = log.cfg.modules,
     log_format          = log.cfg.format,
+    log_async           = log.cfg.async,
+    log_async_overflow  = log.cfg.async_overflow,
 
     audit_log           = ifdef_audit(nil),
     audit_nonblock      = ifdef_audit(true),
@@ -159,6 +168,7 @@ local default_cfg = {
     flightrec_requests_max_res_size = ifdef_flightrec(16384),
 
     io_collect_interval = nil,
+    busy_poll_timeout   = 0,
     readahead           = 16320,
     snap_io_rate_limit  = nil, -- no limit
     too_long_threshold  = 0.5,
@@ -310,6 +320,11 @@ local template_cfg = {
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
     memtx_allocator     = 'string',
+    memtx_huge_pages    = 'string',
+    memtx_mlock         = 'boolean',
+    memtx_prefault      = 'boolean',
+    numa_policy         = 'string',
+    numa_nodes          = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
@@ -320,6 +335,8 @@ local template_cfg = {
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
     vinyl_timeout             = 'number',
+    vinyl_dump_io_rate_limit  = 'number',
+    vinyl_compaction_io_rate_limit = 'number',
     vinyl_defer_deletes       = 'boolean',
     vinyl_run_count_per_level = 'number',
     vinyl_run_size_ratio      = 'number',
@@ -336,6 +353,8 @@ local template_cfg = {
     log_level           = 'number, string',
     log_modules         = 'table',
     log_format          = 'string',
+    log_async           = 'boolean',
+    log_async_overflow  = 'string',
 
     audit_log           = ifdef_audit('string'),
     audit_nonblock      = ifdef_audit('boolean'),
@@ -368,6 +387,7 @@ local template_cfg = {
     flightrec_requests_max_res_size = ifdef_flightrec('number'),
 
     io_collect_interval = 'number',
+    busy_poll_timeout   = 'number',
     readahead           = 'number',
     snap_io_rate_limit  = 'number',
     too_long_threshold  = 'number',
@@ -524,6 +544,7 @@ end
 local dynamic_cfg = {
     replication             = private.cfg_set_replication,
     io_collect_interval     = private.cfg_set_io_collect_interval,
+    busy_poll_timeout       = private.cfg_set_busy_poll_timeout,
     readahead               = private.cfg_set_readahead,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
@@ -535,6 +556,9 @@ local dynamic_cfg = {
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
+    vinyl_dump_io_rate_limit = private.cfg_set_vinyl_dump_io_rate_limit,
+    vinyl_compaction_io_rate_limit =
+        private.cfg_set_vinyl_compaction_io_rate_limit,
     vinyl_defer_deletes     = nop,
     quiver_memory           = private.cfg_set_quiver_memory,
     quiver_run_size         = private.cfg_set_quiver_run_size,
@@ -661,6 +685,8 @@ local dynamic_cfg_modules = {
             log_modules = true,
             log_format = true,
             log_nonblock = true,
+            log_async = true,
+            log_async_overflow = true,
         },
         skip_at_load = true,
     }
@@ -730,6 +756,8 @@ local dynamic_cfg_skip_at_load = {
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
     vinyl_timeout           = true,
+    vinyl_dump_io_rate_limit = true,
+    vinyl_compaction_io_rate_limit = true,
     quiver_memory           = ifdef_quiver(true),
     quiver_run_size         = ifdef_quiver(true),
     too_long_threshold      = true,
@@ -61,6 +61,7 @@
 #include "lua/msgpack.h"
 #include "lua/uri.h"
 #include "lua/utils.h"
+#include "mp_extension_types.h"
 #include "msgpuck.h"
 #include "small/ibuf.h"
 #include "small/region.h"
@@ -1305,11 +1306,12 @@ static int
 netbox_encode_execute(lua_State *L, int idx,
 		      struct netbox_method_encode_ctx *ctx)
 {
-	/* Lua stack at idx: query, parameters, options */
+	/* Lua stack at idx: query, parameters, options, arrow */
 	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync, IPROTO_EXECUTE,
 					 ctx->stream_id);
 
-	mpstream_encode_map(ctx->stream, 3);
+	bool arrow = lua_toboolean(L, idx + 3);
+	mpstream_encode_map(ctx->stream, arrow ? 4 : 3);
 
 	if (lua_type(L, idx) == LUA_TNUMBER) {
 		uint32_t query_id = lua_tointeger(L, idx);
@@ -1330,6 +1332,11 @@ netbox_encode_execute(lua_State *L, int idx,
 	if (luamp_encode_tuple(L, cfg, ctx->stream, idx + 2) != 0)
 		return -1;
 
+	if (arrow) {
+		mpstream_encode_uint(ctx->stream, IPROTO_SQL_ARROW);
+		mpstream_encode_bool(ctx->stream, true);
+	}
+
 	netbox_end_encode(ctx->stream, svp);
 	return 0;
 }
@@ -1928,9 +1935,27 @@ netbox_decode_execute(struct lua_State *L, const char **data,
 	assert(mp_typeof(**data) == MP_MAP);
 	uint32_t map_size = mp_decode_map(data);
 	int rows_index = 0, meta_index = 0, info_index = 0;
+	bool is_arrow = false;
 	for (uint32_t i = 0; i < map_size; ++i) {
 		uint32_t key = mp_decode_uint(data);
 		switch(key) {
+		case IPROTO_ARROW: {
+			/*
+			 * The Arrow IPC stream is passed to the user as
+			 * is, so that it can be handed over to an Arrow
+			 * consumer or space:insert_arrow() without
+			 * decoding the values.
+			 */
+			int8_t type;
+			uint32_t len;
+			const char *arrow = mp_decode_ext(data, &type, &len);
+			assert(type == MP_ARROW);
+			(void)type;
+			lua_pushlstring(L, arrow, len);
+			rows_index = lua_gettop(L);
+			is_arrow = true;
+			break;
+		}
 		case IPROTO_DATA:
 			if (return_raw) {
 				const char *begin = *data;
@@ -1963,7 +1988,7 @@ netbox_decode_execute(struct lua_State *L, const char **data,
 		lua_pushvalue(L, meta_index);
 		lua_setfield(L, -2, "metadata");
 		lua_pushvalue(L, rows_index);
-		lua_setfield(L, -2, "rows");
+		lua_setfield(L, -2, is_arrow ? "arrow" : "rows");
 	} else {
 		assert(meta_index == 0);
 		assert(rows_index == 0);
@@ -3288,6 +3313,8 @@ luaopen_net_box(struct lua_State *L)
 			    IPROTO_FEATURE_CALL_ARG_TUPLE_EXTENSION);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_IS_SYNC);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_SQL_ARROW);
 
 	lua_pushcfunction(L, luaT_netbox_request_iterator_next);
 	luaT_netbox_request_iterator_next_ref = luaL_ref(L, LUA_REGISTRYINDEX);
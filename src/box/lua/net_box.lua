@@ -55,6 +55,10 @@ local REQUEST_OPTION_TYPES = {
     end,
 }
 
+local EXECUTE_OPTION_TYPES = {
+    arrow = "boolean",
+}
+
 local CONNECT_OPTION_TYPES = {
     user                        = "string",
     password                    = "string",
@@ -988,12 +992,15 @@ end
 
 function remote_methods:execute(query, parameters, sql_opts, netbox_opts)
     check_remote_arg(self, "execute")
-    if sql_opts ~= nil then
-        box.error(box.error.UNSUPPORTED, "execute", "options")
+    check_param_table(sql_opts, EXECUTE_OPTION_TYPES)
+    local arrow = sql_opts ~= nil and sql_opts.arrow
+    if arrow and not self.peer_protocol_features.sql_arrow then
+        return box.error(box.error.UNSUPPORTED, "Remote server",
+            "SQL results in Arrow format")
     end
     check_param_table(netbox_opts, REQUEST_OPTION_TYPES)
     return self:_request('EXECUTE', netbox_opts, nil, self._stream_id,
-                         query, parameters or {}, sql_opts or {})
+                         query, parameters or {}, {}, arrow)
 end
 
 function remote_methods:prepare(query, parameters, sql_opts, netbox_opts) -- luacheck: no unused args
@@ -1559,6 +1559,11 @@ local index_options = {
     distance = 'string',
     run_count_per_level = 'number',
     run_size_ratio = 'number',
+    compaction_policy = 'string',
+    compaction_window = 'number',
+    blob_threshold = 'number',
+    page_restart_interval = 'number',
+    page_dict_size = 'number',
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
@@ -1760,6 +1765,11 @@ box.schema.index.create = atomic_wrapper(function(space_id, name, options)
             range_size = options.range_size,
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
+            compaction_policy = options.compaction_policy,
+            compaction_window = options.compaction_window,
+            blob_threshold = options.blob_threshold,
+            page_restart_interval = options.page_restart_interval,
+            page_dict_size = options.page_dict_size,
             bloom_fpr = options.bloom_fpr,
             func = options.func,
             hint = options.hint,
@@ -2952,6 +2962,17 @@ space_mt.upgrade = function(space, ...)
     check_space_arg(space, 'upgrade', 2)
     return box.schema.space.upgrade(space.id, ...)
 end
+space_mt.analyze = function(space)
+    check_space_arg(space, 'analyze', 2)
+    check_space_exists(space, 2)
+    local _sql_stat = box.space[box.schema.SQL_STAT_ID]
+    for id in pairs(space.index) do
+        if type(id) == 'number' then
+            local stat = internal.sql_analyze(space.id, id)
+            _sql_stat:replace({space.id, id, unpack(stat)})
+        end
+    end
+end
 space_mt.drop = function(space)
     check_space_arg(space, 'drop', 2)
     check_space_exists(space, 2)
@@ -52,6 +52,7 @@
 #include "small/small.h"
 #include "small/quota.h"
 #include "memory.h"
+#include "numa.h"
 #include "box/box.h"
 #include "box/engine.h"
 #include "box/memtx_engine.h"
@@ -217,6 +218,52 @@ lbox_slab_info(struct lua_State *L)
 	lua_pushstring(L, ratio_buf);
 	lua_settable(L, -3);
 
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	/*
+	 * How much of the arena is backed by explicit huge pages and
+	 * whether the configured huge pages failed to be used.
+	 */
+	if (memtx->arena_huge_pages != MEMTX_HUGE_PAGES_OFF) {
+		lua_pushstring(L, "arena_huge_size");
+		luaL_pushuint64(L, memtx->arena_huge_size);
+		lua_settable(L, -3);
+
+		lua_pushstring(L, "arena_huge_fallback");
+		lua_pushboolean(L, memtx->arena_huge_fallback);
+		lua_settable(L, -3);
+	}
+	/* How much of the arena is locked in memory. */
+	if (memtx->arena_mlock) {
+		lua_pushstring(L, "arena_locked_size");
+		luaL_pushuint64(L, memtx->arena_locked_size);
+		lua_settable(L, -3);
+	}
+
+	/*
+	 * Memory of the arena resident on each NUMA node. Collecting
+	 * it walks the page tables of the process, so it's reported
+	 * only if a NUMA policy is configured. It is omitted if the
+	 * kernel doesn't report it, e.g. if it's built without NUMA.
+	 */
+	size_t usage[NUMA_NODE_MAX];
+	int node_count = -1;
+	if (numa_get_policy() != NUMA_POLICY_DEFAULT) {
+		node_count = numa_memory_usage(memtx->arena.arena,
+					       memtx->arena.prealloc, usage);
+		if (node_count < 0)
+			diag_clear(diag_get());
+	}
+	if (node_count >= 0) {
+		lua_pushstring(L, "arena_numa_used");
+		lua_createtable(L, 0, node_count);
+		for (int i = 0; i < node_count; i++) {
+			luaL_pushuint64(L, usage[i]);
+			lua_rawseti(L, -2, i);
+		}
+		lua_settable(L, -3);
+	}
+
 	return 1;
 }
 
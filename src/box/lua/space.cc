@@ -704,6 +704,35 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->compaction_policy !=
+			    INDEX_COMPACTION_POLICY_LEVELED) {
+				lua_pushstring(L, index_compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->compaction_policy ==
+			    INDEX_COMPACTION_POLICY_TIME_WINDOW) {
+				lua_pushnumber(L, index_opts->compaction_window);
+				lua_setfield(L, -2, "compaction_window");
+			}
+
+			if (index_opts->blob_threshold != 0) {
+				lua_pushnumber(L, index_opts->blob_threshold);
+				lua_setfield(L, -2, "blob_threshold");
+			}
+
+			if (index_opts->page_restart_interval != 0) {
+				lua_pushnumber(L,
+					index_opts->page_restart_interval);
+				lua_setfield(L, -2, "page_restart_interval");
+			}
+
+			if (index_opts->page_dict_size != 0) {
+				lua_pushnumber(L, index_opts->page_dict_size);
+				lua_setfield(L, -2, "page_dict_size");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -1022,6 +1051,8 @@ box_lua_space_init(struct lua_State *L)
 	lua_setfield(L, -2, "SESSION_SETTINGS_ID");
 	lua_pushnumber(L, BOX_GC_CONSUMERS_ID);
 	lua_setfield(L, -2, "GC_CONSUMERS_ID");
+	lua_pushnumber(L, BOX_SQL_STAT_ID);
+	lua_setfield(L, -2, "SQL_STAT_ID");
 	lua_pushnumber(L, BOX_SYSTEM_ID_MIN);
 	lua_setfield(L, -2, "SYSTEM_ID_MIN");
 	lua_pushnumber(L, BOX_SYSTEM_ID_MAX);
@@ -44,7 +44,11 @@
 #include "box/vinyl.h"
 #include "box/sql.h"
 #include "box/memtx_engine.h"
+#include "box/space.h"
+#include "cbus.h"
+#include "coio_task.h"
 #include "info/info.h"
+#include "latency.h"
 #include "lua/info.h"
 #include "lua/utils.h"
 
@@ -206,6 +210,8 @@ lbox_stat_reset(struct lua_State *L)
 	(void)L;
 	box_reset_stat();
 	iproto_reset_stat();
+	cbus_reset_stat();
+	coio_reset_stat();
 	return 0;
 }
 
@@ -317,6 +323,108 @@ lbox_stat_net_thread_call(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Push a table of metrics of message passing between threads to
+ * a Lua stack:
+ *
+ * - EVENTS: wakeups of threads by incoming messages;
+ * - POLL_HITS: busy polls that caught a message;
+ * - POLL_MISSES: busy polls that timed out, so the thread slept.
+ */
+static int
+lbox_stat_cbus(struct lua_State *L)
+{
+	lua_newtable(L);
+	cbus_rmean_foreach(set_stat_item, L);
+	return 1;
+}
+
+/**
+ * Push a table of statistics of coio tasks of the tx thread by
+ * priority class to a Lua stack: the number of tasks waiting for
+ * a worker thread or running, the number of completed tasks and
+ * percentiles of their latency.
+ */
+static int
+lbox_stat_coio(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	info_begin(&h);
+	for (int i = 0; i < coio_class_MAX; i++) {
+		struct coio_stat stat;
+		coio_stat(i, &stat);
+		info_table_begin(&h, coio_class_strs[i]);
+		info_append_int(&h, "queue", stat.queue);
+		info_append_int(&h, "count", stat.count);
+		info_table_begin(&h, "latency");
+		info_append_double(&h, "p50", stat.latency_p50);
+		info_append_double(&h, "p90", stat.latency_p90);
+		info_append_double(&h, "p99", stat.latency_p99);
+		info_table_end(&h); /* latency */
+		info_table_end(&h); /* coio_class_strs[i] */
+	}
+	info_end(&h);
+	return 1;
+}
+
+/**
+ * Append the number of observations and the percentiles of a latency
+ * counter if there were any observations.
+ */
+static void
+stat_append_latency(struct info_handler *h, const char *key,
+		    struct latency *latency)
+{
+	if (latency == NULL || latency->histogram == NULL)
+		return;
+	size_t count = latency_count(latency);
+	if (count == 0)
+		return;
+	info_table_begin(h, key);
+	info_append_int(h, "count", count);
+	info_append_double(h, "p50", latency_get(latency, 50));
+	info_append_double(h, "p99", latency_get(latency, 99));
+	info_append_double(h, "p999", latency_get(latency, 99.9));
+	info_table_end(h); /* key */
+}
+
+static int
+stat_append_space_latency(struct space *space, void *arg)
+{
+	struct info_handler *h = arg;
+	if (space->latency == NULL)
+		return 0;
+	info_table_begin(h, space_name(space));
+	for (int i = 0; i < SPACE_LATENCY_TYPE_MAX; i++) {
+		stat_append_latency(h, iproto_type_name(i),
+				    &space->latency->type[i]);
+	}
+	info_table_end(h); /* space_name(space) */
+	return 0;
+}
+
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	info_begin(&h);
+	info_table_begin(&h, "requests");
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++) {
+		const char *name = iproto_type_name(i);
+		if (name == NULL)
+			continue;
+		stat_append_latency(&h, name, iproto_request_latency(i));
+	}
+	info_table_end(&h); /* requests */
+	info_table_begin(&h, "spaces");
+	space_foreach(stat_append_space_latency, &h);
+	info_table_end(&h); /* spaces */
+	info_end(&h);
+	return 1;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -367,6 +475,9 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"cbus", lbox_stat_cbus},
+		{"coio", lbox_stat_coio},
+		{"latency", lbox_stat_latency},
 		{NULL, NULL}
 	};
 
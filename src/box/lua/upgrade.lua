@@ -1503,6 +1503,33 @@ local function upgrade_to_3_3_0()
     create_gc_consumers()
 end
 
+--------------------------------------------------------------------------------
+-- Tarantool 3.5.0
+--------------------------------------------------------------------------------
+
+local function create_sql_stat()
+    local _space = box.space[box.schema.SPACE_ID]
+    local _index = box.space[box.schema.INDEX_ID]
+    local space_id = box.schema.SQL_STAT_ID
+    local opts = {group_id = 1}
+
+    log.info("create space _sql_stat")
+    local format = {{name = 'space_id', type = 'unsigned'},
+                    {name = 'index_id', type = 'unsigned'},
+                    {name = 'tuple_count', type = 'unsigned'},
+                    {name = 'distinct', type = 'array'},
+                    {name = 'bounds', type = 'array'}}
+    _space:insert{space_id, ADMIN, '_sql_stat', 'memtx', 0, opts, format}
+
+    log.info("create primary index for space _sql_stat")
+    _index:insert{space_id, 0, 'primary', 'tree', { unique = true },
+                  {{0, 'unsigned'}, {1, 'unsigned'}}}
+end
+
+local function upgrade_to_3_5_0()
+    create_sql_stat()
+end
+
 --------------------------------------------------------------------------------
 
 local handlers = {
@@ -1528,6 +1555,7 @@ local handlers = {
     {version = mkversion.new(3, 0, 0), func = upgrade_to_3_0_0},
     {version = mkversion.new(3, 1, 0), func = upgrade_to_3_1_0},
     {version = mkversion.new(3, 3, 0), func = upgrade_to_3_3_0},
+    {version = mkversion.new(3, 5, 0), func = upgrade_to_3_5_0},
 }
 builtin.box_init_latest_dd_version_id(
     box.internal.version_to_id(handlers[#handlers].version))
@@ -2106,6 +2134,32 @@ local function downgrade_from_3_3_0(issue_handler)
     drop_gc_consumers(issue_handler)
 end
 
+--------------------------------------------------------------------------------
+-- Tarantool 3.5.0
+--------------------------------------------------------------------------------
+
+local function drop_sql_stat(issue_handler)
+    -- Statistics are only a hint for the SQL query planner so they
+    -- can be dropped along with the space.
+    if issue_handler.dry_run then
+        return
+    end
+
+    local _space = box.space[box.schema.SPACE_ID]
+    local _index = box.space[box.schema.INDEX_ID]
+    local space_id = box.schema.SQL_STAT_ID
+
+    log.info("drop primary index of _sql_stat")
+    _index:delete{space_id, 0}
+
+    log.info("drop space _sql_stat")
+    _space:delete{space_id}
+end
+
+local function downgrade_from_3_5_0(issue_handler)
+    drop_sql_stat(issue_handler)
+end
+
 -- Versions should be ordered from newer to older.
 --
 -- Every step can be called in 2 modes. In dry_run mode (issue_handler.dry_run
@@ -2123,6 +2177,7 @@ end
 -- if schema version is 2.10.0.
 --
 local downgrade_handlers = {
+    {version = mkversion.new(3, 5, 0), func = downgrade_from_3_5_0},
     {version = mkversion.new(3, 3, 0), func = downgrade_from_3_3_0},
     {version = mkversion.new(3, 1, 0), func = downgrade_from_3_1_0},
     {version = mkversion.new(3, 0, 0), func = downgrade_from_3_0_0},
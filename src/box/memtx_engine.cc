@@ -65,6 +65,10 @@
 #include "assoc.h"
 #include "wal.h"
 #include "scoped_guard.h"
+#include "numa.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <type_traits>
 
@@ -1958,10 +1962,175 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple)
 	return rc;
 }
 
+const char *memtx_huge_pages_strs[] = {
+	/* [MEMTX_HUGE_PAGES_OFF]         = */ "off",
+	/* [MEMTX_HUGE_PAGES_TRANSPARENT] = */ "transparent",
+	/* [MEMTX_HUGE_PAGES_2M]          = */ "2M",
+	/* [MEMTX_HUGE_PAGES_1G]          = */ "1G",
+};
+
+static_assert(lengthof(memtx_huge_pages_strs) == memtx_huge_pages_MAX,
+	      "memtx_huge_pages_strs must be updated");
+
+/** Exclude a part of the arena from core dumps. */
+static void
+memtx_arena_dontdump(void *addr, size_t size)
+{
+#ifdef MADV_DONTDUMP
+	if (madvise(addr, size, MADV_DONTDUMP) != 0)
+		say_syserror("failed to exclude memtx arena from core dumps");
+#else
+	(void)addr;
+	(void)size;
+#endif
+}
+
+/**
+ * Remap the part of the arena aligned to the huge page size with
+ * explicit huge pages from the hugetlb pool. The arena isn't touched
+ * yet, so there is nothing to copy. Returns the size mapped with huge
+ * pages, 0 if they aren't available.
+ */
+static size_t
+memtx_arena_map_huge_pages(struct slab_arena *arena, size_t page_size,
+			   bool dontdump)
+{
+#ifdef MAP_HUGETLB
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+	uintptr_t begin = (uintptr_t)arena->arena;
+	uintptr_t start = (begin + page_size - 1) & ~(page_size - 1);
+	uintptr_t end = (begin + arena->prealloc) & ~(page_size - 1);
+	if (start >= end) {
+		say_warn("memtx arena is too small to use %zu byte huge pages",
+			 page_size);
+		return 0;
+	}
+	size_t size = end - start;
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+	int huge_flags = MAP_HUGETLB |
+			 (__builtin_ctzll(page_size) << MAP_HUGE_SHIFT);
+	say_info("mapping %zu bytes of memtx arena with %zu byte huge pages",
+		 size, page_size);
+	if (mmap((void *)start, size, PROT_READ | PROT_WRITE,
+		 flags | huge_flags, -1, 0) == MAP_FAILED) {
+		say_syserror("failed to map memtx arena with huge pages, "
+			     "falling back to regular pages");
+		/* A failed fixed mapping may have unmapped the range. */
+		if (mmap((void *)start, size, PROT_READ | PROT_WRITE,
+			 flags, -1, 0) == MAP_FAILED)
+			panic_syserror("failed to restore memtx arena mapping");
+		if (dontdump)
+			memtx_arena_dontdump((void *)start, size);
+		return 0;
+	}
+	if (dontdump)
+		memtx_arena_dontdump((void *)start, size);
+	return size;
+#else /* !defined(MAP_HUGETLB) */
+	(void)arena;
+	(void)page_size;
+	(void)dontdump;
+	say_warn("explicit huge pages are not supported on this system");
+	return 0;
+#endif /* !defined(MAP_HUGETLB) */
+}
+
+/** Ask the kernel to back the arena with transparent huge pages. */
+static bool
+memtx_arena_advise_huge_pages(struct slab_arena *arena)
+{
+#ifdef MADV_HUGEPAGE
+	if (madvise(arena->arena, arena->prealloc, MADV_HUGEPAGE) == 0)
+		return true;
+	say_syserror("failed to enable transparent huge pages for memtx "
+		     "arena");
+#else
+	(void)arena;
+	say_warn("transparent huge pages are not supported on this system");
+#endif
+	return false;
+}
+
+/** Fault in all pages of the arena. */
+static void
+memtx_arena_prefault(struct slab_arena *arena)
+{
+	say_info("prefaulting %zu bytes of memtx arena...", arena->prealloc);
+	char *begin = (char *)arena->arena;
+	char *end = begin + arena->prealloc;
+#ifdef MADV_POPULATE_WRITE
+	/* Faults in the pages in one call, available since Linux 5.14. */
+	if (madvise(begin, end - begin, MADV_POPULATE_WRITE) == 0)
+		return;
+#endif
+	long page_size = sysconf(_SC_PAGESIZE);
+	for (char *p = begin; p < end; p += page_size)
+		*(volatile char *)p = 0;
+}
+
+/**
+ * Set up the pages of the preallocated arena before it's used:
+ * huge pages, the NUMA policy, locking in memory and prefaulting.
+ * Slabs mapped beyond the preallocated size on a quota increase are
+ * not affected. Failures are logged, the arena stays usable anyway.
+ */
+static void
+memtx_engine_setup_arena(struct memtx_engine *memtx,
+			 enum memtx_huge_pages huge_pages, bool dontdump,
+			 bool mlock, bool prefault)
+{
+	struct slab_arena *arena = &memtx->arena;
+	memtx->arena_huge_pages = huge_pages;
+	memtx->arena_mlock = mlock;
+	switch (huge_pages) {
+	case MEMTX_HUGE_PAGES_OFF:
+		break;
+	case MEMTX_HUGE_PAGES_TRANSPARENT:
+		memtx->arena_huge_fallback =
+			!memtx_arena_advise_huge_pages(arena);
+		break;
+	case MEMTX_HUGE_PAGES_2M:
+		memtx->arena_huge_size = memtx_arena_map_huge_pages(
+			arena, (size_t)2 << 20, dontdump);
+		memtx->arena_huge_fallback = memtx->arena_huge_size == 0;
+		break;
+	case MEMTX_HUGE_PAGES_1G:
+		memtx->arena_huge_size = memtx_arena_map_huge_pages(
+			arena, (size_t)1 << 30, dontdump);
+		memtx->arena_huge_fallback = memtx->arena_huge_size == 0;
+		break;
+	default:
+		unreachable();
+	}
+	/*
+	 * The policy must be set before the pages are touched. It isn't
+	 * set for the slabs mapped beyond the preallocated size, they
+	 * follow the policy of the tx thread.
+	 */
+	if (numa_bind_memory(arena->arena, arena->prealloc) != 0) {
+		say_warn("failed to set NUMA policy of the memtx arena: %s",
+			 diag_last_error(diag_get())->errmsg);
+	}
+	if (mlock) {
+		say_info("locking %zu bytes of memtx arena in memory...",
+			 arena->prealloc);
+		if (::mlock(arena->arena, arena->prealloc) == 0)
+			memtx->arena_locked_size = arena->prealloc;
+		else
+			say_syserror("failed to lock memtx arena in memory");
+	}
+	/* Locking in memory faults in the pages as well. */
+	if (prefault && memtx->arena_locked_size == 0)
+		memtx_arena_prefault(arena);
+}
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, enum memtx_huge_pages huge_pages,
+		 bool mlock, bool prefault, unsigned granularity,
 		 const char *allocator, float alloc_factor, int sort_threads,
 		 memtx_on_indexes_built_cb on_indexes_built)
 {
@@ -2068,6 +2237,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx_engine_setup_arena(memtx, huge_pages, dontdump, mlock, prefault);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	float actual_alloc_factor;
 	allocator_settings alloc_settings;
@@ -91,6 +91,22 @@ enum memtx_recovery_state {
 	MEMTX_OK,
 };
 
+/** Kind of pages backing the memtx arena, box.cfg.memtx_huge_pages. */
+enum memtx_huge_pages {
+	/** Regular pages. */
+	MEMTX_HUGE_PAGES_OFF,
+	/** Transparent huge pages, allocated by the kernel if possible. */
+	MEMTX_HUGE_PAGES_TRANSPARENT,
+	/** Explicit 2 MB huge pages from the hugetlb pool. */
+	MEMTX_HUGE_PAGES_2M,
+	/** Explicit 1 GB huge pages from the hugetlb pool. */
+	MEMTX_HUGE_PAGES_1G,
+	memtx_huge_pages_MAX,
+};
+
+/** Values of box.cfg.memtx_huge_pages. */
+extern const char *memtx_huge_pages_strs[];
+
 /**
  * The size of the biggest memtx iterator. Used with
  * mempool_create. This is the size of the block that will be
@@ -130,6 +146,16 @@ struct memtx_engine {
 	 * is reflected in box.slab.info(), @sa lua/slab.c.
 	 */
 	struct slab_arena arena;
+	/** Kind of pages requested for the arena. */
+	enum memtx_huge_pages arena_huge_pages;
+	/** Size of the part of the arena mapped with explicit huge pages. */
+	size_t arena_huge_size;
+	/** Set if the requested huge pages couldn't be used. */
+	bool arena_huge_fallback;
+	/** Set if the arena was requested to be locked in memory. */
+	bool arena_mlock;
+	/** Size of the arena locked in memory. */
+	size_t arena_locked_size;
 	/** Slab cache for allocating tuples. */
 	struct slab_cache slab_cache;
 	/** Slab cache for allocating index extents. */
@@ -212,7 +238,8 @@ memtx_engine_schedule_gc(struct memtx_engine *memtx,
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, enum memtx_huge_pages huge_pages,
+		 bool mlock, bool prefault, unsigned granularity,
 		 const char *allocator, float alloc_factor, int threads_num,
 		 memtx_on_indexes_built_cb on_indexes_built);
 
@@ -359,7 +386,8 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple);
 static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		    bool dontdump, unsigned granularity,
+		    bool dontdump, enum memtx_huge_pages huge_pages,
+		    bool mlock, bool prefault, unsigned granularity,
 		    const char *allocator, float alloc_factor,
 		    int sort_threads,
 		    memtx_on_indexes_built_cb on_indexes_built)
@@ -367,6 +395,7 @@ memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size, objsize_min, dontdump,
+				 huge_pages, mlock, prefault,
 				 granularity, allocator, alloc_factor,
 				 sort_threads, on_indexes_built);
 	if (memtx == NULL)
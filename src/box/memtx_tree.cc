@@ -2430,16 +2430,19 @@ tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
 	assert(key == NULL);
 	assert(part_count == 0);
 	assert(pos == NULL);
-	assert(offset == 0);
 	(void)type;
 	(void)key;
 	(void)part_count;
 	(void)pos;
-	(void)offset;
 	struct tree_read_view<USE_HINT> *rv =
 		(struct tree_read_view<USE_HINT> *)it->base.index;
 	it->base.next_raw = tree_read_view_iterator_next_raw<USE_HINT>;
-	it->tree_iterator = memtx_tree_view_first(&rv->tree_view);
+	/* The offset is skipped in logarithmic time. */
+	if (offset == 0)
+		it->tree_iterator = memtx_tree_view_first(&rv->tree_view);
+	else
+		it->tree_iterator = memtx_tree_view_iterator_at(&rv->tree_view,
+								offset);
 	return 0;
 }
 
@@ -133,6 +133,8 @@ static_assert(BOX_INVALID_NAME_MAX <= BOX_NAME_MAX,
 	_(SESSION_SETTINGS, 380, true) \
 	/** Space id of _gc_consumers. */ \
 	_(GC_CONSUMERS, 388, false) \
+	/** Space id of _sql_stat. Local space. */ \
+	_(SQL_STAT, 396, false) \
 
 /** System space identifier definition. */
 #define SYSTEM_SPACE_MEMBER(name, id, ...) BOX_ ## name ## _ID = id,
@@ -243,6 +245,15 @@ enum {
 	BOX_GC_CONSUMERS_FIELD_OPTS = 2,
 };
 
+/** _sql_stat fields. */
+enum {
+	BOX_SQL_STAT_FIELD_SPACE_ID = 0,
+	BOX_SQL_STAT_FIELD_INDEX_ID = 1,
+	BOX_SQL_STAT_FIELD_TUPLE_COUNT = 2,
+	BOX_SQL_STAT_FIELD_DISTINCT = 3,
+	BOX_SQL_STAT_FIELD_BOUNDS = 4,
+};
+
 /** _cluster fields. */
 enum {
 	BOX_CLUSTER_FIELD_ID = 0,
@@ -45,7 +45,10 @@ const char *session_setting_strs[SESSION_SETTING_COUNT] = {
 	"sql_default_engine",
 	"sql_full_column_names",
 	"sql_full_metadata",
+	"sql_parallel_scan",
 	"sql_parser_debug",
+	"sql_plan_cache",
+	"sql_profile",
 	"sql_recursive_triggers",
 	"sql_reverse_unordered_selects",
 	"sql_select_debug",
@@ -46,7 +46,10 @@ enum {
 	SESSION_SETTING_SQL_DEFAULT_ENGINE = SESSION_SETTING_SQL_BEGIN,
 	SESSION_SETTING_SQL_FULL_COLUMN_NAMES,
 	SESSION_SETTING_SQL_FULL_METADATA,
+	SESSION_SETTING_SQL_PARALLEL_SCAN,
 	SESSION_SETTING_SQL_PARSER_DEBUG,
+	SESSION_SETTING_SQL_PLAN_CACHE,
+	SESSION_SETTING_SQL_PROFILE,
 	SESSION_SETTING_SQL_RECURSIVE_TRIGGERS,
 	SESSION_SETTING_SQL_REVERSE_UNORDERED_SELECTS,
 	SESSION_SETTING_SQL_SELECT_DEBUG,
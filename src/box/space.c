@@ -160,6 +160,51 @@ space_fill_index_map(struct space *space)
 	}
 }
 
+void
+space_latency_collect(uint32_t space_id, uint16_t type, double value)
+{
+	if (type >= SPACE_LATENCY_TYPE_MAX)
+		return;
+	struct space *space = space_by_id(space_id);
+	if (space == NULL)
+		return;
+	if (space->latency == NULL) {
+		space->latency = calloc(1, sizeof(*space->latency));
+		if (space->latency == NULL)
+			return;
+	}
+	struct latency *latency = &space->latency->type[type];
+	if (latency->histogram == NULL && latency_create(latency) != 0)
+		return;
+	latency_collect(latency, value);
+}
+
+void
+space_latency_reset(struct space *space)
+{
+	if (space->latency == NULL)
+		return;
+	for (int i = 0; i < SPACE_LATENCY_TYPE_MAX; i++) {
+		struct latency *latency = &space->latency->type[i];
+		if (latency->histogram != NULL)
+			latency_reset(latency);
+	}
+}
+
+/** Free the latency statistics of a space. */
+static void
+space_latency_delete(struct space *space)
+{
+	if (space->latency == NULL)
+		return;
+	for (int i = 0; i < SPACE_LATENCY_TYPE_MAX; i++) {
+		struct latency *latency = &space->latency->type[i];
+		if (latency->histogram != NULL)
+			latency_destroy(latency);
+	}
+	free(space->latency);
+}
+
 bool
 space_is_system(const struct space *space)
 {
@@ -752,6 +797,7 @@ space_delete(struct space *space)
 	if (space->upgrade != NULL)
 		space_upgrade_delete(space->upgrade);
 	free(space->sequence_path);
+	space_latency_delete(space);
 	space_def_delete(space->def);
 	assert(rlist_empty(&space->space_cache_pin_list));
 	/* tarantool_L is freed on Tarantool shutdown. */
@@ -42,6 +42,7 @@
 #include "core/event.h"
 #include "txn_event_trigger.h"
 #include "arrow/abi.h"
+#include "latency.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -56,6 +57,24 @@ struct port;
 struct tuple;
 struct tuple_format;
 struct space_upgrade;
+
+enum {
+	/**
+	 * Request types whose latency is accounted per space are
+	 * IPROTO_SELECT to IPROTO_UPSERT. Other types, e.g.
+	 * IPROTO_INSERT_ARROW, are not accounted.
+	 */
+	SPACE_LATENCY_TYPE_MAX = IPROTO_UPSERT + 1,
+};
+
+/** Latency of requests to a space. */
+struct space_latency {
+	/**
+	 * Latency by request type. A histogram is created on the
+	 * first request of the type.
+	 */
+	struct latency type[SPACE_LATENCY_TYPE_MAX];
+};
 struct space_wal_ext;
 
 struct space_vtab {
@@ -203,6 +222,13 @@ struct space {
 	struct space_event txn_events[txn_event_id_MAX];
 	/** SQL Trigger list. */
 	struct sql_trigger *sql_triggers;
+	/**
+	 * Value of space_cache_version at the moment the space was
+	 * put into the space cache or its SQL triggers were changed.
+	 * Used to check if SQL statements compiled for the space
+	 * are still valid.
+	 */
+	uint32_t cache_version;
 	/**
 	 * The number of *enabled* indexes in the space.
 	 *
@@ -225,6 +251,11 @@ struct space {
 	uint32_t sequence_fieldno;
 	/** Path to data in the auto-increment field. */
 	char *sequence_path;
+	/**
+	 * Latency of requests to the space or NULL if there were
+	 * no requests yet. Moved to the new space on alter.
+	 */
+	struct space_latency *latency;
 	/** Enable/disable triggers. */
 	bool run_triggers;
 	/**
@@ -754,6 +785,20 @@ space_dump_def(const struct space *space, struct rlist *key_list);
 void
 space_fill_index_map(struct space *space);
 
+/**
+ * Account a request of the given type to the space with the given
+ * id that took @a value seconds. The space is looked up by id,
+ * because it may have been altered or dropped while the request
+ * was yielding. Types not less than SPACE_LATENCY_TYPE_MAX are
+ * ignored.
+ */
+void
+space_latency_collect(uint32_t space_id, uint16_t type, double value);
+
+/** Reset the latency statistics of a space. */
+void
+space_latency_reset(struct space *space);
+
 /** Add info about space to the error. */
 static inline void
 error_set_space(struct error *error, struct space_def *def)
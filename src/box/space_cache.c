@@ -197,6 +197,8 @@ space_cache_replace(struct space *old_space, struct space *new_space)
 		mh_strnptr_del(spaces_by_name, k, NULL);
 	}
 	space_cache_version++;
+	if (new_space != NULL)
+		new_space->cache_version = space_cache_version;
 
 	if (trigger_run(&on_alter_space, new_space != NULL ?
 					 new_space : old_space) != 0) {
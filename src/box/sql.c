@@ -1382,9 +1382,287 @@ index_field_tuple_est(const struct index_def *idx_def, uint32_t field)
 	if (field == idx_def->key_def->part_count &&
 	    idx_def->opts.is_unique)
 		return 0;
+	struct sql_index_stat stat;
+	if (sql_index_stat_get(idx_def, &stat)) {
+		if (field == 0)
+			return sqlLogEst(stat.tuple_count);
+		if (stat.distinct_count == idx_def->key_def->part_count) {
+			const char *pos = stat.distinct;
+			for (uint32_t i = 1; i < field; i++)
+				mp_next(&pos);
+			uint64_t distinct = mp_decode_uint(&pos);
+			if (distinct > 0)
+				return sqlLogEst(MAX(stat.tuple_count /
+						     distinct, 1));
+		}
+	}
 	return default_tuple_est[field + 1 >= 6 ? 6 : field];
 }
 
+enum {
+	/** Number of buckets of an equi-depth histogram. */
+	SQL_STAT_BUCKET_COUNT = 32,
+	/**
+	 * Max number of tuples read to count distinct keys. Larger
+	 * indexes are sampled starting from histogram bounds.
+	 */
+	SQL_STAT_SAMPLE_SIZE = 64 * 1024,
+};
+
+bool
+sql_index_stat_get(const struct index_def *idx, struct sql_index_stat *stat)
+{
+	struct space *space = space_by_id(BOX_SQL_STAT_ID);
+	if (space == NULL)
+		return false;
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL || pk->def->key_def->part_count != 2)
+		return false;
+	char key[2 * 9];
+	char *key_end = mp_encode_uint(key, idx->space_id);
+	key_end = mp_encode_uint(key_end, idx->iid);
+	assert(key_end <= key + sizeof(key));
+	struct tuple *tuple;
+	if (index_get_internal(pk, key, 2, &tuple) != 0) {
+		diag_clear(diag_get());
+		return false;
+	}
+	if (tuple == NULL)
+		return false;
+	const char *count = tuple_field(tuple, BOX_SQL_STAT_FIELD_TUPLE_COUNT);
+	const char *distinct = tuple_field(tuple, BOX_SQL_STAT_FIELD_DISTINCT);
+	const char *bounds = tuple_field(tuple, BOX_SQL_STAT_FIELD_BOUNDS);
+	if (count == NULL || mp_typeof(*count) != MP_UINT ||
+	    distinct == NULL || mp_typeof(*distinct) != MP_ARRAY ||
+	    bounds == NULL || mp_typeof(*bounds) != MP_ARRAY)
+		return false;
+	stat->tuple_count = mp_decode_uint(&count);
+	stat->distinct_count = mp_decode_array(&distinct);
+	stat->distinct = distinct;
+	for (uint32_t i = 0; i < stat->distinct_count; i++) {
+		if (mp_typeof(*distinct) != MP_UINT)
+			return false;
+		mp_next(&distinct);
+	}
+	stat->bound_count = mp_decode_array(&bounds);
+	stat->bounds = bounds;
+	for (uint32_t i = 0; i < stat->bound_count; i++) {
+		if (mp_typeof(*bounds) != MP_ARRAY)
+			return false;
+		mp_next(&bounds);
+	}
+	return true;
+}
+
+int
+sql_index_stat_pos(const struct sql_index_stat *stat,
+		   const struct coll *coll, const struct Mem *value,
+		   double *pos)
+{
+	uint32_t less = 0;
+	const char *bound = stat->bounds;
+	for (uint32_t i = 0; i < stat->bound_count; i++) {
+		const char *key = bound;
+		mp_next(&bound);
+		if (mp_decode_array(&key) == 0)
+			continue;
+		int cmp;
+		if (mem_cmp_msgpack(value, &key, &cmp, coll) != 0)
+			return -1;
+		if (cmp > 0)
+			less++;
+	}
+	/* Assume the value is in the middle of its bucket. */
+	*pos = (less + 0.5) / (stat->bound_count + 1);
+	return 0;
+}
+
+/** Return the number of leading key parts equal in two tuples. */
+static uint32_t
+sql_stat_common_parts(struct tuple *a, struct tuple *b,
+		      struct key_def *key_def)
+{
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		struct key_part *part = &key_def->parts[i];
+		const char *field_a = tuple_field_by_part(a, part,
+							  MULTIKEY_NONE);
+		const char *field_b = tuple_field_by_part(b, part,
+							  MULTIKEY_NONE);
+		bool a_is_null = field_a == NULL ||
+				 mp_typeof(*field_a) == MP_NIL;
+		bool b_is_null = field_b == NULL ||
+				 mp_typeof(*field_b) == MP_NIL;
+		if (a_is_null || b_is_null) {
+			if (a_is_null && b_is_null)
+				continue;
+			return i;
+		}
+		if (tuple_compare_field(field_a, field_b, part->type,
+					part->coll) != 0)
+			return i;
+	}
+	return key_def->part_count;
+}
+
+/**
+ * Read up to @a limit tuples of an index starting from @a key and
+ * count distinct key prefixes among them: values[i] is incremented
+ * for each new value of the first i + 1 key parts.
+ */
+static int
+sql_stat_sample(uint32_t space_id, uint32_t index_id,
+		struct key_def *key_def, const char *key, const char *key_end,
+		uint64_t limit, uint64_t *rows, uint64_t *values)
+{
+	box_iterator_t *it = box_index_iterator(space_id, index_id, ITER_GE,
+						key, key_end);
+	if (it == NULL)
+		return -1;
+	int rc = 0;
+	struct tuple *prev = NULL;
+	for (uint64_t i = 0; i < limit; i++) {
+		struct tuple *tuple;
+		if (box_iterator_next(it, &tuple) != 0) {
+			rc = -1;
+			break;
+		}
+		if (tuple == NULL)
+			break;
+		uint32_t common = prev == NULL ? 0 :
+				  sql_stat_common_parts(prev, tuple, key_def);
+		for (uint32_t j = common; j < key_def->part_count; j++)
+			values[j]++;
+		(*rows)++;
+		tuple_ref(tuple);
+		if (prev != NULL)
+			tuple_unref(prev);
+		prev = tuple;
+	}
+	if (prev != NULL)
+		tuple_unref(prev);
+	box_iterator_free(it);
+	return rc;
+}
+
+int
+sql_index_analyze(uint32_t space_id, uint32_t index_id,
+		  const char **data, const char **data_end)
+{
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	struct index *index = index_find(space, index_id);
+	if (index == NULL)
+		return -1;
+	ssize_t size = index_size(index);
+	if (size < 0)
+		return -1;
+	uint64_t tuple_count = size;
+	struct key_def *key_def = index->def->key_def;
+	bool is_ordered = index->def->type == TREE &&
+			  !key_def->is_multikey && !key_def->for_func_index;
+	uint32_t part_count = key_def->part_count;
+	struct region *region = &fiber()->gc;
+	uint64_t *values = xregion_alloc_array(region, typeof(*values),
+					       part_count);
+	memset(values, 0, part_count * sizeof(*values));
+	const char **bounds = xregion_alloc_array(region, typeof(*bounds),
+						  SQL_STAT_BUCKET_COUNT);
+	uint32_t bound_count = 0;
+	const char empty_key[] = {(char)0x90};
+	const char *empty_key_end = empty_key + sizeof(empty_key);
+	uint64_t rows = 0;
+	if (is_ordered && tuple_count > 0) {
+		/* Equi-depth histogram. */
+		for (int i = 1; i < SQL_STAT_BUCKET_COUNT; i++) {
+			const char *bound, *bound_end;
+			double level = (double)i / SQL_STAT_BUCKET_COUNT;
+			if (box_index_quantile(space_id, index_id, level,
+					       empty_key, empty_key_end,
+					       empty_key, empty_key_end,
+					       &bound, &bound_end) != 0)
+				return -1;
+			if (bound != NULL)
+				bounds[bound_count++] = bound;
+		}
+		/*
+		 * Count distinct keys. Large indexes are sampled in
+		 * chunks starting from the beginning of each bucket
+		 * and the number of distinct keys is extrapolated
+		 * assuming that the average number of tuples per key
+		 * is the same as in the sample.
+		 */
+		uint64_t limit = SQL_STAT_SAMPLE_SIZE;
+		if (tuple_count > SQL_STAT_SAMPLE_SIZE && bound_count > 0)
+			limit /= bound_count + 1;
+		if (sql_stat_sample(space_id, index_id, key_def, empty_key,
+				    empty_key_end, limit, &rows, values) != 0)
+			return -1;
+		for (uint32_t i = 0; limit < SQL_STAT_SAMPLE_SIZE &&
+				     i < bound_count; i++) {
+			const char *bound_end = bounds[i];
+			mp_next(&bound_end);
+			if (sql_stat_sample(space_id, index_id, key_def,
+					    bounds[i], bound_end, limit,
+					    &rows, values) != 0)
+				return -1;
+		}
+	}
+	uint32_t distinct_count = rows > 0 ? part_count : 0;
+	for (uint32_t i = 0; i < distinct_count; i++) {
+		values[i] = MAX((double)tuple_count * values[i] / rows, 1);
+		values[i] = MIN(values[i], tuple_count);
+	}
+	if (distinct_count > 0 && index->def->opts.is_unique &&
+	    !key_def->is_nullable)
+		values[part_count - 1] = tuple_count;
+
+	size_t data_size = mp_sizeof_array(3) + mp_sizeof_uint(tuple_count) +
+			   mp_sizeof_array(distinct_count) +
+			   mp_sizeof_array(bound_count);
+	for (uint32_t i = 0; i < distinct_count; i++)
+		data_size += mp_sizeof_uint(values[i]);
+	for (uint32_t i = 0; i < bound_count; i++) {
+		const char *bound_end = bounds[i];
+		mp_next(&bound_end);
+		data_size += bound_end - bounds[i];
+	}
+	char *buf = xregion_alloc(region, data_size);
+	char *pos = mp_encode_array(buf, 3);
+	pos = mp_encode_uint(pos, tuple_count);
+	pos = mp_encode_array(pos, distinct_count);
+	for (uint32_t i = 0; i < distinct_count; i++)
+		pos = mp_encode_uint(pos, values[i]);
+	pos = mp_encode_array(pos, bound_count);
+	for (uint32_t i = 0; i < bound_count; i++) {
+		const char *bound_end = bounds[i];
+		mp_next(&bound_end);
+		memcpy(pos, bounds[i], bound_end - bounds[i]);
+		pos += bound_end - bounds[i];
+	}
+	assert(pos == buf + data_size);
+	*data = buf;
+	*data_end = pos;
+	return 0;
+}
+
+int
+sql_index_stat_erase(uint32_t space_id, uint32_t index_id)
+{
+	if (space_id == BOX_SQL_STAT_ID)
+		return 0;
+	struct space *space = space_by_id(BOX_SQL_STAT_ID);
+	if (space == NULL || space_index(space, 0) == NULL)
+		return 0;
+	/* The index owner may have no access to the system space. */
+	struct credentials *orig_credentials = effective_user();
+	fiber_set_user(fiber(), &admin_credentials);
+	int rc = boxk(IPROTO_DELETE, BOX_SQL_STAT_ID, "[%u%u]",
+		      (unsigned)space_id, (unsigned)index_id);
+	fiber_set_user(fiber(), orig_credentials);
+	return rc;
+}
+
 /** Drop tuple or field constraint. */
 static int
 sql_constraint_drop(uint32_t space_id, const char *name, const char *prefix)
@@ -415,6 +415,38 @@ func_sql_expr_check_fields(const struct func *base,
 uint32_t
 sql_default_session_flags(void);
 
+/**
+ * Collect statistics of an index used by the SQL query planner.
+ * The result is encoded in MsgPack as [tuple_count, [distinct...],
+ * [bound...]], see struct sql_index_stat, and allocated on the
+ * fiber region. Distinct counts and histogram bounds are only
+ * collected for TREE indexes that are neither multikey nor
+ * functional.
+ *
+ * @param space_id Space identifier.
+ * @param index_id Index identifier.
+ * @param[out] data Encoded statistics.
+ * @param[out] data_end End of @a data.
+ * @retval 0 Success.
+ * @retval -1 Error, check diag.
+ */
+int
+sql_index_analyze(uint32_t space_id, uint32_t index_id,
+		  const char **data, const char **data_end);
+
+/**
+ * Delete statistics of an index from the _sql_stat space. Called
+ * when the index is dropped. Does nothing if the space does not
+ * exist yet, i.e. the schema has not been upgraded.
+ *
+ * @param space_id Space identifier.
+ * @param index_id Index identifier.
+ * @retval 0 Success.
+ * @retval -1 Error, check diag.
+ */
+int
+sql_index_stat_erase(uint32_t space_id, uint32_t index_id);
+
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
 /**
  * Entrypoint for fuzzing SQL engine.
@@ -3560,8 +3560,14 @@ static struct sql_option_metadata sql_session_opts[] = {
 	{FIELD_TYPE_BOOLEAN, SQL_FullColNames},
 	/** SESSION_SETTING_SQL_FULL_METADATA */
 	{FIELD_TYPE_BOOLEAN, SQL_FullMetadata},
+	/** SESSION_SETTING_SQL_PARALLEL_SCAN */
+	{FIELD_TYPE_BOOLEAN, SQL_ParallelScan},
 	/** SESSION_SETTING_SQL_PARSER_DEBUG */
 	{FIELD_TYPE_BOOLEAN, SQL_SqlTrace | PARSER_TRACE_FLAG},
+	/** SESSION_SETTING_SQL_PLAN_CACHE */
+	{FIELD_TYPE_BOOLEAN, SQL_PlanCache},
+	/** SESSION_SETTING_SQL_PROFILE */
+	{FIELD_TYPE_BOOLEAN, SQL_Profile},
 	/** SESSION_SETTING_SQL_RECURSIVE_TRIGGERS */
 	{FIELD_TYPE_BOOLEAN, SQL_RecTriggers},
 	/** SESSION_SETTING_SQL_REVERSE_UNORDERED_SELECTS */
@@ -34,6 +34,25 @@
 #include "sqlInt.h"
 #include "tarantoolInt.h"
 
+/**
+ * Remember that the statement being compiled refers to the space
+ * so that it is recompiled if the space is altered.
+ */
+static void
+sql_parse_add_space_dep(struct Parse *parse, uint32_t space_id)
+{
+	struct Parse *toplevel = sqlParseToplevel(parse);
+	for (uint32_t i = 0; i < toplevel->space_dep_count; i++) {
+		if (toplevel->space_deps[i] == space_id)
+			return;
+	}
+	uint32_t count = ++toplevel->space_dep_count;
+	toplevel->space_deps =
+		sql_xrealloc(toplevel->space_deps,
+			     count * sizeof(*toplevel->space_deps));
+	toplevel->space_deps[count - 1] = space_id;
+}
+
 struct space *
 sql_lookup_space(struct Parse *parse, struct SrcList_item *space_name)
 {
@@ -57,6 +76,7 @@ sql_lookup_space(struct Parse *parse, struct SrcList_item *space_name)
 		return NULL;
 	}
 	struct space *res = space_by_id(space->def->id);
+	sql_parse_add_space_dep(parse, space->def->id);
 	space_name->space = res;
 	if (sqlIndexedByLookup(parse, space_name) != 0)
 		space = NULL;
@@ -117,6 +117,7 @@ ecmd ::= SEMI. {
 explain ::= .
 explain ::= EXPLAIN.              { pParse->explain = 1; }
 explain ::= EXPLAIN QUERY PLAN.   { pParse->explain = 2; }
+explain ::= EXPLAIN ANALYZE.      { pParse->explain = 3; }
 cmdx ::= cmd.
 
 // Define operator precedence early so that this is the first occurrence
@@ -427,6 +428,7 @@ cmd ::= select(X).  {
     pParse->is_aborted = true;
     return;
   }
+  pParse->has_space_deps = true;
   sqlSelect(pParse, X, &dest);
   sql_select_delete(X);
 }
@@ -802,6 +804,7 @@ cmd ::= with(C) DELETE FROM fullname(X) indexed_opt(I) where_opt(W). {
   sqlSubProgramsRemaining = SQL_MAX_COMPILING_TRIGGERS;
   /* Instruct SQL to initate Tarantool's transaction.  */
   pParse->initiateTTrans = true;
+  pParse->has_space_deps = true;
   sql_table_delete_from(pParse,X,W);
 }
 
@@ -832,6 +835,7 @@ cmd ::= with(C) UPDATE orconf(R) fullname(X) indexed_opt(I) SET setlist(Y)
   sqlSubProgramsRemaining = SQL_MAX_COMPILING_TRIGGERS;
   /* Instruct SQL to initate Tarantool's transaction.  */
   pParse->initiateTTrans = true;
+  pParse->has_space_deps = true;
   sqlUpdate(pParse,X,Y,W,R);
 }
 
@@ -860,6 +864,7 @@ cmd ::= with(W) insert_cmd(R) INTO fullname(X) idlist_opt(F) select(S). {
   sqlSubProgramsRemaining = SQL_MAX_COMPILING_TRIGGERS;
   /* Instruct SQL to initate Tarantool's transaction.  */
   pParse->initiateTTrans = true;
+  pParse->has_space_deps = true;
   sqlInsert(pParse, X, S, F, R);
 }
 cmd ::= with(W) insert_cmd(R) INTO fullname(X) idlist_opt(F) DEFAULT VALUES.
@@ -868,6 +873,7 @@ cmd ::= with(W) insert_cmd(R) INTO fullname(X) idlist_opt(F) DEFAULT VALUES.
   sqlSubProgramsRemaining = SQL_MAX_COMPILING_TRIGGERS;
   /* Instruct SQL to initate Tarantool's transaction.  */
   pParse->initiateTTrans = true;
+  pParse->has_space_deps = true;
   sqlInsert(pParse, X, 0, F, R);
 }
 
@@ -10,6 +10,10 @@
 #include "box/lua/execute.h"
 #include "box/sql_stmt_cache.h"
 #include "box/iproto_constants.h"
+#include "box/tuple.h"
+#include "arrow_ipc.h"
+#include "mp_extension_types.h"
+#include "nanoarrow/nanoarrow.h"
 
 /** The size of the metadata encoded in msgpack format. */
 static inline size_t
@@ -206,6 +210,200 @@ sql_get_prepare_common_keys(struct Vdbe *stmt, struct obuf *out, int keys)
 	return 0;
 }
 
+/** Arrow type of values of a result column of the given type. */
+static enum ArrowType
+sql_column_arrow_type(enum field_type type)
+{
+	switch (type) {
+	case FIELD_TYPE_INTEGER:
+		return NANOARROW_TYPE_INT64;
+	case FIELD_TYPE_UNSIGNED:
+		return NANOARROW_TYPE_UINT64;
+	case FIELD_TYPE_DOUBLE:
+		return NANOARROW_TYPE_DOUBLE;
+	case FIELD_TYPE_BOOLEAN:
+		return NANOARROW_TYPE_BOOL;
+	case FIELD_TYPE_STRING:
+		return NANOARROW_TYPE_STRING;
+	case FIELD_TYPE_VARBINARY:
+		return NANOARROW_TYPE_BINARY;
+	default:
+		return NANOARROW_TYPE_UNINITIALIZED;
+	}
+}
+
+/**
+ * Create a struct schema with a child per result column of the
+ * statement.
+ *
+ * @retval  0 Success.
+ * @retval -1 Column of a type not representable in Arrow or memory
+ *            error.
+ */
+static int
+sql_get_arrow_schema(struct Vdbe *stmt, struct ArrowSchema *schema)
+{
+	int column_count = sql_column_count(stmt);
+	ArrowSchemaInit(schema);
+	if (ArrowSchemaSetTypeStruct(schema, column_count) != NANOARROW_OK)
+		goto error;
+	for (int i = 0; i < column_count; i++) {
+		const char *type = sql_column_datatype(stmt, i);
+		enum ArrowType arrow_type = sql_column_arrow_type(
+			field_type_by_name(type, strlen(type)));
+		if (arrow_type == NANOARROW_TYPE_UNINITIALIZED) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Arrow format",
+				 tt_sprintf("column type '%s'", type));
+			schema->release(schema);
+			return -1;
+		}
+		struct ArrowSchema *child = schema->children[i];
+		if (ArrowSchemaSetType(child, arrow_type) != NANOARROW_OK ||
+		    ArrowSchemaSetName(child, sql_column_name(stmt, i)) !=
+		    NANOARROW_OK)
+			goto error;
+	}
+	return 0;
+error:
+	diag_set(OutOfMemory, 0, "ArrowSchemaSetType", "schema");
+	schema->release(schema);
+	return -1;
+}
+
+/**
+ * Append a MsgPack value to the column array. The value must be
+ * of the MsgPack type matching the type of the column or NIL.
+ */
+static ArrowErrorCode
+sql_append_arrow_value(struct ArrowArray *column, const char **data)
+{
+	switch (mp_typeof(**data)) {
+	case MP_NIL:
+		mp_decode_nil(data);
+		return ArrowArrayAppendNull(column, 1);
+	case MP_INT:
+		return ArrowArrayAppendInt(column, mp_decode_int(data));
+	case MP_UINT:
+		return ArrowArrayAppendUInt(column, mp_decode_uint(data));
+	case MP_FLOAT:
+		return ArrowArrayAppendDouble(column, mp_decode_float(data));
+	case MP_DOUBLE:
+		return ArrowArrayAppendDouble(column, mp_decode_double(data));
+	case MP_BOOL:
+		return ArrowArrayAppendInt(column, mp_decode_bool(data));
+	case MP_STR: {
+		struct ArrowStringView str;
+		uint32_t len;
+		str.data = mp_decode_str(data, &len);
+		str.size_bytes = len;
+		return ArrowArrayAppendString(column, str);
+	}
+	case MP_BIN: {
+		struct ArrowBufferView bin;
+		uint32_t len;
+		bin.data.data = mp_decode_bin(data, &len);
+		bin.size_bytes = len;
+		return ArrowArrayAppendBytes(column, bin);
+	}
+	default:
+		return EINVAL;
+	}
+}
+
+/**
+ * Build the struct array from the rows stored in the port. Each
+ * row becomes an element of the array, each column its child.
+ */
+static ArrowErrorCode
+sql_get_arrow_array(struct port *port, struct ArrowArray *array)
+{
+	NANOARROW_RETURN_NOT_OK(ArrowArrayStartAppending(array));
+	struct port_c_entry *entry = ((struct port_c *)port)->first;
+	for (; entry != NULL; entry = entry->next) {
+		assert(entry->type == PORT_C_ENTRY_TUPLE);
+		const char *data = tuple_data(entry->tuple);
+		uint32_t field_count = mp_decode_array(&data);
+		assert(field_count == array->n_children);
+		for (uint32_t i = 0; i < field_count; i++) {
+			NANOARROW_RETURN_NOT_OK(sql_append_arrow_value(
+				array->children[i], &data));
+		}
+		NANOARROW_RETURN_NOT_OK(ArrowArrayFinishElement(array));
+	}
+	return ArrowArrayFinishBuildingDefault(array, NULL);
+}
+
+/**
+ * Encode the result set of the statement in Arrow IPC format. The
+ * data is allocated on the region.
+ *
+ * @retval  0 Success.
+ * @retval -1 Column of a type not representable in Arrow or
+ *            encoding error.
+ */
+static int
+port_sql_get_arrow(struct port *port, struct region *region,
+		   const char **data, const char **data_end)
+{
+	struct port_sql *sql_port = (struct port_sql *)port;
+	struct ArrowSchema schema;
+	if (sql_get_arrow_schema(sql_port->stmt, &schema) != 0)
+		return -1;
+	int rc = -1;
+	struct ArrowArray array;
+	struct ArrowError error;
+	if (ArrowArrayInitFromSchema(&array, &schema, &error) !=
+	    NANOARROW_OK) {
+		diag_set(EncodeError, "Arrow", error.message);
+		goto out;
+	}
+	ArrowErrorCode arrow_rc = sql_get_arrow_array(port, &array);
+	if (arrow_rc != NANOARROW_OK) {
+		diag_set(EncodeError, "Arrow", tt_strerror(arrow_rc));
+		goto out_array;
+	}
+	rc = arrow_ipc_encode(&array, &schema, region, data, data_end);
+out_array:
+	array.release(&array);
+out:
+	schema.release(&schema);
+	return rc;
+}
+
+/**
+ * Dump the metadata and the result set in Arrow IPC format. The
+ * result set is encoded on the region.
+ */
+static int
+port_sql_dump_arrow(struct port *port, struct obuf *out,
+		    struct region *region)
+{
+	struct Vdbe *stmt = ((struct port_sql *)port)->stmt;
+	const char *data, *data_end;
+	if (port_sql_get_arrow(port, region, &data, &data_end) != 0)
+		return -1;
+	uint32_t len = data_end - data;
+	int keys = 2;
+	int size = mp_sizeof_map(keys);
+	char *pos = obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_map(pos, keys);
+	if (sql_get_metadata(stmt, out, sql_column_count(stmt)) != 0)
+		return -1;
+	size = mp_sizeof_uint(IPROTO_ARROW) + mp_sizeof_ext(len);
+	pos = obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_uint(pos, IPROTO_ARROW);
+	mp_encode_ext(pos, MP_ARROW, data, len);
+	return 0;
+}
+
 /**
  * Dump data from port to buffer. Data in port contains tuples,
  * metadata, or information obtained from an executed SQL query.
@@ -225,6 +423,15 @@ sql_get_prepare_common_keys(struct Vdbe *stmt, struct obuf *out, int keys)
  * | }                                            |
  * +-------------------- OR ----------------------+
  * | IPROTO_BODY: {                               |
+ * |     IPROTO_METADATA: [                       |
+ * |         {IPROTO_FIELD_NAME: column name1},   |
+ * |         ...                                  |
+ * |     ],                                       |
+ * |                                              |
+ * |     IPROTO_ARROW: MP_EXT(MP_ARROW)           |
+ * | }                                            |
+ * +-------------------- OR ----------------------+
+ * | IPROTO_BODY: {                               |
  * |     IPROTO_SQL_INFO: {                       |
  * |         SQL_INFO_ROW_COUNT: number           |
  * |         SQL_INFO_AUTOINCREMENT_IDS: [        |
@@ -273,6 +480,13 @@ port_sql_dump_msgpack(struct port *port, struct obuf *out, struct mp_ctx *ctx)
 		port_c_dump_msgpack_wrapped(port, out, ctx);
 		break;
 	}
+	case DQL_EXECUTE_ARROW: {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		int rc = port_sql_dump_arrow(port, out, region);
+		region_truncate(region, region_svp);
+		return rc;
+	}
 	case DML_EXECUTE: {
 		int keys = 1;
 		assert(((struct port_c *)port)->size == 0);
@@ -22,6 +22,8 @@ enum sql_serialization_format {
 	DQL_PREPARE = 2,
 	DML_PREPARE = 3,
 	UNPREPARE = 4,
+	/** Like DQL_EXECUTE, but the rows are in Arrow format. */
+	DQL_EXECUTE_ARROW = 5,
 };
 
 /** Methods of struct port_sql. */
@@ -119,6 +119,10 @@ sql_stmt_compile(const char *zSql, int nBytes, struct Vdbe *pReprepare,
 			/* 21 */ "integer",
 			/* 22 */ "detail",
 			/* 23 */ "text",
+			/* 24 */ "count",
+			/* 25 */ "integer",
+			/* 26 */ "time",
+			/* 27 */ "integer",
 		};
 
 		int name_first, name_count;
@@ -132,6 +136,12 @@ sql_stmt_compile(const char *zSql, int nBytes, struct Vdbe *pReprepare,
 		sqlVdbeSetNumCols(sParse.pVdbe, name_count);
 		for (int i = 0; i < name_count; i++) {
 			int name_index = 2 * i + name_first;
+			/*
+			 * EXPLAIN ANALYZE has the statistics of
+			 * the instructions instead of p5 and comment.
+			 */
+			if (sParse.explain == 3 && i >= 6)
+				name_index = 2 * (i - 6) + 24;
 			vdbe_metadata_set_col_name(sParse.pVdbe, i,
 						   azColName[name_index]);
 			vdbe_metadata_set_col_type(sParse.pVdbe, i,
@@ -203,6 +213,9 @@ sql_parser_destroy(Parse *parser)
 	assert(parser != NULL);
 	assert(!parser->parse_only || parser->pVdbe == NULL);
 	sql_xfree(parser->default_funcs);
+	sql_xfree(parser->space_deps);
+	sql_xfree(parser->param_deps);
+	sql_like_deps_delete(parser->like_deps, parser->like_dep_count);
 	sql_xfree(parser->aLabel);
 	sql_expr_list_delete(parser->pConstExpr);
 	struct create_fk_constraint_parse_def *create_fk_constraint_parse_def =
@@ -4492,6 +4492,264 @@ is_simple_count(struct Select *select, struct AggInfo *agg_info)
 	return space;
 }
 
+/**
+ * Find or add a column read by OP_VecAggregate. If is_numeric is
+ * set, the column values are needed and the column must be of
+ * an integer or double type.
+ *
+ * @retval Index of the column in the plan or -1 if the column
+ *         can't be read in batches.
+ */
+static int
+vec_plan_column(struct vdbe_vec_plan *plan, const struct space_def *def,
+		int fieldno, bool is_numeric)
+{
+	if (fieldno < 0 || (uint32_t)fieldno >= def->field_count)
+		return -1;
+	enum vdbe_vec_type type = VDBE_VEC_ANY;
+	if (is_numeric) {
+		switch (def->fields[fieldno].type) {
+		case FIELD_TYPE_UNSIGNED:
+		case FIELD_TYPE_INTEGER:
+			type = VDBE_VEC_INT;
+			break;
+		case FIELD_TYPE_DOUBLE:
+			type = VDBE_VEC_DOUBLE;
+			break;
+		default:
+			return -1;
+		}
+	}
+	for (uint32_t i = 0; i < plan->column_count; i++) {
+		if (plan->columns[i].fieldno != (uint32_t)fieldno)
+			continue;
+		if (type != VDBE_VEC_ANY)
+			plan->columns[i].type = type;
+		return i;
+	}
+	if (plan->column_count == VDBE_VEC_COLUMN_MAX)
+		return -1;
+	plan->columns[plan->column_count].fieldno = fieldno;
+	plan->columns[plan->column_count].type = type;
+	return plan->column_count++;
+}
+
+/** Check if an expression is a literal or a bound variable. */
+static bool
+vec_plan_is_value(const struct Expr *expr)
+{
+	switch (expr->op) {
+	case TK_UMINUS:
+		return expr->pLeft->op == TK_INTEGER ||
+		       expr->pLeft->op == TK_FLOAT;
+	case TK_INTEGER:
+	case TK_FLOAT:
+	case TK_NULL:
+	case TK_VARIABLE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Add the filters of a WHERE clause to the plan of
+ * OP_VecAggregate. The clause must be a conjunction of
+ * comparisons of columns with values. The values are saved to
+ * the given array in the order of the filters.
+ */
+static bool
+vec_plan_add_filters(struct vdbe_vec_plan *plan, struct Expr *where,
+		     int cursor, const struct space_def *def,
+		     struct Expr **values)
+{
+	if (where->op == TK_AND) {
+		return vec_plan_add_filters(plan, where->pLeft, cursor, def,
+					    values) &&
+		       vec_plan_add_filters(plan, where->pRight, cursor, def,
+					    values);
+	}
+	uint8_t mask;
+	switch (where->op) {
+	case TK_LT:
+		mask = VDBE_VEC_LT;
+		break;
+	case TK_LE:
+		mask = VDBE_VEC_LT | VDBE_VEC_EQ;
+		break;
+	case TK_GT:
+		mask = VDBE_VEC_GT;
+		break;
+	case TK_GE:
+		mask = VDBE_VEC_GT | VDBE_VEC_EQ;
+		break;
+	case TK_EQ:
+		mask = VDBE_VEC_EQ;
+		break;
+	case TK_NE:
+		mask = VDBE_VEC_LT | VDBE_VEC_GT;
+		break;
+	default:
+		return false;
+	}
+	struct Expr *column = where->pLeft;
+	struct Expr *value = where->pRight;
+	if (column->op != TK_COLUMN_REF) {
+		SWAP(column, value);
+		uint8_t swapped = mask & VDBE_VEC_EQ;
+		if ((mask & VDBE_VEC_LT) != 0)
+			swapped |= VDBE_VEC_GT;
+		if ((mask & VDBE_VEC_GT) != 0)
+			swapped |= VDBE_VEC_LT;
+		mask = swapped;
+	}
+	if (column->op != TK_COLUMN_REF || column->iTable != cursor ||
+	    !vec_plan_is_value(value) ||
+	    plan->filter_count == VDBE_VEC_FILTER_MAX)
+		return false;
+	int i = vec_plan_column(plan, def, column->iColumn, true);
+	if (i < 0)
+		return false;
+	struct vdbe_vec_filter *filter = &plan->filters[plan->filter_count];
+	filter->column = i;
+	filter->mask = mask;
+	values[plan->filter_count++] = value;
+	return true;
+}
+
+/**
+ * Find a TREE index that can count the rows passing the filters
+ * of OP_VecAggregate by looking up the bounds of a key range. All
+ * aggregates must be COUNT(*) or COUNT() of the filtered column,
+ * and all filters must compare the same column, which must be the
+ * first part of the index, with values.
+ *
+ * @retval Id of the index or UINT32_MAX.
+ */
+static uint32_t
+vec_plan_count_index(const struct vdbe_vec_plan *plan,
+		     const struct space *space)
+{
+	if (plan->filter_count == 0)
+		return UINT32_MAX;
+	uint32_t column = plan->filters[0].column;
+	for (uint32_t i = 0; i < plan->filter_count; i++) {
+		const struct vdbe_vec_filter *filter = &plan->filters[i];
+		if (filter->column != column ||
+		    filter->mask == (VDBE_VEC_LT | VDBE_VEC_GT))
+			return UINT32_MAX;
+	}
+	for (uint32_t i = 0; i < plan->agg_count; i++) {
+		const struct vdbe_vec_agg *agg = &plan->aggs[i];
+		if (agg->type != VDBE_VEC_COUNT ||
+		    (agg->column >= 0 && (uint32_t)agg->column != column))
+			return UINT32_MAX;
+	}
+	uint32_t fieldno = plan->columns[column].fieldno;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		const struct index_def *def = space->index[i]->def;
+		const struct key_part *part = &def->key_def->parts[0];
+		if (def->type == TREE && part->fieldno == fieldno &&
+		    part->path == NULL && part->coll == NULL &&
+		    part->sort_order == SORT_ORDER_ASC &&
+		    part->type == space->def->fields[fieldno].type &&
+		    !def->key_def->is_multikey &&
+		    !def->key_def->for_func_index)
+			return def->iid;
+	}
+	return UINT32_MAX;
+}
+
+/**
+ * Check if an aggregate query without GROUP BY can be computed
+ * by OP_VecAggregate, i.e. it reads a single memtx space, it has
+ * no columns outside aggregates, all its aggregates are COUNT(),
+ * SUM(), TOTAL(), AVG(), MIN() or MAX() of columns (the latter
+ * five of integer or double columns) and its WHERE clause is a
+ * conjunction of comparisons of such columns with literals or
+ * bound variables. If so, emit code loading the compared values
+ * to registers and return the plan. The id of the index to scan
+ * is up to the caller.
+ *
+ * @param parse Parsing context.
+ * @param select The select statement in form of aggregate query.
+ * @param agg_info The associated aggregate-info object.
+ * @retval Plan allocated with sql_xmalloc() or NULL.
+ */
+static struct vdbe_vec_plan *
+vec_aggregate_plan_new(struct Parse *parse, struct Select *select,
+		       struct AggInfo *agg_info)
+{
+	assert(select->pGroupBy == NULL);
+	if (select->pSrc->nSrc != 1 || select->pSrc->a[0].pSelect != NULL ||
+	    select->pSrc->a[0].fg.isIndexedBy || agg_info->nAccumulator > 0 ||
+	    agg_info->nFunc == 0 || agg_info->nFunc > VDBE_VEC_AGG_MAX)
+		return NULL;
+	struct SrcList_item *src = &select->pSrc->a[0];
+	struct space *space = src->space;
+	assert(space != NULL && !space->def->opts.is_view);
+	if (!space_is_memtx(space))
+		return NULL;
+	static const struct {
+		const char *name;
+		enum vdbe_vec_agg_type type;
+	} funcs[] = {
+		{"COUNT", VDBE_VEC_COUNT},
+		{"SUM", VDBE_VEC_SUM},
+		{"TOTAL", VDBE_VEC_TOTAL},
+		{"AVG", VDBE_VEC_AVG},
+		{"MIN", VDBE_VEC_MIN},
+		{"MAX", VDBE_VEC_MAX},
+	};
+	struct vdbe_vec_plan plan;
+	memset(&plan, 0, sizeof(plan));
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		if (func->iDistinct >= 0 ||
+		    func->func->def->language != FUNC_LANGUAGE_SQL_BUILTIN)
+			return NULL;
+		struct vdbe_vec_agg *agg = &plan.aggs[plan.agg_count++];
+		uint32_t j;
+		for (j = 0; j < lengthof(funcs); j++) {
+			if (strcmp(func->func->def->name, funcs[j].name) == 0)
+				break;
+		}
+		if (j == lengthof(funcs))
+			return NULL;
+		agg->type = funcs[j].type;
+		agg->reg = func->iMem;
+		struct ExprList *args = func->pExpr->x.pList;
+		if (args == NULL || args->nExpr == 0) {
+			if (agg->type != VDBE_VEC_COUNT)
+				return NULL;
+			agg->column = -1;
+			continue;
+		}
+		struct Expr *arg = args->a[0].pExpr;
+		if (args->nExpr != 1 || arg->op != TK_AGG_COLUMN ||
+		    arg->iTable != src->iCursor)
+			return NULL;
+		agg->column = vec_plan_column(&plan, space->def, arg->iColumn,
+					      agg->type != VDBE_VEC_COUNT);
+		if (agg->column < 0)
+			return NULL;
+	}
+	struct Expr *values[VDBE_VEC_FILTER_MAX];
+	if (select->pWhere != NULL &&
+	    !vec_plan_add_filters(&plan, select->pWhere, src->iCursor,
+				  space->def, values))
+		return NULL;
+	plan.index_id = UINT32_MAX;
+	plan.count_index_id = vec_plan_count_index(&plan, space);
+	for (uint32_t i = 0; i < plan.filter_count; i++) {
+		plan.filters[i].reg = ++parse->nMem;
+		sqlExprCode(parse, values[i], plan.filters[i].reg);
+	}
+	struct vdbe_vec_plan *res = sql_xmalloc(sizeof(*res));
+	*res = plan;
+	return res;
+}
+
 /*
  * If the source-list item passed as an argument was augmented with an
  * INDEXED BY clause, then try to locate the specified index. If there
@@ -6416,6 +6674,31 @@ sqlSelect(Parse * pParse,		/* The parser context */
 						TK_COLUMN_REF;
 				}
 
+				/*
+				 * If the query is simple enough, first try
+				 * to compute it in batches. OP_VecAggregate
+				 * jumps over the row-at-a-time code on
+				 * success and falls through to it otherwise.
+				 */
+				struct vdbe_vec_plan *vec_plan =
+					vec_aggregate_plan_new(pParse, p,
+							       &sAggInfo);
+				int addr_vec = -1;
+				int label_vec_done = 0;
+				if (vec_plan != NULL) {
+					int reg = ++pParse->nMem;
+					struct space *space =
+						pTabList->a[0].space;
+					sqlVdbeAddOp2(v, OP_OpenSpace, reg,
+						      space->def->id);
+					label_vec_done = sqlVdbeMakeLabel(v);
+					addr_vec = sqlVdbeAddOp3(v,
+						OP_VecAggregate, 0,
+						label_vec_done, reg);
+					sqlVdbeAppendP4(v, vec_plan,
+							P4_VECPLAN);
+				}
+
 				/* This case runs if the aggregate has no GROUP BY clause.  The
 				 * processing is much simpler since there is only a single row
 				 * of output.
@@ -6428,6 +6711,22 @@ sqlSelect(Parse * pParse,		/* The parser context */
 					sql_expr_list_delete(pDel);
 					goto select_end;
 				}
+				if (vec_plan != NULL) {
+					/*
+					 * Batches pay off only if the
+					 * planner resorts to a full scan.
+					 * Counts of an index range don't
+					 * depend on the plan.
+					 */
+					vec_plan->index_id =
+						sql_where_full_scan_index(
+							pWInfo);
+					if (vec_plan->index_id == UINT32_MAX &&
+					    vec_plan->count_index_id ==
+					    UINT32_MAX)
+						sqlVdbeChangeToNoop(v,
+								    addr_vec);
+				}
 				updateAccumulator(pParse, &sAggInfo);
 				if (pParse->is_aborted) {
 					whereInfoFree(pWInfo);
@@ -6445,6 +6744,8 @@ sqlSelect(Parse * pParse,		/* The parser context */
 				}
 				sqlWhereEnd(pWInfo);
 				finalizeAggFunctions(pParse, &sAggInfo);
+				if (label_vec_done != 0)
+					sqlVdbeResolveLabel(v, label_vec_done);
 				sql_expr_list_delete(pDel);
 			}
 
@@ -410,6 +410,29 @@ sql_column_span(struct Vdbe *v, int n);
 uint64_t
 sql_stmt_schema_version(const struct Vdbe *stmt);
 
+/**
+ * Check if the statement can be executed with the current schema.
+ * A DML or DQL statement stays valid until any of the spaces it
+ * refers to is altered or dropped, other statements expire on any
+ * schema change. All statements expire if a collation or a
+ * function is created, altered or dropped.
+ */
+bool
+sql_stmt_schema_is_valid(struct Vdbe *stmt);
+
+/**
+ * Recompile the statement if the values bound to its parameters
+ * are far from the ones the query plan was chosen for, so that a
+ * better plan can be chosen, or if the plan is built for a LIKE
+ * pattern prefix other than the one of the bound value. The bound
+ * values are kept.
+ *
+ * @retval 0 Success.
+ * @retval -1 Compilation error.
+ */
+int
+sql_stmt_reoptimize(struct Vdbe *stmt);
+
 int
 sql_initialize(void);
 
@@ -1002,6 +1025,21 @@ struct sql {
 					 */
 enum {
 	SQL_SeqScan = 0x00000008,
+	/**
+	 * Share compiled statements between SQL strings differing
+	 * only in literals, see sql_normalize().
+	 */
+	SQL_PlanCache = 0x00000010,
+	/**
+	 * Let worker threads scan large memtx spaces for simple
+	 * aggregate queries, see vdbe_vec_aggregate().
+	 */
+	SQL_ParallelScan = 0x00000020,
+	/**
+	 * Profile sampled statement runs and log the slow ones,
+	 * see vdbe_profile_stop().
+	 */
+	SQL_Profile = 0x00000040,
 	SQL_DEFAULT_FLAGS = SQL_EnableTrigger | SQL_AutoIndex |
 			    SQL_RecTriggers | SQL_SeqScan,
 };
@@ -1218,6 +1256,112 @@ struct UnpackedRecord {
 int16_t
 index_field_tuple_est(const struct index_def *idx, uint32_t field);
 
+/**
+ * Statistics of an index collected by space:analyze() and
+ * stored in the _sql_stat space.
+ */
+struct sql_index_stat {
+	/** Number of tuples in the index at the time of analysis. */
+	uint64_t tuple_count;
+	/**
+	 * MsgPack array of numbers of distinct values of the first
+	 * 1, 2, ... key parts. Either empty or has an entry for each
+	 * key part.
+	 */
+	const char *distinct;
+	uint32_t distinct_count;
+	/**
+	 * Boundaries of an equi-depth histogram: MsgPack array of
+	 * keys sorted in the index order that split the index into
+	 * bound_count + 1 ranges of roughly equal size.
+	 */
+	const char *bounds;
+	uint32_t bound_count;
+};
+
+/**
+ * Look up statistics of an index in the _sql_stat space.
+ * @a stat points to the stored tuple data so it must not be
+ * used after a yield.
+ *
+ * @param idx Index definition.
+ * @param[out] stat Index statistics.
+ * @retval true if the index has been analyzed.
+ */
+bool
+sql_index_stat_get(const struct index_def *idx, struct sql_index_stat *stat);
+
+/**
+ * Estimate the fraction of index tuples less than the given value
+ * of the first index part using the histogram of the index.
+ *
+ * @param stat Index statistics.
+ * @param coll Collation of the first index part.
+ * @param value Value to estimate the position of.
+ * @param[out] pos Estimated fraction.
+ * @retval 0 Success.
+ * @retval -1 The value can't be compared with the index keys.
+ */
+int
+sql_index_stat_pos(const struct sql_index_stat *stat,
+		   const struct coll *coll, const struct Mem *value,
+		   double *pos);
+
+/**
+ * A parameter the query plan of a statement depends on: the first
+ * part of an analyzed index is compared with the parameter by a
+ * range term so the estimated cost of the index scan depends on
+ * the value bound to the parameter.
+ */
+struct sql_param_dep {
+	/** Number of the parameter, starting from 1. */
+	uint32_t var;
+	/** Space and index the value is looked up in. */
+	uint32_t space_id;
+	uint32_t index_id;
+	/**
+	 * Position of the value the plan was chosen for as
+	 * returned by sql_index_stat_pos() or -1 if the value
+	 * wasn't known at the moment of compilation.
+	 */
+	double pos;
+};
+
+/**
+ * A parameter the value of which is used as a LIKE pattern: the
+ * prefix of the value preceding the first wildcard is built into
+ * the compiled statement as the bounds of an index scan.
+ */
+struct sql_like_dep {
+	/** Number of the parameter, starting from 1. */
+	uint32_t var;
+	/** Prefix the statement was compiled for. */
+	char *prefix;
+	/** Length of the prefix. */
+	uint32_t prefix_len;
+	/** True if the pattern was the prefix followed by '%'. */
+	bool is_complete;
+};
+
+/**
+ * Find the prefix of a LIKE pattern preceding the first wildcard.
+ *
+ * @param z Pattern.
+ * @param len Length of @a z.
+ * @param[out] prefix_len Length of the prefix.
+ * @param[out] is_complete True if the only wildcard is '%' in the
+ *             last character.
+ * @retval true The prefix can be used to look up an index.
+ * @retval false The prefix is empty or ends with 0xff.
+ */
+bool
+sql_like_prefix(const char *z, uint32_t len, uint32_t *prefix_len,
+		bool *is_complete);
+
+/** Free an array of LIKE dependencies. */
+void
+sql_like_deps_delete(struct sql_like_dep *deps, uint32_t count);
+
 #ifdef DEFAULT_TUPLE_COUNT
 #undef DEFAULT_TUPLE_COUNT
 #endif
@@ -2033,6 +2177,23 @@ struct Parse {
 	int iNextSelectId;	/* Next available select ID for EXPLAIN output */
 	VList *pVList;		/* Mapping between variable names and numbers */
 	Vdbe *pReprepare;	/* VM being reprepared (sqlReprepare()) */
+	/**
+	 * True if the compiled statement can outlive a schema
+	 * change not affecting the spaces it refers to.
+	 */
+	bool has_space_deps;
+	/** Ids of the spaces the statement refers to. */
+	uint32_t *space_deps;
+	/** Number of entries in space_deps. */
+	uint32_t space_dep_count;
+	/** Parameters the query plan depends on. */
+	struct sql_param_dep *param_deps;
+	/** Number of entries in param_deps. */
+	uint32_t param_dep_count;
+	/** Parameters used as LIKE patterns. */
+	struct sql_like_dep *like_deps;
+	/** Number of entries in like_deps. */
+	uint32_t like_dep_count;
 	const char *zTail;	/* All SQL text past the last semicolon parsed */
 	TriggerPrg *pTriggerPrg;	/* Linked list of coded triggers */
 	With *pWith;		/* Current WITH clause, or NULL */
@@ -3024,6 +3185,15 @@ int sqlWhereIsSorted(WhereInfo *);
 int sqlWhereContinueLabel(WhereInfo *);
 int sqlWhereBreakLabel(WhereInfo *);
 int sqlWhereOkOnePass(WhereInfo *, int *);
+
+/**
+ * Return the id of the index scanned by a single table WHERE
+ * loop if the loop is a plain full scan of the index in its
+ * natural order, without any key constraints. Otherwise return
+ * UINT32_MAX.
+ */
+uint32_t
+sql_where_full_scan_index(struct WhereInfo *info);
 #define ONEPASS_OFF      0	/* Use of ONEPASS not allowed */
 #define ONEPASS_SINGLE   1	/* ONEPASS valid for a single row update */
 #define ONEPASS_MULTI    2	/* ONEPASS is valid for multiple rows */
@@ -4090,6 +4260,33 @@ sql_alter_table_rename(struct Parse *parse);
 int
 sql_token(const char *z, int *type, bool *is_reserved);
 
+struct sql_bind;
+
+/**
+ * Replace literals of a DML or DQL statement with parameters, so
+ * that statements differing only in the values of the literals
+ * can share the compiled statement. Literals are replaced only
+ * in the WHERE, ON, HAVING, SET, LIMIT and OFFSET clauses and in
+ * VALUES of INSERT, so that the result set metadata and the
+ * meaning of the statement don't change. Whitespace and comments
+ * are collapsed.
+ *
+ * @param sql SQL statement.
+ * @param len Length of @a sql.
+ * @param region Region to allocate the result on.
+ * @param[out] out Normalized statement, null-terminated.
+ * @param[out] out_len Length of @a out.
+ * @param[out] bind Values of the replaced literals.
+ * @param[out] bind_count Number of replaced literals.
+ *
+ * @retval 0 Success.
+ * @retval -1 The statement can't be normalized. Diag is not set.
+ */
+int
+sql_normalize(const char *sql, uint32_t len, struct region *region,
+	      char **out, uint32_t *out_len, struct sql_bind **bind,
+	      uint32_t *bind_count);
+
 /**
  * Mark every prepared statement as expired.
  *
@@ -39,6 +39,7 @@
 #include <unicode/utf8.h>
 #include <unicode/uchar.h>
 
+#include "box/bind.h"
 #include "box/session.h"
 #include "box/schema.h"
 #include "say.h"
@@ -604,6 +605,216 @@ sqlRunParser(Parse * pParse, const char *zSql)
 	return pParse->is_aborted ? -1 : 0;
 }
 
+/**
+ * Convert a literal token to the value of a parameter replacing
+ * it. Return -1 if the literal must be kept in the statement.
+ */
+static int
+sql_literal_to_bind(const char *z, int n, int type, struct region *region,
+		    struct sql_bind *bind)
+{
+	memset(bind, 0, sizeof(*bind));
+	switch (type) {
+	case TK_INTEGER: {
+		/* Hex literals have their own overflow rules. */
+		if (n > 1 && (z[1] == 'x' || z[1] == 'X'))
+			return -1;
+		int64_t value;
+		bool unused;
+		if (sql_atoi64(z, &value, &unused, n) != 0 ||
+		    (uint64_t)value > INT64_MAX)
+			return -1;
+		bind->type = MP_UINT;
+		bind->u64 = value;
+		bind->bytes = sizeof(bind->u64);
+		return 0;
+	}
+	case TK_FLOAT:
+		if (sqlAtoF(z, &bind->d, n) == 0)
+			return -1;
+		bind->type = MP_DOUBLE;
+		bind->bytes = sizeof(bind->d);
+		return 0;
+	case TK_DECIMAL:
+		if (n > DECIMAL_MAX_STR_LEN ||
+		    decimal_from_string(&bind->dec, tt_cstr(z, n)) == NULL)
+			return -1;
+		bind->type = MP_EXT;
+		bind->ext_type = MP_DECIMAL;
+		bind->bytes = sizeof(bind->dec);
+		return 0;
+	case TK_STRING: {
+		assert(n >= 2 && z[0] == '\'' && z[n - 1] == '\'');
+		char *str = xregion_alloc(region, n);
+		uint32_t len = 0;
+		for (int i = 1; i < n - 1; i++) {
+			str[len++] = z[i];
+			/* Quotes are escaped by doubling. */
+			if (z[i] == '\'')
+				i++;
+		}
+		bind->type = MP_STR;
+		bind->s = str;
+		bind->bytes = len;
+		return 0;
+	}
+	case TK_BLOB: {
+		assert(n >= 3 && z[1] == '\'' && z[n - 1] == '\'');
+		uint32_t len = (n - 3) / 2;
+		char *bin = xregion_alloc(region, len + 1);
+		for (uint32_t i = 0; i < len; i++) {
+			bin[i] = (sqlHexToInt(z[2 + 2 * i]) << 4) |
+				 sqlHexToInt(z[3 + 2 * i]);
+		}
+		bind->type = MP_BIN;
+		bind->s = bin;
+		bind->bytes = len;
+		return 0;
+	}
+	default:
+		return -1;
+	}
+}
+
+enum {
+	/** Max nesting of parentheses sql_normalize() can handle. */
+	SQL_NORMALIZE_MAX_DEPTH = 64,
+};
+
+int
+sql_normalize(const char *sql, uint32_t len, struct region *region,
+	      char **out, uint32_t *out_len, struct sql_bind **bind,
+	      uint32_t *bind_count)
+{
+	/* The tokenizer expects a null-terminated string. */
+	char *z = xregion_alloc(region, len + 1);
+	memcpy(z, sql, len);
+	z[len] = '\0';
+	/*
+	 * The first pass checks the kind of the statement and
+	 * counts literals to allocate parameters for them.
+	 */
+	int type;
+	bool is_reserved;
+	int first = 0;
+	uint32_t literal_count = 0;
+	for (uint32_t i = 0; i < len;) {
+		i += sql_token(&z[i], &type, &is_reserved);
+		switch (type) {
+		case TK_SPACE:
+		case TK_LINEFEED:
+			continue;
+		case TK_INTEGER:
+		case TK_FLOAT:
+		case TK_DECIMAL:
+		case TK_STRING:
+		case TK_BLOB:
+			literal_count++;
+			break;
+		/* Statements with parameters are compiled as is. */
+		case TK_VARNUM:
+		case TK_VARIABLE:
+		case TK_COLON:
+		case TK_ILLEGAL:
+			return -1;
+		default:
+			break;
+		}
+		if (first == 0)
+			first = type;
+	}
+	if (literal_count == 0)
+		return -1;
+	bool is_insert = first == TK_INSERT || first == TK_REPLACE;
+	if (first != TK_SELECT && first != TK_VALUES && first != TK_WITH &&
+	    first != TK_UPDATE && first != TK_DELETE && !is_insert)
+		return -1;
+	*bind = xregion_alloc_array(region, struct sql_bind, literal_count);
+	char *res = xregion_alloc(region, len + 1);
+	uint32_t res_len = 0;
+	uint32_t count = 0;
+	/*
+	 * For each level of parentheses, whether literals are
+	 * replaced with parameters in the current clause. They
+	 * are kept in the result columns, so that the metadata
+	 * doesn't change, and in ORDER BY and GROUP BY, where
+	 * integers refer to the result columns.
+	 */
+	bool replace[SQL_NORMALIZE_MAX_DEPTH];
+	int depth = 0;
+	replace[0] = false;
+	bool is_limit = false;
+	for (uint32_t i = 0; i < len;) {
+		const char *token = &z[i];
+		int n = sql_token(token, &type, &is_reserved);
+		i += n;
+		switch (type) {
+		case TK_SPACE:
+		case TK_LINEFEED:
+			if (res_len > 0 && res[res_len - 1] != ' ')
+				res[res_len++] = ' ';
+			continue;
+		case TK_LP:
+			if (++depth == SQL_NORMALIZE_MAX_DEPTH)
+				return -1;
+			replace[depth] = replace[depth - 1];
+			break;
+		case TK_RP:
+			if (depth-- == 0)
+				return -1;
+			break;
+		case TK_SELECT:
+		case TK_FROM:
+		case TK_ORDER:
+		case TK_GROUP:
+			replace[depth] = false;
+			break;
+		case TK_WHERE:
+		case TK_ON:
+		case TK_HAVING:
+		case TK_SET:
+			replace[depth] = true;
+			break;
+		case TK_VALUES:
+			replace[depth] = is_insert && depth == 0;
+			break;
+		case TK_INTEGER:
+		case TK_FLOAT:
+		case TK_DECIMAL:
+		case TK_STRING:
+		case TK_BLOB:
+			if (!replace[depth] && !is_limit)
+				break;
+			if (sql_literal_to_bind(token, n, type, region,
+						&(*bind)[count]) != 0)
+				break;
+			(*bind)[count].pos = count + 1;
+			count++;
+			res[res_len++] = '?';
+			is_limit = false;
+			continue;
+		default:
+			break;
+		}
+		/*
+		 * LIMIT and OFFSET aren't reserved and may be column
+		 * names, so only the literal following them is
+		 * replaced.
+		 */
+		is_limit = type == TK_LIMIT || type == TK_OFFSET;
+		memcpy(&res[res_len], token, n);
+		res_len += n;
+	}
+	if (count == 0)
+		return -1;
+	assert(res_len <= len);
+	res[res_len] = '\0';
+	*out = res;
+	*out_len = res_len;
+	*bind_count = count;
+	return 0;
+}
+
 struct Expr *
 sql_expr_compile(const char *expr, int expr_len)
 {
@@ -408,6 +408,11 @@ sql_trigger_replace(const char *name, uint32_t space_id,
 		trigger->next = space->sql_triggers;
 		space->sql_triggers = trigger;
 	}
+	/*
+	 * Triggers are coded into statements modifying the space
+	 * so the statements must be recompiled.
+	 */
+	space->cache_version = ++space_cache_version;
 	return 0;
 }
 
@@ -49,6 +49,7 @@
 #include "vdbeInt.h"
 #include "tarantoolInt.h"
 
+#include "clock.h"
 #include "msgpuck/msgpuck.h"
 #include "mpstream/mpstream.h"
 
@@ -352,6 +353,90 @@ vdbe_field_ref_fetch(struct vdbe_field_ref *field_ref, uint32_t fieldno,
 	return 0;
 }
 
+/**
+ * Execute OP_Column: read the column P2 of the row the cursor P1
+ * points to into the register P3.
+ */
+static int
+vdbe_op_column(struct Vdbe *p, const struct VdbeOp *pOp)
+{
+	int p2;            /* column number to retrieve */
+	VdbeCursor *pC;    /* The VDBE cursor */
+	BtCursor *pCrsr = NULL; /* The BTree cursor */
+	Mem *pDest;        /* Where to write the extracted value */
+	Mem *pReg;         /* PseudoTable input register */
+
+	pC = p->apCsr[pOp->p1];
+	p2 = pOp->p2;
+
+	assert(pOp->p3>0 && pOp->p3<=(p->nMem+1 - p->nCursor));
+	pDest = vdbe_prepare_null_out(p, pOp->p3);
+	assert(pOp->p1>=0 && pOp->p1<p->nCursor);
+	assert(pC!=0);
+	assert(p2<pC->nField);
+	assert(pC->eCurType!=CURTYPE_PSEUDO || pC->nullRow);
+	assert(pC->eCurType!=CURTYPE_SORTER);
+
+	if (pC->cacheStatus!=p->cacheCtr) {                /*OPTIMIZATION-IF-FALSE*/
+		if (pC->nullRow) {
+			if (pC->eCurType==CURTYPE_PSEUDO) {
+				assert(pC->uc.pseudoTableReg>0);
+				pReg = &p->aMem[pC->uc.pseudoTableReg];
+				assert(mem_is_bin(pReg));
+				assert(memIsValid(pReg));
+				vdbe_field_ref_prepare_data(&pC->field_ref,
+							    pReg->z, pReg->n);
+			} else {
+				goto out;
+			}
+		} else if (pC->eCurType == CURTYPE_HASH) {
+			uint32_t size;
+			const char *data = vdbe_hash_record(pC->uc.hash, &size);
+			vdbe_field_ref_prepare_data(&pC->field_ref, data, size);
+		} else {
+			pCrsr = pC->uc.pCursor;
+			assert(pC->eCurType==CURTYPE_TARANTOOL);
+			assert(pCrsr);
+			assert(sqlCursorIsValid(pCrsr));
+			assert(pCrsr->curFlags & BTCF_TaCursor ||
+			       pCrsr->curFlags & BTCF_TEphemCursor);
+			vdbe_field_ref_prepare_tuple(&pC->field_ref,
+						     pCrsr->last_tuple);
+		}
+		pC->cacheStatus = p->cacheCtr;
+	}
+	assert(pC->eCurType == CURTYPE_TARANTOOL ||
+	       pC->eCurType == CURTYPE_PSEUDO ||
+	       pC->eCurType == CURTYPE_HASH);
+	struct Mem *default_val_mem =
+		pOp->p4type == P4_MEM ? pOp->p4.pMem : NULL;
+	if (vdbe_field_ref_fetch(&pC->field_ref, p2, pDest) != 0)
+		return -1;
+
+	if (mem_is_null(pDest) &&
+	    (uint32_t) p2  >= pC->field_ref.field_count &&
+	    default_val_mem != NULL) {
+		mem_copy_as_ephemeral(pDest, default_val_mem);
+	}
+	if (pDest->type == MEM_TYPE_NULL)
+		goto out;
+	enum field_type field_type = field_type_MAX;
+	/* Currently PSEUDO cursor does not have info about field types. */
+	if (pC->eCurType == CURTYPE_TARANTOOL)
+		field_type = pC->uc.pCursor->space->def->fields[p2].type;
+	else if (pC->eCurType == CURTYPE_HASH)
+		field_type = vdbe_hash_field_type(pC->uc.hash, p2);
+	if (field_type == FIELD_TYPE_ANY)
+		pDest->flags |= MEM_Any;
+	else if (field_type == FIELD_TYPE_SCALAR)
+		pDest->flags |= MEM_Scalar;
+	else if (field_type == FIELD_TYPE_NUMBER)
+		pDest->flags |= MEM_Number;
+out:
+	REGISTER_TRACE(p, pOp->p3, pDest);
+	return 0;
+}
+
 /*
  * Execute as much of a VDBE program as we can.
  * This is the core of sql_step().
@@ -373,6 +458,11 @@ int sqlVdbeExec(Vdbe *p)
 	Mem *pIn3 = 0;             /* 3rd input operand */
 	Mem *pOut = 0;             /* Output operand */
 	int *aPermute = 0;         /* Permutation of columns for OP_Compare */
+	/* Statistics of the instructions if the run is profiled. */
+	struct vdbe_op_stat *op_stat = p->is_profiled ? p->op_stat : NULL;
+	/* The profiled instruction being executed and its start. */
+	int stat_pc = -1;
+	int64_t stat_start = 0;
 	/*** INSERT STACK UNION HERE ***/
 
 	assert(p->magic==VDBE_MAGIC_RUN);  /* sql_step() verifies this */
@@ -413,6 +503,20 @@ int sqlVdbeExec(Vdbe *p)
 
 		assert(pOp>=aOp && pOp<&aOp[p->nOp]);
 
+		/*
+		 * Account the time since the previous instruction
+		 * started to it. Instructions of sub-programs are
+		 * not profiled, their time goes to OP_Program.
+		 */
+		if (op_stat != NULL && p->pFrame == NULL) {
+			int64_t now = clock_monotonic64();
+			if (stat_pc >= 0)
+				op_stat[stat_pc].time += now - stat_start;
+			stat_pc = pOp - aOp;
+			op_stat[stat_pc].count++;
+			stat_start = now;
+		}
+
 		/* Only allow tracing if SQL_DEBUG is defined.
 		 */
 #ifdef SQL_DEBUG
@@ -971,6 +1075,7 @@ case OP_SCopy: {            /* out2 */
  * the result row.
  */
 case OP_ResultRow: {
+result_row:
 	assert(p->nResColumn==pOp->p2);
 	assert(pOp->p1>0);
 	assert(pOp->p1+pOp->p2<=(p->nMem+1 - p->nCursor)+1);
@@ -1448,6 +1553,7 @@ case OP_Getitem: {
  */
 case OP_Eq:               /* same as TK_EQ, jump, in1, in3 */
 case OP_Ne: {             /* same as TK_NE, jump, in1, in3 */
+compare_eq:
 	pIn1 = &aMem[pOp->p1];
 	pIn3 = &aMem[pOp->p3];
 	if (mem_is_any_null(pIn1, pIn3) && (pOp->p5 & SQL_NULLEQ) == 0) {
@@ -1513,6 +1619,7 @@ case OP_Lt:               /* same as TK_LT, jump, in1, in3 */
 case OP_Le:               /* same as TK_LE, jump, in1, in3 */
 case OP_Gt:               /* same as TK_GT, jump, in1, in3 */
 case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
+compare_lt:
 	pIn1 = &aMem[pOp->p1];
 	pIn3 = &aMem[pOp->p3];
 	if (mem_is_any_null(pIn1, pIn3)) {
@@ -1887,76 +1994,53 @@ case OP_NotNull: {            /* same as TK_NOTNULL, jump, in1 */
  * skipped for length() and all content loading can be skipped for typeof().
  */
 case OP_Column: {
-	int p2;            /* column number to retrieve */
-	VdbeCursor *pC;    /* The VDBE cursor */
-	BtCursor *pCrsr = NULL; /* The BTree cursor */
-	Mem *pDest;        /* Where to write the extracted value */
-	Mem *pReg;         /* PseudoTable input register */
-
-	pC = p->apCsr[pOp->p1];
-	p2 = pOp->p2;
-
-	assert(pOp->p3>0 && pOp->p3<=(p->nMem+1 - p->nCursor));
-	pDest = vdbe_prepare_null_out(p, pOp->p3);
-	assert(pOp->p1>=0 && pOp->p1<p->nCursor);
-	assert(pC!=0);
-	assert(p2<pC->nField);
-	assert(pC->eCurType!=CURTYPE_PSEUDO || pC->nullRow);
-	assert(pC->eCurType!=CURTYPE_SORTER);
-
-	if (pC->cacheStatus!=p->cacheCtr) {                /*OPTIMIZATION-IF-FALSE*/
-		if (pC->nullRow) {
-			if (pC->eCurType==CURTYPE_PSEUDO) {
-				assert(pC->uc.pseudoTableReg>0);
-				pReg = &aMem[pC->uc.pseudoTableReg];
-				assert(mem_is_bin(pReg));
-				assert(memIsValid(pReg));
-				vdbe_field_ref_prepare_data(&pC->field_ref,
-							    pReg->z, pReg->n);
-			} else {
-				goto op_column_out;
-			}
-		} else {
-			pCrsr = pC->uc.pCursor;
-			assert(pC->eCurType==CURTYPE_TARANTOOL);
-			assert(pCrsr);
-			assert(sqlCursorIsValid(pCrsr));
-			assert(pCrsr->curFlags & BTCF_TaCursor ||
-			       pCrsr->curFlags & BTCF_TEphemCursor);
-			vdbe_field_ref_prepare_tuple(&pC->field_ref,
-						     pCrsr->last_tuple);
-		}
-		pC->cacheStatus = p->cacheCtr;
-	}
-	assert(pC->eCurType == CURTYPE_TARANTOOL ||
-	       pC->eCurType == CURTYPE_PSEUDO);
-	struct Mem *default_val_mem =
-		pOp->p4type == P4_MEM ? pOp->p4.pMem : NULL;
-	if (vdbe_field_ref_fetch(&pC->field_ref, p2, pDest) != 0)
+	if (vdbe_op_column(p, pOp) != 0)
 		goto abort_due_to_error;
+	break;
+}
 
-	if (mem_is_null(pDest) &&
-	    (uint32_t) p2  >= pC->field_ref.field_count &&
-	    default_val_mem != NULL) {
-		mem_copy_as_ephemeral(pDest, default_val_mem);
+/* Opcode: ColumnRun P1 P2 P3 P4 *
+ * Synopsis: r[P3]=PX
+ *
+ * Execute this OP_Column and all OP_Column on the same cursor which
+ * immediately follow it. If they are followed by OP_ResultRow, it is
+ * executed too. The opcode is put by sqlVdbeFuse() in place of the
+ * first OP_Column of the run.
+ */
+case OP_ColumnRun: {
+	int cursor = pOp->p1;
+	if (vdbe_op_column(p, pOp) != 0)
+		goto abort_due_to_error;
+	while (pOp[1].opcode == OP_Column && pOp[1].p1 == cursor) {
+		pOp++;
+		if (vdbe_op_column(p, pOp) != 0)
+			goto abort_due_to_error;
+	}
+	if (pOp[1].opcode == OP_ResultRow) {
+		pOp++;
+		goto result_row;
 	}
-	if (pDest->type == MEM_TYPE_NULL)
-		goto op_column_out;
-	enum field_type field_type = field_type_MAX;
-	/* Currently PSEUDO cursor does not have info about field types. */
-	if (pC->eCurType == CURTYPE_TARANTOOL)
-		field_type = pC->uc.pCursor->space->def->fields[p2].type;
-	if (field_type == FIELD_TYPE_ANY)
-		pDest->flags |= MEM_Any;
-	else if (field_type == FIELD_TYPE_SCALAR)
-		pDest->flags |= MEM_Scalar;
-	else if (field_type == FIELD_TYPE_NUMBER)
-		pDest->flags |= MEM_Number;
-op_column_out:
-	REGISTER_TRACE(p, pOp->p3, pDest);
 	break;
 }
 
+/* Opcode: ColumnCompare P1 P2 P3 P4 *
+ * Synopsis: r[P3]=PX
+ *
+ * Execute this OP_Column and the comparison opcode which immediately
+ * follows it. The opcode is put by sqlVdbeFuse() in place of
+ * OP_Column.
+ */
+case OP_ColumnCompare: {
+	if (vdbe_op_column(p, pOp) != 0)
+		goto abort_due_to_error;
+	pOp++;
+	if (pOp->opcode == OP_Eq || pOp->opcode == OP_Ne)
+		goto compare_eq;
+	assert(pOp->opcode == OP_Lt || pOp->opcode == OP_Le ||
+	       pOp->opcode == OP_Gt || pOp->opcode == OP_Ge);
+	goto compare_lt;
+}
+
 /**
  * Opcode: FetchByName P1 * P3 * P4
  * Synopsis: r[P3]=PX
@@ -2139,6 +2223,36 @@ case OP_Count: {         /* out2 */
 	break;
 }
 
+/* Opcode: VecAggregate * P2 P3 P4 *
+ * Synopsis: space ptr = reg[P3]
+ *
+ * Compute the aggregates described by plan P4 over a full scan of
+ * an index of the space pointed to by register P3, processing
+ * tuples in batches. On success, the results are stored to the
+ * registers given by the plan and the jump to P2 is taken. If the
+ * space contents can't be processed in batches, fall through to
+ * the row-at-a-time code computing the same aggregates.
+ */
+case OP_VecAggregate: {       /* jump */
+	assert(pOp->p4type == P4_VECPLAN);
+	if (!sql_stmt_schema_is_valid(p)) {
+		p->expired = 1;
+		diag_set(ClientError, ER_SQL_EXECUTE, "schema version has "\
+			 "changed: need to re-compile SQL statement");
+		goto abort_due_to_error;
+	}
+	struct space *space = aMem[pOp->p3].u.p;
+	assert(space != NULL);
+	if (access_check_space(space, PRIV_R) != 0)
+		goto abort_due_to_error;
+	bool is_done;
+	if (vdbe_vec_aggregate(pOp->p4.p, space, aMem, &is_done) != 0)
+		goto abort_due_to_error;
+	if (is_done)
+		goto jump_to_p2;
+	break;
+}
+
 /**
  * Opcode: CreateForeignKey P1 * * P4 *
  *
@@ -2435,8 +2549,8 @@ case OP_TTransaction: {
  */
 case OP_IteratorOpen: {
 	struct VdbeCursor *cur = p->apCsr[pOp->p1];
-	if (box_schema_version() != p->schema_ver &&
-	    (pOp->p5 & OPFLAG_SYSTEMSP) == 0) {
+	if ((pOp->p5 & OPFLAG_SYSTEMSP) == 0 &&
+	    !sql_stmt_schema_is_valid(p)) {
 		p->expired = 1;
 		diag_set(ClientError, ER_SQL_EXECUTE, "schema version has "\
 			 "changed: need to re-compile SQL statement");
@@ -2577,6 +2691,101 @@ case OP_OpenPseudo: {
 	break;
 }
 
+/* Opcode: HashOpen P1 P2 * P4 *
+ * Synopsis: key=P2 fields
+ *
+ * Open cursor P1 on a new empty hash table for a hash join. The
+ * records of the table are described by the sql_space_info in P4
+ * and are keyed by their first P2 fields. If the table outgrows
+ * its memory limit, the records are moved to an ephemeral space
+ * created from P4 too.
+ *
+ * The OP_Column opcode reads the record the cursor was positioned
+ * at by the last OP_HashSeek or OP_HashNext.
+ */
+case OP_HashOpen: {
+	assert(pOp->p1 >= 0);
+	assert(pOp->p4type == P4_DYNAMIC);
+	struct sql_space_info *info = pOp->p4.space_info;
+	struct vdbe_hash *hash = vdbe_hash_new(info, pOp->p2);
+	if (hash == NULL)
+		goto abort_due_to_error;
+	struct VdbeCursor *cur = allocateCursor(p, pOp->p1, info->field_count,
+						CURTYPE_HASH);
+	cur->uc.hash = hash;
+	cur->nullRow = 1;
+	break;
+}
+
+/* Opcode: HashInsert P1 P2 * * *
+ * Synopsis: key=r[P2]
+ *
+ * Register P2 holds a record made by the MakeRecord opcode. Add it
+ * to the hash table of cursor P1.
+ */
+case OP_HashInsert: {
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	struct VdbeCursor *cur = p->apCsr[pOp->p1];
+	assert(cur->eCurType == CURTYPE_HASH);
+	struct Mem *rec = &aMem[pOp->p2];
+	assert(mem_is_bin(rec));
+	if (vdbe_hash_insert(cur->uc.hash, rec->z, rec->n) != 0)
+		goto abort_due_to_error;
+	break;
+}
+
+/* Opcode: HashSeek P1 P2 P3 P4 *
+ * Synopsis: key=r[P3@P4]
+ *
+ * Position hash cursor P1 at the first record whose key is equal
+ * to the P4 registers starting at P3. If there is no such record,
+ * jump to P2.
+ */
+case OP_HashSeek: {       /* jump */
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	struct VdbeCursor *cur = p->apCsr[pOp->p1];
+	assert(cur->eCurType == CURTYPE_HASH);
+	assert(pOp->p4type == P4_INT32);
+	uint32_t len = pOp->p4.i;
+	struct Mem *mems = &aMem[pOp->p3];
+	cur->nullRow = 1;
+	cur->cacheStatus = CACHE_STALE;
+	for (uint32_t i = 0; i < len; ++i) {
+		enum field_type type = vdbe_hash_field_type(cur->uc.hash, i);
+		struct Mem *mem = &mems[i];
+		if (mem_is_field_compatible(mem, type))
+			continue;
+		if (!sql_type_is_numeric(type) || !mem_is_num(mem)) {
+			diag_set(ClientError, ER_SQL_TYPE_MISMATCH,
+				 mem_str(mem), field_type_strs[type]);
+			goto abort_due_to_error;
+		}
+		/* Nothing is equal to a value that can't be converted. */
+		if (mem_cast_implicit_number(mem, type) != 0)
+			goto jump_to_p2;
+	}
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	uint32_t size;
+	const char *key = mem_encode_array(mems, len, &size, region);
+	if (key == NULL)
+		goto abort_due_to_error;
+	const char *key_end = key + size;
+	mp_decode_array(&key);
+	bool is_found;
+	int rc = vdbe_hash_seek(cur->uc.hash, key, key_end - key, &is_found);
+	region_truncate(region, svp);
+	if (rc != 0)
+		goto abort_due_to_error;
+#ifdef SQL_TEST
+	sql_search_count++;
+#endif
+	if (!is_found)
+		goto jump_to_p2;
+	cur->nullRow = 0;
+	break;
+}
+
 /* Opcode: Close P1 * * * *
  *
  * Close a cursor previously opened as P1.  If P1 is not
@@ -3443,6 +3652,12 @@ case OP_Rewind: {        /* jump */
  * invoked.  This opcode advances the cursor to the next sorted
  * record, or jumps to P2 if there are no more sorted records.
  */
+/* Opcode: HashNext P1 P2 * * *
+ *
+ * Advance hash cursor P1 to the next record matching the key of
+ * the last OP_HashSeek and jump to P2. Fall through if there are
+ * no more matching records.
+ */
 case OP_SorterNext: {  /* jump */
 	VdbeCursor *pC;
 	int res;
@@ -3453,6 +3668,15 @@ case OP_SorterNext: {  /* jump */
 	if (sqlVdbeSorterNext(pC, &res) != 0)
 		goto abort_due_to_error;
 	goto next_tail;
+case OP_HashNext: {    /* jump */
+	pC = p->apCsr[pOp->p1];
+	assert(pC->eCurType == CURTYPE_HASH);
+	bool is_found;
+	if (vdbe_hash_next(pC->uc.hash, &is_found) != 0)
+		goto abort_due_to_error;
+	res = is_found ? 0 : 1;
+	goto next_tail;
+}
 case OP_PrevIfOpen:    /* jump */
 case OP_NextIfOpen:    /* jump */
 	if (p->apCsr[pOp->p1]==0) break;
@@ -4514,6 +4738,8 @@ default: {          /* This is really OP_Noop and OP_Explain */
 	/* This is the only way out of this procedure. */
 vdbe_return:
 	assert(rc == 0 || rc == -1 || rc == SQL_ROW || rc == SQL_DONE);
+	if (stat_pc >= 0)
+		op_stat[stat_pc].time += clock_monotonic64() - stat_start;
 	return rc;
 
 	/* Jump to here if a string or blob larger than SQL_MAX_LENGTH
@@ -116,6 +116,92 @@ struct SubProgram {
 	SubProgram *pNext;	/* Next sub-program already visited */
 };
 
+enum {
+	/** Max number of columns read by OP_VecAggregate. */
+	VDBE_VEC_COLUMN_MAX = 8,
+	/** Max number of filters applied by OP_VecAggregate. */
+	VDBE_VEC_FILTER_MAX = 8,
+	/** Max number of aggregates computed by OP_VecAggregate. */
+	VDBE_VEC_AGG_MAX = 8,
+};
+
+/** Type of column values decoded by OP_VecAggregate. */
+enum vdbe_vec_type {
+	/** Only the NULL flag is decoded. */
+	VDBE_VEC_ANY,
+	/** 64-bit signed integers. */
+	VDBE_VEC_INT,
+	/** Double precision floating point numbers. */
+	VDBE_VEC_DOUBLE,
+};
+
+/** Aggregate functions supported by OP_VecAggregate. */
+enum vdbe_vec_agg_type {
+	VDBE_VEC_COUNT,
+	VDBE_VEC_SUM,
+	VDBE_VEC_TOTAL,
+	VDBE_VEC_AVG,
+	VDBE_VEC_MIN,
+	VDBE_VEC_MAX,
+};
+
+/** Bits of vdbe_vec_filter::mask. */
+enum {
+	VDBE_VEC_LT = 1 << 0,
+	VDBE_VEC_EQ = 1 << 1,
+	VDBE_VEC_GT = 1 << 2,
+};
+
+/** Comparison of a column with a value: "column <op> r[reg]". */
+struct vdbe_vec_filter {
+	/** Index of the column in vdbe_vec_plan::columns. */
+	uint32_t column;
+	/**
+	 * Comparison results that pass the filter, a combination
+	 * of VDBE_VEC_LT, VDBE_VEC_EQ and VDBE_VEC_GT.
+	 */
+	uint8_t mask;
+	/** Register holding the value the column is compared with. */
+	int reg;
+};
+
+/** Aggregate function computed by OP_VecAggregate. */
+struct vdbe_vec_agg {
+	enum vdbe_vec_agg_type type;
+	/**
+	 * Index of the argument in vdbe_vec_plan::columns or -1
+	 * for COUNT(*).
+	 */
+	int column;
+	/** Register to store the result to. */
+	int reg;
+};
+
+/**
+ * Plan of OP_VecAggregate: aggregates over a full scan of an
+ * index filtered by a conjunction of comparisons.
+ */
+struct vdbe_vec_plan {
+	/** Id of the index to scan or UINT32_MAX. */
+	uint32_t index_id;
+	/**
+	 * Id of a TREE index starting with the only filtered
+	 * column if all aggregates are counts of rows, so they can
+	 * be answered by counting the index range, or UINT32_MAX.
+	 */
+	uint32_t count_index_id;
+	uint32_t column_count;
+	struct {
+		/** Number of the field in the tuple. */
+		uint32_t fieldno;
+		enum vdbe_vec_type type;
+	} columns[VDBE_VEC_COLUMN_MAX];
+	uint32_t filter_count;
+	struct vdbe_vec_filter filters[VDBE_VEC_FILTER_MAX];
+	uint32_t agg_count;
+	struct vdbe_vec_agg aggs[VDBE_VEC_AGG_MAX];
+};
+
 /*
  * Allowed values of VdbeOp.p4type
  */
@@ -141,6 +227,8 @@ struct SubProgram {
 #define P4_BOOL     (-17)	/* P4 is a bool value */
 #define P4_PTR      (-18)	/* P4 is a generic pointer */
 #define P4_KEYINFO  (-19)       /* P4 is a pointer to sql_key_info structure. */
+/** P4 is a pointer to vdbe_vec_plan structure. */
+#define P4_VECPLAN  (-20)
 
 /* Error message codes for OP_Halt */
 #define P5_ConstraintNotNull 1
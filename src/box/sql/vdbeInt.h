@@ -60,6 +60,7 @@ typedef struct VdbeSorter VdbeSorter;
 #define CURTYPE_TARANTOOL   0
 #define CURTYPE_SORTER      1
 #define CURTYPE_PSEUDO      2
+#define CURTYPE_HASH        3
 
 /*
  * A VdbeCursor is an superclass (a wrapper) for various cursor objects:
@@ -68,6 +69,7 @@ typedef struct VdbeSorter VdbeSorter;
  *          -  On either an ephemeral or ordinary space
  *      * A sorter
  *      * A one-row "pseudotable" stored in a single register
+ *      * A hash table built for a hash join
  */
 typedef struct VdbeCursor VdbeCursor;
 struct VdbeCursor {
@@ -99,6 +101,7 @@ struct VdbeCursor {
 		BtCursor *pCursor;	/* CURTYPE_TARANTOOL */
 		int pseudoTableReg;	/* CURTYPE_PSEUDO. Reg holding content. */
 		VdbeSorter *pSorter;	/* CURTYPE_SORTER. Sorter object */
+		struct vdbe_hash *hash;	/* CURTYPE_HASH. Hash table */
 	} uc;
 	/** Info about keys needed by index cursors. */
 	struct key_def *key_def;
@@ -215,6 +218,17 @@ struct sql_column_metadata {
 	char *span;
 };
 
+/** Execution statistics of an instruction of a VDBE program. */
+struct vdbe_op_stat {
+	/** Number of times the instruction was executed. */
+	uint64_t count;
+	/**
+	 * Time spent executing the instruction, in nanoseconds.
+	 * Time spent in sub-programs is accounted to OP_Program.
+	 */
+	uint64_t time;
+};
+
 /*
  * An instance of the virtual machine.  This structure contains the complete
  * state of the virtual machine.
@@ -302,6 +316,48 @@ struct Vdbe {
 	SubProgram *pProgram;	/* Linked list of all sub-programs used by VM */
 	/** Parser flags with which this object was built. */
 	uint32_t sql_flags;
+	/**
+	 * Value of space_cache_version at the moment the statement
+	 * was compiled. If has_space_deps is set, the statement is
+	 * valid as long as none of the spaces in space_deps is
+	 * changed after that.
+	 */
+	uint32_t space_cache_ver;
+	/**
+	 * Values of coll_id_cache_version and func_cache_version
+	 * at the moment the statement was compiled. The compiled
+	 * code refers to collations and function signatures, so
+	 * the statement expires if either changes.
+	 */
+	uint32_t coll_cache_ver;
+	uint32_t func_cache_ver;
+	bool has_space_deps;
+	/** Ids of the spaces the statement refers to. */
+	uint32_t *space_deps;
+	/** Number of entries in space_deps. */
+	uint32_t space_dep_count;
+	/** Parameters the query plan depends on. */
+	struct sql_param_dep *param_deps;
+	/** Number of entries in param_deps. */
+	uint32_t param_dep_count;
+	/** Parameters used as LIKE patterns. */
+	struct sql_like_dep *like_deps;
+	/** Number of entries in like_deps. */
+	uint32_t like_dep_count;
+	/**
+	 * Number of times the statement was started, up to
+	 * SQL_VDBE_FUSE_THRESHOLD, when its program is fused.
+	 */
+	uint32_t exec_count;
+	/**
+	 * Statistics of the instructions of the program, one entry
+	 * per instruction. Allocated on the first profiled run.
+	 */
+	struct vdbe_op_stat *op_stat;
+	/** True if the current run of the program is profiled. */
+	bool is_profiled;
+	/** Time when the profiled run was started. */
+	int64_t profile_start;
 	/* Anonymous savepoint for aborts only */
 	struct txn_savepoint *anonymous_savepoint;
 };
@@ -329,8 +385,50 @@ void sqlVdbePrintOp(FILE *, int, Op *);
 #endif
 
 int sqlVdbeExec(Vdbe *);
+
+enum {
+	/**
+	 * Number of executions after which a statement is
+	 * considered hot and its program is fused.
+	 */
+	SQL_VDBE_FUSE_THRESHOLD = 64,
+	/**
+	 * If the sql_profile session setting is enabled, one of
+	 * this many statement runs is profiled.
+	 */
+	SQL_PROFILE_SAMPLE_PERIOD = 100,
+	/** Number of the hottest instructions a slow run logs. */
+	SQL_PROFILE_LOG_OPS = 5,
+};
+
+/**
+ * Replace frequent sequences of opcodes of a hot statement with
+ * superinstructions which execute the whole sequence without going
+ * back to the dispatch switch: a run of OP_Column on the same cursor
+ * becomes OP_ColumnRun, and OP_Column followed by a comparison
+ * becomes OP_ColumnCompare. The rest of the sequence is left in
+ * place, so jumps into the middle of it are still valid.
+ */
+void
+sqlVdbeFuse(struct Vdbe *p);
 int sqlVdbeList(Vdbe *);
 
+/**
+ * Clear the statistics of the instructions and make the next
+ * run of the program collect them.
+ */
+void
+sqlVdbeProfileStart(struct Vdbe *p);
+
+/**
+ * Run the program of EXPLAIN ANALYZE statement with profiling
+ * enabled, discarding the rows it produces, and prepare the VDBE
+ * to list the program along with the statistics. Returns -1 if
+ * the run failed.
+ */
+int
+sqlVdbeAnalyze(struct Vdbe *p);
+
 int sqlVdbeHalt(Vdbe *);
 
 const char *sqlOpcodeName(int);
@@ -378,6 +476,86 @@ int sqlVdbeSorterRewind(const VdbeCursor *, int *);
 int sqlVdbeSorterWrite(const VdbeCursor *, Mem *);
 int sqlVdbeSorterCompare(const VdbeCursor *, Mem *, int, int *);
 
+struct space;
+
+/**
+ * Compute the aggregates described by the plan over a full scan
+ * of an index of the given space, processing tuples in batches.
+ * If the plan has count_index_id, the counts are taken from the
+ * index range instead. On success the results are stored to the
+ * registers specified by the plan and is_done is set. If the
+ * space contents can't be handled by the batch loops (e.g. an
+ * integer sum overflows or a comparison needs type conversion),
+ * is_done is left unset and the caller should fall back on
+ * row-at-a-time execution.
+ *
+ * @param plan Description of the aggregates and filters.
+ * @param space Space to scan.
+ * @param mems VDBE registers.
+ * @param[out] is_done Set if the results were computed.
+ * @retval 0 Success.
+ * @retval -1 Error, diag is set.
+ */
+int
+vdbe_vec_aggregate(const struct vdbe_vec_plan *plan, struct space *space,
+		   struct Mem *mems, bool *is_done);
+
+struct sql_space_info;
+struct vdbe_hash;
+
+/**
+ * Create a hash table for records described by info, keyed by
+ * their first key_part_count fields.
+ *
+ * @retval NULL Error, diag is set.
+ */
+struct vdbe_hash *
+vdbe_hash_new(const struct sql_space_info *info, uint32_t key_part_count);
+
+/** Destroy a hash table. */
+void
+vdbe_hash_delete(struct vdbe_hash *hash);
+
+/**
+ * Insert a record to a hash table. Records with a NULL key field
+ * are skipped, because they can't be equal to any probe key.
+ * Must not be called after the first vdbe_hash_seek().
+ *
+ * @param hash Hash table.
+ * @param data MsgPack array of the record fields.
+ * @param size Size of the record.
+ * @retval 0 Success.
+ * @retval -1 Error, diag is set.
+ */
+int
+vdbe_hash_insert(struct vdbe_hash *hash, const char *data, uint32_t size);
+
+/**
+ * Position a hash table at the first record matching the key.
+ *
+ * @param hash Hash table.
+ * @param key Key fields without the MsgPack array header.
+ * @param size Size of the key.
+ * @param[out] is_found Set if a matching record was found.
+ * @retval 0 Success.
+ * @retval -1 Error, diag is set.
+ */
+int
+vdbe_hash_seek(struct vdbe_hash *hash, const char *key, uint32_t size,
+	       bool *is_found);
+
+/** Advance a hash table to the next record matching the key. */
+int
+vdbe_hash_next(struct vdbe_hash *hash, bool *is_found);
+
+/** Return the record a hash table is positioned at. */
+const char *
+vdbe_hash_record(struct vdbe_hash *hash, uint32_t *size);
+
+/** Return the type of a field of the records of a hash table. */
+enum field_type
+vdbe_hash_field_type(const struct vdbe_hash *hash, uint32_t fieldno);
+
 int sqlVdbeMemTranslate(Mem *, u8);
 #ifdef SQL_DEBUG
 void sqlVdbePrintSql(Vdbe *);
@@ -37,7 +37,14 @@
 #include "sqlInt.h"
 #include "mem.h"
 #include "vdbeInt.h"
+#include "box/coll_id_cache.h"
+#include "box/func_cache.h"
+#include "box/index.h"
+#include "box/schema.h"
 #include "box/session.h"
+#include "box/txn.h"
+#include "clock.h"
+#include "say.h"
 
 /*
  * Invoke the profile callback.  This routine is only called if we already
@@ -65,6 +72,63 @@ invokeProfileCallback(struct Vdbe *p)
 	p->startTime = 0;
 }
 
+/**
+ * Number of statement runs since the last profiled one. Only the
+ * runs made with the sql_profile session setting are counted.
+ */
+static uint32_t sql_profile_skipped;
+
+/** Check if the run of a statement that is starting is profiled. */
+static inline bool
+vdbe_profile_is_sampled(void)
+{
+	if ((current_session()->sql_flags & SQL_Profile) == 0)
+		return false;
+	if (++sql_profile_skipped < SQL_PROFILE_SAMPLE_PERIOD)
+		return false;
+	sql_profile_skipped = 0;
+	return true;
+}
+
+/**
+ * Finish the profiled run of the statement. If it took longer than
+ * too_long_threshold, log the statement and its instructions that
+ * took the most time.
+ */
+static void
+vdbe_profile_stop(struct Vdbe *p)
+{
+	assert(p->is_profiled);
+	p->is_profiled = false;
+	double elapsed = (clock_monotonic64() - p->profile_start) / 1e9;
+	if (elapsed < too_long_threshold)
+		return;
+	int hot[SQL_PROFILE_LOG_OPS];
+	int hot_count = 0;
+	for (int i = 0; i < p->nOp; i++) {
+		uint64_t time = p->op_stat[i].time;
+		if (time == 0)
+			continue;
+		int j = hot_count;
+		if (hot_count < SQL_PROFILE_LOG_OPS)
+			hot_count++;
+		for (; j > 0 && p->op_stat[hot[j - 1]].time < time; j--) {
+			if (j < SQL_PROFILE_LOG_OPS)
+				hot[j] = hot[j - 1];
+		}
+		if (j < SQL_PROFILE_LOG_OPS)
+			hot[j] = i;
+	}
+	say_warn("too long SQL statement: %.3f sec: %s", elapsed,
+		 p->zSql != NULL ? p->zSql : "");
+	for (int i = 0; i < hot_count; i++) {
+		struct vdbe_op_stat *stat = &p->op_stat[hot[i]];
+		say_warn("  %d %s: %llu times, %.6f sec", hot[i],
+			 sqlOpcodeName(p->aOp[hot[i]].opcode),
+			 (unsigned long long)stat->count, stat->time / 1e9);
+	}
+}
+
 int
 sql_stmt_finalize(struct Vdbe *v)
 {
@@ -125,6 +189,17 @@ sqlStep(Vdbe * p)
 
 		db->nVdbeActive++;
 		p->pc = 0;
+		if (!p->explain &&
+		    p->exec_count < SQL_VDBE_FUSE_THRESHOLD &&
+		    ++p->exec_count == SQL_VDBE_FUSE_THRESHOLD)
+			sqlVdbeFuse(p);
+		p->is_profiled = false;
+		if (p->explain == 3) {
+			if (sqlVdbeAnalyze(p) != 0)
+				return -1;
+		} else if (!p->explain && vdbe_profile_is_sampled()) {
+			sqlVdbeProfileStart(p);
+		}
 	}
 	if (p->explain) {
 		rc = sqlVdbeList(p);
@@ -137,6 +212,8 @@ sqlStep(Vdbe * p)
 	/* If the statement completed successfully, invoke the profile callback */
 	if (rc != SQL_ROW && p->startTime > 0)
 		invokeProfileCallback(p);
+	if (rc != SQL_ROW && p->is_profiled)
+		vdbe_profile_stop(p);
 
 	if (rc != SQL_ROW && rc != SQL_DONE) {
 		/* If this statement was prepared using sql_prepare(), and an
@@ -224,6 +301,88 @@ sql_stmt_schema_version(const struct Vdbe *v)
 	return v->schema_ver;
 }
 
+bool
+sql_stmt_schema_is_valid(struct Vdbe *v)
+{
+	/*
+	 * Collations and functions aren't tracked per statement,
+	 * and their changes don't bump the schema version.
+	 */
+	if (v->coll_cache_ver != coll_id_cache_version ||
+	    v->func_cache_ver != func_cache_version)
+		return false;
+	uint64_t schema_ver = box_schema_version();
+	if (v->schema_ver == schema_ver)
+		return true;
+	if (!v->has_space_deps)
+		return false;
+	for (uint32_t i = 0; i < v->space_dep_count; i++) {
+		struct space *space = space_by_id(v->space_deps[i]);
+		if (space == NULL || space->cache_version > v->space_cache_ver)
+			return false;
+	}
+	/* Don't check the spaces again until the next schema change. */
+	v->schema_ver = schema_ver;
+	return true;
+}
+
+enum {
+	/**
+	 * A statement is recompiled if the estimated fraction of
+	 * tuples less or greater than a bound value differs from
+	 * the one the plan was chosen for by more than this factor.
+	 */
+	SQL_REOPTIMIZE_RATIO = 4,
+};
+
+/** Check if two estimates of a bound value position differ much. */
+static bool
+sql_param_pos_differ(double a, double b)
+{
+	return a > b * SQL_REOPTIMIZE_RATIO || b > a * SQL_REOPTIMIZE_RATIO ||
+	       1 - a > (1 - b) * SQL_REOPTIMIZE_RATIO ||
+	       1 - b > (1 - a) * SQL_REOPTIMIZE_RATIO;
+}
+
+int
+sql_stmt_reoptimize(struct Vdbe *v)
+{
+	for (uint32_t i = 0; i < v->like_dep_count; i++) {
+		const struct sql_like_dep *dep = &v->like_deps[i];
+		assert(dep->var > 0 && (int)dep->var <= v->nVar);
+		const struct Mem *value = &v->aVar[dep->var - 1];
+		uint32_t len;
+		bool is_complete;
+		if (!mem_is_str(value) ||
+		    !sql_like_prefix(value->z, value->n, &len, &is_complete) ||
+		    len != dep->prefix_len || is_complete != dep->is_complete ||
+		    memcmp(value->z, dep->prefix, len) != 0)
+			return sqlReprepare(v);
+	}
+	for (uint32_t i = 0; i < v->param_dep_count; i++) {
+		const struct sql_param_dep *dep = &v->param_deps[i];
+		assert(dep->var > 0 && (int)dep->var <= v->nVar);
+		const struct Mem *value = &v->aVar[dep->var - 1];
+		if (mem_is_null(value))
+			continue;
+		struct space *space = space_by_id(dep->space_id);
+		if (space == NULL)
+			continue;
+		struct index *index = space_index(space, dep->index_id);
+		struct sql_index_stat stat;
+		if (index == NULL || !sql_index_stat_get(index->def, &stat) ||
+		    stat.bound_count == 0)
+			continue;
+		const struct key_part *part = &index->def->key_def->parts[0];
+		double pos;
+		if (sql_index_stat_pos(&stat, part->coll, value, &pos) != 0)
+			continue;
+		if (dep->pos < 0 || sql_param_pos_differ(dep->pos, pos))
+			return sqlReprepare(v);
+	}
+	return 0;
+}
+
 static size_t
 sql_metadata_size(const struct sql_column_metadata *metadata)
 {
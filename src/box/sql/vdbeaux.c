@@ -33,8 +33,11 @@
  * This file contains code used for creating, destroying, and populating
  * a VDBE (or an "sql_stmt" as it is known to the outside world.)
  */
+#include "clock.h"
 #include "fiber.h"
 #include "coll/coll.h"
+#include "box/coll_id_cache.h"
+#include "box/func_cache.h"
 #include "box/session.h"
 #include "box/schema.h"
 #include "box/tuple_format.h"
@@ -68,6 +71,9 @@ sqlVdbeCreate(Parse * pParse)
 	p->magic = VDBE_MAGIC_INIT;
 	p->pParse = pParse;
 	p->schema_ver = box_schema_version();
+	p->space_cache_ver = space_cache_version;
+	p->coll_cache_ver = coll_id_cache_version;
+	p->func_cache_ver = func_cache_version;
 	assert(pParse->aLabel == 0);
 	assert(pParse->nLabel == 0);
 	assert(pParse->nOpAlloc == 0);
@@ -583,6 +589,7 @@ freeP4(int p4type, void *p4)
 	case P4_INT64:
 	case P4_UINT64:
 	case P4_DYNAMIC:
+	case P4_VECPLAN:
 	case P4_INTARRAY:{
 			sql_xfree(p4);
 			break;
@@ -1039,6 +1046,17 @@ displayP4(Op * pOp, char *zTemp, int nTemp)
 			sqlXPrintf(&x, "program");
 			break;
 		}
+	case P4_VECPLAN:{
+			const struct vdbe_vec_plan *plan = pOp->p4.p;
+			sqlXPrintf(&x, "index=%u,filters=%u,aggs=%u",
+				   plan->index_id, plan->filter_count,
+				   plan->agg_count);
+			if (plan->count_index_id != UINT32_MAX) {
+				sqlXPrintf(&x, ",count_index=%u",
+					   plan->count_index_id);
+			}
+			break;
+		}
 	case P4_ADVANCE:{
 			zTemp[0] = 0;
 			break;
@@ -1118,6 +1136,11 @@ sqlVdbeFrameDelete(VdbeFrame * p)
  *
  * When p->explain==1, first the main program is listed, then each of
  * the trigger subprograms are listed one by one.
+ *
+ * When p->explain==3, the program has already been run by
+ * sqlVdbeAnalyze() and the instructions of the main program are
+ * listed along with the number of times each was executed and the
+ * time spent in it. This is used to implement EXPLAIN ANALYZE.
  */
 int
 sqlVdbeList(Vdbe * p)
@@ -1192,7 +1215,7 @@ sqlVdbeList(Vdbe * p)
 			}
 			pOp = &apSub[j]->aOp[i];
 		}
-		if (p->explain == 1) {
+		if (p->explain != 2) {
 			assert(i >= 0);
 			mem_set_uint(pMem, i);
 
@@ -1201,7 +1224,8 @@ sqlVdbeList(Vdbe * p)
 			char *value = (char *)sqlOpcodeName(pOp->opcode);
 			mem_set_str0_static(pMem, value);
 			pMem++;
-
+		}
+		if (p->explain == 1) {
 			/* When an OP_Program opcode is encounter (the only opcode that has
 			 * a P4_SUBPROGRAM argument), expand the size of the array of subprograms
 			 * kept in p->aMem[9].z to hold the new program - assuming this subprogram
@@ -1258,15 +1282,56 @@ sqlVdbeList(Vdbe * p)
 #else
 			mem_set_null(pMem);
 #endif
+		} else if (p->explain == 3) {
+			struct vdbe_op_stat *stat = &p->op_stat[i];
+			mem_set_uint(pMem, stat->count);
+			pMem++;
+			mem_set_uint(pMem, stat->time);
 		}
 
-		p->nResColumn = 8 - 4 * (p->explain - 1);
+		p->nResColumn = p->explain == 2 ? 4 : 8;
 		p->pResultSet = &p->aMem[1];
 		rc = SQL_ROW;
 	}
 	return rc;
 }
 
+void
+sqlVdbeProfileStart(struct Vdbe *p)
+{
+	size_t size = p->nOp * sizeof(p->op_stat[0]);
+	if (p->op_stat == NULL)
+		p->op_stat = sql_xmalloc(size);
+	memset(p->op_stat, 0, size);
+	p->is_profiled = true;
+	p->profile_start = clock_monotonic64();
+}
+
+int
+sqlVdbeAnalyze(struct Vdbe *p)
+{
+	assert(p->explain == 3);
+	assert(p->magic == VDBE_MAGIC_RUN && p->pc == 0);
+	sqlVdbeProfileStart(p);
+	p->explain = 0;
+	int rc;
+	while ((rc = sqlVdbeExec(p)) == SQL_ROW)
+		;
+	p->explain = 3;
+	p->is_profiled = false;
+	if (rc != SQL_DONE)
+		return -1;
+	/*
+	 * The program has been halted, restart the VDBE to list
+	 * it. It is halted once again when the listing is over.
+	 */
+	assert(p->magic == VDBE_MAGIC_HALT);
+	p->magic = VDBE_MAGIC_RUN;
+	p->pc = 0;
+	sql_get()->nVdbeActive++;
+	return 0;
+}
+
 #ifdef SQL_DEBUG
 /*
  * Print the SQL that was used to generate a VDBE program.
@@ -1451,6 +1516,19 @@ sqlVdbeMakeReady(Vdbe * p,	/* The VDBE */
 
 	p->pVList = pParse->pVList;
 	pParse->pVList = 0;
+	p->has_space_deps = pParse->has_space_deps;
+	p->space_deps = pParse->space_deps;
+	p->space_dep_count = pParse->space_dep_count;
+	pParse->space_deps = NULL;
+	pParse->space_dep_count = 0;
+	p->param_deps = pParse->param_deps;
+	p->param_dep_count = pParse->param_dep_count;
+	pParse->param_deps = NULL;
+	pParse->param_dep_count = 0;
+	p->like_deps = pParse->like_deps;
+	p->like_dep_count = pParse->like_dep_count;
+	pParse->like_deps = NULL;
+	pParse->like_dep_count = 0;
 	p->explain = pParse->explain;
 	p->nCursor = nCursor;
 	p->nVar = nVar;
@@ -1465,6 +1543,40 @@ sqlVdbeMakeReady(Vdbe * p,	/* The VDBE */
 	sqlVdbeRewind(p);
 }
 
+/** Check if the opcode is a comparison which OP_ColumnCompare runs. */
+static inline bool
+vdbe_op_is_compare(int opcode)
+{
+	return opcode == OP_Eq || opcode == OP_Ne || opcode == OP_Lt ||
+	       opcode == OP_Le || opcode == OP_Gt || opcode == OP_Ge;
+}
+
+void
+sqlVdbeFuse(struct Vdbe *p)
+{
+	assert(p->explain == 0);
+	struct VdbeOp *ops = p->aOp;
+	int i = 0;
+	while (i < p->nOp) {
+		if (ops[i].opcode != OP_Column) {
+			i++;
+			continue;
+		}
+		int end = i + 1;
+		while (end < p->nOp && ops[end].opcode == OP_Column &&
+		       ops[end].p1 == ops[i].p1)
+			end++;
+		int next = end;
+		if (end < p->nOp && vdbe_op_is_compare(ops[end].opcode)) {
+			ops[--end].opcode = OP_ColumnCompare;
+			next++;
+		}
+		if (end - i > 1)
+			ops[i].opcode = OP_ColumnRun;
+		i = next;
+	}
+}
+
 void
 sqlVdbeFreeCursor(struct VdbeCursor *pCx)
 {
@@ -1481,6 +1593,9 @@ sqlVdbeFreeCursor(struct VdbeCursor *pCx)
 		sql_cursor_close(pCx->uc.pCursor);
 			break;
 		}
+	case CURTYPE_HASH:
+		vdbe_hash_delete(pCx->uc.hash);
+		break;
 	}
 }
 
@@ -1985,6 +2100,10 @@ sqlVdbeClearObject(struct Vdbe *p)
 	}
 	vdbeFreeOpArray(p->aOp, p->nOp);
 	sql_xfree(p->zSql);
+	sql_xfree(p->space_deps);
+	sql_xfree(p->param_deps);
+	sql_like_deps_delete(p->like_deps, p->like_dep_count);
+	sql_xfree(p->op_stat);
 }
 
 /*
@@ -0,0 +1,400 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+/*
+ * In-memory hash table used by the hash join.
+ *
+ * The build phase stores the records produced from the inner table
+ * in a chained hash table keyed by the leading key_part_count
+ * fields, the probe phase walks the chain of the bucket the probe
+ * key falls into. Records are copied to a region, so the build
+ * does a single allocation and no comparisons per row.
+ *
+ * Once the table grows over VDBE_HASH_MEMORY_MAX bytes, it spills
+ * all the records to an ephemeral space and the rest of the build
+ * and all the probes are served by the tree index of that space.
+ */
+#include "box/index.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "sqlInt.h"
+#include "tarantoolInt.h"
+#include "vdbeInt.h"
+
+#include "errinj.h"
+#include "fiber.h"
+#include "msgpuck/msgpuck.h"
+#include "small/region.h"
+
+enum {
+	/** Hash table size limit, in bytes. */
+	VDBE_HASH_MEMORY_MAX = 64 * 1024 * 1024,
+	/** Initial number of buckets. */
+	VDBE_HASH_BUCKET_COUNT_MIN = 1024,
+};
+
+/** A record stored in the hash table. */
+struct vdbe_hash_entry {
+	/** Next entry in the same bucket. */
+	struct vdbe_hash_entry *next;
+	/** Hash of the key of the record. */
+	uint32_t hash;
+	/** Size of the record. */
+	uint32_t size;
+	/** MsgPack array of the record fields. */
+	char data[0];
+};
+
+struct vdbe_hash {
+	/** Definition of the fields the hash table is keyed by. */
+	struct key_def *key_def;
+	/** Description of the records, used to spill them. */
+	const struct sql_space_info *info;
+	/** Memory the entries are allocated from. */
+	struct region region;
+	/** Array of bucket_mask + 1 chains of entries. */
+	struct vdbe_hash_entry **buckets;
+	uint32_t bucket_mask;
+	/** Number of entries in the table. */
+	uint32_t count;
+	/** Memory limit after which the table is spilled. */
+	size_t memory_max;
+	/**
+	 * Set once the chains are reversed to keep records with
+	 * equal keys in the order they were inserted.
+	 */
+	bool is_sealed;
+	/** Probe key, without the MsgPack array header. */
+	char *key;
+	uint32_t key_size;
+	uint32_t key_hash;
+	/** Entry the hash is positioned at. */
+	struct vdbe_hash_entry *entry;
+	/** Ephemeral space the records were spilled to, or NULL. */
+	struct space *space;
+	/** Iterator over the spilled records and its current tuple. */
+	struct iterator *it;
+	struct tuple *tuple;
+	/** Row id generator for the spilled records. */
+	uint64_t rowid;
+};
+
+struct vdbe_hash *
+vdbe_hash_new(const struct sql_space_info *info, uint32_t key_part_count)
+{
+	assert(key_part_count > 0 && key_part_count < info->field_count);
+	struct region *gc = &fiber()->gc;
+	size_t svp = region_used(gc);
+	struct key_part_def *parts = xregion_alloc_array(gc, typeof(parts[0]),
+							 key_part_count);
+	for (uint32_t i = 0; i < key_part_count; i++) {
+		parts[i] = key_part_def_default;
+		parts[i].fieldno = i;
+		parts[i].type = info->types[i];
+		parts[i].coll_id = info->coll_ids[i];
+		parts[i].is_nullable = true;
+	}
+	struct key_def *key_def = key_def_new(parts, key_part_count, 0);
+	region_truncate(gc, svp);
+	if (key_def == NULL)
+		return NULL;
+	struct vdbe_hash *hash = xcalloc(1, sizeof(*hash));
+	hash->key_def = key_def;
+	hash->info = info;
+	region_create(&hash->region, &cord()->slabc);
+	hash->bucket_mask = VDBE_HASH_BUCKET_COUNT_MIN - 1;
+	hash->buckets = xcalloc(VDBE_HASH_BUCKET_COUNT_MIN,
+				sizeof(hash->buckets[0]));
+	hash->memory_max = VDBE_HASH_MEMORY_MAX;
+	struct errinj *inj = errinj(ERRINJ_SQL_HASH_JOIN_MEMORY, ERRINJ_INT);
+	if (inj != NULL && inj->iparam >= 0)
+		hash->memory_max = inj->iparam;
+	return hash;
+}
+
+/** Release the tuple and the iterator over the spilled records. */
+static void
+vdbe_hash_iterator_close(struct vdbe_hash *hash)
+{
+	if (hash->tuple != NULL) {
+		tuple_unref(hash->tuple);
+		hash->tuple = NULL;
+	}
+	if (hash->it != NULL) {
+		iterator_delete(hash->it);
+		hash->it = NULL;
+	}
+}
+
+void
+vdbe_hash_delete(struct vdbe_hash *hash)
+{
+	vdbe_hash_iterator_close(hash);
+	if (hash->space != NULL)
+		space_delete(hash->space);
+	region_destroy(&hash->region);
+	free(hash->buckets);
+	free(hash->key);
+	key_def_delete(hash->key_def);
+	free(hash);
+}
+
+/** Memory used by the hash table. */
+static size_t
+vdbe_hash_memory(struct vdbe_hash *hash)
+{
+	return region_used(&hash->region) +
+	       (hash->bucket_mask + 1) * sizeof(hash->buckets[0]);
+}
+
+/**
+ * Double the number of buckets. Each chain is split in two with
+ * the order of its entries preserved.
+ */
+static void
+vdbe_hash_grow(struct vdbe_hash *hash)
+{
+	uint32_t old_count = hash->bucket_mask + 1;
+	struct vdbe_hash_entry **buckets =
+		xcalloc(old_count * 2, sizeof(buckets[0]));
+	for (uint32_t i = 0; i < old_count; i++) {
+		struct vdbe_hash_entry **lo = &buckets[i];
+		struct vdbe_hash_entry **hi = &buckets[i + old_count];
+		struct vdbe_hash_entry *entry = hash->buckets[i];
+		for (; entry != NULL; entry = entry->next) {
+			if ((entry->hash & old_count) == 0) {
+				*lo = entry;
+				lo = &entry->next;
+			} else {
+				*hi = entry;
+				hi = &entry->next;
+			}
+		}
+		*lo = NULL;
+		*hi = NULL;
+	}
+	free(hash->buckets);
+	hash->buckets = buckets;
+	hash->bucket_mask = old_count * 2 - 1;
+}
+
+/**
+ * Reverse the chains, so that records with equal keys are
+ * returned in the order they were inserted, like they are by the
+ * automatic index.
+ */
+static void
+vdbe_hash_seal(struct vdbe_hash *hash)
+{
+	for (uint32_t i = 0; hash->buckets != NULL &&
+			     i <= hash->bucket_mask; i++) {
+		struct vdbe_hash_entry *entry = hash->buckets[i];
+		struct vdbe_hash_entry *prev = NULL;
+		while (entry != NULL) {
+			struct vdbe_hash_entry *next = entry->next;
+			entry->next = prev;
+			prev = entry;
+			entry = next;
+		}
+		hash->buckets[i] = prev;
+	}
+	hash->is_sealed = true;
+}
+
+/**
+ * Insert a record to the ephemeral space, appending a row id to
+ * it to make records with equal keys distinct.
+ */
+static int
+vdbe_hash_spill_record(struct vdbe_hash *hash, const char *data,
+		       uint32_t size)
+{
+	struct region *gc = &fiber()->gc;
+	size_t svp = region_used(gc);
+	const char *fields = data;
+	uint32_t field_count = mp_decode_array(&fields);
+	uint32_t fields_size = size - (fields - data);
+	uint64_t rowid = hash->rowid++;
+	char *tuple = xregion_alloc(gc, mp_sizeof_array(field_count + 1) +
+				    fields_size + mp_sizeof_uint(rowid));
+	char *pos = mp_encode_array(tuple, field_count + 1);
+	memcpy(pos, fields, fields_size);
+	pos = mp_encode_uint(pos + fields_size, rowid);
+	int rc = tarantoolsqlEphemeralInsert(hash->space, tuple, pos);
+	region_truncate(gc, svp);
+	return rc;
+}
+
+/** Move all the records to an ephemeral space. */
+static int
+vdbe_hash_spill(struct vdbe_hash *hash)
+{
+	assert(hash->space == NULL);
+	hash->space = sql_ephemeral_space_new(hash->info);
+	if (hash->space == NULL)
+		return -1;
+	/* Row ids must follow the order the records were inserted in. */
+	vdbe_hash_seal(hash);
+	for (uint32_t i = 0; i <= hash->bucket_mask; i++) {
+		struct vdbe_hash_entry *entry = hash->buckets[i];
+		for (; entry != NULL; entry = entry->next) {
+			if (vdbe_hash_spill_record(hash, entry->data,
+						   entry->size) != 0)
+				return -1;
+		}
+	}
+	region_free(&hash->region);
+	free(hash->buckets);
+	hash->buckets = NULL;
+	hash->bucket_mask = 0;
+	hash->count = 0;
+	return 0;
+}
+
+/** Check if any of the key fields of a record is NULL. */
+static bool
+vdbe_hash_key_has_null(struct vdbe_hash *hash, const char *key)
+{
+	for (uint32_t i = 0; i < hash->key_def->part_count; i++) {
+		if (mp_typeof(*key) == MP_NIL)
+			return true;
+		mp_next(&key);
+	}
+	return false;
+}
+
+int
+vdbe_hash_insert(struct vdbe_hash *hash, const char *data, uint32_t size)
+{
+	assert(hash->entry == NULL && hash->it == NULL);
+	const char *key = data;
+	mp_decode_array(&key);
+	/* NULL is not equal to anything, such a record is never found. */
+	if (vdbe_hash_key_has_null(hash, key))
+		return 0;
+	if (hash->space != NULL)
+		return vdbe_hash_spill_record(hash, data, size);
+	if (vdbe_hash_memory(hash) + size > hash->memory_max) {
+		if (vdbe_hash_spill(hash) != 0)
+			return -1;
+		return vdbe_hash_spill_record(hash, data, size);
+	}
+	struct vdbe_hash_entry *entry;
+	entry = region_aligned_alloc(&hash->region, sizeof(*entry) + size,
+				     alignof(*entry));
+	if (entry == NULL) {
+		diag_set(OutOfMemory, sizeof(*entry) + size,
+			 "region_aligned_alloc", "entry");
+		return -1;
+	}
+	entry->hash = key_hash(key, hash->key_def);
+	entry->size = size;
+	memcpy(entry->data, data, size);
+	struct vdbe_hash_entry **head =
+		&hash->buckets[entry->hash & hash->bucket_mask];
+	entry->next = *head;
+	*head = entry;
+	if (++hash->count > hash->bucket_mask)
+		vdbe_hash_grow(hash);
+	return 0;
+}
+
+/** Find the first entry matching the probe key starting from entry. */
+static struct vdbe_hash_entry *
+vdbe_hash_find(struct vdbe_hash *hash, struct vdbe_hash_entry *entry)
+{
+	uint32_t part_count = hash->key_def->part_count;
+	for (; entry != NULL; entry = entry->next) {
+		if (entry->hash != hash->key_hash)
+			continue;
+		const char *key = entry->data;
+		mp_decode_array(&key);
+		if (key_compare(key, part_count, HINT_NONE,
+				hash->key, part_count, HINT_NONE,
+				hash->key_def) == 0)
+			return entry;
+	}
+	return NULL;
+}
+
+/** Advance the iterator over the spilled records. */
+static int
+vdbe_hash_iterator_next(struct vdbe_hash *hash, bool *is_found)
+{
+	struct tuple *tuple;
+	if (iterator_next(hash->it, &tuple) != 0)
+		return -1;
+	if (hash->tuple != NULL)
+		tuple_unref(hash->tuple);
+	if (tuple != NULL)
+		tuple_ref(tuple);
+	hash->tuple = tuple;
+	*is_found = tuple != NULL;
+	return 0;
+}
+
+int
+vdbe_hash_seek(struct vdbe_hash *hash, const char *key, uint32_t size,
+	       bool *is_found)
+{
+	*is_found = false;
+	hash->entry = NULL;
+	vdbe_hash_iterator_close(hash);
+	if (vdbe_hash_key_has_null(hash, key))
+		return 0;
+	if (hash->space != NULL) {
+		struct index *pk = space_index(hash->space, 0);
+		assert(pk != NULL);
+		hash->it = index_create_iterator(pk, ITER_EQ, key,
+						 hash->key_def->part_count);
+		if (hash->it == NULL)
+			return -1;
+		return vdbe_hash_iterator_next(hash, is_found);
+	}
+	if (!hash->is_sealed)
+		vdbe_hash_seal(hash);
+	if (size > hash->key_size) {
+		hash->key = xrealloc(hash->key, size);
+		hash->key_size = size;
+	}
+	memcpy(hash->key, key, size);
+	hash->key_hash = key_hash(key, hash->key_def);
+	struct vdbe_hash_entry *head =
+		hash->buckets[hash->key_hash & hash->bucket_mask];
+	hash->entry = vdbe_hash_find(hash, head);
+	*is_found = hash->entry != NULL;
+	return 0;
+}
+
+int
+vdbe_hash_next(struct vdbe_hash *hash, bool *is_found)
+{
+	if (hash->it != NULL)
+		return vdbe_hash_iterator_next(hash, is_found);
+	if (hash->entry != NULL)
+		hash->entry = vdbe_hash_find(hash, hash->entry->next);
+	*is_found = hash->entry != NULL;
+	return 0;
+}
+
+const char *
+vdbe_hash_record(struct vdbe_hash *hash, uint32_t *size)
+{
+	if (hash->tuple != NULL) {
+		*size = tuple_bsize(hash->tuple);
+		return tuple_data(hash->tuple);
+	}
+	assert(hash->entry != NULL);
+	*size = hash->entry->size;
+	return hash->entry->data;
+}
+
+enum field_type
+vdbe_hash_field_type(const struct vdbe_hash *hash, uint32_t fieldno)
+{
+	assert(fieldno < hash->info->field_count);
+	return hash->info->types[fieldno];
+}
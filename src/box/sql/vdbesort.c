@@ -92,9 +92,10 @@
  * Records passed to the sorter via calls to Write() are initially held
  * unsorted in main memory. Assuming the amount of memory used never exceeds
  * a threshold, when Rewind() is called the set of records is sorted using
- * an in-memory merge sort. In this case, no temporary files are required
- * and subsequent calls to Rowkey(), Next() and Compare() read records
- * directly from main memory.
+ * tt_sort(), which runs in sort worker threads while the calling fiber
+ * yields. In this case, no temporary files are required and subsequent
+ * calls to Rowkey(), Next() and Compare() read records directly from main
+ * memory.
  *
  * If the amount of space used to store records in main memory exceeds the
  * threshold, then the set of records currently in memory are sorted and
@@ -154,6 +155,11 @@
 #include "sqlInt.h"
 #include "mem.h"
 #include "vdbeInt.h"
+#include "box/engine.h"
+#include "box/memtx_engine.h"
+#include "box/txn.h"
+#include "qsort_arg.h"
+#include "tt_sort.h"
 
 /*
  * Hard-coded maximum amount of data to accumulate in memory before flushing
@@ -211,22 +217,19 @@ struct SorterList {
  * to or equal to the number of PMAs being merged. The extra aReadr[] elements
  * are treated as if they are empty (always at EOF).
  *
- * The aTree[] array is also N elements in size. The value of N is stored in
- * the MergeEngine.nTree variable.
- *
- * The final (N/2) elements of aTree[] contain the results of comparing
- * pairs of PMA keys together. Element i contains the result of
- * comparing aReadr[2*i-N] and aReadr[2*i-N+1]. Whichever key is smaller, the
- * aTree element is set to the index of it.
+ * The PmaReaders are merged with a loser tree. The aTree[] array is also
+ * N elements in size. The value of N is stored in the MergeEngine.nTree
+ * variable. Think of PmaReader i as of leaf (N+i) of a complete binary
+ * tree in which the children of node i are nodes 2*i and 2*i+1. Each
+ * internal node aTree[i] (0<i<N) holds the index of the PmaReader that
+ * lost the comparison made at that node, i.e. of the greater of the
+ * winners of its two subtrees. aTree[0] holds the index of the overall
+ * winner, the PmaReader that currently points to the smallest key value.
  *
  * For the purposes of this comparison, EOF is considered greater than any
- * other key value. If the keys are equal (only possible with two EOF
- * values), it doesn't matter which index is stored.
- *
- * The (N/4) elements of aTree[] that precede the final (N/2) described
- * above contains the index of the smallest of each block of 4 PmaReaders
- * And so on. So that aTree[1] contains the index of the PmaReader that
- * currently points to the smallest key value. aTree[0] is unused.
+ * other key value. If the keys are equal, the PmaReader with the smaller
+ * index wins, because the aReadr[] array is sorted from oldest to newest
+ * PMA and the order of equal keys must be preserved.
  *
  * Example:
  *
@@ -239,7 +242,7 @@ struct SorterList {
  *     aReadr[6] -> Durian
  *     aReadr[7] -> EOF
  *
- *     aTree[] = { X, 5   0, 5    0, 3, 5, 6 }
+ *     aTree[] = { 5, 0   3, 6    1, 2, 4, 7 }
  *
  * The current element is "Apple" (the value of the key indicated by
  * PmaReader 5). When the Next() operation is invoked, PmaReader 5 will
@@ -248,18 +251,19 @@ struct SorterList {
  *
  *     aReadr[5] -> Eggplant
  *
- * The contents of aTree[] are updated first by comparing the new PmaReader
- * 5 key to the current key of PmaReader 4 (still "Grapefruit"). The PmaReader
- * 5 value is still smaller, so aTree[6] is set to 5. And so on up the tree.
- * The value of PmaReader 6 - "Durian" - is now smaller than that of PmaReader
- * 5, so aTree[3] is set to 6. Key 0 is smaller than key 6 (Banana<Durian),
- * so the value written into element 1 of the array is 0. As follows:
+ * Then the new key is compared with the losers stored on the path from
+ * leaf 5 to the root only: with PmaReader 4 at aTree[6] ("Grapefruit",
+ * Eggplant wins), with PmaReader 6 at aTree[3] ("Durian" wins, so 5 is
+ * stored at aTree[3] and 6 goes on) and with PmaReader 0 at aTree[1]
+ * ("Banana" wins over "Durian"):
  *
- *     aTree[] = { X, 0   0, 6    0, 3, 5, 6 }
+ *     aTree[] = { 0, 6   3, 5    1, 2, 4, 7 }
  *
  * In other words, each time we advance to the next sorter element, log2(N)
  * key comparison operations are required, where N is the number of segments
- * being merged (rounded up to the next power of 2).
+ * being merged (rounded up to the next power of 2). Unlike a tree of
+ * winners, all of them are made against the same key, which is unpacked
+ * only once.
  */
 struct MergeEngine {
 	int nTree;		/* Used size of aTree/aReadr (power of 2) */
@@ -1002,48 +1006,6 @@ vdbeSortAllocUnpacked(SortSubtask * pTask)
 	return 0;
 }
 
-/*
- * Merge the two sorted lists p1 and p2 into a single list.
- */
-static SorterRecord *
-vdbeSorterMerge(SortSubtask * pTask,	/* Calling thread context */
-		SorterRecord * p1,	/* First list to merge */
-		SorterRecord * p2	/* Second list to merge */
-    )
-{
-	SorterRecord *pFinal = 0;
-	SorterRecord **pp = &pFinal;
-	bool bCached = false;
-
-	assert(p1 != 0 && p2 != 0);
-	for (;;) {
-		int res;
-		res =
-		    pTask->xCompare(pTask, &bCached, SRVAL(p1),
-				    SRVAL(p2));
-
-		if (res <= 0) {
-			*pp = p1;
-			pp = &p1->u.pNext;
-			p1 = p1->u.pNext;
-			if (p1 == 0) {
-				*pp = p2;
-				break;
-			}
-		} else {
-			*pp = p2;
-			pp = &p2->u.pNext;
-			p2 = p2->u.pNext;
-			bCached = 0;
-			if (p2 == 0) {
-				*pp = p1;
-				break;
-			}
-		}
-	}
-	return pFinal;
-}
-
 /*
  * Return the SorterCompare function to compare values collected by the
  * sorter object passed as the only argument.
@@ -1055,16 +1017,72 @@ vdbeSorterGetCompare(VdbeSorter * p)
 	return vdbeSorterCompare;
 }
 
+/*
+ * An element of the array the in-memory list is sorted in. The sequence
+ * number is the position of the record in the list, it is used to break
+ * ties so that equal records keep their order.
+ */
+struct sorter_sort_item {
+	SorterRecord *record;
+	uint32_t seq;
+};
+
+/*
+ * Compare two records the way vdbeSorterCompare() does, but without
+ * any state shared between calls, so that the comparison may run in
+ * sort worker threads.
+ */
+static int
+vdbe_sorter_sort_item_cmp(const void *a, const void *b, void *arg)
+{
+	const struct sorter_sort_item *item1 = a;
+	const struct sorter_sort_item *item2 = b;
+	struct key_def *key_def = arg;
+	const char *key1 = SRVAL(item1->record);
+	const char *key2 = SRVAL(item2->record);
+	uint32_t n = mp_decode_array(&key1);
+	n = MIN(n, mp_decode_array(&key2));
+	n = MIN(n, key_def->part_count);
+	for (uint32_t i = 0; i < n; i++) {
+		struct key_part *part = &key_def->parts[i];
+		struct Mem mem;
+		uint32_t size = 0;
+		int rc = 0;
+		mem_create(&mem);
+		mem_from_mp_ephemeral(&mem, key2, &size);
+		key2 += size;
+		if (mem_cmp_msgpack(&mem, &key1, &rc, part->coll) != 0)
+			rc = 0;
+		if (rc != 0)
+			return part->sort_order != SORT_ORDER_ASC ? rc : -rc;
+	}
+	return item1->seq < item2->seq ? -1 : item1->seq > item2->seq;
+}
+
+/*
+ * Return true if the sorter may yield the current fiber to wait for
+ * sort worker threads. A transaction that doesn't allow yields would
+ * be aborted, so the list is sorted in the calling thread then.
+ */
+static bool
+vdbe_sorter_can_yield(void)
+{
+	struct txn *txn = in_txn();
+	return txn == NULL || txn_has_flag(txn, TXN_CAN_YIELD);
+}
+
 /*
  * Sort the linked list of records headed at pTask->pList. Return
  * 0 if successful, or an sql error code (i.e. -1) if
  * an error occurs.
+ *
+ * The list is sorted as an array with tt_sort(), which runs in sort
+ * worker threads (see box.cfg.memtx_sort_threads) while the calling
+ * fiber yields, so that large sorts don't stall the TX thread.
  */
 static int
 vdbeSorterSort(SortSubtask * pTask, SorterList * pList)
 {
-	int i;
-	SorterRecord **aSlot;
 	SorterRecord *p;
 	int rc;
 
@@ -1072,43 +1090,50 @@ vdbeSorterSort(SortSubtask * pTask, SorterList * pList)
 	if (rc != 0)
 		return rc;
 
-	p = pList->pList;
 	pTask->xCompare = vdbeSorterGetCompare(pTask->pSorter);
 
-	aSlot = xcalloc(64, sizeof(SorterRecord *));
-
-	while (p) {
-		SorterRecord *pNext;
-		if (pList->aMemory) {
-			if ((u8 *) p == pList->aMemory) {
-				pNext = 0;
-			} else {
-				pNext =
-				    (SorterRecord *) & pList->aMemory[p->u.
-								      iNext];
-			}
-		} else {
-			pNext = p->u.pNext;
-		}
+	uint32_t count = 0;
+	for (p = pList->pList; p != NULL;) {
+		count++;
+		if (pList->aMemory == NULL)
+			p = p->u.pNext;
+		else if ((u8 *)p == pList->aMemory)
+			p = NULL;
+		else
+			p = (SorterRecord *)&pList->aMemory[p->u.iNext];
+	}
+	if (count == 0)
+		return 0;
 
-		p->u.pNext = 0;
-		for (i = 0; aSlot[i]; i++) {
-			p = vdbeSorterMerge(pTask, p, aSlot[i]);
-			aSlot[i] = 0;
-		}
-		aSlot[i] = p;
-		p = pNext;
+	struct sorter_sort_item *items = xmalloc(count * sizeof(*items));
+	p = pList->pList;
+	for (uint32_t i = 0; i < count; i++) {
+		items[i].record = p;
+		items[i].seq = i;
+		if (pList->aMemory == NULL)
+			p = p->u.pNext;
+		else if ((u8 *)p != pList->aMemory)
+			p = (SorterRecord *)&pList->aMemory[p->u.iNext];
 	}
 
-	p = 0;
-	for (i = 0; i < 64; i++) {
-		if (aSlot[i] == 0)
-			continue;
-		p = p ? vdbeSorterMerge(pTask, p, aSlot[i]) : aSlot[i];
+	struct key_def *key_def = pTask->pSorter->key_def;
+	if (vdbe_sorter_can_yield()) {
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)engine_by_name("memtx");
+		tt_sort(items, count, sizeof(*items),
+			vdbe_sorter_sort_item_cmp, key_def,
+			memtx->sort_threads);
+	} else {
+		qsort_arg(items, count, sizeof(*items),
+			  vdbe_sorter_sort_item_cmp, key_def);
 	}
-	pList->pList = p;
 
-	free(aSlot);
+	for (uint32_t i = 0; i + 1 < count; i++)
+		items[i].record->u.pNext = items[i + 1].record;
+	items[count - 1].record->u.pNext = NULL;
+	pList->pList = items[0].record;
+
+	free(items);
 	return 0;
 }
 
@@ -1273,6 +1298,26 @@ vdbeSorterListToPMA(SortSubtask * pTask, SorterList * pList)
 	return rc;
 }
 
+/*
+ * Return true if the key of PmaReader i1 of the merge engine should be
+ * returned before the key of PmaReader i2. The unpacked key of i2 is
+ * cached in the task and reused while *pbCached is true.
+ */
+static bool
+vdbeMergeEngineLess(MergeEngine * pMerger, int i1, int i2, bool *pbCached)
+{
+	PmaReader *pReadr1 = &pMerger->aReadr[i1];
+	PmaReader *pReadr2 = &pMerger->aReadr[i2];
+	if (pReadr1->pFd == 0)
+		return false;
+	if (pReadr2->pFd == 0)
+		return true;
+	SortSubtask *pTask = pMerger->pTask;
+	int iRes = pTask->xCompare(pTask, pbCached, pReadr1->aKey,
+				   pReadr2->aKey);
+	return iRes < 0 || (iRes == 0 && i1 < i2);
+}
+
 /*
  * Advance the MergeEngine to its next entry.
  * Set *pbEof to true there is no next entry because
@@ -1286,72 +1331,30 @@ vdbeMergeEngineStep(MergeEngine * pMerger,	/* The merge engine to advance to the
     )
 {
 	int rc;
-	int iPrev = pMerger->aTree[1];	/* Index of PmaReader to advance */
-	SortSubtask *pTask = pMerger->pTask;
+	int iWinner = pMerger->aTree[0];	/* PmaReader to advance */
 
 	/* Advance the current PmaReader */
-	rc = vdbePmaReaderNext(&pMerger->aReadr[iPrev]);
+	rc = vdbePmaReaderNext(&pMerger->aReadr[iWinner]);
 
-	/* Update contents of aTree[] */
+	/* Replay the matches on the path from the advanced PmaReader to the
+	 * root of the tree. The winner of each match goes on, the loser is
+	 * stored in the node. While the candidate doesn't change, its key
+	 * stays unpacked in pTask->pUnpacked.
+	 */
 	if (rc == 0) {
-		int i;		/* Index of aTree[] to recalculate */
-		PmaReader *pReadr1;	/* First PmaReader to compare */
-		PmaReader *pReadr2;	/* Second PmaReader to compare */
+		int i;		/* Index of aTree[] to replay */
 		bool bCached = false;
-
-		/* Find the first two PmaReaders to compare. The one that was just
-		 * advanced (iPrev) and the one next to it in the array.
-		 */
-		pReadr1 = &pMerger->aReadr[(iPrev & 0xFFFE)];
-		pReadr2 = &pMerger->aReadr[(iPrev | 0x0001)];
-
-		for (i = (pMerger->nTree + iPrev) / 2; i > 0; i = i / 2) {
-			/* Compare pReadr1 and pReadr2. Store the result in variable iRes. */
-			int iRes;
-			if (pReadr1->pFd == 0) {
-				iRes = +1;
-			} else if (pReadr2->pFd == 0) {
-				iRes = -1;
-			} else {
-				iRes = pTask->xCompare(pTask, &bCached,
-						       pReadr1->aKey,
-						       pReadr2->aKey);
-			}
-
-			/* If pReadr1 contained the smaller value, set aTree[i] to its index.
-			 * Then set pReadr2 to the next PmaReader to compare to pReadr1. In this
-			 * case there is no cache of pReadr2 in pTask->pUnpacked, so set
-			 * pKey2 to point to the record belonging to pReadr2.
-			 *
-			 * Alternatively, if pReadr2 contains the smaller of the two values,
-			 * set aTree[i] to its index and update pReadr1. If vdbeSorterCompare()
-			 * was actually called above, then pTask->pUnpacked now contains
-			 * a value equivalent to pReadr2. So set pKey2 to NULL to prevent
-			 * vdbeSorterCompare() from decoding pReadr2 again.
-			 *
-			 * If the two values were equal, then the value from the oldest
-			 * PMA should be considered smaller. The VdbeSorter.aReadr[] array
-			 * is sorted from oldest to newest, so pReadr1 contains older values
-			 * than pReadr2 iff (pReadr1<pReadr2).
-			 */
-			if (iRes < 0 || (iRes == 0 && pReadr1 < pReadr2)) {
-				pMerger->aTree[i] =
-				    (int)(pReadr1 - pMerger->aReadr);
-				pReadr2 =
-				    &pMerger->aReadr[pMerger->
-						     aTree[i ^ 0x0001]];
-				bCached = 0;
-			} else {
-				if (pReadr1->pFd)
-					bCached = 0;
-				pMerger->aTree[i] =
-				    (int)(pReadr2 - pMerger->aReadr);
-				pReadr1 =
-				    &pMerger->aReadr[pMerger->
-						     aTree[i ^ 0x0001]];
+		for (i = (pMerger->nTree + iWinner) / 2; i > 0; i = i / 2) {
+			int iLoser = pMerger->aTree[i];
+			if (vdbeMergeEngineLess(pMerger, iLoser, iWinner,
+						&bCached)) {
+				pMerger->aTree[i] = iWinner;
+				iWinner = iLoser;
+				bCached = false;
 			}
 		}
-		*pbEof = (pMerger->aReadr[pMerger->aTree[1]].pFd == 0);
+		pMerger->aTree[0] = iWinner;
+		*pbEof = (pMerger->aReadr[iWinner].pFd == 0);
 	}
 
 	return rc;
@@ -1484,7 +1487,7 @@ vdbeIncrPopulate(IncrMerger * pIncr)
 	vdbePmaWriterInit(pOut->pFd, &writer, pTask->pSorter->pgsz, iStart);
 	while (rc == 0) {
 		int dummy;
-		PmaReader *pReader = &pMerger->aReadr[pMerger->aTree[1]];
+		PmaReader *pReader = &pMerger->aReadr[pMerger->aTree[0]];
 		int nKey = pReader->nKey;
 		i64 iEof = writer.iWriteOff + writer.iBufEnd;
 
@@ -1563,53 +1566,37 @@ vdbeIncrMergerNew(SortSubtask * pTask,	/* The thread that will be using the new
 }
 
 /*
- * Recompute pMerger->aTree[iOut] by comparing the next keys on the
- * two PmaReaders that feed that entry.  Neither of the PmaReaders
- * are advanced.  This routine merely does the comparison.
+ * Play all matches of the loser tree of pMerger from the leaves up and
+ * fill in pMerger->aTree. None of the PmaReaders are advanced.
  */
 static void
-vdbeMergeEngineCompare(MergeEngine * pMerger,	/* Merge engine containing PmaReaders to compare */
-		       int iOut	/* Store the result in pMerger->aTree[iOut] */
-    )
+vdbeMergeEngineBuildTree(MergeEngine * pMerger)
 {
-	int i1;
-	int i2;
-	int iRes;
-	PmaReader *p1;
-	PmaReader *p2;
-
-	assert(iOut < pMerger->nTree && iOut > 0);
-
-	if (iOut >= (pMerger->nTree / 2)) {
-		i1 = (iOut - pMerger->nTree / 2) * 2;
-		i2 = i1 + 1;
-	} else {
-		i1 = pMerger->aTree[iOut * 2];
-		i2 = pMerger->aTree[iOut * 2 + 1];
-	}
-
-	p1 = &pMerger->aReadr[i1];
-	p2 = &pMerger->aReadr[i2];
+	int nTree = pMerger->nTree;
+	/* Winners of the subtrees, indexed like aTree[]. */
+	int aWinner[SORTER_MAX_MERGE_COUNT];
+	int i;
 
-	if (p1->pFd == 0) {
-		iRes = i2;
-	} else if (p2->pFd == 0) {
-		iRes = i1;
-	} else {
-		SortSubtask *pTask = pMerger->pTask;
-		bool cached = false;
-		int res;
-		assert(pTask->pUnpacked != 0);	/* from vdbeSortSubtaskMain() */
-		res =
-		    pTask->xCompare(pTask, &cached, p1->aKey, p2->aKey);
-		if (res <= 0) {
-			iRes = i1;
+	assert(nTree <= SORTER_MAX_MERGE_COUNT);
+	for (i = nTree - 1; i > 0; i--) {
+		int i1, i2;
+		if (i >= nTree / 2) {
+			i1 = (i - nTree / 2) * 2;
+			i2 = i1 + 1;
 		} else {
-			iRes = i2;
+			i1 = aWinner[i * 2];
+			i2 = aWinner[i * 2 + 1];
 		}
+		bool bCached = false;
+		if (vdbeMergeEngineLess(pMerger, i2, i1, &bCached)) {
+			int iTmp = i1;
+			i1 = i2;
+			i2 = iTmp;
+		}
+		aWinner[i] = i1;
+		pMerger->aTree[i] = i2;
 	}
-
-	pMerger->aTree[iOut] = iRes;
+	pMerger->aTree[0] = aWinner[1];
 }
 
 /*
@@ -1650,9 +1637,7 @@ vdbeMergeEngineInit(SortSubtask * pTask,	/* Thread that will run pMerger */
 			return rc;
 	}
 
-	for (i = pMerger->nTree - 1; i > 0; i--) {
-		vdbeMergeEngineCompare(pMerger, i);
-	}
+	vdbeMergeEngineBuildTree(pMerger);
 	return 0;
 }
 
@@ -2040,12 +2025,8 @@ vdbeSorterRowkey(const VdbeSorter * pSorter,	/* Sorter object */
 {
 	void *pKey;
 	if (pSorter->bUsePMA) {
-		PmaReader *pReader;
-			/*if( !pSorter->bUseThreads ) */  {
-			pReader =
-			    &pSorter->pMerger->aReadr[pSorter->pMerger->
-						      aTree[1]];
-			}
+		MergeEngine *pMerger = pSorter->pMerger;
+		PmaReader *pReader = &pMerger->aReadr[pMerger->aTree[0]];
 		*pnKey = pReader->nKey;
 		pKey = pReader->aKey;
 	} else {
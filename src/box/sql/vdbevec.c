@@ -0,0 +1,970 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+/*
+ * Batch-at-a-time evaluation of simple aggregate queries.
+ *
+ * Tuples are read from the index in batches of VDBE_VEC_BATCH_SIZE
+ * rows. The fields referenced by the query are decoded once per
+ * batch into typed column vectors, then the filters narrow down a
+ * selection vector and the aggregates are updated by tight loops
+ * over the selected rows. Anything these loops can't reproduce
+ * exactly is left to the row-at-a-time VDBE code.
+ *
+ * If the sql_parallel_scan session setting is enabled, a large
+ * memtx space is scanned by worker threads instead: each of them
+ * scans its own range of a read view of the index, and the states
+ * of the aggregates over the ranges are merged in the TX thread.
+ */
+#include <math.h>
+
+#include "box/engine.h"
+#include "box/index.h"
+#include "box/memtx_engine.h"
+#include "box/memtx_tx.h"
+#include "box/read_view.h"
+#include "box/session.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "box/txn.h"
+#include "sqlInt.h"
+#include "mem.h"
+#include "vdbeInt.h"
+
+#include "fiber.h"
+#include "msgpuck/msgpuck.h"
+#include "small/region.h"
+
+enum {
+	/** Number of rows processed at once. */
+	VDBE_VEC_BATCH_SIZE = 1024,
+	/** Minimal number of rows scanned by a worker thread. */
+	VDBE_VEC_PARALLEL_MIN_ROWS = 16 * VDBE_VEC_BATCH_SIZE,
+};
+
+/** Values of a column for a batch of rows. */
+struct vec_column {
+	/** NULL flags. Values of NULL rows are set to zero. */
+	bool is_null[VDBE_VEC_BATCH_SIZE];
+	union {
+		int64_t i[VDBE_VEC_BATCH_SIZE];
+		double d[VDBE_VEC_BATCH_SIZE];
+	};
+};
+
+/** Filter with the value converted to the column type. */
+struct vec_filter {
+	const struct vec_column *column;
+	enum vdbe_vec_type type;
+	/** See vdbe_vec_filter::mask. */
+	uint8_t mask;
+	union {
+		int64_t i;
+		double d;
+	} value;
+};
+
+/** State of an aggregate function. */
+struct vec_agg_state {
+	/** Number of aggregated non-NULL values. */
+	uint64_t count;
+	/** Sum, minimum or maximum of the values. */
+	union {
+		int64_t i;
+		double d;
+	} value;
+};
+
+enum {
+	/** Mask of a filter that passes all non-NULL values. */
+	VDBE_VEC_ALL = VDBE_VEC_LT | VDBE_VEC_EQ | VDBE_VEC_GT,
+};
+
+/**
+ * Make a filter comparing an integer column with a value always
+ * yielding the given comparison result.
+ */
+static void
+vec_filter_set_const(struct vec_filter *filter, uint8_t result)
+{
+	filter->mask = (filter->mask & result) != 0 ? VDBE_VEC_ALL : 0;
+	filter->value.i = 0;
+}
+
+/**
+ * Convert the value of a filter to the type of the column.
+ * Integer columns are compared with doubles by rounding the
+ * value down and adjusting the mask so the comparison stays
+ * exact. Return -1 if the value can't be compared exactly.
+ */
+static int
+vec_filter_prepare(struct vec_filter *filter, const struct Mem *value)
+{
+	/* Comparison with NULL is never true. */
+	if (mem_is_null(value)) {
+		filter->mask = 0;
+		return 0;
+	}
+	if (filter->type == VDBE_VEC_DOUBLE) {
+		/* Integers beyond 2^53 can't be converted exactly. */
+		const int64_t limit = (int64_t)1 << 53;
+		if (value->type == MEM_TYPE_DOUBLE)
+			filter->value.d = value->u.r;
+		else if (value->type == MEM_TYPE_INT && value->u.i >= -limit)
+			filter->value.d = value->u.i;
+		else if (value->type == MEM_TYPE_UINT &&
+			 value->u.u <= (uint64_t)limit)
+			filter->value.d = value->u.u;
+		else
+			return -1;
+		return 0;
+	}
+	assert(filter->type == VDBE_VEC_INT);
+	if (value->type == MEM_TYPE_INT) {
+		filter->value.i = value->u.i;
+	} else if (value->type == MEM_TYPE_UINT) {
+		/*
+		 * Integer columns may hold values up to UINT64_MAX,
+		 * which can't be decoded, so such a comparison can't
+		 * be folded to a constant.
+		 */
+		if (value->u.u > INT64_MAX)
+			return -1;
+		filter->value.i = value->u.u;
+	} else if (value->type == MEM_TYPE_DOUBLE) {
+		double d = value->u.r;
+		if (d >= 0x1p63) {
+			return -1;
+		} else if (d < -0x1p63) {
+			vec_filter_set_const(filter, VDBE_VEC_GT);
+		} else {
+			double f = floor(d);
+			filter->value.i = (int64_t)f;
+			if (f != d) {
+				/*
+				 * x <= floor(d) means x < d, and
+				 * x > floor(d) means x > d.
+				 */
+				uint8_t mask = filter->mask;
+				filter->mask = 0;
+				if ((mask & VDBE_VEC_LT) != 0)
+					filter->mask |= VDBE_VEC_LT |
+							VDBE_VEC_EQ;
+				if ((mask & VDBE_VEC_GT) != 0)
+					filter->mask |= VDBE_VEC_GT;
+			}
+		}
+	} else {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Decode a field to the n-th row of a column. Return -1 if the
+ * field is of a type the column can't hold.
+ */
+static int
+vec_column_fill(struct vec_column *column, enum vdbe_vec_type type,
+		uint32_t n, const char *field)
+{
+	column->i[n] = 0;
+	column->is_null[n] = field == NULL || mp_typeof(*field) == MP_NIL;
+	if (column->is_null[n])
+		return 0;
+	switch (type) {
+	case VDBE_VEC_ANY: {
+		/* SQL treats NaN as NULL. */
+		double d = 0;
+		if (mp_typeof(*field) == MP_DOUBLE)
+			d = mp_decode_double(&field);
+		else if (mp_typeof(*field) == MP_FLOAT)
+			d = mp_decode_float(&field);
+		column->is_null[n] = isnan(d);
+		break;
+	}
+	case VDBE_VEC_INT:
+		if (mp_typeof(*field) == MP_INT) {
+			column->i[n] = mp_decode_int(&field);
+		} else if (mp_typeof(*field) == MP_UINT) {
+			uint64_t u = mp_decode_uint(&field);
+			if (u > INT64_MAX)
+				return -1;
+			column->i[n] = u;
+		} else {
+			return -1;
+		}
+		break;
+	case VDBE_VEC_DOUBLE: {
+		double d;
+		if (mp_typeof(*field) == MP_DOUBLE)
+			d = mp_decode_double(&field);
+		else if (mp_typeof(*field) == MP_FLOAT)
+			d = mp_decode_float(&field);
+		else
+			return -1;
+		if (isnan(d))
+			column->is_null[n] = true;
+		else
+			column->d[n] = d;
+		break;
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/**
+ * Decode the fields of a tuple to the n-th row of the columns.
+ * Return -1 if a field is of a type the columns can't hold.
+ */
+static int
+vec_columns_fill(const struct vdbe_vec_plan *plan, struct vec_column *columns,
+		 uint32_t n, struct tuple *tuple)
+{
+	for (uint32_t i = 0; i < plan->column_count; i++) {
+		uint32_t fieldno = plan->columns[i].fieldno;
+		const char *field = tuple_field(tuple, fieldno);
+		if (vec_column_fill(&columns[i], plan->columns[i].type, n,
+				    field) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Same as vec_columns_fill(), but takes the MsgPack data of a
+ * tuple, which has no field map, so the fields are looked up by
+ * skipping the preceding ones.
+ */
+static int
+vec_columns_fill_raw(const struct vdbe_vec_plan *plan,
+		     struct vec_column *columns, uint32_t n, const char *data)
+{
+	uint32_t field_count = mp_decode_array(&data);
+	for (uint32_t i = 0; i < plan->column_count; i++) {
+		uint32_t fieldno = plan->columns[i].fieldno;
+		const char *field = NULL;
+		if (fieldno < field_count) {
+			field = data;
+			for (uint32_t j = 0; j < fieldno; j++)
+				mp_next(&field);
+		}
+		if (vec_column_fill(&columns[i], plan->columns[i].type, n,
+				    field) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Apply a filter to the selected rows of a batch. Return the
+ * number of rows left in the selection.
+ */
+static uint32_t
+vec_filter_apply(const struct vec_filter *filter, uint16_t *sel,
+		 uint32_t count)
+{
+	const bool *is_null = filter->column->is_null;
+	uint8_t mask = filter->mask;
+	uint32_t n = 0;
+	if (filter->type == VDBE_VEC_INT) {
+		const int64_t *values = filter->column->i;
+		int64_t value = filter->value.i;
+		for (uint32_t k = 0; k < count; k++) {
+			uint16_t i = sel[k];
+			int cmp = (values[i] > value) - (values[i] < value);
+			sel[n] = i;
+			n += !is_null[i] & (mask >> (cmp + 1));
+		}
+	} else {
+		assert(filter->type == VDBE_VEC_DOUBLE);
+		const double *values = filter->column->d;
+		double value = filter->value.d;
+		for (uint32_t k = 0; k < count; k++) {
+			uint16_t i = sel[k];
+			int cmp = (values[i] > value) - (values[i] < value);
+			sel[n] = i;
+			n += !is_null[i] & (mask >> (cmp + 1));
+		}
+	}
+	return n;
+}
+
+/**
+ * Update the state of an aggregate with the selected rows of a
+ * batch. Return -1 if an integer sum overflows, in which case
+ * the exact result (or error) is up to the row-at-a-time code.
+ */
+static int
+vec_agg_update(const struct vdbe_vec_agg *agg, enum vdbe_vec_type type,
+	       const struct vec_column *column, struct vec_agg_state *state,
+	       const uint16_t *sel, uint32_t count)
+{
+	if (column == NULL) {
+		assert(agg->type == VDBE_VEC_COUNT);
+		state->count += count;
+		return 0;
+	}
+	const bool *is_null = column->is_null;
+	uint64_t n = state->count;
+	switch (agg->type) {
+	case VDBE_VEC_COUNT:
+		for (uint32_t k = 0; k < count; k++)
+			n += !is_null[sel[k]];
+		break;
+	case VDBE_VEC_SUM:
+	case VDBE_VEC_AVG:
+		if (type == VDBE_VEC_INT) {
+			int64_t sum = state->value.i;
+			for (uint32_t k = 0; k < count; k++) {
+				uint16_t i = sel[k];
+				int64_t v = column->i[i];
+				if (v > 0 ? sum > INT64_MAX - v :
+					    sum < INT64_MIN - v)
+					return -1;
+				sum += v;
+				n += !is_null[i];
+			}
+			state->value.i = sum;
+		} else {
+			double sum = state->value.d;
+			for (uint32_t k = 0; k < count; k++) {
+				uint16_t i = sel[k];
+				if (is_null[i])
+					continue;
+				sum += column->d[i];
+				n++;
+			}
+			state->value.d = sum;
+		}
+		break;
+	case VDBE_VEC_TOTAL: {
+		double sum = state->value.d;
+		for (uint32_t k = 0; k < count; k++) {
+			uint16_t i = sel[k];
+			if (is_null[i])
+				continue;
+			sum += type == VDBE_VEC_INT ? (double)column->i[i] :
+			       column->d[i];
+			n++;
+		}
+		state->value.d = sum;
+		break;
+	}
+	case VDBE_VEC_MIN:
+	case VDBE_VEC_MAX: {
+		bool is_max = agg->type == VDBE_VEC_MAX;
+		for (uint32_t k = 0; k < count; k++) {
+			uint16_t i = sel[k];
+			if (is_null[i])
+				continue;
+			if (type == VDBE_VEC_INT) {
+				int64_t v = column->i[i];
+				int64_t *best = &state->value.i;
+				if (n == 0 || (is_max ? *best < v : *best > v))
+					*best = v;
+			} else {
+				double v = column->d[i];
+				double *best = &state->value.d;
+				if (n == 0 || (is_max ? *best < v : *best > v))
+					*best = v;
+			}
+			n++;
+		}
+		break;
+	}
+	default:
+		unreachable();
+	}
+	state->count = n;
+	return 0;
+}
+
+/** Store the result of an aggregate to a register. */
+static int
+vec_agg_finalize(const struct vdbe_vec_agg *agg, enum vdbe_vec_type type,
+		 const struct vec_agg_state *state, struct Mem *out)
+{
+	struct Mem value;
+	mem_create(&value);
+	if (type == VDBE_VEC_INT)
+		mem_set_int(&value, state->value.i);
+	else
+		mem_set_double(&value, state->value.d);
+	switch (agg->type) {
+	case VDBE_VEC_COUNT:
+		mem_set_uint(out, state->count);
+		return 0;
+	case VDBE_VEC_TOTAL:
+		mem_set_double(out, state->value.d);
+		return 0;
+	case VDBE_VEC_AVG: {
+		if (state->count == 0) {
+			mem_set_null(out);
+			return 0;
+		}
+		struct Mem count;
+		mem_create(&count);
+		mem_set_uint(&count, state->count);
+		return mem_div(&value, &count, out);
+	}
+	case VDBE_VEC_SUM:
+	case VDBE_VEC_MIN:
+	case VDBE_VEC_MAX:
+		if (state->count == 0)
+			mem_set_null(out);
+		else
+			mem_copy_as_ephemeral(out, &value);
+		return 0;
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/**
+ * Apply the filters to a batch of n rows and update the aggregates
+ * with the rows passing them. Return 1 if an aggregate can't be
+ * updated by the batch loops.
+ */
+static int
+vec_batch_aggregate(const struct vdbe_vec_plan *plan,
+		    const struct vec_column *columns,
+		    const struct vec_filter *filters,
+		    struct vec_agg_state *states, uint32_t n)
+{
+	uint16_t sel[VDBE_VEC_BATCH_SIZE];
+	uint32_t count = n;
+	for (uint32_t i = 0; i < count; i++)
+		sel[i] = i;
+	for (uint32_t i = 0; i < plan->filter_count && count > 0; i++)
+		count = vec_filter_apply(&filters[i], sel, count);
+	if (count == 0)
+		return 0;
+	for (uint32_t i = 0; i < plan->agg_count; i++) {
+		const struct vdbe_vec_agg *agg = &plan->aggs[i];
+		const struct vec_column *column = NULL;
+		enum vdbe_vec_type type = VDBE_VEC_ANY;
+		if (agg->column >= 0) {
+			column = &columns[agg->column];
+			type = plan->columns[agg->column].type;
+		}
+		if (vec_agg_update(agg, type, column, &states[i],
+				   sel, count) != 0)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * Scan the index and update the aggregates. Return 1 if the
+ * tuples can't be processed by the batch loops.
+ */
+static int
+vec_aggregate_scan(const struct vdbe_vec_plan *plan, struct space *space,
+		   struct index *index, struct vec_column *columns,
+		   const struct vec_filter *filters,
+		   struct vec_agg_state *states)
+{
+	struct txn *txn = NULL;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	struct iterator *it = index_create_iterator(index, ITER_ALL, NULL, 0);
+	if (txn != NULL)
+		txn_end_ro_stmt(txn, &svp);
+	if (it == NULL)
+		return -1;
+	int rc = 0;
+	uint32_t n;
+	do {
+		struct tuple *tuple;
+		for (n = 0; n < VDBE_VEC_BATCH_SIZE; n++) {
+			if (iterator_next(it, &tuple) != 0) {
+				rc = -1;
+				goto out;
+			}
+			if (tuple == NULL)
+				break;
+			if (vec_columns_fill(plan, columns, n, tuple) != 0) {
+				rc = 1;
+				goto out;
+			}
+		}
+		rc = vec_batch_aggregate(plan, columns, filters, states, n);
+	} while (rc == 0 && n == VDBE_VEC_BATCH_SIZE);
+out:
+	iterator_delete(it);
+	return rc;
+}
+
+/**
+ * Merge the state of an aggregate over the rows following the ones
+ * of the given state into it. Return -1 if an integer sum overflows.
+ */
+static int
+vec_agg_merge(const struct vdbe_vec_agg *agg, enum vdbe_vec_type type,
+	      struct vec_agg_state *state, const struct vec_agg_state *next)
+{
+	if (next->count == 0)
+		return 0;
+	switch (agg->type) {
+	case VDBE_VEC_COUNT:
+		break;
+	case VDBE_VEC_SUM:
+	case VDBE_VEC_AVG: {
+		assert(type == VDBE_VEC_INT);
+		int64_t sum = state->value.i;
+		int64_t v = next->value.i;
+		if (v > 0 ? sum > INT64_MAX - v : sum < INT64_MIN - v)
+			return -1;
+		state->value.i = sum + v;
+		break;
+	}
+	case VDBE_VEC_MIN:
+	case VDBE_VEC_MAX: {
+		/*
+		 * The states are merged in the order of the rows, so
+		 * the first of equal values is kept like in a single
+		 * scan.
+		 */
+		bool is_max = agg->type == VDBE_VEC_MAX;
+		if (state->count == 0) {
+			state->value = next->value;
+		} else if (type == VDBE_VEC_INT) {
+			int64_t v = next->value.i;
+			int64_t *best = &state->value.i;
+			if (is_max ? *best < v : *best > v)
+				*best = v;
+		} else {
+			double v = next->value.d;
+			double *best = &state->value.d;
+			if (is_max ? *best < v : *best > v)
+				*best = v;
+		}
+		break;
+	}
+	default:
+		unreachable();
+	}
+	state->count += next->count;
+	return 0;
+}
+
+/** A range of rows of a parallel scan. */
+struct vec_scan_worker {
+	/** The worker cord. */
+	struct cord cord;
+	const struct vdbe_vec_plan *plan;
+	/** Read view of the scanned index. */
+	struct index_read_view *index;
+	/** Position of the first row of the range in the index. */
+	uint32_t offset;
+	/** Number of rows in the range. */
+	uint32_t count;
+	/** Columns of the batches read by the worker. */
+	struct vec_column *columns;
+	/** Filters comparing the worker columns. */
+	struct vec_filter filters[VDBE_VEC_FILTER_MAX];
+	/** States of the aggregates over the range. */
+	struct vec_agg_state states[VDBE_VEC_AGG_MAX];
+	/** Set if the rows can't be processed by the batch loops. */
+	bool is_fallback;
+};
+
+/** Scan the range of rows of a worker. Runs in the worker thread. */
+static int
+vec_scan_worker_f(va_list ap)
+{
+	struct vec_scan_worker *worker = va_arg(ap, typeof(worker));
+	const struct vdbe_vec_plan *plan = worker->plan;
+	struct index_read_view_iterator it;
+	if (index_read_view_create_iterator_with_offset(worker->index,
+							ITER_ALL, NULL, 0,
+							NULL, worker->offset,
+							&it) != 0)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = 0;
+	uint32_t left = worker->count;
+	while (left > 0 && rc == 0) {
+		uint32_t n = MIN(left, (uint32_t)VDBE_VEC_BATCH_SIZE);
+		for (uint32_t i = 0; i < n; i++) {
+			struct read_view_tuple tuple;
+			if (index_read_view_iterator_next_raw(&it,
+							      &tuple) != 0) {
+				rc = -1;
+				goto out;
+			}
+			assert(tuple.data != NULL);
+			if (vec_columns_fill_raw(plan, worker->columns, i,
+						 tuple.data) != 0) {
+				rc = 1;
+				goto out;
+			}
+		}
+		left -= n;
+		rc = vec_batch_aggregate(plan, worker->columns,
+					 worker->filters, worker->states, n);
+		/* Tuples may be decompressed to the region. */
+		region_truncate(region, region_svp);
+	}
+out:
+	index_read_view_iterator_destroy(&it);
+	region_truncate(region, region_svp);
+	if (rc > 0) {
+		worker->is_fallback = true;
+		rc = 0;
+	}
+	return rc;
+}
+
+/**
+ * Return the number of worker threads to scan the index with or 0
+ * if the index is to be scanned by the calling fiber.
+ */
+static uint32_t
+vec_parallel_scan_worker_count(const struct vdbe_vec_plan *plan,
+			       struct space *space, struct index *index)
+{
+	if ((current_session()->sql_flags & SQL_ParallelScan) == 0)
+		return 0;
+	/*
+	 * The calling fiber yields while the workers run, and a row
+	 * of a read view can be found by its offset only if there
+	 * are no changes invisible to the read view in the index.
+	 */
+	if (in_txn() != NULL || memtx_tx_manager_use_mvcc_engine ||
+	    !space_is_memtx(space) || index->def->type != TREE)
+		return 0;
+	for (uint32_t i = 0; i < plan->agg_count; i++) {
+		const struct vdbe_vec_agg *agg = &plan->aggs[i];
+		/* Floating point sums depend on the order of addition. */
+		if (agg->type == VDBE_VEC_TOTAL ||
+		    ((agg->type == VDBE_VEC_SUM || agg->type == VDBE_VEC_AVG) &&
+		     plan->columns[agg->column].type != VDBE_VEC_INT))
+			return 0;
+	}
+	ssize_t size = index_size(index);
+	if (size < 0 || size > UINT32_MAX)
+		return 0;
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	return MIN((uint32_t)size / VDBE_VEC_PARALLEL_MIN_ROWS,
+		   (uint32_t)memtx->sort_threads);
+}
+
+static bool
+vec_read_view_filter_space(struct space *space, void *arg)
+{
+	struct index *index = arg;
+	return space->def->id == index->def->space_id;
+}
+
+static bool
+vec_read_view_filter_index(struct space *space, struct index *index,
+			   void *arg)
+{
+	(void)space;
+	return index == arg;
+}
+
+/**
+ * Scan a read view of the index in worker threads, each of them
+ * scanning an equal range of rows, and merge the states of the
+ * aggregates over the ranges. The calling fiber yields while the
+ * workers run. Return 1 if the tuples can't be processed by the
+ * batch loops.
+ */
+static int
+vec_aggregate_parallel_scan(const struct vdbe_vec_plan *plan,
+			    struct index *index, uint32_t worker_count,
+			    const struct vec_filter *filters,
+			    struct vec_agg_state *states)
+{
+	uint32_t size = index_size(index);
+	struct read_view rv;
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "sql";
+	opts.filter_space = vec_read_view_filter_space;
+	opts.filter_index = vec_read_view_filter_index;
+	opts.filter_arg = index;
+	opts.enable_data_temporary_spaces = true;
+	if (read_view_open(&rv, &opts) != 0)
+		return -1;
+	assert(!rlist_empty(&rv.spaces));
+	struct space_read_view *space_rv =
+		rlist_first_entry(&rv.spaces, struct space_read_view, link);
+	struct index_read_view *index_rv =
+		space_read_view_index(space_rv, index->def->iid);
+	assert(index_rv != NULL);
+	struct vec_scan_worker *workers =
+		xcalloc(worker_count, sizeof(workers[0]));
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < worker_count; i++) {
+		struct vec_scan_worker *worker = &workers[i];
+		worker->plan = plan;
+		worker->index = index_rv;
+		worker->offset = offset;
+		worker->count = (uint64_t)size * (i + 1) / worker_count -
+				offset;
+		offset += worker->count;
+		worker->columns = xcalloc(MAX(plan->column_count, 1),
+					  sizeof(worker->columns[0]));
+		for (uint32_t j = 0; j < plan->filter_count; j++) {
+			worker->filters[j] = filters[j];
+			worker->filters[j].column =
+				&worker->columns[plan->filters[j].column];
+		}
+		for (uint32_t j = 0; j < plan->agg_count; j++)
+			worker->states[j] = states[j];
+	}
+	int rc = 0;
+	uint32_t started;
+	for (started = 0; started < worker_count; started++) {
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "sql.scan.%u", started);
+		if (cord_costart(&workers[started].cord, name,
+				 vec_scan_worker_f, &workers[started]) != 0) {
+			rc = -1;
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < started; i++) {
+		if (cord_cojoin(&workers[i].cord) != 0)
+			rc = -1;
+	}
+	for (uint32_t i = 0; i < worker_count && rc == 0; i++) {
+		struct vec_scan_worker *worker = &workers[i];
+		if (worker->is_fallback) {
+			rc = 1;
+			break;
+		}
+		for (uint32_t j = 0; j < plan->agg_count; j++) {
+			const struct vdbe_vec_agg *agg = &plan->aggs[j];
+			enum vdbe_vec_type type = agg->column < 0 ?
+				VDBE_VEC_ANY : plan->columns[agg->column].type;
+			if (vec_agg_merge(agg, type, &states[j],
+					  &worker->states[j]) != 0) {
+				rc = 1;
+				break;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < worker_count; i++)
+		free(workers[i].columns);
+	free(workers);
+	read_view_close(&rv);
+	return rc;
+}
+
+/**
+ * Check if the filter is a tighter bound of the key range than
+ * the given one. Lower bounds are filters passing only values not
+ * less than the filter value, upper bounds pass only values not
+ * greater than it.
+ */
+static bool
+vec_filter_is_tighter(const struct vec_filter *filter,
+		      const struct vec_filter *bound, bool is_lower)
+{
+	if (bound == NULL)
+		return true;
+	int cmp;
+	if (filter->type == VDBE_VEC_DOUBLE) {
+		cmp = filter->value.d < bound->value.d ? -1 :
+		      filter->value.d > bound->value.d;
+	} else {
+		cmp = filter->value.i < bound->value.i ? -1 :
+		      filter->value.i > bound->value.i;
+	}
+	if (cmp == 0)
+		return (filter->mask & VDBE_VEC_EQ) == 0;
+	return is_lower ? cmp > 0 : cmp < 0;
+}
+
+/**
+ * Count the rows of the index with the first key part beyond the
+ * bound of the key range: not less than the lower bound or greater
+ * than the upper bound. NULLs are never counted.
+ */
+static ssize_t
+vec_range_count_from(struct index *index, const struct vec_filter *bound,
+		     bool is_lower, ssize_t total)
+{
+	bool is_inclusive = (bound->mask & VDBE_VEC_EQ) != 0;
+	char key[16];
+	char *key_end = key;
+	if (bound->type == VDBE_VEC_DOUBLE) {
+		key_end = mp_encode_double(key_end, bound->value.d);
+	} else if (bound->value.i >= 0) {
+		key_end = mp_encode_uint(key_end, bound->value.i);
+	} else if (index->def->key_def->parts[0].type == FIELD_TYPE_UNSIGNED) {
+		/* All non-NULL values are beyond a negative bound. */
+		return total;
+	} else {
+		key_end = mp_encode_int(key_end, bound->value.i);
+	}
+	assert(key_end <= key + sizeof(key));
+	(void)key_end;
+	enum iterator_type type;
+	if (is_lower)
+		type = is_inclusive ? ITER_GE : ITER_GT;
+	else
+		type = is_inclusive ? ITER_GT : ITER_GE;
+	return index_count(index, type, key, 1);
+}
+
+/**
+ * Count the rows passing the filters by looking up the bounds of
+ * the key range in the index, which takes logarithmic time in a
+ * TREE index. All filters compare the first part of the index.
+ * Return 1 if the filters can't be turned into a key range.
+ *
+ * Only counts can be served this way: a TREE index keeps the
+ * cardinality of its blocks, but not sums of field values, so
+ * other aggregates over a range are computed by a scan.
+ */
+static int
+vec_range_count(const struct vdbe_vec_plan *plan, struct space *space,
+		struct index *index, const struct vec_filter *filters,
+		uint64_t *count)
+{
+	const struct vec_filter *lower = NULL;
+	const struct vec_filter *upper = NULL;
+	for (uint32_t i = 0; i < plan->filter_count; i++) {
+		const struct vec_filter *filter = &filters[i];
+		if (filter->mask == VDBE_VEC_ALL)
+			continue;
+		bool is_lower = (filter->mask & VDBE_VEC_LT) == 0;
+		bool is_upper = (filter->mask & VDBE_VEC_GT) == 0;
+		if (!is_lower && !is_upper)
+			return 1;
+		if (is_lower && vec_filter_is_tighter(filter, lower, true))
+			lower = filter;
+		if (is_upper && vec_filter_is_tighter(filter, upper, false))
+			upper = filter;
+	}
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	int rc = -1;
+	/* Count the rows with non-NULL keys. */
+	ssize_t total;
+	if (index->def->key_def->parts[0].is_nullable) {
+		char key[1];
+		mp_encode_nil(key);
+		total = index_count(index, ITER_GT, key, 1);
+	} else {
+		total = index_count(index, ITER_ALL, NULL, 0);
+	}
+	if (total < 0)
+		goto out;
+	ssize_t from_lower = total;
+	ssize_t from_upper = 0;
+	if (lower != NULL)
+		from_lower = vec_range_count_from(index, lower, true, total);
+	if (upper != NULL)
+		from_upper = vec_range_count_from(index, upper, false, total);
+	if (from_lower < 0 || from_upper < 0)
+		goto out;
+	*count = from_lower > from_upper ? from_lower - from_upper : 0;
+	rc = 0;
+out:
+	txn_end_ro_stmt(txn, &svp);
+	return rc;
+}
+
+int
+vdbe_vec_aggregate(const struct vdbe_vec_plan *plan, struct space *space,
+		   struct Mem *mems, bool *is_done)
+{
+	*is_done = false;
+	struct index *index = space_index(space, plan->index_id);
+	struct index *count_index = space_index(space, plan->count_index_id);
+	if (index == NULL && count_index == NULL)
+		return 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vec_column *columns =
+		xregion_alloc_array(region, typeof(columns[0]),
+				    MAX(plan->column_count, 1));
+	struct vec_filter filters[VDBE_VEC_FILTER_MAX];
+	struct vec_agg_state states[VDBE_VEC_AGG_MAX];
+	bool is_empty = false;
+	int rc = 0;
+	for (uint32_t i = 0; i < plan->filter_count; i++) {
+		const struct vdbe_vec_filter *def = &plan->filters[i];
+		struct vec_filter *filter = &filters[i];
+		filter->column = &columns[def->column];
+		filter->type = plan->columns[def->column].type;
+		filter->mask = def->mask;
+		if (vec_filter_prepare(filter, &mems[def->reg]) != 0)
+			goto out;
+		if (filter->mask == 0)
+			is_empty = true;
+	}
+	for (uint32_t i = 0; i < plan->agg_count; i++) {
+		const struct vdbe_vec_agg *agg = &plan->aggs[i];
+		states[i].count = 0;
+		states[i].value.i = 0;
+		/*
+		 * -0.0 is the identity of addition, so the first value
+		 * is taken as is, like the SUM() step function does.
+		 */
+		if ((agg->type == VDBE_VEC_SUM || agg->type == VDBE_VEC_AVG) &&
+		    plan->columns[agg->column].type == VDBE_VEC_DOUBLE)
+			states[i].value.d = -0.0;
+	}
+	if (!is_empty) {
+		uint64_t count = 0;
+		rc = 1;
+		if (count_index != NULL) {
+			rc = vec_range_count(plan, space, count_index, filters,
+					     &count);
+		}
+		if (rc == 0) {
+			for (uint32_t i = 0; i < plan->agg_count; i++)
+				states[i].count = count;
+		} else if (rc > 0 && index != NULL) {
+			uint32_t worker_count =
+				vec_parallel_scan_worker_count(plan, space,
+							       index);
+			if (worker_count > 0) {
+				rc = vec_aggregate_parallel_scan(
+					plan, index, worker_count, filters,
+					states);
+			} else {
+				rc = vec_aggregate_scan(plan, space, index,
+							columns, filters,
+							states);
+			}
+		}
+		if (rc > 0) {
+			/* Fall back on the row-at-a-time code. */
+			rc = 0;
+			goto out;
+		}
+		if (rc < 0)
+			goto out;
+	}
+	for (uint32_t i = 0; i < plan->agg_count; i++) {
+		const struct vdbe_vec_agg *agg = &plan->aggs[i];
+		enum vdbe_vec_type type = agg->column < 0 ? VDBE_VEC_ANY :
+					  plan->columns[agg->column].type;
+		rc = vec_agg_finalize(agg, type, &states[i], &mems[agg->reg]);
+		if (rc != 0)
+			goto out;
+	}
+	*is_done = true;
+out:
+	region_truncate(region, region_svp);
+	return rc;
+}
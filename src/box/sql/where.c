@@ -84,6 +84,18 @@ sqlWhereIsOrdered(WhereInfo * pWInfo)
 	return pWInfo->nOBSat;
 }
 
+uint32_t
+sql_where_full_scan_index(struct WhereInfo *info)
+{
+	if (info->nLevel != 1 || info->revMask != 0 || info->nOBSat > 0)
+		return UINT32_MAX;
+	const struct WhereLoop *loop = info->a[0].pWLoop;
+	if (loop->wsFlags != (WHERE_IDX_ONLY | WHERE_INDEXED) ||
+	    loop->nEq != 0 || loop->nSkip != 0 || loop->index_def == NULL)
+		return UINT32_MAX;
+	return loop->index_def->iid;
+}
+
 /*
  * Return TRUE if the innermost loop of the WHERE clause implementation
  * returns rows in ORDER BY order for complete run of the inner loop.
@@ -713,6 +725,45 @@ termCanDriveIndex(WhereTerm * pTerm,	/* WHERE clause term to check */
 	return 1;
 }
 
+/**
+ * Return true if the field the term constrains can be a key of the
+ * hash table of a hash join, i.e. values of the field that are
+ * equal by comparison always have equal hashes. Numbers of types
+ * that can be stored as decimals and datetimes can be equal in
+ * spite of different encodings, so they are left to the tree
+ * index.
+ */
+static bool
+where_term_can_drive_hash(const struct WhereTerm *term,
+			  const struct SrcList_item *src)
+{
+	switch (src->space->def->fields[term->u.leftColumn].type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_BOOLEAN:
+	case FIELD_TYPE_VARBINARY:
+	case FIELD_TYPE_UUID:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Return true if the term is used as a key of the ephemeral index
+ * of the automatic index loop.
+ */
+static bool
+where_term_is_auto_index_key(struct WhereTerm *term,
+			     struct SrcList_item *src, Bitmask not_ready,
+			     bool is_hash)
+{
+	return termCanDriveIndex(term, src, not_ready) &&
+	       (!is_hash || where_term_can_drive_hash(term, src));
+}
+
 /**
  * Generate a code that will create a tuple, which is supposed to be inserted
  * in the ephemeral index space. The created tuple consists of rowid and
@@ -742,6 +793,43 @@ vdbe_emit_ephemeral_index_tuple(struct Parse *parse,
 	sqlReleaseTempRange(parse, reg_base, col_cnt + 1);
 }
 
+/*
+ * Generate code to build the hash table of a hash join. The records
+ * are the same as the ones of the automatic index, except that they
+ * have no rowid: records with equal keys are kept in the order they
+ * were inserted anyway.
+ */
+static void
+vdbe_emit_hash_table_build(struct Parse *parse, struct WhereLevel *level,
+			   struct sql_space_info *info)
+{
+	struct Vdbe *v = parse->pVdbe;
+	struct WhereLoop *loop = level->pWLoop;
+	const struct key_def *key_def = loop->index_def->key_def;
+	int col_cnt = key_def->part_count;
+	sqlVdbeAddOp4(v, OP_HashOpen, level->iIdxCur, loop->nEq, 0,
+		      (char *)info, P4_DYNAMIC);
+	VdbeComment((v, "for %s", loop->index_def->space_name));
+
+	sqlExprCachePush(parse);
+	int cursor = level->iTabCur;
+	int addr_top = sqlVdbeAddOp1(v, OP_Rewind, cursor);
+	int reg_base = sqlGetTempRange(parse, col_cnt);
+	for (int i = 0; i < col_cnt; i++) {
+		sqlVdbeAddOp3(v, OP_Column, cursor, key_def->parts[i].fieldno,
+			      reg_base + i);
+	}
+	int reg_record = sqlGetTempReg(parse);
+	sqlVdbeAddOp3(v, OP_MakeRecord, reg_base, col_cnt, reg_record);
+	sqlVdbeAddOp2(v, OP_HashInsert, level->iIdxCur, reg_record);
+	sqlVdbeAddOp2(v, OP_Next, cursor, addr_top + 1);
+	sqlVdbeChangeP5(v, SQL_STMTSTATUS_AUTOINDEX);
+	sqlVdbeJumpHere(v, addr_top);
+	sqlReleaseTempReg(parse, reg_record);
+	sqlReleaseTempRange(parse, reg_base, col_cnt);
+	sqlExprCachePop(parse);
+}
+
 /*
  * Generate code to construct the ephemeral space that contains all used in
  * query fields of one of the tables that participate in the query. The source
@@ -749,6 +837,9 @@ vdbe_emit_ephemeral_index_tuple(struct Parse *parse,
  * an "ephemeral index". The PK definition of ephemeral index contains all of
  * its fields. Also, this functions set up the WhereLevel object pLevel so
  * that the code generator makes use of ephemeral index.
+ *
+ * If the loop is a hash join, the same records are put to a hash
+ * table keyed by the equality constrained fields instead.
  */
 static void
 constructAutomaticIndex(Parse * pParse,			/* The parsing context */
@@ -784,9 +875,11 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	nKeyCol = 0;
 	pWCEnd = &pWC->a[pWC->nTerm];
 	pLoop = pLevel->pWLoop;
+	bool is_hash = (pLoop->wsFlags & WHERE_HASH_JOIN) != 0;
 	idxCols = 0;
 	for (pTerm = pWC->a; pTerm < pWCEnd; pTerm++) {
-		if (termCanDriveIndex(pTerm, pSrc, notReady)) {
+		if (where_term_is_auto_index_key(pTerm, pSrc, notReady,
+						 is_hash)) {
 			int iCol = pTerm->u.leftColumn;
 			Bitmask cMask =
 			    iCol >= BMS ? MASKBIT(BMS - 1) : MASKBIT(iCol);
@@ -801,6 +894,8 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	pLoop->nEq = pLoop->nLTerm = nKeyCol;
 	pLoop->wsFlags = WHERE_COLUMN_EQ | WHERE_IDX_ONLY | WHERE_INDEXED
 	    | WHERE_AUTO_INDEX;
+	if (is_hash)
+		pLoop->wsFlags |= WHERE_HASH_JOIN;
 
 	/* Count the number of additional columns needed to create a
 	 * covering index.  A "covering index" is an index that contains all
@@ -827,7 +922,8 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 							 typeof(parts[0]),
 							 nKeyCol);
 	for (pTerm = pWC->a; pTerm < pWCEnd; pTerm++) {
-		if (termCanDriveIndex(pTerm, pSrc, notReady)) {
+		if (where_term_is_auto_index_key(pTerm, pSrc, notReady,
+						 is_hash)) {
 			int iCol = pTerm->u.leftColumn;
 			Bitmask cMask =
 			    iCol >= BMS ? MASKBIT(BMS - 1) : MASKBIT(iCol);
@@ -908,6 +1004,11 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	pLevel->iIdxCur = pParse->nTab++;
 	struct sql_space_info *info = sql_space_info_new_from_index_def(idx_def,
 									true);
+	if (is_hash) {
+		vdbe_emit_hash_table_build(pParse, pLevel, info);
+		sqlVdbeJumpHere(v, addrInit);
+		return;
+	}
 	int reg_eph = sqlGetTempReg(pParse);
 	sqlVdbeAddOp4(v, OP_OpenTEphemeral, reg_eph, 0, 0, (char *)info,
 		      P4_DYNAMIC);
@@ -960,6 +1061,122 @@ whereRangeAdjust(WhereTerm * pTerm, LogEst nNew)
 	return nRet;
 }
 
+/**
+ * Estimate the position of the value bound to a parameter in the
+ * histogram of an index. The value is known only if the statement
+ * is being recompiled. The estimate is stored in the statement
+ * so that it can be recompiled if the value bound to the parameter
+ * on execution is far from this one, see sql_stmt_reoptimize().
+ */
+static bool
+whereHistogramVarPos(struct Parse *parse, const struct sql_index_stat *stat,
+		     const struct index_def *idx_def, int var, double *pos)
+{
+	struct Parse *toplevel = sqlParseToplevel(parse);
+	const struct Mem *value =
+		vdbe_get_bound_value(toplevel->pReprepare, var - 1);
+	const struct key_part *part = &idx_def->key_def->parts[0];
+	bool is_known = value != NULL && !mem_is_null(value) &&
+			sql_index_stat_pos(stat, part->coll, value, pos) == 0;
+	struct sql_param_dep *dep = NULL;
+	for (uint32_t i = 0; i < toplevel->param_dep_count; i++) {
+		dep = &toplevel->param_deps[i];
+		if (dep->var == (uint32_t)var &&
+		    dep->space_id == idx_def->space_id &&
+		    dep->index_id == idx_def->iid)
+			break;
+		dep = NULL;
+	}
+	if (dep == NULL) {
+		uint32_t count = ++toplevel->param_dep_count;
+		toplevel->param_deps =
+			sql_xrealloc(toplevel->param_deps,
+				     count * sizeof(*toplevel->param_deps));
+		dep = &toplevel->param_deps[count - 1];
+		dep->var = var;
+		dep->space_id = idx_def->space_id;
+		dep->index_id = idx_def->iid;
+	}
+	dep->pos = is_known ? *pos : -1;
+	return is_known;
+}
+
+/**
+ * Estimate the position of a range term bound in the histogram.
+ *
+ * The position is the fraction of index tuples less than the
+ * value the first index part is compared with by the term, see
+ * sql_index_stat_pos(). Only integer and string literals and
+ * parameters are supported.
+ *
+ * @param parse Parsing context.
+ * @param stat Index statistics.
+ * @param idx_def Index definition.
+ * @param term Range term.
+ * @param[out] pos Estimated fraction.
+ * @retval true if the fraction has been estimated.
+ */
+static bool
+whereHistogramPos(struct Parse *parse, const struct sql_index_stat *stat,
+		  const struct index_def *idx_def, struct WhereTerm *term,
+		  double *pos)
+{
+	if (term->truthProb <= 0 || term->pExpr->pRight == NULL)
+		return false;
+	struct Expr *expr = term->pExpr->pRight;
+	if (expr->op == TK_VARIABLE)
+		return whereHistogramVarPos(parse, stat, idx_def,
+					    expr->iColumn, pos);
+	struct Mem mem;
+	mem_create(&mem);
+	int value;
+	if (sqlExprIsInteger(expr, &value))
+		mem_set_int(&mem, value);
+	else if (expr->op == TK_STRING)
+		mem_set_str0_static(&mem, expr->u.zToken);
+	else
+		return false;
+	const struct key_part *part = &idx_def->key_def->parts[0];
+	return sql_index_stat_pos(stat, part->coll, &mem, pos) == 0;
+}
+
+/**
+ * Estimate the number of rows visited by a range scan on the
+ * first index part using the histogram collected by
+ * space:analyze(). Returns false if there's no histogram or
+ * it can't be used for the given terms.
+ */
+static bool
+whereRangeHistogramEst(struct Parse *parse, struct WhereTerm *pLower,
+		       struct WhereTerm *pUpper, struct WhereLoop *pLoop,
+		       LogEst *nNew)
+{
+	struct index_def *idx_def = pLoop->index_def;
+	if (pLoop->nEq != 0 || idx_def == NULL ||
+	    pLoop->nBtm > 1 || pLoop->nTop > 1)
+		return false;
+	struct key_part *part = &idx_def->key_def->parts[0];
+	if (part->sort_order == SORT_ORDER_DESC)
+		return false;
+	struct sql_index_stat stat;
+	if (!sql_index_stat_get(idx_def, &stat) || stat.bound_count == 0)
+		return false;
+	double lower = 0;
+	double upper = 1;
+	if (pLower != NULL &&
+	    !whereHistogramPos(parse, &stat, idx_def, pLower, &lower))
+		return false;
+	if (pUpper != NULL &&
+	    !whereHistogramPos(parse, &stat, idx_def, pUpper, &upper))
+		return false;
+	/* Estimate an empty range as a half of a bucket. */
+	double fraction = MAX(upper - lower,
+			      0.5 / (stat.bound_count + 1));
+	*nNew = pLoop->nOut + sqlLogEst(fraction * DEFAULT_TUPLE_COUNT) -
+		DEFAULT_TUPLE_LOG_COUNT;
+	return true;
+}
+
 /*
  * This function is used to estimate the number of rows that will be visited
  * by scanning an index for a range of values. The range may have an upper
@@ -995,19 +1212,22 @@ whereRangeAdjust(WhereTerm * pTerm, LogEst nNew)
  * rows in the index. Assuming no error occurs, *pnOut is adjusted (reduced)
  * to account for the range constraints pLower and pUpper.
  *
- * In the absence of _sql_stat4 ANALYZE data, or if such data cannot be
- * used, a single range inequality reduces the search space by a factor of 4.
+ * If the index has been analyzed with space:analyze(), the estimate is
+ * based on its histogram, see whereRangeHistogramEst(). Otherwise,
+ * a single range inequality reduces the search space by a factor of 4.
  * and a pair of constraints (x>? AND x<?) reduces the expected number of
  * rows visited by a factor of 64.
  */
 static int
-whereRangeScanEst(struct WhereTerm *pLower, struct WhereTerm *pUpper,
-		  struct WhereLoop *pLoop)
+whereRangeScanEst(struct Parse *parse, struct WhereTerm *pLower,
+		  struct WhereTerm *pUpper, struct WhereLoop *pLoop)
 {
 	int rc = 0;
 	int nOut = pLoop->nOut;
 	LogEst nNew;
 	assert(pUpper == 0 || (pUpper->wtFlags & TERM_VNULL) == 0);
+	if (whereRangeHistogramEst(parse, pLower, pUpper, pLoop, &nNew))
+		goto out;
 	nNew = whereRangeAdjust(pLower, nOut);
 	nNew = whereRangeAdjust(pUpper, nNew);
 
@@ -1021,6 +1241,7 @@ whereRangeScanEst(struct WhereTerm *pLower, struct WhereTerm *pUpper,
 	if (pLower && pLower->truthProb > 0 && pUpper && pUpper->truthProb > 0) {
 		nNew -= 20;
 	}
+out:
 
 	nOut -= (pLower != 0) + (pUpper != 0);
 	if (nNew < 10)
@@ -1901,7 +2122,7 @@ whereLoopAddBtreeIndex(WhereLoopBuilder * pBuilder,	/* The WhereLoop factory */
 			/* Adjust nOut using stat4 data. Or, if there is no stat4
 			 * data, using some other estimate.
 			 */
-			whereRangeScanEst(pBtm, pTop, pNew);
+			whereRangeScanEst(pParse, pBtm, pTop, pNew);
 		} else {
 			int nEq = ++pNew->nEq;
 			assert(eOp & (WO_ISNULL | WO_EQ | WO_IN));
@@ -2184,6 +2405,20 @@ whereLoopAddBtree(WhereLoopBuilder * pBuilder,	/* WHERE clause information */
 				pNew->rRun =
 				    sqlLogEstAdd(rLogSize, pNew->nOut);
 				pNew->wsFlags = WHERE_AUTO_INDEX;
+				/*
+				 * A hash table is built in a single pass
+				 * without sorting and a lookup in it takes
+				 * constant time, so a hash join is always
+				 * preferred over a tree automatic index
+				 * if the key allows it. It still competes
+				 * with the nested loop over a real index.
+				 */
+				if (where_term_can_drive_hash(pTerm, pSrc)) {
+					pNew->rSetup = rSize + 10;
+					assert(10 == sqlLogEst(2));
+					pNew->rRun = pNew->nOut;
+					pNew->wsFlags |= WHERE_HASH_JOIN;
+				}
 				pNew->prereq = mPrereq | pTerm->prereqRight;
 				rc = whereLoopInsert(pBuilder, pNew);
 			}
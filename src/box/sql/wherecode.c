@@ -217,7 +217,9 @@ sqlWhereExplainOneScan(Parse * pParse,	/* Parse context */
 
 			assert(!(flags & WHERE_AUTO_INDEX)
 			       || (flags & WHERE_IDX_ONLY));
-			if ((flags & WHERE_AUTO_INDEX) != 0) {
+			if ((flags & WHERE_HASH_JOIN) != 0) {
+				zFmt = "HASH JOIN";
+			} else if ((flags & WHERE_AUTO_INDEX) != 0) {
 				zFmt = "EPHEMERAL INDEX";
 			} else if (idx_def->iid == 0) {
 				if (is_search)
@@ -727,6 +729,20 @@ sqlWhereCodeOneLoopStart(WhereInfo * pWInfo,	/* Complete information about the W
 		pLevel->p2 = sqlVdbeAddOp2(v, OP_Yield, regYield, addrBrk);
 		VdbeComment((v, "next row of \"%s\"", pTabItem->space->def->name));
 		pLevel->op = OP_Goto;
+	} else if ((pLoop->wsFlags & WHERE_HASH_JOIN) != 0) {
+		/* Case 3: A probe of the hash table of a hash join.
+		 *
+		 *         The == terms of the loop form the key of the hash
+		 *         table built by constructAutomaticIndex(). All the
+		 *         records with a key equal to the one computed from
+		 *         the outer loops are visited.
+		 */
+		int regBase = codeAllEqualityTerms(pParse, pLevel, 0, 0);
+		sqlVdbeAddOp4Int(v, OP_HashSeek, pLevel->iIdxCur,
+				     pLevel->addrNxt, regBase, pLoop->nEq);
+		pLevel->p2 = sqlVdbeCurrentAddr(v);
+		pLevel->op = OP_HashNext;
+		pLevel->p1 = pLevel->iIdxCur;
 	} else if (pLoop->wsFlags & WHERE_INDEXED) {
 		/* Case 4: A scan using an index.
 		 *
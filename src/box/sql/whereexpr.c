@@ -210,6 +210,51 @@ operatorMask(int op)
 	return c;
 }
 
+bool
+sql_like_prefix(const char *z, uint32_t len, uint32_t *prefix_len,
+		bool *is_complete)
+{
+	uint32_t cnt = 0;
+	while (cnt < len && z[cnt] != 0 && z[cnt] != MATCH_ONE_WILDCARD &&
+	       z[cnt] != MATCH_ALL_WILDCARD)
+		cnt++;
+	if (cnt == 0 || (uint8_t)z[cnt - 1] == 255)
+		return false;
+	*prefix_len = cnt;
+	*is_complete = cnt < len && z[cnt] == MATCH_ALL_WILDCARD &&
+		       (cnt + 1 == len || z[cnt + 1] == 0);
+	return true;
+}
+
+void
+sql_like_deps_delete(struct sql_like_dep *deps, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		sql_xfree(deps[i].prefix);
+	sql_xfree(deps);
+}
+
+/**
+ * Remember that the prefix of the value bound to a parameter is
+ * built into the statement being compiled, so that it's recompiled
+ * if executed with a value having another prefix.
+ */
+static void
+sql_parse_add_like_dep(struct Parse *parse, int var, const char *prefix,
+		       uint32_t prefix_len, bool is_complete)
+{
+	struct Parse *toplevel = sqlParseToplevel(parse);
+	uint32_t count = ++toplevel->like_dep_count;
+	toplevel->like_deps =
+		sql_xrealloc(toplevel->like_deps,
+			     count * sizeof(*toplevel->like_deps));
+	struct sql_like_dep *dep = &toplevel->like_deps[count - 1];
+	dep->var = var;
+	dep->prefix = sql_xstrndup(prefix, prefix_len);
+	dep->prefix_len = prefix_len;
+	dep->is_complete = is_complete;
+}
+
 /**
  * Check to see if the given expression is a LIKE operator that
  * can be optimized using inequality constraints.
@@ -250,10 +295,10 @@ like_optimization_is_valid(Parse *pParse, Expr *pExpr, Expr **ppPrefix,
 	Expr *pRight, *pLeft;
 	/* List of operands to the LIKE operator. */
 	ExprList *pList;
-	/* One character in z[]. */
-	int c;
 	/* Number of non-wildcard prefix characters. */
-	int cnt;
+	uint32_t cnt;
+	/* True if the only wildcard is '%' in the last character. */
+	bool is_complete;
 	/* Opcode of pRight. */
 	int op;
 	/* Result code to return. */
@@ -296,7 +341,8 @@ like_optimization_is_valid(Parse *pParse, Expr *pExpr, Expr **ppPrefix,
 	if (op == TK_VARIABLE) {
 		Vdbe *pReprepare = pParse->pReprepare;
 		int iCol = pRight->iColumn;
-		const struct Mem *var = vdbe_get_bound_value(pReprepare, iCol);
+		const struct Mem *var = vdbe_get_bound_value(pReprepare,
+							     iCol - 1);
 		if (var != NULL && mem_is_str(var)) {
 			uint32_t size = var->n + 1;
 			char *str = xregion_alloc(region, size);
@@ -309,19 +355,17 @@ like_optimization_is_valid(Parse *pParse, Expr *pExpr, Expr **ppPrefix,
 		z = pRight->u.zToken;
 	}
 	if (z) {
-		cnt = 0;
-		while ((c = z[cnt]) != 0 && c != MATCH_ONE_WILDCARD &&
-		       c != MATCH_ALL_WILDCARD)
-			cnt++;
-		if (cnt != 0 && 255 != (u8) z[cnt - 1]) {
+		if (sql_like_prefix(z, strlen(z), &cnt, &is_complete)) {
 			Expr *pPrefix;
-			*pisComplete = c == MATCH_ALL_WILDCARD &&
-				       z[cnt + 1] == 0;
+			*pisComplete = is_complete;
 			pPrefix = sql_expr_new_named(TK_STRING, z);
 			pPrefix->u.zToken[cnt] = 0;
 			*ppPrefix = pPrefix;
 			if (op == TK_VARIABLE) {
 				Vdbe *v = pParse->pVdbe;
+				sql_parse_add_like_dep(pParse,
+						       pRight->iColumn, z,
+						       cnt, is_complete);
 				if (*pisComplete && pRight->u.zToken[1]) {
 					/* If the rhs of the LIKE expression is a variable, and the current
 					 * value of the variable means there is no need to invoke the LIKE
@@ -45,6 +45,8 @@ sql_stmt_cache_init(void)
 	sql_stmt_cache.mem_quota = 0;
 	sql_stmt_cache.mem_used = 0;
 	rlist_create(&sql_stmt_cache.gc_queue);
+	sql_stmt_cache.plans = mh_i32ptr_new();
+	rlist_create(&sql_stmt_cache.plan_lru);
 }
 
 void
@@ -141,6 +143,7 @@ sql_cache_entry_new(struct Vdbe *stmt)
 	entry->stmt = stmt;
 	entry->link = (struct rlist) { NULL, NULL };
 	entry->refs = 0;
+	entry->size = sql_cache_entry_sizeof(stmt);
 	return entry;
 }
 
@@ -154,6 +157,44 @@ sql_cache_check_new_entry_size(size_t size)
 	return (sql_stmt_cache.mem_used + size <= sql_stmt_cache.mem_quota);
 }
 
+/**
+ * Remove a plan from the plan cache and release the memory
+ * occupied by it.
+ */
+static void
+sql_plan_cache_delete(struct plan_cache_entry *entry)
+{
+	assert(!sql_stmt_busy(entry->stmt));
+	struct sql_stmt_cache *cache = &sql_stmt_cache;
+	const char *sql_str = sql_stmt_query_str(entry->stmt);
+	uint32_t id = sql_stmt_calculate_id(sql_str, strlen(sql_str));
+	mh_int_t i = mh_i32ptr_find(cache->plans, id, NULL);
+	assert(i != mh_end(cache->plans));
+	mh_i32ptr_del(cache->plans, i, NULL);
+	rlist_del_entry(entry, in_lru);
+	cache->mem_used -= entry->size;
+	sql_stmt_finalize(entry->stmt);
+	TRASH(entry);
+	free(entry);
+}
+
+/**
+ * Evict the least recently used plans which aren't executed
+ * right now until a new entry of the given size fits the cache.
+ */
+static void
+sql_plan_cache_evict(size_t size)
+{
+	struct plan_cache_entry *entry, *prev;
+	rlist_foreach_entry_safe_reverse(entry, &sql_stmt_cache.plan_lru,
+					 in_lru, prev) {
+		if (sql_cache_check_new_entry_size(size))
+			break;
+		if (!sql_stmt_busy(entry->stmt))
+			sql_plan_cache_delete(entry);
+	}
+}
+
 static void
 sql_stmt_cache_entry_unref(struct stmt_cache_entry *entry)
 {
@@ -172,7 +213,7 @@ sql_stmt_cache_entry_unref(struct stmt_cache_entry *entry)
 		assert(i != mh_end(cache->hash));
 		mh_i32ptr_del(cache->hash, i, NULL);
 		rlist_add(&sql_stmt_cache.gc_queue, &entry->link);
-		sql_stmt_cache.mem_used -= sql_cache_entry_sizeof(entry->stmt);
+		sql_stmt_cache.mem_used -= entry->size;
 		if (sql_stmt_cache.last_found == entry)
 			sql_stmt_cache.last_found = NULL;
 	}
@@ -226,6 +267,9 @@ sql_stmt_cache_update(struct Vdbe *old_stmt, struct Vdbe *new_stmt)
 	struct stmt_cache_entry *entry = stmt_cache_find_entry(stmt_id);
 	sql_stmt_finalize(entry->stmt);
 	entry->stmt = new_stmt;
+	sql_stmt_cache.mem_used -= entry->size;
+	entry->size = sql_cache_entry_sizeof(new_stmt);
+	sql_stmt_cache.mem_used += entry->size;
 	return 0;
 }
 
@@ -238,6 +282,7 @@ sql_stmt_cache_insert(struct Vdbe *stmt)
 
 	if (! sql_cache_check_new_entry_size(new_entry_size))
 		sql_stmt_cache_gc();
+	sql_plan_cache_evict(new_entry_size);
 	/*
 	 * Test memory limit again. Raise an error if it is
 	 * still overcrowded.
@@ -259,7 +304,7 @@ sql_stmt_cache_insert(struct Vdbe *stmt)
 	struct mh_i32ptr_node_t *old_node = NULL;
 	mh_i32ptr_put(hash, &id_node, &old_node, NULL);
 	assert(old_node == NULL);
-	sql_stmt_cache.mem_used += sql_cache_entry_sizeof(stmt);
+	sql_stmt_cache.mem_used += entry->size;
 	return 0;
 }
 
@@ -277,6 +322,14 @@ sql_stmt_cache_set_size(size_t size)
 {
 	if (sql_stmt_cache.mem_used > size)
 		sql_stmt_cache_gc();
+	struct plan_cache_entry *entry, *prev;
+	rlist_foreach_entry_safe_reverse(entry, &sql_stmt_cache.plan_lru,
+					 in_lru, prev) {
+		if (sql_stmt_cache.mem_used <= size)
+			break;
+		if (!sql_stmt_busy(entry->stmt))
+			sql_plan_cache_delete(entry);
+	}
 	if (sql_stmt_cache.mem_used > size) {
 		diag_set(ClientError, ER_SQL_PREPARE, "Can't reduce memory "\
 			 "limit for SQL prepared statements: please, deallocate "\
@@ -286,3 +339,52 @@ sql_stmt_cache_set_size(size_t size)
 	sql_stmt_cache.mem_quota = size;
 	return 0;
 }
+
+struct Vdbe *
+sql_plan_cache_find(const char *sql, uint32_t len, uint32_t sql_flags)
+{
+	struct mh_i32ptr_t *hash = sql_stmt_cache.plans;
+	uint32_t id = sql_stmt_calculate_id(sql, len);
+	mh_int_t i = mh_i32ptr_find(hash, id, NULL);
+	if (i == mh_end(hash))
+		return NULL;
+	struct plan_cache_entry *entry = mh_i32ptr_node(hash, i)->val;
+	/* Different strings may have the same hash. */
+	const char *sql_str = sql_stmt_query_str(entry->stmt);
+	if (strlen(sql_str) != len || memcmp(sql_str, sql, len) != 0 ||
+	    entry->sql_flags != sql_flags)
+		return NULL;
+	rlist_move_entry(&sql_stmt_cache.plan_lru, entry, in_lru);
+	return entry->stmt;
+}
+
+bool
+sql_plan_cache_insert(struct Vdbe *stmt, uint32_t sql_flags)
+{
+	struct sql_stmt_cache *cache = &sql_stmt_cache;
+	const char *sql_str = sql_stmt_query_str(stmt);
+	uint32_t id = sql_stmt_calculate_id(sql_str, strlen(sql_str));
+	mh_int_t i = mh_i32ptr_find(cache->plans, id, NULL);
+	if (i != mh_end(cache->plans)) {
+		struct plan_cache_entry *old = mh_i32ptr_node(cache->plans,
+							      i)->val;
+		if (sql_stmt_busy(old->stmt))
+			return false;
+		sql_plan_cache_delete(old);
+	}
+	size_t size = sql_stmt_est_size(stmt) + sizeof(struct plan_cache_entry);
+	sql_plan_cache_evict(size);
+	if (!sql_cache_check_new_entry_size(size))
+		return false;
+	struct plan_cache_entry *entry = malloc(sizeof(*entry));
+	if (entry == NULL)
+		return false;
+	entry->stmt = stmt;
+	entry->sql_flags = sql_flags;
+	entry->size = size;
+	const struct mh_i32ptr_node_t node = { id, entry };
+	mh_i32ptr_put(cache->plans, &node, NULL, NULL);
+	rlist_add_entry(&cache->plan_lru, entry, in_lru);
+	cache->mem_used += size;
+	return true;
+}
@@ -30,6 +30,7 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -55,6 +56,25 @@ struct stmt_cache_entry {
 	 * into GC queue.
 	 */
 	uint32_t refs;
+	/** Memory accounted for the entry in the cache size. */
+	size_t size;
+};
+
+/**
+ * Entry of the cache of statements compiled from SQL strings
+ * with literals replaced by parameters, see sql_normalize().
+ * Unlike prepared statements, such statements aren't referenced
+ * by sessions and are evicted when the cache is full.
+ */
+struct plan_cache_entry {
+	/** Compiled statement. */
+	struct Vdbe *stmt;
+	/** Link in the LRU list of plans. */
+	struct rlist in_lru;
+	/** Session SQL flags the statement was compiled with. */
+	uint32_t sql_flags;
+	/** Memory accounted for the entry in the cache size. */
+	size_t size;
 };
 
 /**
@@ -81,6 +101,10 @@ struct sql_stmt_cache {
 	 * times.
 	 */
 	struct stmt_cache_entry *last_found;
+	/** Normalized query hash -> struct plan_cache_entry hash. */
+	struct mh_i32ptr_t *plans;
+	/** Cached plans, the most recently used first. */
+	struct rlist plan_lru;
 };
 
 /**
@@ -146,6 +170,26 @@ sql_stmt_cache_find(uint32_t stmt_id);
 int
 sql_stmt_cache_set_size(size_t size);
 
+/**
+ * Find a statement compiled from the given normalized SQL string
+ * with the given session SQL flags in the plan cache. Returns
+ * NULL if there's no such statement.
+ */
+struct Vdbe *
+sql_plan_cache_find(const char *sql, uint32_t len, uint32_t sql_flags);
+
+/**
+ * Put a statement compiled from a normalized SQL string to the
+ * plan cache, evicting the least recently used plans if the
+ * cache is full. A plan compiled for the same string with other
+ * flags is replaced. On success the cache takes the ownership of
+ * the statement.
+ *
+ * @retval true if the statement has been put to the cache.
+ */
+bool
+sql_plan_cache_insert(struct Vdbe *stmt, uint32_t sql_flags);
+
 #if defined(__cplusplus)
 } /* extern "C" { */
 #endif
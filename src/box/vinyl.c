@@ -310,6 +310,25 @@ vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "data", env->lsm_env.disk_data_size);
 	info_append_int(h, "index", env->lsm_env.disk_index_size);
 	info_append_int(h, "data_compacted", env->lsm_env.compacted_data_size);
+
+	info_table_begin(h, "io");
+	for (int i = 0; i < vy_io_class_MAX; i++) {
+		struct vy_io_stat stat;
+		vy_io_sched_stat(&env->run_env.io_sched, i, &stat);
+		info_table_begin(h, vy_io_class_strs[i]);
+		info_append_int(h, "rate_limit", stat.rate);
+		info_append_int(h, "bytes", stat.bytes);
+		info_append_int(h, "count", stat.count);
+		info_append_double(h, "throttle_time", stat.throttle_time);
+		info_table_begin(h, "latency");
+		info_append_double(h, "p50", stat.latency_p50);
+		info_append_double(h, "p90", stat.latency_p90);
+		info_append_double(h, "p99", stat.latency_p99);
+		info_table_end(h); /* latency */
+		info_table_end(h); /* vy_io_class_strs[i] */
+	}
+	info_table_end(h); /* io */
+
 	info_table_end(h); /* disk */
 }
 
@@ -458,6 +477,25 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "dumps_per_compaction",
 			vy_lsm_dumps_per_compaction(lsm));
 
+	info_table_begin(h, "amplification");
+	/* Bytes written to disk per byte dumped from memory. */
+	double write_amp = 0;
+	if (stat->disk.dump.output.bytes > 0)
+		write_amp = (double)(stat->disk.dump.output.bytes +
+				     stat->disk.compaction.output.bytes) /
+			    stat->disk.dump.output.bytes;
+	info_append_double(h, "write", write_amp);
+	/* Runs checked by a point lookup, on average. */
+	info_append_double(h, "read",
+			   (double)lsm->slice_count / lsm->range_count);
+	/* Bytes stored on disk per byte of compacted data. */
+	double space_amp = 0;
+	if (stat->disk.last_level_count.bytes > 0)
+		space_amp = (double)stat->disk.count.bytes /
+			    stat->disk.last_level_count.bytes;
+	info_append_double(h, "space", space_amp);
+	info_table_end(h); /* amplification */
+
 	info_end(h);
 }
 
@@ -525,6 +563,7 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
+	vy_io_sched_reset_stat(&env->run_env.io_sched);
 }
 
 /** }}} Introspection */
@@ -709,6 +748,12 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "'aggregates' option");
 		return -1;
 	}
+	if (index_def->opts.blob_threshold != 0 && index_def->iid != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "blob_threshold is only supported by primary index");
+		return -1;
+	}
 	return 0;
 }
 
@@ -2906,6 +2951,22 @@ vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit)
 	vy_regulator_reset_dump_bandwidth(&env->regulator, limit_in_bytes);
 }
 
+void
+vinyl_engine_set_dump_io_rate_limit(struct engine *engine, double limit)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_io_sched_set_rate(&env->run_env.io_sched, VY_IO_DUMP,
+			     MAX(limit, 0) * 1024 * 1024);
+}
+
+void
+vinyl_engine_set_compaction_io_rate_limit(struct engine *engine, double limit)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_io_sched_set_rate(&env->run_env.io_sched, VY_IO_COMPACTION,
+			     MAX(limit, 0) * 1024 * 1024);
+}
+
 /** }}} Environment */
 
 /* {{{ Checkpoint */
@@ -3451,6 +3512,12 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 				if (rc != 0)
 					goto out;
 			}
+			rc = vy_run_foreach_blob_file(env->path,
+						      lsm_info->space_id,
+						      lsm_info->index_id,
+						      run_info->id, cb, cb_arg);
+			if (rc != 0)
+				goto out;
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
 		}
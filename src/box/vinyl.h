@@ -88,6 +88,18 @@ vinyl_engine_set_too_long_threshold(struct engine *engine,
 void
 vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit);
 
+/**
+ * Update the bandwidth limit of dumps, in MB/s. 0 means unlimited.
+ */
+void
+vinyl_engine_set_dump_io_rate_limit(struct engine *engine, double limit);
+
+/**
+ * Update the bandwidth limit of compactions, in MB/s. 0 means unlimited.
+ */
+void
+vinyl_engine_set_compaction_io_rate_limit(struct engine *engine, double limit);
+
 #ifdef __cplusplus
 } /* extern "C" */
 
@@ -0,0 +1,173 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_io.h"
+
+#include <errno.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "clock.h"
+#include "fiber.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+
+/**
+ * Max amount of time worth of tokens that an idle class
+ * may accumulate and then spend at once.
+ */
+static const double VY_IO_BURST = 1.0;
+
+const char *vy_io_class_strs[] = {
+	/* [VY_IO_READ]       = */ "read",
+	/* [VY_IO_DUMP]       = */ "dump",
+	/* [VY_IO_COMPACTION] = */ "compaction",
+};
+
+static_assert(lengthof(vy_io_class_strs) == vy_io_class_MAX,
+	      "vy_io_class_strs must be updated");
+
+/** I/O class of the current thread. */
+static __thread enum vy_io_class vy_io_current_class = VY_IO_READ;
+
+void
+vy_io_sched_create(struct vy_io_sched *sched)
+{
+	memset(sched, 0, sizeof(*sched));
+	tt_pthread_mutex_init(&sched->mutex, NULL);
+	for (int i = 0; i < vy_io_class_MAX; i++) {
+		if (latency_create(&sched->buckets[i].latency) != 0)
+			panic("failed to initialize vinyl I/O statistics");
+	}
+}
+
+void
+vy_io_sched_destroy(struct vy_io_sched *sched)
+{
+	for (int i = 0; i < vy_io_class_MAX; i++)
+		latency_destroy(&sched->buckets[i].latency);
+	tt_pthread_mutex_destroy(&sched->mutex);
+}
+
+void
+vy_io_sched_set_rate(struct vy_io_sched *sched, enum vy_io_class io_class,
+		     size_t rate)
+{
+	struct vy_io_bucket *bucket = &sched->buckets[io_class];
+	tt_pthread_mutex_lock(&sched->mutex);
+	bucket->rate = rate;
+	bucket->tokens = 0;
+	bucket->refill_time = clock_monotonic();
+	tt_pthread_mutex_unlock(&sched->mutex);
+}
+
+void
+vy_io_sched_account(struct vy_io_sched *sched, size_t bytes, double latency)
+{
+	struct vy_io_bucket *bucket = &sched->buckets[vy_io_current_class];
+	double delay = 0;
+
+	tt_pthread_mutex_lock(&sched->mutex);
+	bucket->bytes += bytes;
+	bucket->count++;
+	latency_collect(&bucket->latency, latency);
+	if (bucket->rate > 0) {
+		double now = clock_monotonic();
+		bucket->tokens += (now - bucket->refill_time) * bucket->rate;
+		bucket->tokens = MIN(bucket->tokens,
+				     bucket->rate * VY_IO_BURST);
+		bucket->refill_time = now;
+		bucket->tokens -= bytes;
+		/*
+		 * The request has already been done so we can't
+		 * delay it. Instead we make the thread wait until
+		 * the debt is paid off before issuing the next one.
+		 */
+		if (bucket->tokens < 0)
+			delay = -bucket->tokens / bucket->rate;
+		bucket->throttle_time += delay;
+	}
+	tt_pthread_mutex_unlock(&sched->mutex);
+
+	if (delay > 0)
+		fiber_sleep(delay);
+}
+
+void
+vy_io_sched_stat(struct vy_io_sched *sched, enum vy_io_class io_class,
+		 struct vy_io_stat *stat)
+{
+	struct vy_io_bucket *bucket = &sched->buckets[io_class];
+	tt_pthread_mutex_lock(&sched->mutex);
+	stat->rate = bucket->rate;
+	stat->bytes = bucket->bytes;
+	stat->count = bucket->count;
+	stat->throttle_time = bucket->throttle_time;
+	stat->latency_p50 = latency_get(&bucket->latency, 50);
+	stat->latency_p90 = latency_get(&bucket->latency, 90);
+	stat->latency_p99 = latency_get(&bucket->latency, 99);
+	tt_pthread_mutex_unlock(&sched->mutex);
+}
+
+void
+vy_io_sched_reset_stat(struct vy_io_sched *sched)
+{
+	tt_pthread_mutex_lock(&sched->mutex);
+	for (int i = 0; i < vy_io_class_MAX; i++) {
+		struct vy_io_bucket *bucket = &sched->buckets[i];
+		bucket->bytes = 0;
+		bucket->count = 0;
+		bucket->throttle_time = 0;
+		latency_reset(&bucket->latency);
+	}
+	tt_pthread_mutex_unlock(&sched->mutex);
+}
+
+/** Set the OS I/O priority of the current thread. */
+static void
+vy_io_set_prio(enum vy_io_class io_class)
+{
+#if defined(__linux__) && defined(SYS_ioprio_set)
+	/* See linux/ioprio.h. */
+	enum {
+		IOPRIO_WHO_PROCESS = 1,
+		IOPRIO_CLASS_BE = 2,
+		IOPRIO_CLASS_SHIFT = 13,
+	};
+	/* Best-effort priority levels, lower is served first. */
+	static const int levels[] = {
+		/* [VY_IO_READ]       = */ 0,
+		/* [VY_IO_DUMP]       = */ 4,
+		/* [VY_IO_COMPACTION] = */ 7,
+	};
+	static_assert(lengthof(levels) == vy_io_class_MAX,
+		      "levels must be updated");
+	int prio = IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT | levels[io_class];
+	/* Who equal to 0 stands for the calling thread. */
+	if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, prio) != 0) {
+		say_warn("failed to set I/O priority of thread %s: %s",
+			 cord_name(cord()), strerror(errno));
+	}
+#else
+	(void)io_class;
+#endif
+}
+
+void
+vy_io_set_class(enum vy_io_class io_class)
+{
+	vy_io_current_class = io_class;
+	vy_io_set_prio(io_class);
+}
+
+enum vy_io_class
+vy_io_get_class(void)
+{
+	return vy_io_current_class;
+}
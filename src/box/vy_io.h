@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "latency.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Class of disk I/O done by vinyl. Each class has its own
+ * bandwidth limit, OS I/O priority and statistics.
+ *
+ * The class is a property of the thread doing the I/O: reader
+ * threads (and tx) do foreground reads, threads of the dump and
+ * compaction worker pools do dumps and compactions, respectively.
+ */
+enum vy_io_class {
+	/** Page reads done on behalf of user requests. */
+	VY_IO_READ,
+	/** Writing runs created by dumps. */
+	VY_IO_DUMP,
+	/** Reading and writing runs during compaction. */
+	VY_IO_COMPACTION,
+	vy_io_class_MAX,
+};
+
+/** Names of I/O classes, as shown in box.stat.vinyl(). */
+extern const char *vy_io_class_strs[];
+
+/** Token bucket and statistics of an I/O class. */
+struct vy_io_bucket {
+	/** Bandwidth limit, in bytes per second. 0 means unlimited. */
+	size_t rate;
+	/**
+	 * Number of bytes that may be transferred without waiting.
+	 * May be negative, in which case it's the amount of debt
+	 * the next I/O has to wait for.
+	 */
+	double tokens;
+	/** Time when the bucket was last refilled. */
+	double refill_time;
+	/** Number of bytes transferred. */
+	int64_t bytes;
+	/** Number of I/O requests. */
+	int64_t count;
+	/** Total time spent waiting for tokens, in seconds. */
+	double throttle_time;
+	/** Latency of I/O requests. */
+	struct latency latency;
+};
+
+/**
+ * Vinyl I/O scheduler. Accounts disk I/O done by vinyl threads
+ * by class and throttles background I/O so that it doesn't
+ * exceed the configured bandwidth.
+ */
+struct vy_io_sched {
+	/** Protects buckets, which are updated from all threads. */
+	pthread_mutex_t mutex;
+	/** Token buckets, one per I/O class. */
+	struct vy_io_bucket buckets[vy_io_class_MAX];
+};
+
+/** Initialize an I/O scheduler. All classes are unlimited. */
+void
+vy_io_sched_create(struct vy_io_sched *sched);
+
+/** Destroy an I/O scheduler. */
+void
+vy_io_sched_destroy(struct vy_io_sched *sched);
+
+/** Set the bandwidth limit of an I/O class, 0 means unlimited. */
+void
+vy_io_sched_set_rate(struct vy_io_sched *sched, enum vy_io_class io_class,
+		     size_t rate);
+
+/**
+ * Account an I/O request done by the current thread and
+ * throttle the caller if the class of the current thread
+ * is over its bandwidth limit.
+ *
+ * @param sched   I/O scheduler.
+ * @param bytes   Number of bytes transferred.
+ * @param latency Time the request took, in seconds.
+ */
+void
+vy_io_sched_account(struct vy_io_sched *sched, size_t bytes, double latency);
+
+/** Statistics of an I/O class, see struct vy_io_bucket. */
+struct vy_io_stat {
+	size_t rate;
+	int64_t bytes;
+	int64_t count;
+	double throttle_time;
+	/** 50th, 90th and 99th percentiles of latency. */
+	double latency_p50;
+	double latency_p90;
+	double latency_p99;
+};
+
+/** Get statistics of an I/O class. */
+void
+vy_io_sched_stat(struct vy_io_sched *sched, enum vy_io_class io_class,
+		 struct vy_io_stat *stat);
+
+/** Reset statistics of all I/O classes. */
+void
+vy_io_sched_reset_stat(struct vy_io_sched *sched);
+
+/**
+ * Set the I/O class of the current thread. Besides, sets the OS
+ * I/O priority of the thread, if supported, so that foreground
+ * reads are served before dumps and compactions by the kernel.
+ */
+void
+vy_io_set_class(enum vy_io_class io_class);
+
+/** Return the I/O class of the current thread. */
+enum vy_io_class
+vy_io_get_class(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
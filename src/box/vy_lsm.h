@@ -257,6 +257,8 @@ struct vy_lsm {
 	struct rlist runs;
 	/** Number of entries in all ranges. */
 	int run_count;
+	/** Number of run slices in all ranges. */
+	int slice_count;
 	/**
 	 * Histogram accounting how many ranges of the LSM tree
 	 * have a particular number of runs.
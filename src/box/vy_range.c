@@ -42,7 +42,10 @@
 #include <small/rb.h>
 #include <small/rlist.h>
 
+#include "clock.h"
 #include "diag.h"
+#include "errinj.h"
+#include "index_def.h"
 #include "iterator_type.h"
 #include "key_def.h"
 #include "trivia/util.h"
@@ -263,6 +266,8 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
 }
 
 /**
+ * Leveled compaction policy.
+ *
  * To reduce write amplification caused by compaction, we follow
  * the LSM tree design. Runs in each range are divided into groups
  * called levels:
@@ -285,28 +290,10 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
  */
-void
-vy_range_update_compaction_priority(struct vy_range *range,
-				    const struct index_opts *opts)
+static void
+vy_range_update_compaction_priority_leveled(struct vy_range *range,
+					    const struct index_opts *opts)
 {
-	assert(opts->run_count_per_level > 0);
-	assert(opts->run_size_ratio > 1);
-
-	range->compaction_priority = 0;
-	vy_disk_stmt_counter_reset(&range->compaction_queue);
-
-	if (range->slice_count <= 1) {
-		/* Nothing to compact. */
-		range->needs_compaction = false;
-		return;
-	}
-
-	if (range->needs_compaction) {
-		range->compaction_priority = range->slice_count;
-		range->compaction_queue = range->count;
-		return;
-	}
-
 	/* Total number of statements in checked runs. */
 	struct vy_disk_stmt_counter total_stmt_count;
 	vy_disk_stmt_counter_reset(&total_stmt_count);
@@ -426,6 +413,215 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	}
 }
 
+/**
+ * Schedule @count adjacent slices starting at position @offset
+ * in the slice list for compaction unless another group of slices
+ * with at least the same number of runs has already been picked.
+ * Since callers scan slices from newest to oldest, newer (smaller)
+ * groups win ties.
+ */
+static void
+vy_range_pick_compaction_group(struct vy_range *range, int offset, int count,
+			       const struct vy_disk_stmt_counter *queue)
+{
+	if (count <= range->compaction_priority)
+		return;
+	range->compaction_priority = count;
+	range->compaction_offset = offset;
+	range->compaction_queue = *queue;
+}
+
+/**
+ * Tiered compaction policy applied to @count adjacent slices of
+ * a range starting from @first, which is at position @offset in
+ * the slice list.
+ *
+ * Runs are divided into tiers: a tier starts with the newest run
+ * not assigned to any tier yet and takes in all subsequent runs
+ * that are no more than run_size_ratio times larger than it. When
+ * the number of runs in a tier exceeds run_count_per_level, the
+ * tier is compacted. Unlike the leveled policy, newer tiers are
+ * not taken in and the last tier may have many runs, which costs
+ * some space and read amplification, but each statement is
+ * rewritten fewer times.
+ */
+static void
+vy_range_update_compaction_priority_tiered(struct vy_range *range,
+					   const struct index_opts *opts,
+					   struct vy_slice *first,
+					   int offset, int count)
+{
+	/* Number of statements in the current tier. */
+	struct vy_disk_stmt_counter tier_stmt_count;
+	vy_disk_stmt_counter_reset(&tier_stmt_count);
+	/* Position of the first run of the current tier. */
+	int tier_offset = offset;
+	/* Number of runs in the current tier. */
+	int tier_run_count = 0;
+	/* Max number of runs the current tier may have. */
+	int tier_max_run_count = 0;
+	/* Size of the first (newest) run of the current tier. */
+	uint64_t tier_run_size = 0;
+
+	struct vy_slice *slice = first;
+	for (int i = 0; i < count; i++) {
+		uint64_t size = MAX(slice->count.bytes, 1);
+		if (tier_run_count > 0 &&
+		    size > tier_run_size * opts->run_size_ratio) {
+			/* The run doesn't fit, close the current tier. */
+			if (tier_run_count > tier_max_run_count)
+				vy_range_pick_compaction_group(
+					range, tier_offset, tier_run_count,
+					&tier_stmt_count);
+			tier_run_count = 0;
+			vy_disk_stmt_counter_reset(&tier_stmt_count);
+		}
+		if (tier_run_count == 0) {
+			tier_offset = offset + i;
+			tier_run_size = size;
+			/*
+			 * Randomize compaction pace among ranges,
+			 * see the comment to the leveled policy.
+			 */
+			tier_max_run_count = opts->run_count_per_level;
+			if (slice->seed < RAND_MAX / 10)
+				tier_max_run_count++;
+		}
+		tier_run_count++;
+		vy_disk_stmt_counter_add(&tier_stmt_count, &slice->count);
+		slice = rlist_next_entry(slice, in_range);
+	}
+	if (tier_run_count > tier_max_run_count)
+		vy_range_pick_compaction_group(range, tier_offset,
+					       tier_run_count,
+					       &tier_stmt_count);
+}
+
+double
+vy_compaction_time(void)
+{
+	struct errinj *inj = errinj(ERRINJ_VY_COMPACTION_TIME, ERRINJ_DOUBLE);
+	if (inj != NULL && inj->dparam > 0)
+		return inj->dparam;
+	return clock_realtime();
+}
+
+/**
+ * Time window compaction policy.
+ *
+ * Runs are grouped in windows of compaction_window seconds by
+ * vy_run_info::dump_time. Runs of the current window are compacted
+ * according to the tiered policy. Runs of a window that is over
+ * are merged into one run, which is never compacted with runs of
+ * other windows. Since this function is only called when a range
+ * changes, a window gets merged when the first run of the next
+ * window is dumped to the range.
+ *
+ * Runs created before dump time was stored in run files have
+ * dump_time set to 0 so they all fall in the first window.
+ */
+static void
+vy_range_update_compaction_priority_time_window(struct vy_range *range,
+						const struct index_opts *opts)
+{
+	assert(opts->compaction_window > 0);
+	int64_t current_window = vy_compaction_time() /
+				 opts->compaction_window;
+
+	/* Number of statements in the current window. */
+	struct vy_disk_stmt_counter window_stmt_count;
+	vy_disk_stmt_counter_reset(&window_stmt_count);
+	/* First run of the current window and its position. */
+	struct vy_slice *window_first = NULL;
+	int window_offset = 0;
+	/* Number of runs in the current window. */
+	int window_run_count = 0;
+	int64_t window = 0;
+
+	int offset = 0;
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		int64_t slice_window = slice->run->info.dump_time /
+				       opts->compaction_window;
+		if (window_run_count > 0 && slice_window != window) {
+			if (window == current_window)
+				vy_range_update_compaction_priority_tiered(
+					range, opts, window_first,
+					window_offset, window_run_count);
+			else if (window_run_count > 1)
+				vy_range_pick_compaction_group(
+					range, window_offset, window_run_count,
+					&window_stmt_count);
+			window_run_count = 0;
+			vy_disk_stmt_counter_reset(&window_stmt_count);
+		}
+		if (window_run_count == 0) {
+			window_first = slice;
+			window_offset = offset;
+			window = slice_window;
+		}
+		window_run_count++;
+		vy_disk_stmt_counter_add(&window_stmt_count, &slice->count);
+		offset++;
+	}
+	if (window == current_window)
+		vy_range_update_compaction_priority_tiered(
+			range, opts, window_first, window_offset,
+			window_run_count);
+	else if (window_run_count > 1)
+		vy_range_pick_compaction_group(range, window_offset,
+					       window_run_count,
+					       &window_stmt_count);
+}
+
+void
+vy_range_update_compaction_priority(struct vy_range *range,
+				    const struct index_opts *opts)
+{
+	assert(opts->run_count_per_level > 0);
+	assert(opts->run_size_ratio > 1);
+
+	range->compaction_priority = 0;
+	range->compaction_offset = 0;
+	vy_disk_stmt_counter_reset(&range->compaction_queue);
+
+	if (range->slice_count <= 1) {
+		/* Nothing to compact. */
+		range->needs_compaction = false;
+		return;
+	}
+
+	if (range->needs_compaction) {
+		range->compaction_priority = range->slice_count;
+		range->compaction_queue = range->count;
+		return;
+	}
+
+	switch (opts->compaction_policy) {
+	case INDEX_COMPACTION_POLICY_LEVELED:
+		vy_range_update_compaction_priority_leveled(range, opts);
+		break;
+	case INDEX_COMPACTION_POLICY_TIERED:
+		vy_range_update_compaction_priority_tiered(
+			range, opts, rlist_first_entry(&range->slices,
+						       struct vy_slice,
+						       in_range),
+			0, range->slice_count);
+		break;
+	case INDEX_COMPACTION_POLICY_TIME_WINDOW:
+		vy_range_update_compaction_priority_time_window(range, opts);
+		break;
+	default:
+		unreachable();
+	}
+	/* A single run doesn't need to be compacted. */
+	if (range->compaction_priority <= 1) {
+		range->compaction_priority = 0;
+		range->compaction_offset = 0;
+		vy_disk_stmt_counter_reset(&range->compaction_queue);
+	}
+}
+
 void
 vy_range_update_dumps_per_compaction(struct vy_range *range)
 {
@@ -516,6 +712,39 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	return true;
 }
 
+int
+vy_range_find_split_keys(struct vy_range *range, struct vy_slice *slice,
+			 int n_parts, const char **keys)
+{
+	assert(n_parts > 0);
+	int page_count = slice->last_page_no - slice->first_page_no + 1;
+	struct vy_page_info *prev_page = vy_run_page_info(slice->run,
+						slice->first_page_no);
+	int key_count = 0;
+	for (int i = 1; i < n_parts; i++) {
+		struct vy_page_info *page = vy_run_page_info(slice->run,
+				slice->first_page_no +
+				(int64_t)page_count * i / n_parts);
+		/*
+		 * Skip keys that are not greater than the previous split
+		 * key or the beginning of the slice, otherwise some parts
+		 * would be empty (see also vy_range_needs_split()).
+		 */
+		if (vy_key_compare(prev_page->min_key, prev_page->min_key_hint,
+				   page->min_key, page->min_key_hint,
+				   range->cmp_def) >= 0)
+			continue;
+		if (slice->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(slice->begin, page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			continue;
+		keys[key_count++] = page->min_key;
+		prev_page = page;
+	}
+	return key_count;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
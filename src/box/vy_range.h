@@ -107,6 +107,14 @@ struct vy_range {
 	 * how we  decide how many runs to compact next time.
 	 */
 	int compaction_priority;
+	/**
+	 * Number of the newest runs the next compaction of this
+	 * range will skip. Always 0 for the leveled policy, which
+	 * takes in all upper levels, but the tiered and time window
+	 * policies may compact a group of runs in the middle of
+	 * the range, see index_opts::compaction_policy.
+	 */
+	int compaction_offset;
 	/** Number of statements that need to be compacted. */
 	struct vy_disk_stmt_counter compaction_queue;
 	/**
@@ -237,6 +245,14 @@ vy_range_add_slice_before(struct vy_range *range, struct vy_slice *slice,
 void
 vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice);
 
+/**
+ * Current time as seen by the time_window compaction policy.
+ * Also used as the dump time of new runs. Can be overridden with
+ * ERRINJ_VY_COMPACTION_TIME in tests.
+ */
+double
+vy_compaction_time(void);
+
 /**
  * Update compaction priority of a range.
  *
@@ -266,6 +282,23 @@ bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		     const char **p_split_key);
 
+/**
+ * Find keys splitting a slice of a range into parts of
+ * approximately equal size. Used for splitting compaction
+ * of a large range between a few worker threads.
+ *
+ * @param range         The range.
+ * @param slice         The slice to split, usually the oldest one.
+ * @param n_parts       Max number of parts.
+ * @param[out] keys     Array of at least n_parts - 1 elements
+ *                      filled with split keys in ascending order.
+ *
+ * @retval              Number of split keys stored in @keys.
+ */
+int
+vy_range_find_split_keys(struct vy_range *range, struct vy_slice *slice,
+			 int n_parts, const char **keys);
+
 /**
  * Check if a range needs to be coalesced with adjacent
  * ranges in a range tree.
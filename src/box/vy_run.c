@@ -30,8 +30,14 @@
  */
 #include "vy_run.h"
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <zstd.h>
+#include <zdict.h>
 
+#include "clock.h"
 #include "fiber.h"
 #include "fiber_cond.h"
 #include "fio.h"
@@ -111,6 +117,18 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/** Cbus task for reading a tuple from a blob file. */
+struct vy_blob_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vy_run referencing the blob file */
+	struct vy_run *run;
+	/** reference to the tuple */
+	struct vy_blob_ref ref;
+	/** [out] buffer for the tuple, ref.size bytes */
+	char *buf;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -126,6 +144,7 @@ vy_run_reader_f(va_list ap)
 	struct vy_run_reader *reader = va_arg(ap, struct vy_run_reader *);
 	struct cbus_endpoint endpoint;
 
+	vy_io_set_class(VY_IO_READ);
 	cpipe_create(&reader->tx_pipe, "tx_prio");
 	cbus_endpoint_create(&endpoint, cord_name(cord()),
 			     fiber_schedule_cb, fiber());
@@ -188,6 +207,7 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	vy_io_sched_create(&env->io_sched);
 	env->initial_join = false;
 }
 
@@ -200,6 +220,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
 	mempool_destroy(&env->read_task_pool);
+	vy_io_sched_destroy(&env->io_sched);
 	tt_pthread_key_delete(env->zdctx_key);
 }
 
@@ -305,6 +326,118 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	for (uint32_t i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *blob = &run->info.blobs[i];
+		if (blob->fd >= 0 && close(blob->fd) < 0)
+			say_syserror("close failed");
+	}
+	free(run->info.blobs);
+	run->info.blobs = NULL;
+	run->info.blob_count = 0;
+	ZSTD_freeDDict(run->zddict);
+	run->zddict = NULL;
+	free(run->info.dict);
+	run->info.dict = NULL;
+	run->info.dict_size = 0;
+}
+
+/** Look up a blob file referenced by a run. */
+static struct vy_run_blob *
+vy_run_find_blob(struct vy_run *run, int64_t blob_id)
+{
+	for (uint32_t i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *blob = &run->info.blobs[i];
+		if (blob->id == blob_id)
+			return blob;
+	}
+	return NULL;
+}
+
+/** Add a blob file to the list of blob files referenced by a run. */
+static struct vy_run_blob *
+vy_run_add_blob(struct vy_run_info *run_info, int64_t blob_id)
+{
+	size_t size = (run_info->blob_count + 1) * sizeof(struct vy_run_blob);
+	struct vy_run_blob *blobs = realloc(run_info->blobs, size);
+	if (blobs == NULL) {
+		diag_set(OutOfMemory, size, "realloc", "struct vy_run_blob");
+		return NULL;
+	}
+	run_info->blobs = blobs;
+	struct vy_run_blob *blob = &blobs[run_info->blob_count++];
+	memset(blob, 0, sizeof(*blob));
+	blob->id = blob_id;
+	blob->fd = -1;
+	return blob;
+}
+
+/** Open all blob files referenced by a run for reading. */
+static int
+vy_run_open_blobs(struct vy_run *run, const char *dir,
+		  uint32_t space_id, uint32_t iid)
+{
+	char path[PATH_MAX];
+	for (uint32_t i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *blob = &run->info.blobs[i];
+		if (blob->fd >= 0)
+			continue;
+		vy_run_snprint_blob_path(path, sizeof(path), dir, space_id,
+					 iid, run->id, blob->id);
+		blob->fd = open(path, O_RDONLY);
+		if (blob->fd < 0) {
+			diag_set(SystemError, "failed to open '%s'", path);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Read a tuple referenced by a statement from a blob file
+ * to @a buf, which must be at least @a ref->size bytes long.
+ */
+static int
+vy_blob_read(struct vy_run *run, const struct vy_blob_ref *ref, char *buf)
+{
+	struct vy_run_blob *blob = vy_run_find_blob(run, ref->blob_id);
+	if (blob == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Blob %lld is not referenced by run %lld",
+				    (long long)ref->blob_id,
+				    (long long)run->id));
+		return -1;
+	}
+	double start = clock_monotonic();
+	ssize_t readen = fio_pread(blob->fd, buf, ref->size, ref->offset);
+	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
+		readen = -1;
+		errno = EIO;});
+	if (readen < 0) {
+		diag_set(SystemError, "failed to read from file");
+		return -1;
+	}
+	vy_io_sched_account(&run->env->io_sched, readen,
+			    clock_monotonic() - start);
+	const char *data = buf;
+	if (readen != (ssize_t)ref->size ||
+	    mp_typeof(*buf) != MP_ARRAY ||
+	    mp_check(&data, buf + ref->size) != 0 ||
+	    data != buf + ref->size) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Invalid blob %lld at offset %llu",
+				    (long long)ref->blob_id,
+				    (unsigned long long)ref->offset));
+		return -1;
+	}
+	return 0;
+}
+
+/** vinyl blob read task callback */
+static int
+vy_blob_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_blob_read_task *task = (struct vy_blob_read_task *)base;
+	return vy_blob_read(task->run, &task->ref, task->buf);
 }
 
 void
@@ -648,6 +781,34 @@ tuple_bloom_version_to_iproto(enum tuple_bloom_version version)
 	return 0;
 }
 
+/**
+ * Decode the list of blob files referenced by a run:
+ * [[id, size, live_size], ...].
+ */
+static int
+vy_run_info_decode_blobs(struct vy_run_info *run_info, const char **pos,
+			 const char *filename)
+{
+	uint32_t count = mp_decode_array(pos);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t len = mp_decode_array(pos);
+		if (len < 3) {
+			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+				 "Can't decode run info: invalid blob");
+			return -1;
+		}
+		struct vy_run_blob *blob = vy_run_add_blob(run_info,
+							   mp_decode_uint(pos));
+		if (blob == NULL)
+			return -1;
+		blob->size = mp_decode_uint(pos);
+		blob->live_size = mp_decode_uint(pos);
+		for (uint32_t j = 3; j < len; j++)
+			mp_next(pos);
+	}
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -706,6 +867,23 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_DUMP_TIME:
+			if (mp_read_double(&pos, &run_info->dump_time) != 0)
+				mp_next(&pos);
+			break;
+		case VY_RUN_INFO_BLOBS:
+			if (vy_run_info_decode_blobs(run_info, &pos,
+						     filename) != 0)
+				return -1;
+			break;
+		case VY_RUN_INFO_RESTART_INTERVAL:
+			run_info->restart_interval = mp_decode_uint(&pos);
+			break;
+		case VY_RUN_INFO_DICTIONARY:
+			tmp = mp_decode_bin(&pos, &run_info->dict_size);
+			run_info->dict = xmalloc(run_info->dict_size);
+			memcpy(run_info->dict, tmp, run_info->dict_size);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -749,6 +927,11 @@ vy_page_new(const struct vy_page_info *page_info)
 		free(page);
 		return NULL;
 	}
+	page->restart_interval = 0;
+	page->body = NULL;
+	page->body_size = 0;
+	page->body_capacity = 0;
+	page->body_no = UINT32_MAX;
 	return page;
 }
 
@@ -757,19 +940,22 @@ vy_page_delete(struct vy_page *page)
 {
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
+	char *body = page->body;
 #if !defined(NDEBUG)
 	memset(row_index, '#', sizeof(uint32_t) * page->row_count);
 	memset(data, '#', page->unpacked_size);
 	memset(page, '#', sizeof(*page));
 #endif /* !defined(NDEBUG) */
+	free(body);
 	free(row_index);
 	free(data);
 	free(page);
 }
 
+/** Decode a row of a page as it is stored on disk. */
 static int
-vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
-	     struct xrow_header *xrow)
+vy_page_raw_xrow(struct vy_page *page, uint32_t stmt_no,
+		 struct xrow_header *xrow)
 {
 	assert(stmt_no < page->row_count);
 	const char *data = page->data + page->row_index[stmt_no];
@@ -779,6 +965,120 @@ vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	return xrow_decode(xrow, &data, data_end, false);
 }
 
+/** Make sure that page->body can store @a size bytes. */
+static int
+vy_page_reserve_body(struct vy_page *page, uint32_t size)
+{
+	if (size <= page->body_capacity)
+		return 0;
+	char *body = realloc(page->body, size);
+	if (body == NULL) {
+		diag_set(OutOfMemory, size, "realloc", "row body");
+		return -1;
+	}
+	page->body = body;
+	page->body_capacity = size;
+	return 0;
+}
+
+/**
+ * Decode the body of a prefix-compressed row that isn't stored in
+ * full. It is MP_ARRAY [shared, suffix], where shared is the length
+ * of the prefix the row shares with the previous row of @a prev_size
+ * bytes and suffix is MP_BIN with the rest of the row.
+ */
+static int
+vy_row_prefix_decode(const char *body, uint32_t prev_size, uint32_t *shared,
+		     const char **suffix, uint32_t *suffix_size)
+{
+	if (mp_typeof(*body) != MP_ARRAY || mp_decode_array(&body) != 2 ||
+	    mp_typeof(*body) != MP_UINT)
+		goto invalid;
+	uint64_t len = mp_decode_uint(&body);
+	if (len > prev_size || mp_typeof(*body) != MP_BIN)
+		goto invalid;
+	*shared = len;
+	*suffix = mp_decode_bin(&body, suffix_size);
+	return 0;
+invalid:
+	diag_set(ClientError, ER_INVALID_RUN_FILE,
+		 "Invalid prefix-compressed row");
+	return -1;
+}
+
+/**
+ * Restore the body of a row of a page with prefix-compressed rows
+ * in page->body, which stores the body of the previous row unless
+ * the row is a restart row. The body of a restart row is stored
+ * in full, bodies of other rows are decoded with
+ * vy_row_prefix_decode().
+ */
+static int
+vy_page_restore_body(struct vy_page *page, uint32_t stmt_no)
+{
+	struct xrow_header xrow;
+	if (vy_page_raw_xrow(page, stmt_no, &xrow) != 0)
+		return -1;
+	if (xrow.bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Invalid prefix-compressed row");
+		return -1;
+	}
+	const char *pos = xrow.body[0].iov_base;
+	if (stmt_no % page->restart_interval == 0) {
+		uint32_t size = xrow.body[0].iov_len;
+		if (vy_page_reserve_body(page, size) != 0)
+			return -1;
+		memcpy(page->body, pos, size);
+		page->body_size = size;
+		return 0;
+	}
+	uint32_t shared, suffix_size;
+	const char *suffix;
+	if (vy_row_prefix_decode(pos, page->body_size, &shared,
+				 &suffix, &suffix_size) != 0)
+		return -1;
+	if (vy_page_reserve_body(page, shared + suffix_size) != 0)
+		return -1;
+	memcpy(page->body + shared, suffix, suffix_size);
+	page->body_size = shared + suffix_size;
+	return 0;
+}
+
+/**
+ * Decode a row of a page. If rows are prefix-compressed, the body
+ * of the row is restored starting from the nearest preceding
+ * restart row or from the last restored row if it's closer so
+ * that a sequential scan restores each row only once. In this
+ * case the row body is valid until the next call.
+ */
+static int
+vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
+	     struct xrow_header *xrow)
+{
+	uint32_t interval = page->restart_interval;
+	if (vy_page_raw_xrow(page, stmt_no, xrow) != 0)
+		return -1;
+	if (interval == 0 || stmt_no % interval == 0)
+		return 0;
+	if (page->body_no != stmt_no) {
+		uint32_t first = stmt_no - stmt_no % interval;
+		if (page->body_no != UINT32_MAX &&
+		    page->body_no >= first && page->body_no < stmt_no)
+			first = page->body_no + 1;
+		page->body_no = UINT32_MAX;
+		for (uint32_t i = first; i <= stmt_no; i++) {
+			if (vy_page_restore_body(page, i) != 0)
+				return -1;
+		}
+		page->body_no = stmt_no;
+	}
+	xrow->body[0].iov_base = page->body;
+	xrow->body[0].iov_len = page->body_size;
+	xrow->bodycnt = 1;
+	return 0;
+}
+
 /* {{{ vy_run_iterator vy_run_iterator support functions */
 
 /**
@@ -818,16 +1118,24 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 		 enum iterator_type iterator_type, uint32_t *pos,
 		 bool *equal_key)
 {
-	uint32_t beg = 0;
-	uint32_t end = page->row_count;
+	/*
+	 * If rows are prefix-compressed, only restart rows can be
+	 * decoded without restoring preceding rows so we first look
+	 * up the restart block containing the key among them and
+	 * then scan the block.
+	 */
+	uint32_t step = page->restart_interval > 0 ?
+			page->restart_interval : 1;
 	*equal_key = false;
 	/* for upper bound we change zero comparison result to -1 */
 	int zero_cmp = (iterator_type == ITER_GT ||
 			iterator_type == ITER_LE ? -1 : 0);
+	uint32_t beg = 0;
+	uint32_t end = (page->row_count + step - 1) / step;
 	while (beg != end) {
 		uint32_t mid = beg + (end - beg) / 2;
-		struct vy_entry fnd_key = vy_page_stmt(page, mid, cmp_def,
-						       format);
+		struct vy_entry fnd_key = vy_page_stmt(page, mid * step,
+						       cmp_def, format);
 		if (fnd_key.stmt == NULL)
 			return -1;
 		int cmp = vy_entry_compare(fnd_key, key, cmp_def);
@@ -839,7 +1147,29 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 			end = mid;
 		tuple_unref(fnd_key.stmt);
 	}
-	*pos = end;
+	/*
+	 * The restart row of block end is not less than the key
+	 * while all rows of block end - 1 starting from the restart
+	 * row are, so the position is in block end - 1 or it's the
+	 * restart row of block end.
+	 */
+	*pos = MIN(end * step, page->row_count);
+	if (end == 0)
+		return 0;
+	for (uint32_t i = (end - 1) * step + 1; i < *pos; i++) {
+		struct vy_entry fnd_key = vy_page_stmt(page, i, cmp_def,
+						       format);
+		if (fnd_key.stmt == NULL)
+			return -1;
+		int cmp = vy_entry_compare(fnd_key, key, cmp_def);
+		tuple_unref(fnd_key.stmt);
+		cmp = cmp ? cmp : zero_cmp;
+		*equal_key = *equal_key || cmp == 0;
+		if (cmp >= 0) {
+			*pos = i;
+			break;
+		}
+	}
 	return 0;
 }
 
@@ -919,6 +1249,7 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 		diag_set(OutOfMemory, page_info->size, "region gc", "page");
 		return -1;
 	}
+	double start = clock_monotonic();
 	ssize_t readen = fio_pread(run->fd, data, page_info->size,
 				   page_info->offset);
 	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
@@ -928,6 +1259,8 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 		diag_set(SystemError, "failed to read from file");
 		goto error;
 	}
+	vy_io_sched_account(&run->env->io_sched, readen,
+			    clock_monotonic() - start);
 	if (readen != (ssize_t)page_info->size) {
 		diag_set(ClientError, ER_INVALID_RUN_FILE,
 			 "Unexpected end of file");
@@ -945,8 +1278,10 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	const char *data_end = data + readen;
 	char *rows = page->data;
 	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
+	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx,
+			   run->zddict) != 0)
 		goto error;
+	page->restart_interval = run->info.restart_interval;
 
 	struct xrow_header xrow;
 	data_pos = page->data + page_info->row_index_offset;
@@ -1212,6 +1547,45 @@ vy_run_iterator_next_pos(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * If the current statement references a tuple stored in a blob
+ * file, replace it with a statement containing the full tuple.
+ *
+ * @retval 0 success
+ * @retval -1 read or memory error
+ */
+static NODISCARD int
+vy_run_iterator_resolve_blob(struct vy_run_iterator *itr)
+{
+	struct tuple *stmt = itr->curr.stmt;
+	if ((vy_stmt_flags(stmt) & VY_STMT_BLOB) == 0)
+		return 0;
+
+	struct vy_run *run = itr->slice->run;
+	struct vy_blob_read_task task;
+	task.run = run;
+	vy_stmt_blob_ref(stmt, &task.ref);
+	size_t region_svp = region_used(&fiber()->gc);
+	task.buf = region_alloc(&fiber()->gc, task.ref.size);
+	if (task.buf == NULL) {
+		diag_set(OutOfMemory, task.ref.size, "region", "blob");
+		return -1;
+	}
+	struct tuple *result = NULL;
+	if (vy_run_env_coio_call(run->env, &task.base, vy_blob_read_cb) == 0)
+		result = vy_stmt_new_from_blob(itr->format, stmt, task.buf,
+					       task.buf + task.ref.size, NULL);
+	region_truncate(&fiber()->gc, region_svp);
+	if (result == NULL)
+		return -1;
+
+	itr->stat->read.bytes += task.ref.size;
+	itr->stat->read.bytes_compressed += task.ref.size;
+	tuple_unref(stmt);
+	itr->curr.stmt = result;
+	return 0;
+}
+
 /**
  * Find the next record with lsn <= itr->lsn record.
  * The current position must be at the beginning of a series of
@@ -1285,6 +1659,8 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 			return 0;
 		}
 	}
+	if (vy_run_iterator_resolve_blob(itr) != 0)
+		return -1;
 	vy_stmt_counter_acct_tuple(&itr->stat->get, itr->curr.stmt);
 	*ret = itr->curr;
 	return 0;
@@ -1594,6 +1970,8 @@ vy_run_iterator_next_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 	if (vy_stmt_flags(itr->curr.stmt) & VY_STMT_SKIP_READ)
 		goto next;
 
+	if (vy_run_iterator_resolve_blob(itr) != 0)
+		return -1;
 	vy_stmt_counter_acct_tuple(&itr->stat->get, itr->curr.stmt);
 	*ret = itr->curr;
 	return 0;
@@ -1714,6 +2092,25 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	run->count.pages++;
 }
 
+/**
+ * Prepare the compression dictionary stored in the run info
+ * for decompressing pages. Does nothing if there's no one.
+ */
+static int
+vy_run_create_ddict(struct vy_run *run)
+{
+	assert(run->zddict == NULL);
+	if (run->info.dict == NULL)
+		return 0;
+	run->zddict = ZSTD_createDDict(run->info.dict, run->info.dict_size);
+	if (run->zddict == NULL) {
+		diag_set(OutOfMemory, run->info.dict_size, "ZSTD_createDDict",
+			 "dictionary");
+		return -1;
+	}
+	return 0;
+}
+
 int
 vy_run_recover(struct vy_run *run, const char *dir,
 	       uint32_t space_id, uint32_t iid, struct key_def *cmp_def)
@@ -1765,6 +2162,8 @@ vy_run_recover(struct vy_run *run, const char *dir,
 
 	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
 		goto fail_close;
+	if (vy_run_create_ddict(run) != 0)
+		goto fail_close;
 
 	/* Allocate buffer for page info. */
 	run->page_info = calloc(run->info.page_count,
@@ -1827,6 +2226,10 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	}
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+
+	/* Prepare blob files for reading. */
+	if (vy_run_open_blobs(run, dir, space_id, iid) != 0)
+		goto fail;
 	return 0;
 
 fail_close:
@@ -1838,20 +2241,91 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	return -1;
 }
 
-/* dump statement to the run page buffers (stmt header and data) */
+/**
+ * Prefix-compress the body of a row, see vy_row_prefix_decode().
+ * The body of a restart row is left as is. @a prev_body stores
+ * the body of the previous row and is updated to store the body
+ * of the given row. The new body is allocated on the region.
+ */
+static int
+vy_run_prefix_encode(struct xrow_header *xrow, bool is_restart,
+		     struct ibuf *prev_body)
+{
+	size_t size = 0;
+	for (int i = 0; i < xrow->bodycnt; i++)
+		size += xrow->body[i].iov_len;
+	char *body = region_alloc(&fiber()->gc, size);
+	if (body == NULL) {
+		diag_set(OutOfMemory, size, "region", "row body");
+		return -1;
+	}
+	size_t offset = 0;
+	for (int i = 0; i < xrow->bodycnt; i++) {
+		memcpy(body + offset, xrow->body[i].iov_base,
+		       xrow->body[i].iov_len);
+		offset += xrow->body[i].iov_len;
+	}
+	size_t shared = 0;
+	size_t prev_size = MIN(size, ibuf_used(prev_body));
+	while (shared < prev_size && body[shared] == prev_body->rpos[shared])
+		shared++;
+	ibuf_reset(prev_body);
+	char *copy = ibuf_alloc(prev_body, size);
+	if (copy == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "row body");
+		return -1;
+	}
+	memcpy(copy, body, size);
+	if (is_restart)
+		return 0;
+	size_t suffix_size = size - shared;
+	size_t new_size = mp_sizeof_array(2) + mp_sizeof_uint(shared) +
+			  mp_sizeof_bin(suffix_size);
+	char *pos = region_alloc(&fiber()->gc, new_size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, new_size, "region", "row body");
+		return -1;
+	}
+	xrow->body[0].iov_base = pos;
+	pos = mp_encode_array(pos, 2);
+	pos = mp_encode_uint(pos, shared);
+	pos = mp_encode_bin(pos, body + shared, suffix_size);
+	xrow->body[0].iov_len = new_size;
+	xrow->bodycnt = 1;
+	return 0;
+}
+
+/*
+ * dump statement to the run page buffers (stmt header and data),
+ * if @blob is not NULL, only the key and the blob reference are
+ * dumped, if @restart_interval is not 0, the row is prefix-compressed
+ * relative to @prev_body
+ */
 static int
 vy_run_dump_stmt(struct vy_entry entry, struct xlog *data_xlog,
 		 struct vy_page_info *info, struct key_def *key_def,
-		 bool is_primary)
+		 bool is_primary, const struct vy_blob_ref *blob,
+		 uint32_t restart_interval, struct ibuf *prev_body)
 {
 	struct xrow_header xrow;
-	int rc = (is_primary ?
-		  vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow) :
-		  vy_stmt_encode_secondary(entry.stmt, key_def,
-					   vy_entry_multikey_idx(entry, key_def),
-					   &xrow));
+	int rc;
+	if (blob != NULL) {
+		assert(is_primary);
+		rc = vy_stmt_encode_blob(entry.stmt, key_def, blob, &xrow);
+	} else {
+		rc = (is_primary ?
+		      vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow) :
+		      vy_stmt_encode_secondary(entry.stmt, key_def,
+					vy_entry_multikey_idx(entry, key_def),
+					&xrow));
+	}
 	if (rc != 0)
 		return -1;
+	if (restart_interval > 0 &&
+	    vy_run_prefix_encode(&xrow,
+				 info->row_count % restart_interval == 0,
+				 prev_body) != 0)
+		return -1;
 
 	ssize_t row_size;
 	if ((row_size = xlog_write_row(data_xlog, &xrow)) < 0)
@@ -2053,6 +2527,14 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		bloom_key = tuple_bloom_version_to_iproto(
 			run_info->bloom->version);
 	}
+	if (run_info->dump_time > 0)
+		key_count++;
+	if (run_info->blob_count > 0)
+		key_count++;
+	if (run_info->restart_interval > 0)
+		key_count++;
+	if (run_info->dict != NULL)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2068,6 +2550,26 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->dump_time > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_DUMP_TIME) +
+			mp_sizeof_double(run_info->dump_time);
+	if (run_info->blob_count > 0) {
+		size += mp_sizeof_uint(VY_RUN_INFO_BLOBS) +
+			mp_sizeof_array(run_info->blob_count);
+		for (uint32_t i = 0; i < run_info->blob_count; i++) {
+			struct vy_run_blob *blob = &run_info->blobs[i];
+			size += mp_sizeof_array(3) +
+				mp_sizeof_uint(blob->id) +
+				mp_sizeof_uint(blob->size) +
+				mp_sizeof_uint(blob->live_size);
+		}
+	}
+	if (run_info->restart_interval > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_RESTART_INTERVAL) +
+			mp_sizeof_uint(run_info->restart_interval);
+	if (run_info->dict != NULL)
+		size += mp_sizeof_uint(VY_RUN_INFO_DICTIONARY) +
+			mp_sizeof_bin(run_info->dict_size);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2096,12 +2598,99 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->dump_time > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DUMP_TIME);
+		pos = mp_encode_double(pos, run_info->dump_time);
+	}
+	if (run_info->blob_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOBS);
+		pos = mp_encode_array(pos, run_info->blob_count);
+		for (uint32_t i = 0; i < run_info->blob_count; i++) {
+			struct vy_run_blob *blob = &run_info->blobs[i];
+			pos = mp_encode_array(pos, 3);
+			pos = mp_encode_uint(pos, blob->id);
+			pos = mp_encode_uint(pos, blob->size);
+			pos = mp_encode_uint(pos, blob->live_size);
+		}
+	}
+	if (run_info->restart_interval > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_RESTART_INTERVAL);
+		pos = mp_encode_uint(pos, run_info->restart_interval);
+	}
+	if (run_info->dict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DICTIONARY);
+		pos = mp_encode_bin(pos, run_info->dict, run_info->dict_size);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
 	return 0;
 }
 
+/**
+ * Encode the compression dictionary of a run as a run info row
+ * with no other keys. The row is written to the head of the run
+ * file, before the pages compressed with the dictionary, so that
+ * the file can be read without the index file, see
+ * vy_run_rebuild_index().
+ */
+static int
+vy_run_dict_encode(const struct vy_run_info *run_info,
+		   struct xrow_header *xrow)
+{
+	assert(run_info->dict != NULL);
+	memset(xrow, 0, sizeof(*xrow));
+	size_t size = mp_sizeof_map(1) +
+		      mp_sizeof_uint(VY_RUN_INFO_DICTIONARY) +
+		      mp_sizeof_bin(run_info->dict_size);
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "run dictionary");
+		return -1;
+	}
+	xrow->body->iov_base = pos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_DICTIONARY);
+	pos = mp_encode_bin(pos, run_info->dict, run_info->dict_size);
+	xrow->body->iov_len = size;
+	xrow->bodycnt = 1;
+	xrow->type = VY_INDEX_RUN_INFO;
+	return 0;
+}
+
+/**
+ * Decode the compression dictionary written to the head of a run
+ * file by vy_run_dict_encode() to the run info.
+ */
+static int
+vy_run_dict_decode(struct vy_run_info *run_info,
+		   const struct xrow_header *xrow)
+{
+	assert(xrow->type == VY_INDEX_RUN_INFO);
+	assert(run_info->dict == NULL);
+	if (xrow->bodycnt == 0)
+		goto invalid;
+	const char *pos = xrow->body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(&pos);
+		if (key != VY_RUN_INFO_DICTIONARY || run_info->dict != NULL) {
+			mp_next(&pos); /* unknown key, ignore */
+			continue;
+		}
+		const char *dict = mp_decode_bin(&pos, &run_info->dict_size);
+		run_info->dict = xmalloc(run_info->dict_size);
+		memcpy(run_info->dict, dict, run_info->dict_size);
+	}
+	if (run_info->dict == NULL)
+		goto invalid;
+	return 0;
+invalid:
+	diag_set(ClientError, ER_INVALID_RUN_FILE,
+		 "Run info row without a dictionary");
+	return -1;
+}
+
 /* vy_run_info }}} */
 
 /**
@@ -2189,15 +2778,176 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		if (writer->bloom == NULL)
 			return -1;
 	}
+	writer->blob_fd = -1;
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	ibuf_create(&writer->prev_body, &cord()->slabc, 1024);
+	ibuf_create(&writer->samples, &cord()->slabc,
+		    1024 * sizeof(struct vy_entry));
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
 	return 0;
 }
 
+void
+vy_run_writer_set_page_format(struct vy_run_writer *writer,
+			      uint32_t restart_interval, uint32_t dict_size)
+{
+	assert(!xlog_is_open(&writer->data_xlog));
+	writer->restart_interval = restart_interval;
+	writer->run->info.restart_interval = restart_interval;
+	writer->dict_size = writer->no_compression ? 0 : dict_size;
+}
+
+void
+vy_run_writer_enable_blobs(struct vy_run_writer *writer, uint32_t threshold,
+			   const int64_t *gc_ids, uint32_t gc_count)
+{
+	assert(writer->iid == 0);
+	writer->blob_threshold = threshold;
+	writer->blob_gc_ids = gc_ids;
+	writer->blob_gc_count = gc_count;
+}
+
+/** Create the directory for blob files of the run being written. */
+static int
+vy_run_writer_create_blob_dir(struct vy_run_writer *writer)
+{
+	char path[PATH_MAX];
+	vy_run_snprint_blob_dir(path, sizeof(path), writer->dirpath,
+				writer->space_id, writer->iid,
+				writer->run->id);
+	if (mkdir(path, 0777) != 0 && errno != EEXIST) {
+		diag_set(SystemError, "failed to create directory '%s'", path);
+		return -1;
+	}
+	return 0;
+}
+
+/** Create the blob file the writer appends large tuples to. */
+static int
+vy_run_writer_create_blob(struct vy_run_writer *writer)
+{
+	assert(writer->blob_fd < 0);
+	struct vy_run *run = writer->run;
+	if (vy_run_writer_create_blob_dir(writer) != 0)
+		return -1;
+	char path[PATH_MAX];
+	vy_run_snprint_blob_path(path, sizeof(path), writer->dirpath,
+				 writer->space_id, writer->iid,
+				 run->id, run->id);
+	say_info("writing `%s'", path);
+	struct vy_run_blob *blob = vy_run_add_blob(&run->info, run->id);
+	if (blob == NULL)
+		return -1;
+	blob->fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (blob->fd < 0) {
+		diag_set(SystemError, "failed to create file '%s'", path);
+		return -1;
+	}
+	/* The descriptor is closed along with the run. */
+	writer->blob_fd = blob->fd;
+	return 0;
+}
+
+/**
+ * Link a blob file referenced by a statement to the directory
+ * of the run being written and account the referenced tuple.
+ */
+static int
+vy_run_writer_link_blob(struct vy_run_writer *writer,
+			const struct vy_blob_ref *ref)
+{
+	struct vy_run *run = writer->run;
+	struct vy_run_blob *blob = vy_run_find_blob(run, ref->blob_id);
+	if (blob != NULL)
+		goto out;
+	if (vy_run_writer_create_blob_dir(writer) != 0)
+		return -1;
+	char src[PATH_MAX];
+	char dst[PATH_MAX];
+	vy_run_snprint_blob_path(src, sizeof(src), writer->dirpath,
+				 writer->space_id, writer->iid,
+				 ref->run_id, ref->blob_id);
+	vy_run_snprint_blob_path(dst, sizeof(dst), writer->dirpath,
+				 writer->space_id, writer->iid,
+				 run->id, ref->blob_id);
+	if (link(src, dst) != 0) {
+		diag_set(SystemError, "failed to link '%s' to '%s'", src, dst);
+		return -1;
+	}
+	blob = vy_run_add_blob(&run->info, ref->blob_id);
+	if (blob == NULL)
+		return -1;
+	blob->fd = open(dst, O_RDONLY);
+	struct stat st;
+	if (blob->fd < 0 || fstat(blob->fd, &st) != 0) {
+		diag_set(SystemError, "failed to open '%s'", dst);
+		return -1;
+	}
+	blob->size = st.st_size;
+out:
+	blob->live_size += ref->size;
+	return 0;
+}
+
+/**
+ * Check if the tuple of a statement must be stored in a blob file.
+ * If it must, either link the blob file the tuple is already stored
+ * in or append the tuple to the run's own blob file, fill @a ref,
+ * and set @a is_blob.
+ */
+static int
+vy_run_writer_write_blob(struct vy_run_writer *writer, struct tuple *stmt,
+			 struct vy_blob_ref *ref, bool *is_blob)
+{
+	*is_blob = false;
+	enum iproto_type type = vy_stmt_type(stmt);
+	if (type != IPROTO_REPLACE && type != IPROTO_INSERT)
+		return 0;
+	assert(!vy_stmt_is_key(stmt));
+	uint32_t size;
+	const char *data = tuple_data_range(stmt, &size);
+	if (size < writer->blob_threshold)
+		return 0;
+	if (vy_stmt_flags(stmt) & VY_STMT_BLOB) {
+		vy_stmt_blob_ref(stmt, ref);
+		bool is_garbage = false;
+		for (uint32_t i = 0; i < writer->blob_gc_count; i++) {
+			if (writer->blob_gc_ids[i] == ref->blob_id)
+				is_garbage = true;
+		}
+		if (!is_garbage) {
+			if (vy_run_writer_link_blob(writer, ref) != 0)
+				return -1;
+			*is_blob = true;
+			return 0;
+		}
+	}
+	struct vy_run *run = writer->run;
+	if (writer->blob_fd < 0 && vy_run_writer_create_blob(writer) != 0)
+		return -1;
+	struct vy_run_blob *blob = vy_run_find_blob(run, run->id);
+	assert(blob != NULL);
+	double start = clock_monotonic();
+	if (fio_writen(writer->blob_fd, data, size) != 0) {
+		diag_set(SystemError, "failed to write to blob file");
+		return -1;
+	}
+	vy_io_sched_account(&run->env->io_sched, size,
+			    clock_monotonic() - start);
+	ref->blob_id = run->id;
+	ref->run_id = run->id;
+	ref->offset = blob->size;
+	ref->size = size;
+	blob->size += size;
+	blob->live_size += size;
+	*is_blob = true;
+	return 0;
+}
+
 /**
  * Create an xlog to write run.
  * @param writer Run writer.
@@ -2288,8 +3038,15 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 		return -1;
 	}
 	*offset = page->unpacked_size;
+	struct vy_blob_ref blob;
+	bool is_blob = false;
+	if (writer->blob_threshold > 0 &&
+	    vy_run_writer_write_blob(writer, entry.stmt, &blob, &is_blob) != 0)
+		return -1;
 	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+			     writer->cmp_def, writer->iid == 0,
+			     is_blob ? &blob : NULL, writer->restart_interval,
+			     &writer->prev_body) != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2325,19 +3082,23 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	page->row_index_offset = page->unpacked_size;
 	page->unpacked_size += written;
 
+	double start = clock_monotonic();
 	written = xlog_tx_commit(&writer->data_xlog);
 	if (written == 0)
 		written = xlog_flush(&writer->data_xlog);
 	if (written < 0)
 		return -1;
+	vy_io_sched_account(&run->env->io_sched, written,
+			    clock_monotonic() - start);
 	page->size = written;
 	vy_run_acct_page(run, page);
 	ibuf_reset(&writer->row_index_buf);
 	return 0;
 }
 
-int
-vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
+/** Write a statement to the run file. */
+static int
+vy_run_writer_write_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 {
 	int rc = -1;
 	size_t region_svp = region_used(&fiber()->gc);
@@ -2358,6 +3119,172 @@ vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 	return rc;
 }
 
+enum {
+	/**
+	 * Size of statements buffered to train a compression
+	 * dictionary on, in dictionary sizes.
+	 */
+	VY_RUN_DICT_SAMPLE_RATIO = 100,
+	/** Max size of statements buffered to train a dictionary. */
+	VY_RUN_DICT_SAMPLE_MAX = 4 * 1024 * 1024,
+};
+
+/**
+ * Train a zstd dictionary on the statements buffered by the writer
+ * and store it in the run info. If there isn't enough data to train
+ * a dictionary on, the run is written without it.
+ */
+static int
+vy_run_writer_train_dict(struct vy_run_writer *writer)
+{
+	struct vy_run *run = writer->run;
+	struct vy_entry *samples = (struct vy_entry *)writer->samples.rpos;
+	size_t count = ibuf_used(&writer->samples) / sizeof(*samples);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	size_t *sizes = region_alloc_array(region, typeof(*sizes), count,
+					   &size);
+	char *data = region_alloc(region, writer->samples_size);
+	if (sizes == NULL || data == NULL) {
+		region_truncate(region, region_svp);
+		diag_set(OutOfMemory, writer->samples_size, "region",
+			 "dictionary samples");
+		return -1;
+	}
+	char *pos = data;
+	for (size_t i = 0; i < count; i++) {
+		sizes[i] = tuple_bsize(samples[i].stmt);
+		memcpy(pos, tuple_data(samples[i].stmt), sizes[i]);
+		pos += sizes[i];
+	}
+	char *dict = xmalloc(writer->dict_size);
+	size_t dict_size = ZDICT_trainFromBuffer(dict, writer->dict_size,
+						 data, sizes, count);
+	region_truncate(region, region_svp);
+	if (ZDICT_isError(dict_size)) {
+		say_verbose("failed to train compression dictionary: %s",
+			    ZDICT_getErrorName(dict_size));
+		free(dict);
+		return 0;
+	}
+	run->info.dict = dict;
+	run->info.dict_size = dict_size;
+	return 0;
+}
+
+/**
+ * Write the compression dictionary to the head of the run file,
+ * see vy_run_dict_encode(). The dictionary is written in a separate
+ * transaction, which is compressed without it.
+ */
+static int
+vy_run_writer_write_dict(struct vy_run_writer *writer)
+{
+	int rc = -1;
+	size_t region_svp = region_used(&fiber()->gc);
+	struct xrow_header xrow;
+	if (vy_run_dict_encode(&writer->run->info, &xrow) != 0)
+		goto out;
+	xlog_tx_begin(&writer->data_xlog);
+	if (xlog_write_row(&writer->data_xlog, &xrow) < 0) {
+		xlog_tx_rollback(&writer->data_xlog);
+		goto out;
+	}
+	ssize_t written = xlog_tx_commit(&writer->data_xlog);
+	if (written == 0)
+		written = xlog_flush(&writer->data_xlog);
+	if (written < 0)
+		goto out;
+	rc = 0;
+out:
+	region_truncate(&fiber()->gc, region_svp);
+	return rc;
+}
+
+/**
+ * Train a compression dictionary on the buffered statements and
+ * write them to the run file compressing pages with it.
+ */
+static int
+vy_run_writer_flush_samples(struct vy_run_writer *writer)
+{
+	assert(!xlog_is_open(&writer->data_xlog));
+	if (vy_run_writer_train_dict(writer) != 0)
+		return -1;
+	if (vy_run_writer_create_xlog(writer) != 0)
+		return -1;
+	struct vy_run *run = writer->run;
+	if (run->info.dict != NULL &&
+	    (vy_run_writer_write_dict(writer) != 0 ||
+	     xlog_set_zstd_dict(&writer->data_xlog, run->info.dict,
+				run->info.dict_size) != 0))
+		return -1;
+	struct vy_entry *samples = (struct vy_entry *)writer->samples.rpos;
+	size_t count = ibuf_used(&writer->samples) / sizeof(*samples);
+	for (size_t i = 0; i < count; i++) {
+		if (vy_run_writer_write_stmt(writer, samples[i]) != 0)
+			return -1;
+	}
+	for (size_t i = 0; i < count; i++)
+		vy_stmt_unref_if_possible(samples[i].stmt);
+	ibuf_reset(&writer->samples);
+	writer->samples_size = 0;
+	return 0;
+}
+
+int
+vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
+{
+	if (writer->dict_size == 0 || xlog_is_open(&writer->data_xlog))
+		return vy_run_writer_write_stmt(writer, entry);
+	/*
+	 * Buffer first statements until there's enough data to
+	 * train a compression dictionary on.
+	 */
+	struct vy_entry *sample = ibuf_alloc(&writer->samples,
+					     sizeof(*sample));
+	if (sample == NULL) {
+		diag_set(OutOfMemory, sizeof(*sample), "ibuf",
+			 "dictionary sample");
+		return -1;
+	}
+	*sample = entry;
+	vy_stmt_ref_if_possible(entry.stmt);
+	writer->samples_size += tuple_bsize(entry.stmt);
+	size_t limit = MIN((size_t)writer->dict_size * VY_RUN_DICT_SAMPLE_RATIO,
+			   (size_t)VY_RUN_DICT_SAMPLE_MAX);
+	if (writer->samples_size >= limit)
+		return vy_run_writer_flush_samples(writer);
+	return 0;
+}
+
+/**
+ * Sync the blob file written by the writer and the directory with
+ * blob files linked to the run.
+ */
+static int
+vy_run_writer_sync_blobs(struct vy_run_writer *writer)
+{
+	if (writer->blob_fd >= 0 && fsync(writer->blob_fd) != 0) {
+		diag_set(SystemError, "failed to sync blob file");
+		return -1;
+	}
+	char path[PATH_MAX];
+	vy_run_snprint_blob_dir(path, sizeof(path), writer->dirpath,
+				writer->space_id, writer->iid,
+				writer->run->id);
+	int fd = open(path, O_RDONLY);
+	if (fd < 0 || fsync(fd) != 0) {
+		diag_set(SystemError, "failed to sync directory '%s'", path);
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
 /**
  * Destroy a run writer.
  * @param writer Writer to destroy.
@@ -2371,6 +3298,12 @@ vy_run_writer_destroy(struct vy_run_writer *writer)
 		xlog_discard(&writer->data_xlog);
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
+	struct vy_entry *samples = (struct vy_entry *)writer->samples.rpos;
+	size_t count = ibuf_used(&writer->samples) / sizeof(*samples);
+	for (size_t i = 0; i < count; i++)
+		vy_stmt_unref_if_possible(samples[i].stmt);
+	ibuf_destroy(&writer->samples);
+	ibuf_destroy(&writer->prev_body);
 	ibuf_destroy(&writer->row_index_buf);
 }
 
@@ -2380,6 +3313,9 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	int rc = -1;
 	size_t region_svp = region_used(&fiber()->gc);
 
+	if (ibuf_used(&writer->samples) != 0 &&
+	    vy_run_writer_flush_samples(writer) != 0)
+		goto out;
 	if (ibuf_used(&writer->row_index_buf) != 0 &&
 	    vy_run_writer_end_page(writer) != 0)
 		goto out;
@@ -2404,6 +3340,9 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	assert(run->info.max_key == NULL);
 	run->info.max_key = mp_dup(key);
 
+	if (run->info.blob_count > 0 && vy_run_writer_sync_blobs(writer) != 0)
+		goto out;
+
 	ERROR_INJECT(ERRINJ_VY_RUN_FILE_RENAME, {
 		diag_set(ClientError, ER_INJECTION, "vinyl run file rename");
 		goto out;
@@ -2425,6 +3364,8 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	if (vy_run_write_index(run, writer->dirpath,
 			       writer->space_id, writer->iid) != 0)
 		goto out;
+	if (vy_run_create_ddict(run) != 0)
+		goto out;
 
 	vy_run_writer_destroy(writer);
 	rc = 0;
@@ -2439,6 +3380,89 @@ vy_run_writer_abort(struct vy_run_writer *writer)
 	vy_run_writer_destroy(writer);
 }
 
+/**
+ * Account a tuple stored in a blob file to the list of blob files
+ * referenced by a run. Support function of vy_run_rebuild_index().
+ * The exact size of a blob file is unknown so we use the end of
+ * the last tuple referenced by the run instead.
+ */
+static int
+vy_run_rebuild_acct_blob(struct vy_run *run, struct tuple *stmt)
+{
+	struct vy_blob_ref ref;
+	vy_stmt_blob_ref(stmt, &ref);
+	struct vy_run_blob *blob = vy_run_find_blob(run, ref.blob_id);
+	if (blob == NULL) {
+		blob = vy_run_add_blob(&run->info, ref.blob_id);
+		if (blob == NULL)
+			return -1;
+	}
+	blob->size = MAX(blob->size, ref.offset + ref.size);
+	blob->live_size += ref.size;
+	return 0;
+}
+
+/**
+ * Restore the body of a row of a run page that may be
+ * prefix-compressed. Support function of vy_run_rebuild_index().
+ * The restart interval isn't stored in the run file, so rows stored
+ * in full are told from prefix-compressed ones by the body type,
+ * see vy_run_prefix_encode(), and the interval is the number of
+ * the first row stored in full in a page other than the first row.
+ *
+ * @param xrow Row number @a row_no of a page. The body of
+ *             a prefix-compressed row is replaced with the
+ *             restored one stored in @a prev_body.
+ * @param prev_body Body of the previous row of the page.
+ * @param restart_interval Restart interval or 0 if unknown yet.
+ * @param is_prefix_compressed Set if the row is prefix-compressed.
+ */
+static int
+vy_run_rebuild_restore_body(struct xrow_header *xrow, uint32_t row_no,
+			    struct ibuf *prev_body, uint32_t *restart_interval,
+			    bool *is_prefix_compressed)
+{
+	if (xrow->bodycnt == 0)
+		return 0;
+	const char *body = xrow->body[0].iov_base;
+	uint32_t size = xrow->body[0].iov_len;
+	bool is_restart = mp_typeof(*body) != MP_ARRAY;
+	if (*restart_interval == 0 && is_restart && row_no > 0)
+		*restart_interval = row_no;
+	if ((row_no == 0 && !is_restart) ||
+	    (*restart_interval != 0 &&
+	     is_restart != (row_no % *restart_interval == 0))) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Invalid prefix-compressed row");
+		return -1;
+	}
+	if (is_restart) {
+		ibuf_reset(prev_body);
+		char *copy = ibuf_alloc(prev_body, size);
+		if (copy == NULL) {
+			diag_set(OutOfMemory, size, "ibuf", "row body");
+			return -1;
+		}
+		memcpy(copy, body, size);
+		return 0;
+	}
+	*is_prefix_compressed = true;
+	uint32_t shared, suffix_size;
+	const char *suffix;
+	if (vy_row_prefix_decode(body, ibuf_used(prev_body), &shared,
+				 &suffix, &suffix_size) != 0)
+		return -1;
+	ibuf_discard(prev_body, ibuf_used(prev_body) - shared);
+	if (ibuf_alloc(prev_body, suffix_size) == NULL) {
+		diag_set(OutOfMemory, suffix_size, "ibuf", "row body");
+		return -1;
+	}
+	memcpy(prev_body->rpos + shared, suffix, suffix_size);
+	xrow->body[0].iov_base = prev_body->rpos;
+	xrow->body[0].iov_len = ibuf_used(prev_body);
+	return 0;
+}
+
 int
 vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		     uint32_t space_id, uint32_t iid,
@@ -2462,6 +3486,13 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	int rc = 0;
 	uint32_t page_info_capacity = 0;
 
+	/* Body of the last row, see vy_run_rebuild_restore_body(). */
+	struct ibuf prev_body;
+	ibuf_create(&prev_body, &cord()->slabc, 1024);
+	uint32_t restart_interval = 0;
+	uint32_t max_page_row_count = 0;
+	bool is_prefix_compressed = false;
+
 	const char *key = NULL;
 	int64_t max_lsn = 0;
 	int64_t min_lsn = INT64_MAX;
@@ -2487,6 +3518,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		uint32_t page_row_count = 0;
 		uint64_t page_row_index_offset = 0;
 		uint64_t row_offset = xlog_cursor_tx_pos(&cursor);
+		bool is_dict = false;
 
 		struct xrow_header xrow;
 		while ((rc = xlog_cursor_next_row(&cursor, &xrow)) == 0) {
@@ -2495,10 +3527,39 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				row_offset = xlog_cursor_tx_pos(&cursor);
 				continue;
 			}
+			if (xrow.type == VY_INDEX_RUN_INFO) {
+				/* Compression dictionary, not a page. */
+				if (run->info.page_count > 0 ||
+				    run->info.dict != NULL) {
+					diag_set(ClientError,
+						 ER_INVALID_RUN_FILE,
+						 "Unexpected run info row");
+					goto close_err;
+				}
+				if (vy_run_dict_decode(&run->info,
+						       &xrow) != 0 ||
+				    vy_run_create_ddict(run) != 0)
+					goto close_err;
+				xlog_cursor_set_zstd_dict(&cursor,
+							  run->zddict);
+				is_dict = true;
+				continue;
+			}
+			if (vy_run_rebuild_restore_body(&xrow, page_row_count,
+							&prev_body,
+							&restart_interval,
+							&is_prefix_compressed)
+			    != 0)
+				goto close_err;
 			++page_row_count;
 			struct tuple *tuple = vy_stmt_decode(&xrow, format);
 			if (tuple == NULL)
 				goto close_err;
+			if ((vy_stmt_flags(tuple) & VY_STMT_BLOB) != 0 &&
+			    vy_run_rebuild_acct_blob(run, tuple) != 0) {
+				tuple_unref(tuple);
+				goto close_err;
+			}
 			if (bloom_builder != NULL) {
 				struct vy_entry entry = {tuple, HINT_NONE};
 				if (vy_bloom_builder_add(bloom_builder, entry,
@@ -2525,6 +3586,9 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				min_lsn = xrow.lsn;
 			row_offset = xlog_cursor_tx_pos(&cursor);
 		}
+		if (is_dict)
+			continue;
+		max_page_row_count = MAX(max_page_row_count, page_row_count);
 		struct vy_page_info *info;
 		info = run->page_info + run->info.page_count;
 		vy_page_info_create(info, page_offset, page_min_key, cmp_def);
@@ -2543,6 +3607,15 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		run->info.max_key = mp_dup(key);
 	run->info.max_lsn = max_lsn;
 	run->info.min_lsn = min_lsn;
+	/*
+	 * If no page has a restart row other than the first one,
+	 * any interval not less than the number of rows in a page
+	 * describes the run.
+	 */
+	if (is_prefix_compressed)
+		run->info.restart_interval = restart_interval != 0 ?
+					     restart_interval :
+					     max_page_row_count;
 
 	if (prev_tuple != NULL) {
 		tuple_unref(prev_tuple);
@@ -2561,14 +3634,19 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		bloom_builder = NULL;
 	}
 
+	if (vy_run_open_blobs(run, dir, space_id, iid) != 0)
+		goto close_err;
+
 	/* New run index is ready for write, unlink old file if exists */
 	vy_run_snprint_path(path, sizeof(path), dir,
 			    space_id, iid, run->id, VY_FILE_INDEX);
 	xlog_remove_file(path, 0);
 	if (vy_run_write_index(run, dir, space_id, iid) != 0)
 		goto close_err;
+	ibuf_destroy(&prev_body);
 	return 0;
 close_err:
+	ibuf_destroy(&prev_body);
 	vy_run_clear(run);
 	region_truncate(region, mem_used);
 	if (prev_tuple != NULL)
@@ -2604,6 +3682,70 @@ try_rmdir(const char *path)
 	return rc;
 }
 
+/**
+ * Remove blob files linked to the directory of a run and the
+ * directory itself.
+ */
+static int
+vy_run_remove_blob_dir(const char *dir, uint32_t space_id,
+		       uint32_t iid, int64_t run_id)
+{
+	char path[PATH_MAX];
+	vy_run_snprint_blob_dir(path, sizeof(path), dir,
+				space_id, iid, run_id);
+	DIR *dh = opendir(path);
+	if (dh == NULL) {
+		if (errno == ENOENT)
+			return 0;
+		say_syserror("error while opening %s", path);
+		return -1;
+	}
+	int rc = 0;
+	struct dirent *de;
+	while ((de = readdir(dh)) != NULL) {
+		if (strcmp(de->d_name, ".") == 0 ||
+		    strcmp(de->d_name, "..") == 0)
+			continue;
+		char file[PATH_MAX];
+		snprintf(file, sizeof(file), "%s/%s", path, de->d_name);
+		if (unlink(file) < 0 && errno != ENOENT) {
+			say_syserror("error while removing %s", file);
+			rc = -1;
+		}
+	}
+	closedir(dh);
+	if (rc == 0 && try_rmdir(path) < 0)
+		rc = -1;
+	return rc;
+}
+
+int
+vy_run_foreach_blob_file(const char *dir, uint32_t space_id,
+			 uint32_t iid, int64_t run_id,
+			 int (*cb)(const char *path, void *arg), void *arg)
+{
+	char path[PATH_MAX];
+	vy_run_snprint_blob_dir(path, sizeof(path), dir,
+				space_id, iid, run_id);
+	DIR *dh = opendir(path);
+	if (dh == NULL)
+		return 0; /* no blob files */
+	int rc = 0;
+	struct dirent *de;
+	while ((de = readdir(dh)) != NULL) {
+		if (strcmp(de->d_name, ".") == 0 ||
+		    strcmp(de->d_name, "..") == 0)
+			continue;
+		char file[PATH_MAX];
+		snprintf(file, sizeof(file), "%s/%s", path, de->d_name);
+		rc = cb(file, arg);
+		if (rc != 0)
+			break;
+	}
+	closedir(dh);
+	return rc;
+}
+
 static ssize_t
 vy_run_remove_files_f(va_list ap)
 {
@@ -2623,6 +3765,8 @@ vy_run_remove_files_f(va_list ap)
 		if (!xlog_remove_file(path, XLOG_RM_VERBOSE))
 			ret = -1;
 	}
+	if (vy_run_remove_blob_dir(dir, space_id, iid, run_id) != 0)
+		ret = -1;
 	/* Remove the root directory if it's empty. */
 	vy_lsm_snprint_path(path, sizeof(path), dir, space_id, iid);
 	if (try_rmdir(path) < 0)
@@ -2636,7 +3780,37 @@ int
 vy_run_remove_files(const char *dir, uint32_t space_id,
 		    uint32_t iid, int64_t run_id)
 {
-	return coio_call(vy_run_remove_files_f, dir, space_id, iid, run_id);
+	return coio_call_ex(COIO_CLASS_BULK, vy_run_remove_files_f, dir,
+			    space_id, iid, run_id);
+}
+
+/**
+ * Read a tuple referenced by a statement from a blob file.
+ * The new statement keeps the blob reference so that the run
+ * writer can link the blob file rather than copy the tuple.
+ * Support function of slice stream.
+ * @return the new statement or NULL on memory or read error.
+ */
+static struct tuple *
+vy_slice_stream_resolve_blob(struct vy_slice_stream *stream,
+			     struct tuple *stmt)
+{
+	struct vy_run *run = stream->slice->run;
+	struct vy_blob_ref ref;
+	vy_stmt_blob_ref(stmt, &ref);
+	ref.run_id = run->id;
+	size_t region_svp = region_used(&fiber()->gc);
+	char *buf = region_alloc(&fiber()->gc, ref.size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, ref.size, "region", "blob");
+		return NULL;
+	}
+	struct tuple *result = NULL;
+	if (vy_blob_read(run, &ref, buf) == 0)
+		result = vy_stmt_new_from_blob(stream->format, stmt, buf,
+					       buf + ref.size, &ref);
+	region_truncate(&fiber()->gc, region_svp);
+	return result;
 }
 
 /**
@@ -2747,6 +3921,16 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 		return 0;
 	}
 
+	/* Load the tuple if it is stored in a blob file. */
+	if (vy_stmt_flags(entry.stmt) & VY_STMT_BLOB) {
+		struct tuple *stmt = vy_slice_stream_resolve_blob(stream,
+								  entry.stmt);
+		tuple_unref(entry.stmt);
+		if (stmt == NULL)
+			return -1;
+		entry.stmt = stmt;
+	}
+
 	/* We definitely has the next non-null tuple. Save it in stream */
 	if (stream->entry.stmt != NULL)
 		tuple_unref(stream->entry.stmt);
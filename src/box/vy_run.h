@@ -40,6 +40,7 @@
 #include "vy_stmt_stream.h"
 #include "vy_read_view.h"
 #include "vy_stat.h"
+#include "vy_io.h"
 #include "index_def.h"
 #include "xlog.h"
 
@@ -56,6 +57,8 @@ struct vy_run_reader;
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
 	uint64_t snap_io_rate_limit;
+	/** Accounts and throttles run file I/O by class. */
+	struct vy_io_sched io_sched;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
 	/** Key for thread-local ZSTD context */
@@ -76,6 +79,20 @@ struct vy_run_env {
 	bool initial_join;
 };
 
+/**
+ * Blob file referenced by a run, see struct vy_blob_ref.
+ */
+struct vy_run_blob {
+	/** ID of the blob file. */
+	int64_t id;
+	/** Size of the blob file. */
+	uint64_t size;
+	/** Total size of tuples stored in the file used by the run. */
+	uint64_t live_size;
+	/** Blob file descriptor. Not stored on disk. */
+	int fd;
+};
+
 /**
  * Run metadata. Is a written to a file as a single chunk.
  */
@@ -94,6 +111,29 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/**
+	 * Wall clock time of the most recent memory dump whose
+	 * statements are stored in the run, or 0 if unknown (the
+	 * run was created by an older version).
+	 */
+	double dump_time;
+	/** Blob files referenced by the run. */
+	struct vy_run_blob *blobs;
+	/** Number of entries in the blobs array. */
+	uint32_t blob_count;
+	/**
+	 * If not 0, page rows are prefix-compressed and every
+	 * restart_interval-th row of a page is stored in full,
+	 * see vy_page_xrow().
+	 */
+	uint32_t restart_interval;
+	/**
+	 * Zstd dictionary pages are compressed with or NULL.
+	 * It's also written to the head of the run file.
+	 */
+	char *dict;
+	/** Size of the zstd dictionary. */
+	uint32_t dict_size;
 };
 
 /**
@@ -128,6 +168,8 @@ struct vy_run {
 	struct vy_page_info *page_info;
 	/** Run data file. */
 	int fd;
+	/** Digested info.dict used for reading pages or NULL. */
+	ZSTD_DDict *zddict;
 	/** Unique ID of this run. */
 	int64_t id;
 	/** Number of statements in this run. */
@@ -302,6 +344,16 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/** Restart interval of prefix-compressed rows, see vy_run_info. */
+	uint32_t restart_interval;
+	/**
+	 * Body of the last restored prefix-compressed row and
+	 * its number in the page or UINT32_MAX.
+	 */
+	char *body;
+	uint32_t body_size;
+	uint32_t body_capacity;
+	uint32_t body_no;
 };
 
 /**
@@ -475,7 +527,36 @@ vy_run_snprint_path(char *buf, int size, const char *dir,
 }
 
 /**
- * Remove all files (data, index) corresponding to a run
+ * Blob files referenced by a run are linked to a directory named
+ * after the run, see struct vy_blob_ref.
+ */
+static inline int
+vy_run_snprint_blob_dir(char *buf, int size, const char *dir,
+			uint32_t space_id, uint32_t iid, int64_t run_id)
+{
+	int total = 0;
+	SNPRINT(total, vy_lsm_snprint_path, buf, size,
+		dir, (unsigned)space_id, (unsigned)iid);
+	SNPRINT(total, snprintf, buf, size, "/%020lld.blob",
+		(long long)run_id);
+	return total;
+}
+
+static inline int
+vy_run_snprint_blob_path(char *buf, int size, const char *dir,
+			 uint32_t space_id, uint32_t iid,
+			 int64_t run_id, int64_t blob_id)
+{
+	int total = 0;
+	SNPRINT(total, vy_run_snprint_blob_dir, buf, size,
+		dir, space_id, iid, run_id);
+	SNPRINT(total, snprintf, buf, size, "/%020lld",
+		(long long)blob_id);
+	return total;
+}
+
+/**
+ * Remove all files (data, index, blobs) corresponding to a run
  * with the given id. Return 0 on success, -1 if unlink()
  * failed.
  */
@@ -483,6 +564,16 @@ int
 vy_run_remove_files(const char *dir, uint32_t space_id,
 		    uint32_t iid, int64_t run_id);
 
+/**
+ * Invoke a callback for each blob file linked to the directory
+ * of a run with the given id. Used for backup.
+ * Return 0 on success, -1 if the callback failed.
+ */
+int
+vy_run_foreach_blob_file(const char *dir, uint32_t space_id,
+			 uint32_t iid, int64_t run_id,
+			 int (*cb)(const char *path, void *arg), void *arg);
+
 /**
  * Allocate a new run slice.
  * This function increments @run->refs.
@@ -660,6 +751,36 @@ struct vy_run_writer {
 	 * of max key of a finished run.
 	 */
 	struct vy_entry last;
+	/**
+	 * Tuples of this size or larger are stored in blob files.
+	 * 0 if blob files are disabled.
+	 */
+	uint32_t blob_threshold;
+	/**
+	 * IDs of blob files that have too much garbage. Live tuples
+	 * referencing them are written to the run's own blob file
+	 * rather than linked.
+	 */
+	const int64_t *blob_gc_ids;
+	uint32_t blob_gc_count;
+	/** Blob file the writer appends tuples to or -1. */
+	int blob_fd;
+	/** Restart interval of prefix-compressed rows, 0 if disabled. */
+	uint32_t restart_interval;
+	/** Body of the last row written to the current page. */
+	struct ibuf prev_body;
+	/**
+	 * Max size of the zstd dictionary to train, 0 if
+	 * dictionaries are disabled.
+	 */
+	uint32_t dict_size;
+	/**
+	 * Statements buffered to train the dictionary on. They are
+	 * written once the dictionary is ready.
+	 */
+	struct ibuf samples;
+	/** Total size of buffered statements. */
+	size_t samples_size;
 };
 
 /** Create a run writer to fill a run with statements. */
@@ -669,6 +790,28 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     struct key_def *cmp_def, struct key_def *key_def,
 		     uint64_t page_size, double bloom_fpr, bool no_compression);
 
+/**
+ * Set the format of pages written by the writer. If
+ * @a restart_interval is not 0, rows are prefix-compressed.
+ * If @a dict_size is not 0, the writer buffers first statements,
+ * trains a zstd dictionary of up to this size on them and
+ * compresses all pages with it.
+ */
+void
+vy_run_writer_set_page_format(struct vy_run_writer *writer,
+			      uint32_t restart_interval, uint32_t dict_size);
+
+/**
+ * Make the writer store tuples of size @a threshold or larger in
+ * blob files. Tuples already stored in a blob file are linked
+ * unless the blob file is listed in @a gc_ids, in which case
+ * they are copied to the run's own blob file. The array must
+ * stay valid until the writer is committed or aborted.
+ */
+void
+vy_run_writer_enable_blobs(struct vy_run_writer *writer, uint32_t threshold,
+			   const int64_t *gc_ids, uint32_t gc_count);
+
 /**
  * Write a specified statement into a run.
  * @param writer Writer to write a statement.
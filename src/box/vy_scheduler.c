@@ -39,6 +39,7 @@
 #include <small/rlist.h>
 #include <tarantool_ev.h>
 
+#include "clock.h"
 #include "diag.h"
 #include "errcode.h"
 #include "errinj.h"
@@ -64,6 +65,9 @@
 #define VY_SCHEDULER_TIMEOUT_MIN	1
 #define VY_SCHEDULER_TIMEOUT_MAX	60
 
+/** Max number of tasks a range compaction can be split into. */
+enum { VY_SUBCOMPACTION_MAX = 16 };
+
 static int vy_worker_f(va_list);
 static int vy_scheduler_f(va_list);
 static void vy_task_execute_f(struct cmsg *);
@@ -205,6 +209,16 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	uint32_t blob_threshold;
+	uint32_t page_restart_interval;
+	uint32_t page_dict_size;
+	/**
+	 * IDs of blob files that have too much garbage, see
+	 * vy_task_compaction_collect_blobs(). Live tuples stored
+	 * in these files are rewritten by the task.
+	 */
+	int64_t *blob_gc_ids;
+	uint32_t blob_gc_count;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -218,6 +232,28 @@ struct vy_task {
 	 * and not yet processed.
 	 */
 	int deferred_delete_in_progress;
+	/**
+	 * Compaction of a large range may be split between a few
+	 * tasks, each of which compacts keys from a separate interval
+	 * in its own worker thread. The group is completed by its first
+	 * task (leader) once all the tasks have been executed. This
+	 * points to the leader of the group the task belongs to or is
+	 * NULL if the task isn't a part of a group.
+	 */
+	struct vy_task *leader;
+	/** Leader only: other tasks of the group, ordered by key. */
+	struct rlist subtasks;
+	/** Link in the leader's list of subtasks. */
+	struct rlist in_subtasks;
+	/** Leader only: number of tasks of the group being executed. */
+	int pending_count;
+	/** Interval of keys compacted by a task of a group. */
+	struct vy_entry begin, end;
+	/**
+	 * Slices of compacted runs cut by the interval of keys
+	 * compacted by a task of a group. Linked by in_range.
+	 */
+	struct rlist cut_slices;
 	/** Link in vy_scheduler::processed_tasks. */
 	struct stailq_entry in_processed;
 };
@@ -253,6 +289,10 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	rlist_create(&task->subtasks);
+	rlist_create(&task->cut_slices);
+	task->begin = vy_entry_none();
+	task->end = vy_entry_none();
 	return task;
 }
 
@@ -262,6 +302,16 @@ vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	assert(rlist_empty(&task->cut_slices));
+	struct vy_task *subtask, *next_subtask;
+	rlist_foreach_entry_safe(subtask, &task->subtasks, in_subtasks,
+				 next_subtask)
+		vy_task_delete(subtask);
+	if (task->begin.stmt != NULL)
+		tuple_unref(task->begin.stmt);
+	if (task->end.stmt != NULL)
+		tuple_unref(task->end.stmt);
+	free(task->blob_gc_ids);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -335,10 +385,10 @@ vy_worker_pool_start(struct vy_worker_pool *pool)
 		char name[FIBER_NAME_MAX];
 		snprintf(name, sizeof(name), "vinyl.%s.%d", pool->name, i);
 		struct vy_worker *worker = &pool->workers[i];
+		worker->pool = pool;
 		if (cord_costart(&worker->cord, name, vy_worker_f, worker) != 0)
 			panic("failed to start vinyl worker thread");
 
-		worker->pool = pool;
 		cpipe_create(&worker->worker_pipe, name);
 		stailq_add_tail_entry(&pool->idle_workers, worker, in_idle);
 
@@ -366,10 +416,12 @@ vy_worker_pool_shutdown(struct vy_worker_pool *pool)
 }
 
 static void
-vy_worker_pool_create(struct vy_worker_pool *pool, const char *name, int size)
+vy_worker_pool_create(struct vy_worker_pool *pool, const char *name, int size,
+		      enum vy_io_class io_class)
 {
 	pool->name = name;
 	pool->size = size;
+	pool->io_class = io_class;
 	pool->workers = NULL;
 	stailq_create(&pool->idle_workers);
 }
@@ -446,9 +498,10 @@ vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 	int dump_threads = MAX(1, write_threads / 4);
 	int compaction_threads = write_threads - dump_threads;
 	vy_worker_pool_create(&scheduler->dump_pool,
-			      "dump", dump_threads);
+			      "dump", dump_threads, VY_IO_DUMP);
 	vy_worker_pool_create(&scheduler->compaction_pool,
-			      "compaction", compaction_threads);
+			      "compaction", compaction_threads,
+			      VY_IO_COMPACTION);
 
 	stailq_create(&scheduler->processed_tasks);
 
@@ -1119,6 +1172,13 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 task->page_size, task->bloom_fpr,
 				 no_compression) != 0)
 		goto fail;
+	if (task->blob_threshold > 0)
+		vy_run_writer_enable_blobs(&writer, task->blob_threshold,
+					   task->blob_gc_ids,
+					   task->blob_gc_count);
+	vy_run_writer_set_page_format(&writer, task->page_restart_interval,
+				      no_compression ? 0 :
+				      task->page_dict_size);
 
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
@@ -1433,6 +1493,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	new_run->dump_count = 1;
 	new_run->dump_lsn = dump_lsn;
+	new_run->info.dump_time = vy_compaction_time();
 
 	/*
 	 * Note, since deferred DELETE are generated on tx commit
@@ -1457,6 +1518,10 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->blob_threshold = lsm->index_id == 0 ?
+			       lsm->opts.blob_threshold : 0;
+	task->page_restart_interval = lsm->opts.page_restart_interval;
+	task->page_dict_size = lsm->opts.page_dict_size;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1687,6 +1752,507 @@ vy_task_compaction_abort(struct vy_task *task)
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Close the write iterator of a task of a subcompaction group
+ * and delete the slices it was reading from.
+ */
+static void
+vy_task_subcompaction_close(struct vy_task *task)
+{
+	if (task->wi != NULL) {
+		task->wi->iface->close(task->wi);
+		task->wi = NULL;
+	}
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &task->cut_slices,
+				 in_range, next_slice)
+		vy_slice_delete(slice);
+	rlist_create(&task->cut_slices);
+}
+
+static int
+vy_task_subcompaction_complete(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_slice *first_slice = task->first_slice;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice, *new_slice;
+	struct vy_range *new_range;
+	struct vy_run *run;
+
+	/*
+	 * The leader is checked by vy_task_complete() so we only
+	 * need to check the other tasks of the group here.
+	 */
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		if (subtask->is_failed) {
+			diag_move(&subtask->diag, diag_get());
+			return -1;
+		}
+	}
+
+	/* The iterators have been cleaned up in workers. */
+	vy_task_subcompaction_close(task);
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks)
+		vy_task_subcompaction_close(subtask);
+
+	/* Tasks of the group ordered by key, starting from the leader. */
+	int n_parts = 0;
+	struct vy_task *parts[VY_SUBCOMPACTION_MAX];
+	struct vy_range *new_ranges[VY_SUBCOMPACTION_MAX];
+	parts[n_parts] = task;
+	new_ranges[n_parts++] = NULL;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		assert(n_parts < VY_SUBCOMPACTION_MAX);
+		parts[n_parts] = subtask;
+		new_ranges[n_parts++] = NULL;
+	}
+
+	/*
+	 * The LSM tree could have been dropped while we were writing
+	 * the new runs, see vy_task_compaction_complete().
+	 */
+	if (lsm->is_dropped) {
+		for (int i = 0; i < n_parts; i++)
+			vy_run_discard(parts[i]->new_run);
+		goto out;
+	}
+
+	/*
+	 * Replace the compacted range with new ranges, one per each
+	 * task of the group. A new range gets a slice of the run
+	 * written by the corresponding task and slices of the runs
+	 * that weren't compacted, cut by the range boundaries.
+	 *
+	 * Note, since a slice might have been added to the range
+	 * by a concurrent dump while compaction was in progress,
+	 * we must insert the new slice at the same position where
+	 * the compacted slices were.
+	 */
+	for (int i = 0; i < n_parts; i++) {
+		struct vy_task *part = parts[i];
+		new_range = vy_range_new(vy_log_next_id(), part->begin,
+					 part->end, lsm->cmp_def);
+		if (new_range == NULL)
+			goto fail;
+		new_ranges[i] = new_range;
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward.
+		 */
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice)
+				is_compacted = true;
+			if (is_compacted) {
+				if (slice != first_slice)
+					continue;
+				is_compacted = false;
+				if (vy_run_is_empty(part->new_run))
+					continue;
+				new_slice = vy_slice_new(vy_log_next_id(),
+							 part->new_run,
+							 new_range->begin,
+							 new_range->end,
+							 lsm->cmp_def);
+				if (new_slice == NULL)
+					goto fail;
+			} else if (vy_slice_cut(slice, vy_log_next_id(),
+						new_range->begin,
+						new_range->end, lsm->cmp_def,
+						&new_slice) != 0) {
+				goto fail;
+			}
+			if (new_slice != NULL)
+				vy_range_add_slice(new_range, new_slice);
+		}
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (int i = 0; i < n_parts; i++) {
+		run = parts[i]->new_run;
+		new_range = new_ranges[i];
+		if (!vy_run_is_empty(run))
+			vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+					  run->dump_count);
+		vy_log_insert_range(lsm->id, new_range->id,
+				    tuple_data_or_null(new_range->begin.stmt),
+				    tuple_data_or_null(new_range->end.stmt));
+		rlist_foreach_entry(slice, &new_range->slices, in_range)
+			vy_log_insert_slice(new_range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/*
+	 * Remove compacted run files that were created after
+	 * the last checkpoint, see vy_task_compaction_complete().
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id);
+	}
+
+	/*
+	 * Account the new runs if they are not empty,
+	 * otherwise discard them.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (int i = 0; i < n_parts; i++) {
+		run = parts[i]->new_run;
+		vy_disk_stmt_counter_add(&compaction_output, &run->count);
+		if (!vy_run_is_empty(run)) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else
+			vy_run_discard(run);
+	}
+
+	vy_disk_stmt_counter_reset(&compaction_input);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Replace the old range in the LSM tree. Note, it was
+	 * removed from the heap when the task was scheduled.
+	 */
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_lsm_unacct_range(lsm, range);
+	vy_lsm_remove_range(lsm, range);
+	for (int i = 0; i < n_parts; i++) {
+		new_range = new_ranges[i];
+		new_range->n_compactions = range->n_compactions + 1;
+		new_range->needs_compaction = range->needs_compaction;
+		vy_range_update_compaction_priority(new_range, &lsm->opts);
+		vy_range_update_dumps_per_compaction(new_range);
+		vy_lsm_add_range(lsm, new_range);
+		vy_lsm_acct_range(lsm, new_range);
+	}
+	lsm->range_tree_version++;
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+
+	/*
+	 * Unaccount unused runs and delete the old range.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_verbose("%s: completed compacting range %s in %d parts",
+		    vy_lsm_name(lsm), vy_range_str(range), n_parts);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	return 0;
+out:
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_scheduler_update_lsm(scheduler, lsm);
+	return 0;
+fail:
+	for (int i = 0; i < n_parts; i++) {
+		if (new_ranges[i] != NULL)
+			vy_range_delete(new_ranges[i]);
+	}
+	return -1;
+}
+
+static void
+vy_task_subcompaction_abort(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+
+	struct error *e = diag_last_error(&task->diag);
+	error_log(e);
+	say_error("%s: failed to compact range %s",
+		  vy_lsm_name(lsm), vy_range_str(range));
+
+	struct vy_task *subtask;
+	vy_task_subcompaction_close(task);
+	vy_run_discard(task->new_run);
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		vy_task_subcompaction_close(subtask);
+		vy_run_discard(subtask->new_run);
+	}
+
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_scheduler_update_lsm(scheduler, lsm);
+}
+
+/**
+ * Split compaction of a large range between a few worker threads.
+ *
+ * If the size of compacted data exceeds the target range size
+ * several times and there are idle compaction workers, the range
+ * is divided into intervals of keys of approximately equal size,
+ * using the page index of the oldest compacted run. The first
+ * interval is compacted by @a task, which becomes the leader of
+ * the group, and a new task is created for each other interval.
+ * All tasks of the group are executed in parallel and committed
+ * at once, by replacing the range with new ranges matching the
+ * intervals, see vy_task_subcompaction_complete().
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+static int
+vy_task_compaction_split(struct vy_task *task, int64_t input_size)
+{
+	static struct vy_task_ops subcompaction_ops = {
+		.execute = vy_task_compaction_execute,
+		.complete = vy_task_subcompaction_complete,
+		.abort = vy_task_subcompaction_abort,
+	};
+
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+
+	int64_t n_parts = input_size / vy_lsm_range_size(lsm);
+	n_parts = MIN(n_parts, VY_SUBCOMPACTION_MAX);
+	if (n_parts < 2)
+		return 0;
+
+	/* Don't wait for busy workers, use only idle ones. */
+	int worker_count = 0;
+	struct vy_worker *workers[VY_SUBCOMPACTION_MAX - 1];
+	while (worker_count < n_parts - 1) {
+		struct vy_worker *worker = vy_worker_pool_get(
+					&scheduler->compaction_pool);
+		if (worker == NULL)
+			break;
+		workers[worker_count++] = worker;
+	}
+	int key_count = 0;
+	const char *keys[VY_SUBCOMPACTION_MAX - 1];
+	if (worker_count > 0)
+		key_count = vy_range_find_split_keys(range, task->last_slice,
+						     worker_count + 1, keys);
+	while (worker_count > key_count)
+		vy_worker_pool_put(workers[--worker_count]);
+	if (key_count == 0)
+		return 0;
+
+	task->ops = &subcompaction_ops;
+	task->leader = task;
+	task->pending_count = 1;
+	task->begin = range->begin;
+	if (task->begin.stmt != NULL)
+		tuple_ref(task->begin.stmt);
+
+	struct vy_task *part = task;
+	for (int i = 0; i < key_count; i++) {
+		struct vy_entry key = vy_entry_key_from_msgpack(
+				lsm->env->key_format, lsm->cmp_def, keys[i]);
+		if (key.stmt == NULL)
+			goto fail;
+		/* The previous part ends where this one begins. */
+		part->end = key;
+		struct vy_task *subtask = vy_task_new(scheduler, workers[i],
+						      lsm, &subcompaction_ops);
+		if (subtask == NULL)
+			goto fail;
+		/* The worker is released along with the task now. */
+		workers[i] = NULL;
+		rlist_add_tail_entry(&task->subtasks, subtask, in_subtasks);
+		task->pending_count++;
+		subtask->leader = task;
+		subtask->range = range;
+		subtask->first_slice = task->first_slice;
+		subtask->last_slice = task->last_slice;
+		subtask->bloom_fpr = task->bloom_fpr;
+		subtask->page_size = task->page_size;
+		subtask->blob_threshold = task->blob_threshold;
+		subtask->page_restart_interval = task->page_restart_interval;
+		subtask->page_dict_size = task->page_dict_size;
+		subtask->begin = key;
+		tuple_ref(key.stmt);
+		subtask->new_run = vy_run_prepare(scheduler->run_env, lsm);
+		if (subtask->new_run == NULL)
+			goto fail;
+		subtask->new_run->dump_lsn = task->new_run->dump_lsn;
+		subtask->new_run->dump_count = task->new_run->dump_count;
+		subtask->new_run->info.dump_time =
+			task->new_run->info.dump_time;
+		part = subtask;
+	}
+	part->end = range->end;
+	if (part->end.stmt != NULL)
+		tuple_ref(part->end.stmt);
+
+	say_verbose("%s: splitting compaction of range %s in %d parts",
+		    vy_lsm_name(lsm), vy_range_str(range), key_count + 1);
+	return 0;
+fail:
+	for (int i = 0; i < key_count; i++) {
+		if (workers[i] != NULL)
+			vy_worker_pool_put(workers[i]);
+	}
+	return -1;
+}
+
+/**
+ * A blob file is garbage collected when the total size of live
+ * tuples stored in it drops below this fraction of its size.
+ */
+static const double VY_BLOB_GC_LIVE_RATIO = 0.5;
+
+/**
+ * Collect IDs of blob files referenced by the runs compacted by
+ * a task that are mostly garbage, i.e. store tuples that were
+ * overwritten or deleted. The task copies live tuples stored in
+ * those files to the new run's own blob file rather than linking
+ * the files, which lets the files be removed once all runs that
+ * reference them are compacted and garbage collected.
+ *
+ * Returns 0 on success, -1 on memory allocation error.
+ */
+static int
+vy_task_compaction_collect_blobs(struct vy_task *task)
+{
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		struct vy_run_info *info = &slice->run->info;
+		for (uint32_t i = 0; i < info->blob_count; i++) {
+			struct vy_run_blob *blob = &info->blobs[i];
+			bool is_collected = false;
+			for (uint32_t j = 0; j < task->blob_gc_count; j++) {
+				if (task->blob_gc_ids[j] == blob->id)
+					is_collected = true;
+			}
+			if (is_collected)
+				continue;
+			/* Sum live tuples over all runs of the tree. */
+			uint64_t live_size = 0;
+			struct vy_run *run;
+			rlist_foreach_entry(run, &lsm->runs, in_lsm) {
+				for (uint32_t k = 0; k < run->info.blob_count;
+				     k++) {
+					struct vy_run_blob *b =
+						&run->info.blobs[k];
+					if (b->id == blob->id)
+						live_size += b->live_size;
+				}
+			}
+			if (live_size >= blob->size * VY_BLOB_GC_LIVE_RATIO)
+				continue;
+			size_t size = (task->blob_gc_count + 1) *
+				      sizeof(*task->blob_gc_ids);
+			int64_t *ids = realloc(task->blob_gc_ids, size);
+			if (ids == NULL) {
+				diag_set(OutOfMemory, size, "realloc",
+					 "blob ids");
+				return -1;
+			}
+			ids[task->blob_gc_count++] = blob->id;
+			task->blob_gc_ids = ids;
+		}
+		if (slice == task->last_slice)
+			break;
+	}
+	return 0;
+}
+
+/**
+ * Create the write iterator for a compaction task. If the task
+ * is a part of a subcompaction group, the compacted slices are
+ * cut by the interval of keys compacted by the task.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+static int
+vy_task_compaction_prepare(struct vy_task *task, bool is_last_level)
+{
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_stmt_stream *wi;
+	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
+				   is_last_level, task->scheduler->read_views,
+				   lsm->index_id > 0 ? NULL :
+				   &task->deferred_delete_handler);
+	if (wi == NULL)
+		return -1;
+	task->wi = wi;
+
+	if (task->blob_threshold > 0 &&
+	    vy_task_compaction_collect_blobs(task) != 0)
+		return -1;
+
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		struct vy_slice *input = slice;
+		if (task->leader != NULL) {
+			if (vy_slice_cut(slice, vy_log_next_id(), task->begin,
+					 task->end, lsm->cmp_def,
+					 &input) != 0)
+				return -1;
+			if (input != NULL)
+				rlist_add_tail_entry(&task->cut_slices,
+						     input, in_range);
+		}
+		if (input != NULL &&
+		    vy_write_iterator_new_slice(wi, input,
+						lsm->disk_format) != 0)
+			return -1;
+		if (slice == task->last_slice)
+			break;
+	}
+	return 0;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1716,25 +2282,26 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (new_run == NULL)
 		goto err_run;
 
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compaction_priority == range->slice_count);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
-				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
-	if (wi == NULL)
-		goto err_wi;
+	bool is_last_level = (range->compaction_offset +
+			      range->compaction_priority == range->slice_count);
 
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
+	int64_t input_size = 0;
+	int skip = range->compaction_offset;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
-			goto err_wi_sub;
+		if (skip > 0) {
+			/* Newer runs are not compacted by this task. */
+			skip--;
+			continue;
+		}
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
 					slice->run->dump_lsn);
+		new_run->info.dump_time = MAX(new_run->info.dump_time,
+					      slice->run->info.dump_time);
 		dump_count += slice->run->dump_count;
+		input_size += slice->count.bytes;
 		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
 			task->first_slice = slice;
@@ -1745,7 +2312,7 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	}
 	assert(n == 0);
 	assert(new_run->dump_lsn >= 0);
-	if (range->compaction_priority == range->slice_count)
+	if (is_last_level)
 		dump_count -= slice->run->dump_count;
 	/*
 	 * Do not update dumps_per_compaction in case compaction
@@ -1757,13 +2324,26 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	else
 		new_run->dump_count = dump_count;
 
-	range->needs_compaction = false;
-
 	task->range = range;
 	task->new_run = new_run;
-	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->blob_threshold = lsm->index_id == 0 ?
+			       lsm->opts.blob_threshold : 0;
+	task->page_restart_interval = lsm->opts.page_restart_interval;
+	task->page_dict_size = lsm->opts.page_dict_size;
+
+	if (vy_task_compaction_split(task, input_size) != 0)
+		goto err_wi;
+	if (vy_task_compaction_prepare(task, is_last_level) != 0)
+		goto err_wi;
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		if (vy_task_compaction_prepare(subtask, is_last_level) != 0)
+			goto err_wi;
+	}
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1772,15 +2352,21 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_range_heap_delete(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 
-	say_verbose("%s: started compacting range %s, runs %d/%d",
-		    vy_lsm_name(lsm), vy_range_str(range),
-		    range->compaction_priority, range->slice_count);
+	say_verbose("%s: started compacting range %s, runs %d/%d, "
+		    "skipped %d", vy_lsm_name(lsm), vy_range_str(range),
+		    range->compaction_priority, range->slice_count,
+		    range->compaction_offset);
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
 err_wi:
+	vy_task_subcompaction_close(task);
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		vy_task_subcompaction_close(subtask);
+		if (subtask->new_run != NULL)
+			vy_run_discard(subtask->new_run);
+		vy_worker_pool_put(subtask->worker);
+	}
 	vy_run_discard(new_run);
 err_run:
 	vy_task_delete(task);
@@ -2082,11 +2668,26 @@ vy_scheduler_complete_tasks(struct vy_scheduler *scheduler, int *tasks_done,
 		struct vy_task *task, *next;
 		stailq_concat(&tasks, &scheduler->processed_tasks);
 		stailq_foreach_entry_safe(task, next, &tasks, in_processed) {
+			if (task->leader != NULL) {
+				/*
+				 * Tasks of a subcompaction group are
+				 * completed at once, by the leader, when
+				 * all of them have been executed.
+				 */
+				struct vy_task *leader = task->leader;
+				vy_worker_pool_put(task->worker);
+				task->worker = NULL;
+				assert(leader->pending_count > 0);
+				if (--leader->pending_count > 0)
+					continue;
+				task = leader;
+			}
 			if (vy_task_complete(task) == 0)
 				(*tasks_done)++;
 			else
 				(*tasks_failed)++;
-			vy_worker_pool_put(task->worker);
+			if (task->worker != NULL)
+				vy_worker_pool_put(task->worker);
 			vy_task_delete(task);
 		}
 	}
@@ -2132,6 +2733,12 @@ vy_scheduler_f(va_list va)
 		/* Queue the task for execution. */
 		cmsg_init(&task->cmsg, vy_task_execute_route);
 		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+		struct vy_task *subtask;
+		rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+			cmsg_init(&subtask->cmsg, vy_task_execute_route);
+			cpipe_push(&subtask->worker->worker_pipe,
+				   &subtask->cmsg);
+		}
 
 		fiber_reschedule();
 		continue;
@@ -2170,6 +2777,7 @@ vy_worker_f(va_list ap)
 	struct vy_worker *worker = va_arg(ap, struct vy_worker *);
 	struct cbus_endpoint endpoint;
 
+	vy_io_set_class(worker->pool->io_class);
 	cpipe_create(&worker->tx_pipe, "tx");
 	cbus_endpoint_create(&endpoint, cord_name(&worker->cord),
 			     fiber_schedule_cb, fiber());
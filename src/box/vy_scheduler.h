@@ -41,6 +41,7 @@
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
 #include "salad/stailq.h"
+#include "vy_io.h"
 #include "vy_stat.h"
 
 #if defined(__cplusplus)
@@ -63,6 +64,8 @@ struct vy_worker_pool {
 	const char *name;
 	/** Number of worker threads in the pool. */
 	int size;
+	/** Class of disk I/O done by worker threads. */
+	enum vy_io_class io_class;
 	/** Array of all worker threads in the pool. */
 	struct vy_worker *workers;
 	/** List of workers that are currently idle. */
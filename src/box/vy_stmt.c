@@ -52,6 +52,8 @@
 enum vy_stmt_meta_key {
 	/** Statement flags. */
 	VY_STMT_FLAGS = 0x01,
+	/** Blob reference: [blob_id, offset, size]. */
+	VY_STMT_BLOB_REF = 0x02,
 };
 
 /**
@@ -70,6 +72,12 @@ vy_stmt_persistent_flags(struct tuple *stmt, bool is_primary)
 	 */
 	mask &= ~VY_STMT_UPDATE;
 
+	/*
+	 * A blob reference is stored under a separate meta key,
+	 * see vy_stmt_meta_encode().
+	 */
+	mask &= ~VY_STMT_BLOB;
+
 	if (!is_primary) {
 		/*
 		 * Do not store VY_STMT_DEFERRED_DELETE flag in
@@ -202,11 +210,14 @@ vy_stmt_is_exact_key(struct tuple *stmt, struct key_def *cmp_def,
  * @param bsize  Size of the variable part of the statement. It
  *               includes size of MessagePack tuple data and, for
  *               upserts, MessagePack array of operations.
+ * @param extra  Size of the memory reserved after the statement
+ *               data. Used for storing a blob reference.
  * @retval not NULL Success.
  * @retval     NULL Memory error.
  */
 static struct tuple *
-vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
+vy_stmt_alloc_ext(struct tuple_format *format, uint32_t data_offset,
+		  uint32_t bsize, uint32_t extra)
 {
 	assert(data_offset >= sizeof(struct vy_stmt) + format->field_map_size);
 
@@ -226,9 +237,10 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 			 "vinyl statement allocate");
 		return NULL;
 	});
-	struct tuple *tuple = malloc(total_size);
+	struct tuple *tuple = malloc(total_size + extra);
 	if (unlikely(tuple == NULL)) {
-		diag_set(OutOfMemory, total_size, "malloc", "struct vy_stmt");
+		diag_set(OutOfMemory, total_size + extra, "malloc",
+			 "struct vy_stmt");
 		return NULL;
 	}
 	tuple_create(tuple, 1, tuple_format_id(format),
@@ -245,6 +257,12 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 	return tuple;
 }
 
+static struct tuple *
+vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
+{
+	return vy_stmt_alloc_ext(format, data_offset, bsize, 0);
+}
+
 struct tuple *
 vy_stmt_dup(struct tuple *stmt)
 {
@@ -253,15 +271,32 @@ vy_stmt_dup(struct tuple *stmt)
 	 * tuple field map. This map can be simple memcopied from
 	 * the original tuple.
 	 */
-	struct tuple *res = vy_stmt_alloc(tuple_format(stmt),
-					  tuple_data_offset(stmt),
-					  tuple_bsize(stmt));
+	uint32_t extra = (vy_stmt_flags(stmt) & VY_STMT_BLOB) != 0 ?
+			 sizeof(struct vy_blob_ref) : 0;
+	struct tuple *res = vy_stmt_alloc_ext(tuple_format(stmt),
+					      tuple_data_offset(stmt),
+					      tuple_bsize(stmt), extra);
 	if (res == NULL)
 		return NULL;
 	assert(tuple_size(res) == tuple_size(stmt));
 	assert(tuple_data_offset(res) == tuple_data_offset(stmt));
+	memcpy(res, stmt, tuple_size(stmt) + extra);
+	tuple_ref_init(res, 1);
+	return res;
+}
+
+struct tuple *
+vy_stmt_dup_with_blob(struct tuple *stmt, const struct vy_blob_ref *ref)
+{
+	struct tuple *res = vy_stmt_alloc_ext(tuple_format(stmt),
+					      tuple_data_offset(stmt),
+					      tuple_bsize(stmt), sizeof(*ref));
+	if (res == NULL)
+		return NULL;
 	memcpy(res, stmt, tuple_size(stmt));
+	memcpy((char *)res + tuple_size(res), ref, sizeof(*ref));
 	tuple_ref_init(res, 1);
+	vy_stmt_set_flags(res, vy_stmt_flags(stmt) | VY_STMT_BLOB);
 	return res;
 }
 
@@ -269,6 +304,8 @@ struct tuple *
 vy_stmt_dup_lsregion(struct tuple *stmt, struct lsregion *lsregion,
 		     int64_t alloc_id)
 {
+	/* Blob references are never stored in memory trees. */
+	assert((vy_stmt_flags(stmt) & VY_STMT_BLOB) == 0);
 	size_t size = tuple_size(stmt);
 	struct tuple *mem_stmt;
 	const size_t align = alignof(struct vy_stmt);
@@ -333,9 +370,9 @@ vy_key_new(struct tuple_format *format, const char *key, uint32_t part_count)
  * For details @sa struct vy_stmt comment.
  */
 static struct tuple *
-vy_stmt_new_with_ops(struct tuple_format *format, const char *tuple_begin,
-		     const char *tuple_end, struct iovec *ops,
-		     int op_count, enum iproto_type type)
+vy_stmt_new_with_ops_ext(struct tuple_format *format, const char *tuple_begin,
+			 const char *tuple_end, struct iovec *ops,
+			 int op_count, enum iproto_type type, uint32_t extra)
 {
 	mp_tuple_assert(tuple_begin, tuple_end);
 
@@ -372,8 +409,8 @@ vy_stmt_new_with_ops(struct tuple_format *format, const char *tuple_begin,
 	 */
 	size_t mpsize = (tuple_end - tuple_begin);
 	size_t bsize = mpsize + ops_size;
-	stmt = vy_stmt_alloc(format, sizeof(struct vy_stmt) +
-			     field_map_size, bsize);
+	stmt = vy_stmt_alloc_ext(format, sizeof(struct vy_stmt) +
+				 field_map_size, bsize, extra);
 	if (stmt == NULL)
 		goto end;
 	/* Copy MsgPack data */
@@ -393,6 +430,36 @@ vy_stmt_new_with_ops(struct tuple_format *format, const char *tuple_begin,
 	return stmt;
 }
 
+static struct tuple *
+vy_stmt_new_with_ops(struct tuple_format *format, const char *tuple_begin,
+		     const char *tuple_end, struct iovec *ops,
+		     int op_count, enum iproto_type type)
+{
+	return vy_stmt_new_with_ops_ext(format, tuple_begin, tuple_end,
+					ops, op_count, type, 0);
+}
+
+struct tuple *
+vy_stmt_new_from_blob(struct tuple_format *format, struct tuple *stmt,
+		      const char *data, const char *data_end,
+		      const struct vy_blob_ref *ref)
+{
+	assert(vy_stmt_flags(stmt) & VY_STMT_BLOB);
+	struct tuple *res = vy_stmt_new_with_ops_ext(
+		format, data, data_end, NULL, 0, vy_stmt_type(stmt),
+		ref != NULL ? sizeof(*ref) : 0);
+	if (res == NULL)
+		return NULL;
+	vy_stmt_set_lsn(res, vy_stmt_lsn(stmt));
+	uint8_t flags = vy_stmt_flags(stmt) & ~VY_STMT_BLOB;
+	if (ref != NULL) {
+		memcpy((char *)res + tuple_size(res), ref, sizeof(*ref));
+		flags |= VY_STMT_BLOB;
+	}
+	vy_stmt_set_flags(res, flags);
+	return res;
+}
+
 struct tuple *
 vy_stmt_new_upsert(struct tuple_format *format, const char *tuple_begin,
 		   const char *tuple_end, struct iovec *operations,
@@ -606,24 +673,37 @@ vy_bloom_maybe_has(const struct tuple_bloom *bloom,
 
 /**
  * Encode the given statement meta data in a request.
+ * If @a blob is not NULL, the blob reference is encoded, too.
  * Returns 0 on success, -1 on memory allocation error.
  */
 static int
 vy_stmt_meta_encode(struct tuple *stmt, struct request *request,
-		    bool is_primary)
+		    bool is_primary, const struct vy_blob_ref *blob)
 {
 	uint8_t flags = vy_stmt_persistent_flags(stmt, is_primary);
-	if (flags == 0)
+	uint32_t count = (flags != 0) + (blob != NULL);
+	if (count == 0)
 		return 0; /* nothing to encode */
 
-	size_t len = mp_sizeof_map(1) * 2 * mp_sizeof_uint(UINT64_MAX);
+	size_t len = mp_sizeof_map(count) +
+		     count * 2 * mp_sizeof_uint(UINT64_MAX) +
+		     mp_sizeof_array(3) + 3 * mp_sizeof_uint(UINT64_MAX);
 	char *buf = region_alloc(&fiber()->gc, len);
 	if (buf == NULL)
 		return -1;
 	char *pos = buf;
-	pos = mp_encode_map(pos, 1);
-	pos = mp_encode_uint(pos, VY_STMT_FLAGS);
-	pos = mp_encode_uint(pos, flags);
+	pos = mp_encode_map(pos, count);
+	if (flags != 0) {
+		pos = mp_encode_uint(pos, VY_STMT_FLAGS);
+		pos = mp_encode_uint(pos, flags);
+	}
+	if (blob != NULL) {
+		pos = mp_encode_uint(pos, VY_STMT_BLOB_REF);
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_uint(pos, blob->blob_id);
+		pos = mp_encode_uint(pos, blob->offset);
+		pos = mp_encode_uint(pos, blob->size);
+	}
 	assert(pos <= buf + len);
 
 	request->tuple_meta = buf;
@@ -633,27 +713,43 @@ vy_stmt_meta_encode(struct tuple *stmt, struct request *request,
 
 /**
  * Decode statement meta data from a request.
+ * Returns true if the meta data contain a blob reference,
+ * in which case it is stored in @a blob.
  */
-static void
-vy_stmt_meta_decode(struct request *request, struct tuple *stmt)
+static bool
+vy_stmt_meta_decode(struct request *request, uint8_t *flags,
+		    struct vy_blob_ref *blob)
 {
+	*flags = 0;
 	const char *data = request->tuple_meta;
 	if (data == NULL)
-		return; /* nothing to decode */
+		return false; /* nothing to decode */
 
+	bool has_blob = false;
 	uint32_t size = mp_decode_map(&data);
 	for (uint32_t i = 0; i < size; i++) {
 		uint64_t key = mp_decode_uint(&data);
 		switch (key) {
-		case VY_STMT_FLAGS: {
-			uint64_t flags = mp_decode_uint(&data);
-			vy_stmt_set_flags(stmt, flags);
+		case VY_STMT_FLAGS:
+			*flags = mp_decode_uint(&data);
+			break;
+		case VY_STMT_BLOB_REF: {
+			uint32_t len = mp_decode_array(&data);
+			assert(len >= 3);
+			blob->blob_id = mp_decode_uint(&data);
+			blob->offset = mp_decode_uint(&data);
+			blob->size = mp_decode_uint(&data);
+			blob->run_id = -1;
+			for (uint32_t j = 3; j < len; j++)
+				mp_next(&data);
+			has_blob = true;
 			break;
 		}
 		default:
 			mp_next(&data); /* unknown key, ignore */
 		}
 	}
+	return has_blob;
 }
 
 int
@@ -697,7 +793,7 @@ vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
 	default:
 		unreachable();
 	}
-	if (vy_stmt_meta_encode(value, &request, true) != 0)
+	if (vy_stmt_meta_encode(value, &request, true, NULL) != 0)
 		return -1;
 	xrow_encode_dml(&request, &fiber()->gc, xrow->body, &xrow->bodycnt);
 	return 0;
@@ -730,7 +826,35 @@ vy_stmt_encode_secondary(struct tuple *value, struct key_def *cmp_def,
 		request.key = extracted;
 		request.key_end = extracted + size;
 	}
-	if (vy_stmt_meta_encode(value, &request, false) != 0)
+	if (vy_stmt_meta_encode(value, &request, false, NULL) != 0)
+		return -1;
+	xrow_encode_dml(&request, &fiber()->gc, xrow->body, &xrow->bodycnt);
+	return 0;
+}
+
+int
+vy_stmt_encode_blob(struct tuple *value, struct key_def *key_def,
+		    const struct vy_blob_ref *ref, struct xrow_header *xrow)
+{
+	memset(xrow, 0, sizeof(*xrow));
+	enum iproto_type type = vy_stmt_type(value);
+	assert(type == IPROTO_REPLACE || type == IPROTO_INSERT);
+	xrow->type = type;
+	xrow->lsn = vy_stmt_lsn(value);
+
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = type;
+	uint32_t size;
+	const char *extracted = vy_stmt_is_key(value) ?
+				tuple_data_range(value, &size) :
+				tuple_extract_key(value, key_def,
+						  MULTIKEY_NONE, &size);
+	if (extracted == NULL)
+		return -1;
+	request.tuple = extracted;
+	request.tuple_end = extracted + size;
+	if (vy_stmt_meta_encode(value, &request, true, ref) != 0)
 		return -1;
 	xrow_encode_dml(&request, &fiber()->gc, xrow->body, &xrow->bodycnt);
 	return 0;
@@ -750,6 +874,9 @@ vy_stmt_decode(struct xrow_header *xrow, struct tuple_format *format)
 	key_map &= ~(1ULL << IPROTO_SPACE_ID); /* space_id is optional */
 	if (xrow_decode_dml(xrow, &request, key_map) != 0)
 		return NULL;
+	uint8_t flags;
+	struct vy_blob_ref blob;
+	bool has_blob = vy_stmt_meta_decode(&request, &flags, &blob);
 	struct tuple *stmt = NULL;
 	struct iovec ops;
 	switch (request.type) {
@@ -761,7 +888,12 @@ vy_stmt_decode(struct xrow_header *xrow, struct tuple_format *format)
 		break;
 	case IPROTO_INSERT:
 	case IPROTO_REPLACE:
-		stmt = vy_stmt_new_with_ops(format, request.tuple,
+		/*
+		 * If the tuple is stored in a blob file, the request
+		 * contains only the key so use key format.
+		 */
+		stmt = vy_stmt_new_with_ops(has_blob ? env->key_format :
+					    format, request.tuple,
 					    request.tuple_end,
 					    NULL, 0, request.type);
 		break;
@@ -783,7 +915,14 @@ vy_stmt_decode(struct xrow_header *xrow, struct tuple_format *format)
 	if (stmt == NULL)
 		return NULL; /* OOM */
 
-	vy_stmt_meta_decode(&request, stmt);
+	if (has_blob) {
+		struct tuple *key = stmt;
+		stmt = vy_stmt_dup_with_blob(key, &blob);
+		tuple_unref(key);
+		if (stmt == NULL)
+			return NULL;
+	}
+	vy_stmt_set_flags(stmt, vy_stmt_flags(stmt) | flags);
 	vy_stmt_set_lsn(stmt, xrow->lsn);
 	return stmt;
 }
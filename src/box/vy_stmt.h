@@ -33,6 +33,7 @@
 
 #include <trivia/util.h>
 #include <stddef.h>
+#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
@@ -141,11 +142,49 @@ enum {
 	 * compaction. It is never written to disk.
 	 */
 	VY_STMT_UPDATE			= 1 << 2,
+	/**
+	 * This flag is set for statements that carry a reference
+	 * to a value stored in a blob file, see struct vy_blob_ref.
+	 * A statement read from a run file with this flag set is
+	 * a key statement that must be resolved before it can be
+	 * returned to the user. A resolved statement may retain
+	 * the flag so that the run writer can reuse the stored
+	 * value rather than write it again. The flag is never
+	 * written to disk as is.
+	 */
+	VY_STMT_BLOB			= 1 << 3,
 	/**
 	 * Bit mask of all statement flags.
 	 */
 	VY_STMT_FLAGS_ALL = (VY_STMT_DEFERRED_DELETE | VY_STMT_SKIP_READ |
-			     VY_STMT_UPDATE),
+			     VY_STMT_UPDATE | VY_STMT_BLOB),
+};
+
+/**
+ * Reference to a tuple stored in a blob file.
+ *
+ * If a primary index has the blob_threshold option set, tuples
+ * larger than the threshold are appended to a blob file, while
+ * the run file stores only the primary key and the reference.
+ * Compaction copies the reference rather than the tuple so that
+ * large values are written to disk only once.
+ *
+ * The reference is stored in memory right after the statement
+ * data (see vy_stmt_dup_with_blob()).
+ */
+struct vy_blob_ref {
+	/** ID of the blob file. */
+	int64_t blob_id;
+	/**
+	 * ID of the run the statement was read from. The blob file
+	 * is linked to the directory of every run referencing it.
+	 * Not stored on disk.
+	 */
+	int64_t run_id;
+	/** Offset of the tuple in the blob file. */
+	uint64_t offset;
+	/** Size of the tuple. */
+	uint32_t size;
 };
 
 /**
@@ -347,6 +386,48 @@ vy_stmt_is_exact_key(struct tuple *stmt, struct key_def *cmp_def,
 struct tuple *
 vy_stmt_dup(struct tuple *stmt);
 
+/**
+ * Duplicate the statement and attach a blob reference to it.
+ * The new statement has VY_STMT_BLOB flag set.
+ *
+ * @param stmt statement
+ * @param ref  blob reference
+ * @retval not NULL The new statement.
+ * @retval     NULL Memory error.
+ */
+struct tuple *
+vy_stmt_dup_with_blob(struct tuple *stmt, const struct vy_blob_ref *ref);
+
+/**
+ * Get the blob reference attached to a statement.
+ * The statement must have VY_STMT_BLOB flag set.
+ */
+static inline void
+vy_stmt_blob_ref(struct tuple *stmt, struct vy_blob_ref *ref)
+{
+	assert(vy_stmt_flags(stmt) & VY_STMT_BLOB);
+	memcpy(ref, (char *)stmt + tuple_size(stmt), sizeof(*ref));
+}
+
+/**
+ * Create a statement from a tuple read from a blob file.
+ * The type, LSN and flags are copied from @a stmt, which is
+ * the key statement referencing the blob.
+ *
+ * @param format Format of the new statement.
+ * @param stmt   Key statement with VY_STMT_BLOB flag set.
+ * @param data   MessagePack array of the tuple fields.
+ * @param data_end End of @a data.
+ * @param ref    Blob reference to attach to the new statement
+ *               or NULL if the statement must not keep it.
+ * @retval not NULL The new statement.
+ * @retval     NULL Memory error.
+ */
+struct tuple *
+vy_stmt_new_from_blob(struct tuple_format *format, struct tuple *stmt,
+		      const char *data, const char *data_end,
+		      const struct vy_blob_ref *ref);
+
 struct lsregion;
 
 /**
@@ -713,6 +794,23 @@ int
 vy_stmt_encode_secondary(struct tuple *value, struct key_def *cmp_def,
 			 int multikey_idx, struct xrow_header *xrow);
 
+/**
+ * Encode a REPLACE or INSERT statement for a primary key with
+ * the tuple stored in a blob file. Only the primary key and the
+ * blob reference are written to the xrow.
+ *
+ * @param value statement to encode
+ * @param key_def key definition
+ * @param ref reference to the tuple in a blob file
+ * @param xrow[out] xrow to fill
+ *
+ * @retval 0 if OK
+ * @retval -1 if error
+ */
+int
+vy_stmt_encode_blob(struct tuple *value, struct key_def *key_def,
+		    const struct vy_blob_ref *ref, struct xrow_header *xrow);
+
 /**
  * Reconstruct vinyl tuple info and data from xrow
  *
@@ -33,6 +33,7 @@
 #include "fiber.h"
 #include "fio.h"
 #include "errinj.h"
+#include "numa.h"
 #include "error.h"
 #include "exception.h"
 
@@ -1295,11 +1296,14 @@ wal_writer_f(va_list ap)
 	(void) ap;
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	/* Keep the xlog buffers on the configured NUMA nodes. */
+	numa_bind_thread();
 	/** Initialize eio in this thread */
 	coio_enable();
 
 	struct cbus_endpoint endpoint;
 	cbus_endpoint_create(&endpoint, "wal", fiber_schedule_cb, fiber());
+	cbus_endpoint_enable_busy_poll(&endpoint);
 	/*
 	 * Create a pipe to TX thread. Use a high priority
 	 * endpoint, to ensure that WAL messages are delivered
@@ -834,6 +834,8 @@ xlog_free(struct xlog *xlog)
 	obuf_destroy(&xlog->zbuf);
 	ZSTD_freeCCtx(xlog->zctx);
 	xlog->zctx = NULL;
+	ZSTD_freeCDict(xlog->zcdict);
+	xlog->zcdict = NULL;
 }
 
 int
@@ -1147,7 +1149,10 @@ xlog_tx_write_zstd(struct xlog *log)
 	uint32_t crc32c = 0;
 	struct iovec *iov;
 	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	if (log->zcdict != NULL)
+		ZSTD_compressBegin_usingCDict(log->zctx, log->zcdict);
+	else
+		ZSTD_compressBegin(log->zctx, 3);
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1244,7 +1249,8 @@ xlog_tx_write(struct xlog *log)
 	ssize_t written;
 
 	if (!log->opts.no_compression &&
-	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
+	    (obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD ||
+	     log->zcdict != NULL)) {
 		written = xlog_tx_write_zstd(log);
 	} else {
 		written = xlog_tx_write_plain(log);
@@ -1378,6 +1384,21 @@ xlog_write_row(struct xlog *log, const struct xrow_header *packet)
 	return row_size;
 }
 
+int
+xlog_set_zstd_dict(struct xlog *log, const void *dict, size_t dict_size)
+{
+	assert(log->zctx != NULL);
+	assert(log->zcdict == NULL);
+	/* 3 is compression level, same as without a dictionary. */
+	log->zcdict = ZSTD_createCDict(dict, dict_size, 3);
+	if (log->zcdict == NULL) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "failed to create dictionary");
+		return -1;
+	}
+	return 0;
+}
+
 /**
  * Begin a multi-statement xlog transaction. All xrow objects
  * of a single transaction share the same header and checksum
@@ -1734,7 +1755,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zddict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1774,6 +1796,8 @@ xlog_tx_decode(const char *data, const char *data_end,
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
 	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_DCtx_refDDict(zdctx, zddict);
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1797,7 +1821,7 @@ xlog_tx_decode(const char *data, const char *data_end,
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx)
+		      ZSTD_DStream *zdctx, const ZSTD_DDict *zddict)
 {
 	const char *rpos = *data;
 	struct xlog_fixheader fixheader;
@@ -1840,6 +1864,8 @@ xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 
 	assert(fixheader.magic == zrow_marker);
 	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_DCtx_refDDict(zdctx, zddict);
 	int rc;
 	do {
 		if (ibuf_reserve(&tx_cursor->rows,
@@ -1949,7 +1975,8 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 	ssize_t to_load;
 	while ((to_load = xlog_tx_cursor_create(&i->tx_cursor,
 						(const char **)&i->rbuf.rpos,
-						i->rbuf.wpos, i->zdctx)) > 0) {
+						i->rbuf.wpos, i->zdctx,
+						i->zddict)) > 0) {
 		/* not enough data in read buffer */
 		int rc = xlog_cursor_ensure(i, ibuf_used(&i->rbuf) + to_load);
 		if (rc < 0)
@@ -2240,6 +2267,7 @@ xlog_remove_file_async(const char *filename, unsigned flags,
 	assert(grp_alloc_size(&all) == 0);
 	coio_task_create(&task->base, xlog_remove_file_cb,
 			 xlog_remove_file_done_cb);
+	coio_task_set_class(&task->base, COIO_CLASS_BULK);
 	coio_task_post(&task->base);
 	return true;
 }
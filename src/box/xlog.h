@@ -431,6 +431,11 @@ struct xlog {
 	struct obuf obuf;
 	/** The context of zstd compression */
 	ZSTD_CCtx *zctx;
+	/**
+	 * Dictionary used for zstd compression or NULL,
+	 * see xlog_set_zstd_dict().
+	 */
+	ZSTD_CDict *zcdict;
 	/**
 	 * Compressed output buffer
 	 */
@@ -548,6 +553,20 @@ xlog_fallocate(struct xlog *log, size_t size);
 ssize_t
 xlog_write_row(struct xlog *log, const struct xrow_header *packet);
 
+/**
+ * Compress transactions written to the xlog using the given
+ * zstd dictionary. Since a dictionary makes compression of
+ * small transactions worthwhile, all transactions are
+ * compressed regardless of their size after this call.
+ * Readers must pass the same dictionary to xlog_tx_decode()
+ * or xlog_cursor_set_zstd_dict().
+ *
+ * @retval  0 success
+ * @retval -1 error, check diag
+ */
+int
+xlog_set_zstd_dict(struct xlog *log, const void *dict, size_t dict_size);
+
 /**
  * Prevent xlog row buffer offloading, should be use
  * at transaction start to write transaction in one xlog tx
@@ -652,6 +671,7 @@ struct xlog_tx_cursor
 /**
  * Create xlog tx iterator from memory data.
  * *data will be adjusted to end of tx
+ * @a zddict is the dictionary the tx was compressed with or NULL.
  *
  * @retval 0 for Ok
  * @retval -1 for error
@@ -660,7 +680,7 @@ struct xlog_tx_cursor
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx);
+		      ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /**
  * Destroy xlog tx cursor and free all associated memory
@@ -717,13 +737,15 @@ xlog_tx_cursor_pos(struct xlog_tx_cursor *tx_cursor)
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdctx zstd decompression context
+ * @param zddict dictionary the tx was compressed with or NULL
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /* }}} */
 
@@ -768,6 +790,11 @@ struct xlog_cursor {
 	struct xlog_tx_cursor tx_cursor;
 	/** ZSTD context for decompression */
 	ZSTD_DStream *zdctx;
+	/**
+	 * Dictionary used for zstd decompression or NULL,
+	 * see xlog_cursor_set_zstd_dict().
+	 */
+	const ZSTD_DDict *zddict;
 };
 
 /**
@@ -827,6 +854,18 @@ int
 xlog_cursor_openmem(struct xlog_cursor *cursor, const char *data, size_t size,
 		    const char *name);
 
+/**
+ * Decompress transactions read by the cursor from now on using
+ * the given zstd dictionary, see xlog_set_zstd_dict(). The
+ * dictionary must outlive the cursor.
+ */
+static inline void
+xlog_cursor_set_zstd_dict(struct xlog_cursor *cursor,
+			  const ZSTD_DDict *zddict)
+{
+	cursor->zddict = zddict;
+}
+
 /**
  * Close cursor
  * @param cursor cursor
@@ -834,8 +834,19 @@ xrow_decode_sql(const struct xrow_header *row, struct sql_request *request)
 	request->sql_text = NULL;
 	request->bind = NULL;
 	request->stmt_id = NULL;
+	request->arrow = false;
 	for (uint32_t i = 0; i < map_size; ++i) {
 		uint8_t key = *data;
+		if (key == IPROTO_SQL_ARROW) {
+			data++;                 /* skip the key */
+			if (mp_typeof(*data) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "SQL_ARROW");
+				return -1;
+			}
+			request->arrow = mp_decode_bool(&data);
+			continue;
+		}
 		if (key != IPROTO_SQL_BIND && key != IPROTO_SQL_TEXT &&
 		    key != IPROTO_STMT_ID) {
 			mp_next(&data);         /* skip the key */
@@ -929,6 +929,8 @@ struct sql_request {
 	const char *bind;
 	/** ID of prepared statement. In this case @sql_text == NULL. */
 	const char *stmt_id;
+	/** True if the result must be returned in Arrow format. */
+	bool arrow;
 };
 
 /**
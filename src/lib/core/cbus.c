@@ -31,6 +31,8 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <pmatomic.h>
+#include "clock.h"
 #include "fiber.h"
 #include "trigger.h"
 
@@ -46,6 +48,11 @@ struct cbus {
 	pthread_cond_t cond;
 	/** Connected endpoints */
 	struct rlist endpoints;
+	/**
+	 * Time in nanoseconds the cords spin on their busy polled
+	 * endpoints before going to sleep, 0 if busy poll is off.
+	 */
+	int64_t busy_poll_timeout;
 };
 
 /** A singleton for all cords. */
@@ -53,9 +60,220 @@ static struct cbus cbus;
 
 const char *cbus_stat_strings[CBUS_STAT_LAST] = {
 	"EVENTS",
-	"LOCKS",
+	"POLL_HITS",
+	"POLL_MISSES",
+};
+
+/** Busy poll state of a cord. */
+struct cbus_busy_poll {
+	/** Endpoints of the cord with busy poll enabled. */
+	struct rlist endpoints;
+	/** The watcher to poll the endpoints before the loop sleeps. */
+	struct ev_prepare prepare;
+};
+
+static __thread struct cbus_busy_poll cbus_busy_poll;
+
+enum {
+	/** Min number of polls of the queue before the loop sleeps. */
+	CBUS_SPIN_MIN = 16,
+	/** Max number of polls of the queue before the loop sleeps. */
+	CBUS_SPIN_MAX = 4096,
 };
 
+/** The link of an entry of the endpoint queue to access atomically. */
+static inline struct stailq_entry **
+cbus_entry_next(struct stailq_entry *entry)
+{
+	return (struct stailq_entry **)(void *)&entry->next;
+}
+
+/**
+ * Append the linked entries first..last to the queue of the
+ * endpoint. May be called by many producers concurrently.
+ * Returns true if the queue was empty.
+ */
+static bool
+cbus_endpoint_link(struct cbus_endpoint *endpoint, struct stailq_entry *first,
+		   struct stailq_entry *last)
+{
+	pm_atomic_store_explicit(cbus_entry_next(last), NULL,
+				 pm_memory_order_relaxed);
+	struct stailq_entry *prev =
+		pm_atomic_exchange_explicit(&endpoint->tail, last,
+					    pm_memory_order_acq_rel);
+	/*
+	 * Until the entries are linked to the previous tail the
+	 * consumer stops at it. The producer notifies the consumer
+	 * after the push, so it will get the entries anyway.
+	 */
+	pm_atomic_store_explicit(cbus_entry_next(prev), first,
+				 pm_memory_order_release);
+	return prev == &endpoint->stub;
+}
+
+/**
+ * Move all messages of the input to the queue of the endpoint.
+ * The messages pushed by one producer keep their order.
+ */
+static bool
+cbus_endpoint_push(struct cbus_endpoint *endpoint, struct stailq *input)
+{
+	assert(!stailq_empty(input));
+	bool was_empty = cbus_endpoint_link(endpoint, stailq_first(input),
+					    stailq_last(input));
+	stailq_create(input);
+	return was_empty;
+}
+
+/**
+ * Take the first message from the queue of the endpoint. Returns
+ * NULL if there are no messages or the next one is not linked to
+ * the queue by its producer yet. Must be called by the consumer.
+ */
+static struct stailq_entry *
+cbus_endpoint_pop(struct cbus_endpoint *endpoint)
+{
+	struct stailq_entry *stub = &endpoint->stub;
+	struct stailq_entry *head = endpoint->head;
+	struct stailq_entry *next =
+		pm_atomic_load_explicit(cbus_entry_next(head),
+					pm_memory_order_acquire);
+	if (head == stub) {
+		if (next == NULL)
+			return NULL;
+		endpoint->head = head = next;
+		next = pm_atomic_load_explicit(cbus_entry_next(head),
+					       pm_memory_order_acquire);
+	}
+	if (next == NULL) {
+		struct stailq_entry *tail =
+			pm_atomic_load_explicit(&endpoint->tail,
+						pm_memory_order_acquire);
+		if (head != tail)
+			return NULL;
+		/*
+		 * The head is the last entry: queue the stub after
+		 * it to be able to take it out.
+		 */
+		cbus_endpoint_link(endpoint, stub, stub);
+		next = pm_atomic_load_explicit(cbus_entry_next(head),
+					       pm_memory_order_acquire);
+		if (next == NULL)
+			return NULL;
+	}
+	endpoint->head = next;
+	return head;
+}
+
+/** Check if the queue of the endpoint has no messages. */
+static inline bool
+cbus_endpoint_is_empty(struct cbus_endpoint *endpoint)
+{
+	return endpoint->head == &endpoint->stub &&
+	       pm_atomic_load_explicit(&endpoint->tail,
+				       pm_memory_order_acquire) ==
+	       &endpoint->stub;
+}
+
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	/*
+	 * Don't take the messages pushed after the fetch has
+	 * started so as not to starve the consumer loop.
+	 */
+	struct stailq_entry *last =
+		pm_atomic_load_explicit(&endpoint->tail,
+					pm_memory_order_acquire);
+	struct stailq_entry *entry;
+	while ((entry = cbus_endpoint_pop(endpoint)) != NULL) {
+		stailq_add_tail(output, entry);
+		if (entry == last)
+			break;
+	}
+}
+
+/** Hint the CPU that the thread is spinning in a busy-wait loop. */
+static inline void
+cbus_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ volatile("yield");
+#endif
+}
+
+/**
+ * Poll the queue of the endpoint for a while before the consumer
+ * loop goes to sleep, since waking it up costs a syscall on both
+ * sides. The loop has flushed the pipes of the cord by now, so
+ * the replies to the processed messages are not delayed. The
+ * number of polls doubles each time a message arrives while
+ * polling and halves each time it doesn't.
+ */
+static void
+cbus_endpoint_prepare_cb(ev_loop *loop, ev_prepare *watcher, int events)
+{
+	(void)events;
+	struct cbus_endpoint *endpoint = watcher->data;
+	/* The loop isn't going to sleep if there are pending events. */
+	if (ev_pending_count(loop) > 0)
+		return;
+	/* The endpoint is polled by the busy poll of the cord. */
+	if (!rlist_empty(&endpoint->in_busy_poll) &&
+	    pm_atomic_load_explicit(&cbus.busy_poll_timeout,
+				    pm_memory_order_relaxed) > 0)
+		return;
+	for (int i = 0; i < endpoint->spin; i++) {
+		if (!cbus_endpoint_is_empty(endpoint)) {
+			endpoint->spin = MIN(endpoint->spin * 2,
+					     CBUS_SPIN_MAX);
+			ev_feed_event(loop, &endpoint->async, EV_ASYNC);
+			return;
+		}
+		cbus_cpu_relax();
+	}
+	endpoint->spin = MAX(endpoint->spin / 2, CBUS_SPIN_MIN);
+}
+
+/**
+ * Poll the busy polled endpoints of the cord until a message
+ * arrives to any of them or the busy poll timeout expires. Called
+ * before the cord loop goes to sleep.
+ */
+static void
+cbus_busy_poll_cb(ev_loop *loop, ev_prepare *watcher, int events)
+{
+	(void)events;
+	struct cbus_busy_poll *poll = watcher->data;
+	if (ev_pending_count(loop) > 0)
+		return;
+	int64_t timeout = pm_atomic_load_explicit(&cbus.busy_poll_timeout,
+						  pm_memory_order_relaxed);
+	if (timeout == 0)
+		return;
+	int64_t deadline = clock_monotonic64() + timeout;
+	do {
+		bool hit = false;
+		struct cbus_endpoint *endpoint;
+		rlist_foreach_entry(endpoint, &poll->endpoints, in_busy_poll) {
+			if (cbus_endpoint_is_empty(endpoint))
+				continue;
+			ev_feed_event(loop, &endpoint->async, EV_ASYNC);
+			hit = true;
+		}
+		if (hit) {
+			rmean_collect(cbus.stats, CBUS_STAT_POLL_HITS, 1);
+			return;
+		}
+		for (int i = 0; i < CBUS_SPIN_MIN; i++)
+			cbus_cpu_relax();
+	} while ((int64_t)clock_monotonic64() < deadline);
+	rmean_collect(cbus.stats, CBUS_STAT_POLL_MISSES, 1);
+}
+
 /**
  * Find a joined cbus endpoint by name.
  * This is an internal helper method which should be called
@@ -155,11 +373,10 @@ cpipe_destroy(struct cpipe *pipe)
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
-	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	/* Flush input with the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
+	cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -184,6 +401,7 @@ cbus_create(struct cbus *bus)
 	(void) tt_pthread_cond_init(&bus->cond, NULL);
 
 	rlist_create(&bus->endpoints);
+	bus->busy_poll_timeout = 0;
 }
 
 static void
@@ -221,11 +439,17 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	endpoint->n_pipes = 0;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
-	stailq_create(&endpoint->output);
+	endpoint->stub.next.value = NULL;
+	endpoint->head = endpoint->tail = &endpoint->stub;
+	endpoint->spin = CBUS_SPIN_MIN;
+	rlist_create(&endpoint->in_busy_poll);
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
 	ev_async_start(endpoint->consumer, &endpoint->async);
+	ev_prepare_init(&endpoint->prepare, cbus_endpoint_prepare_cb);
+	endpoint->prepare.data = endpoint;
+	ev_prepare_start(endpoint->consumer, &endpoint->prepare);
 
 	rlist_add_tail(&cbus.endpoints, &endpoint->in_cbus);
 	/*
@@ -255,7 +479,7 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		if (endpoint->n_pipes == 0 && cbus_endpoint_is_empty(endpoint))
 			break;
 		 fiber_cond_wait(&endpoint->cond);
 	}
@@ -268,6 +492,13 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	tt_pthread_mutex_unlock(&endpoint->mutex);
 	tt_pthread_mutex_destroy(&endpoint->mutex);
 	ev_async_stop(endpoint->consumer, &endpoint->async);
+	ev_prepare_stop(endpoint->consumer, &endpoint->prepare);
+	if (!rlist_empty(&endpoint->in_busy_poll)) {
+		struct cbus_busy_poll *poll = &cbus_busy_poll;
+		rlist_del_entry(endpoint, in_busy_poll);
+		if (rlist_empty(&poll->endpoints))
+			ev_prepare_stop(endpoint->consumer, &poll->prepare);
+	}
 	fiber_cond_destroy(&endpoint->cond);
 	TRASH(endpoint);
 	return 0;
@@ -280,22 +511,19 @@ cpipe_flush(struct cpipe *pipe)
 		return;
 	struct cbus_endpoint *endpoint = pipe->endpoint;
 	trigger_run(&pipe->on_flush, pipe);
-	/* Trigger task processing when the queue becomes non-empty. */
-	bool output_was_empty;
-
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
 	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-
-	pipe->n_input = 0;
-	if (output_was_empty) {
+	if (cbus_endpoint_push(endpoint, &pipe->input)) {
 		/* Count statistics */
 		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
-
-		ev_async_send(endpoint->consumer, &endpoint->async);
 	}
+	pipe->n_input = 0;
+	/*
+	 * Trigger task processing even if the queue was not empty:
+	 * the consumer may have stopped at an entry that wasn't
+	 * linked to the queue yet. The call is cheap while the
+	 * consumer hasn't handled the previous notification.
+	 */
+	ev_async_send(endpoint->consumer, &endpoint->async);
 }
 
 static void
@@ -318,6 +546,43 @@ cbus_free(void)
 	cbus_destroy(&cbus);
 }
 
+void
+cbus_set_busy_poll_timeout(double timeout)
+{
+	assert(timeout >= 0);
+	pm_atomic_store_explicit(&cbus.busy_poll_timeout,
+				 (int64_t)(timeout * 1e9),
+				 pm_memory_order_relaxed);
+}
+
+void
+cbus_endpoint_enable_busy_poll(struct cbus_endpoint *endpoint)
+{
+	assert(endpoint->consumer == loop());
+	assert(rlist_empty(&endpoint->in_busy_poll));
+	struct cbus_busy_poll *poll = &cbus_busy_poll;
+	if (poll->endpoints.next == NULL)
+		rlist_create(&poll->endpoints);
+	if (rlist_empty(&poll->endpoints)) {
+		ev_prepare_init(&poll->prepare, cbus_busy_poll_cb);
+		poll->prepare.data = poll;
+		ev_prepare_start(endpoint->consumer, &poll->prepare);
+	}
+	rlist_add_tail_entry(&poll->endpoints, endpoint, in_busy_poll);
+}
+
+int
+cbus_rmean_foreach(rmean_cb cb, void *cb_ctx)
+{
+	return rmean_foreach(cbus.stats, cb, cb_ctx);
+}
+
+void
+cbus_reset_stat(void)
+{
+	rmean_cleanup(cbus.stats);
+}
+
 /* {{{ cmsg */
 
 /**
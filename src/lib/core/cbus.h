@@ -48,7 +48,8 @@ typedef void (*cmsg_f)(struct cmsg *);
 
 enum cbus_stat_name {
 	CBUS_STAT_EVENTS,
-	CBUS_STAT_LOCKS,
+	CBUS_STAT_POLL_HITS,
+	CBUS_STAT_POLL_MISSES,
 	CBUS_STAT_LAST,
 };
 
@@ -118,7 +119,7 @@ struct cpipe {
 	/**
 	 * When pushing messages, keep the staged input size under
 	 * this limit (speeds up message delivery and reduces
-	 * latency, while still keeping the bus mutex cold enough).
+	 * latency, while still keeping the wakeups of the consumer rare).
 	 */
 	int max_input;
 	/**
@@ -170,7 +171,7 @@ cpipe_destroy(struct cpipe *pipe);
  * Otherwise, the messages flushed once per event loop iteration.
  *
  * @todo: collect bus stats per second and adjust max_input once
- * a second to keep the mutex cold regardless of the message load,
+ * a second to keep the wakeups rare regardless of the message load,
  * while still keeping the latency low if there are few
  * long-to-process messages.
  */
@@ -241,14 +242,37 @@ struct cbus_endpoint {
 	char name[FIBER_NAME_MAX];
 	/** Member of cbus->endpoints */
 	struct rlist in_cbus;
-	/** The lock around the pipe. */
+	/**
+	 * The lock to let a pipe being destroyed finish its flush
+	 * before the endpoint is gone.
+	 */
 	pthread_mutex_t mutex;
-	/** A queue with incoming messages. */
-	struct stailq output;
+	/**
+	 * A queue with incoming messages: an intrusive lock-free
+	 * multi-producer single-consumer queue linked through
+	 * cmsg::fifo. Producers append a batch of messages with an
+	 * atomic exchange of the tail, the consumer takes messages
+	 * from the head. The queue always holds at least one entry,
+	 * the stub one if there are no messages.
+	 */
+	struct stailq_entry *tail;
+	/** The head of the queue, only accessed by the consumer. */
+	struct stailq_entry *head;
+	/** The entry the empty queue consists of. */
+	struct stailq_entry stub;
+	/**
+	 * How many times the consumer polls the queue before its
+	 * loop goes to sleep, adapts to the message flow.
+	 */
+	int spin;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
 	ev_async async;
+	/** The watcher to poll the queue before the loop sleeps. */
+	ev_prepare prepare;
+	/** Member of the list of busy polled endpoints of the cord. */
+	struct rlist in_busy_poll;
 	/** Count of connected pipes */
 	uint32_t n_pipes;
 	/** Condition for endpoint destroy */
@@ -256,15 +280,11 @@ struct cbus_endpoint {
 };
 
 /**
- * Fetch incomming messages to output
+ * Fetch incomming messages to output. Must be called by the
+ * consumer.
  */
-static inline void
-cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
-{
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-}
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output);
 
 /** Initialize the global singleton bus. */
 void
@@ -274,6 +294,31 @@ cbus_init(void);
 void
 cbus_free(void);
 
+/**
+ * Set the time in seconds the cords with busy poll enabled spin
+ * on their endpoints before their loops go to sleep. Zero turns
+ * busy poll off.
+ */
+void
+cbus_set_busy_poll_timeout(double timeout);
+
+/**
+ * Enable busy poll of the endpoint: each time before the consumer
+ * loop goes to sleep, it polls all such endpoints of the cord until
+ * a message arrives or the busy poll timeout expires. Must be
+ * called by the consumer.
+ */
+void
+cbus_endpoint_enable_busy_poll(struct cbus_endpoint *endpoint);
+
+/** Iterate over the cbus statistics. */
+int
+cbus_rmean_foreach(rmean_cb cb, void *cb_ctx);
+
+/** Reset the cbus statistics. */
+void
+cbus_reset_stat(void);
+
 /**
  * Connect the cord to cbus as a named reciever.
  * @param name a destination name
@@ -47,6 +47,8 @@ struct coio_file_task {
 	int errorno;
 	struct fiber *fiber;
 	bool done;
+	/** Priority class of the request. */
+	enum coio_class io_class;
 
 	union {
 		struct {
@@ -110,6 +112,10 @@ struct coio_file_task {
 	struct coio_file_task name;		\
 	memset(&name, 0, sizeof(name));		\
 	name.fiber = fiber();			\
+	name.io_class = COIO_CLASS_INTERACTIVE;	\
+
+/** libeio priority of a request with the given context. */
+#define COIO_PRI(eio) coio_class_pri((eio).io_class)
 
 /** A callback invoked by eio when a task is complete. */
 static int
@@ -137,8 +143,10 @@ coio_wait_done(eio_req *req, struct coio_file_task *eio)
 		return -1;
 	}
 
+	double start = coio_stat_begin(eio->io_class);
 	while (!eio->done)
 		fiber_yield();
+	coio_stat_end(eio->io_class, start);
 
 	errno = eio->errorno;
 	return eio->result;
@@ -148,7 +156,7 @@ int
 coio_file_open(const char *path, int flags, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_open(path, flags, mode, 0,
+	eio_req *req = eio_open(path, flags, mode, COIO_PRI(eio),
 				coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -157,7 +165,7 @@ int
 coio_file_close(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_close(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_close(fd, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -176,7 +184,7 @@ coio_pwrite(int fd, const void *buf, size_t count, off_t offset)
 		});
 
 		req = eio_write(fd, (char *)buf + pos, chunk,
-				offset + pos, EIO_PRI_DEFAULT,
+				offset + pos, COIO_PRI(eio),
 				coio_complete, &eio);
 		res = coio_wait_done(req, &eio);
 		if (res < 0) {
@@ -195,7 +203,7 @@ coio_pread(int fd, void *buf, size_t count, off_t offset)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req = eio_read(fd, buf, count,
-				offset, 0, coio_complete, &eio);
+				offset, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -243,7 +251,7 @@ coio_write(int fd, const void *buf, size_t count)
 		eio.write.count	= left;
 		eio.write.fd	= fd;
 
-		req = eio_custom(coio_do_write, EIO_PRI_DEFAULT,
+		req = eio_custom(coio_do_write, COIO_PRI(eio),
 				 coio_complete, &eio);
 		res = coio_wait_done(req, &eio);
 		if (res < 0) {
@@ -272,7 +280,7 @@ coio_read(int fd, void *buf, size_t count)
 	eio.read.buf = buf;
 	eio.read.count = count;
 	eio.read.fd = fd;
-	eio_req *req = eio_custom(coio_do_read, 0,
+	eio_req *req = eio_custom(coio_do_read, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -296,7 +304,7 @@ coio_lseek(int fd, off_t offset, int whence)
 	eio.lseek.offset = offset;
 	eio.lseek.fd = fd;
 
-	eio_req *req = eio_custom(coio_do_lseek, 0,
+	eio_req *req = eio_custom(coio_do_lseek, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -315,7 +323,7 @@ coio_lstat(const char *pathname, struct stat *buf)
 	INIT_COEIO_FILE(eio);
 	eio.lstat.pathname = pathname;
 	eio.lstat.buf = buf;
-	eio_req *req = eio_custom(coio_do_lstat, 0,
+	eio_req *req = eio_custom(coio_do_lstat, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -334,7 +342,7 @@ coio_stat(const char *pathname, struct stat *buf)
 	INIT_COEIO_FILE(eio);
 	eio.lstat.pathname = pathname;
 	eio.lstat.buf = buf;
-	eio_req *req = eio_custom(coio_do_stat, 0,
+	eio_req *req = eio_custom(coio_do_stat, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -354,7 +362,7 @@ coio_fstat(int fd, struct stat *stat)
 	eio.fstat.fd = fd;
 	eio.fstat.buf = stat;
 
-	eio_req *req = eio_custom(coio_do_fstat, 0,
+	eio_req *req = eio_custom(coio_do_fstat, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -363,7 +371,7 @@ int
 coio_rename(const char *oldpath, const char *newpath)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_rename(oldpath, newpath, 0,
+	eio_req *req = eio_rename(oldpath, newpath, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 
@@ -373,7 +381,7 @@ int
 coio_unlink(const char *pathname)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_unlink(pathname, 0, coio_complete, &eio);
+	eio_req *req = eio_unlink(pathname, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -381,7 +389,8 @@ int
 coio_ftruncate(int fd, off_t length)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_ftruncate(fd, length, 0, coio_complete, &eio);
+	eio_req *req = eio_ftruncate(fd, length, COIO_PRI(eio),
+				     coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -389,7 +398,8 @@ int
 coio_truncate(const char *path, off_t length)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_truncate(path, length, 0, coio_complete, &eio);
+	eio_req *req = eio_truncate(path, length, COIO_PRI(eio),
+				    coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -413,7 +423,7 @@ coio_glob(const char *pattern, int flags,
 	eio.glob.errfunc = errfunc;
 	eio.glob.pglob = pglob;
 	eio_req *req =
-		eio_custom(coio_do_glob, 0, coio_complete, &eio);
+		eio_custom(coio_do_glob, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -422,7 +432,8 @@ coio_chown(const char *path, uid_t owner, gid_t group)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req =
-		eio_chown(path, owner, group, 0, coio_complete, &eio);
+		eio_chown(path, owner, group, COIO_PRI(eio),
+			  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -430,7 +441,8 @@ int
 coio_chmod(const char *path, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_chmod(path, mode, 0, coio_complete, &eio);
+	eio_req *req = eio_chmod(path, mode, COIO_PRI(eio),
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -438,7 +450,8 @@ int
 coio_mkdir(const char *pathname, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_mkdir(pathname, mode, 0, coio_complete, &eio);
+	eio_req *req = eio_mkdir(pathname, mode, COIO_PRI(eio),
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -446,7 +459,7 @@ int
 coio_rmdir(const char *pathname)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_rmdir(pathname, 0, coio_complete, &eio);
+	eio_req *req = eio_rmdir(pathname, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -454,7 +467,8 @@ int
 coio_link(const char *oldpath, const char *newpath)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_link(oldpath, newpath, 0, coio_complete, &eio);
+	eio_req *req = eio_link(oldpath, newpath, COIO_PRI(eio),
+				coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -463,7 +477,8 @@ coio_symlink(const char *target, const char *linkpath)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req =
-		eio_symlink(target, linkpath, 0, coio_complete, &eio);
+		eio_symlink(target, linkpath, COIO_PRI(eio),
+			    coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -483,7 +498,7 @@ coio_readlink(const char *pathname, char *buf, size_t bufsize)
 	eio.readlink.pathname = pathname;
 	eio.readlink.buf = buf;
 	eio.readlink.bufsize = bufsize;
-	eio_req *req = eio_custom(coio_do_readlink, 0,
+	eio_req *req = eio_custom(coio_do_readlink, COIO_PRI(eio),
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -520,7 +535,7 @@ coio_tempdir(char *path, size_t path_size)
 	}
 	eio.tempdir.tpl = path;
 	eio_req *req =
-		eio_custom(coio_do_tempdir, 0, coio_complete, &eio);
+		eio_custom(coio_do_tempdir, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -528,7 +543,8 @@ int
 coio_sync(void)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_sync(0, coio_complete, &eio);
+	eio.io_class = COIO_CLASS_BULK;
+	eio_req *req = eio_sync(COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -536,7 +552,7 @@ int
 coio_fsync(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_fsync(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_fsync(fd, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -544,7 +560,7 @@ int
 coio_fdatasync(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_fdatasync(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_fdatasync(fd, COIO_PRI(eio), coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -609,7 +625,8 @@ coio_readdir(const char *dir_path, char **buf)
 	INIT_COEIO_FILE(eio)
 	eio.readdir.bufp = buf;
 	eio.readdir.pathname = dir_path;
-	eio_req *req = eio_custom(coio_do_readdir, 0, coio_complete, &eio);
+	eio_req *req = eio_custom(coio_do_readdir, COIO_PRI(eio),
+				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -673,7 +690,9 @@ coio_copyfile(const char *source, const char *dest)
 	INIT_COEIO_FILE(eio)
 	eio.copyfile.source = source;
 	eio.copyfile.dest = dest;
-	eio_req *req = eio_custom(coio_do_copyfile, 0, coio_complete, &eio);
+	eio.io_class = COIO_CLASS_BULK;
+	eio_req *req = eio_custom(coio_do_copyfile, COIO_PRI(eio),
+				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -681,6 +700,7 @@ int
 coio_utime(const char *pathname, double atime, double mtime)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_utime(pathname, atime, mtime, 0, coio_complete, &eio);
+	eio_req *req = eio_utime(pathname, atime, mtime, COIO_PRI(eio),
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -38,7 +38,12 @@
 #include <netdb.h>
 #include <sys/socket.h>
 
+#include <pmatomic.h>
+
+#include "clock.h"
 #include "fiber.h"
+#include "latency.h"
+#include "say.h"
 #include <tarantool_ev.h>
 
 /*
@@ -70,10 +75,131 @@ struct coio_manager {
 	ev_loop *loop;
 	ev_idle coio_idle;
 	ev_async coio_async;
+	/** Bulk tasks waiting for a worker thread to be submitted. */
+	struct rlist bulk_queue;
+	/** Number of submitted bulk tasks that haven't completed. */
+	int bulk_in_progress;
 };
 
 static __thread struct coio_manager coio_manager;
 
+const char *coio_class_strs[] = {
+	/* [COIO_CLASS_INTERACTIVE] = */ "interactive",
+	/* [COIO_CLASS_DEFAULT]     = */ "default",
+	/* [COIO_CLASS_BULK]        = */ "bulk",
+};
+
+static_assert(lengthof(coio_class_strs) == coio_class_MAX,
+	      "coio_class_strs must be updated");
+
+/**
+ * Max number of bulk tasks of one thread run by the worker threads
+ * at the same time. Half of the worker threads, so that there are
+ * always threads left for tasks of other classes.
+ */
+static int coio_bulk_max = 2;
+
+/**
+ * Statistics of coio tasks by class. Only tasks of the main thread
+ * are accounted.
+ */
+static struct {
+	/** Number of tasks waiting for a worker thread or running. */
+	int64_t queue;
+	/** Number of completed tasks. */
+	int64_t count;
+	/** Time from submission to completion of tasks. */
+	struct latency latency;
+} coio_stats[coio_class_MAX];
+
+double
+coio_stat_begin(enum coio_class io_class)
+{
+	if (cord_is_main())
+		coio_stats[io_class].queue++;
+	return clock_monotonic();
+}
+
+void
+coio_stat_end(enum coio_class io_class, double start)
+{
+	if (!cord_is_main())
+		return;
+	assert(coio_stats[io_class].queue > 0);
+	coio_stats[io_class].queue--;
+	coio_stats[io_class].count++;
+	latency_collect(&coio_stats[io_class].latency,
+			clock_monotonic() - start);
+}
+
+void
+coio_stat(enum coio_class io_class, struct coio_stat *stat)
+{
+	stat->queue = coio_stats[io_class].queue;
+	stat->count = coio_stats[io_class].count;
+	stat->latency_p50 = latency_get(&coio_stats[io_class].latency, 50);
+	stat->latency_p90 = latency_get(&coio_stats[io_class].latency, 90);
+	stat->latency_p99 = latency_get(&coio_stats[io_class].latency, 99);
+}
+
+void
+coio_reset_stat(void)
+{
+	for (int i = 0; i < coio_class_MAX; i++) {
+		coio_stats[i].count = 0;
+		latency_reset(&coio_stats[i].latency);
+	}
+}
+
+void
+coio_set_worker_count(int count)
+{
+	eio_set_min_parallel(count);
+	eio_set_max_parallel(count);
+	pm_atomic_store_explicit(&coio_bulk_max, MAX(count / 2, 1),
+				 pm_memory_order_relaxed);
+}
+
+/**
+ * Submit a task to the worker threads. A bulk task waits in the
+ * queue if there are too many bulk tasks in progress already.
+ */
+static void
+coio_task_submit(struct coio_task *task)
+{
+	task->submit_time = coio_stat_begin(task->io_class);
+	if (task->io_class == COIO_CLASS_BULK) {
+		int bulk_max = pm_atomic_load_explicit(&coio_bulk_max,
+						       pm_memory_order_relaxed);
+		if (coio_manager.bulk_in_progress >= bulk_max) {
+			rlist_add_tail_entry(&coio_manager.bulk_queue, task,
+					     in_queue);
+			return;
+		}
+		coio_manager.bulk_in_progress++;
+	}
+	eio_submit(&task->base);
+}
+
+/**
+ * Account completion of a task and submit the next bulk task if
+ * the completed one was bulk.
+ */
+static void
+coio_task_complete(struct coio_task *task)
+{
+	coio_stat_end(task->io_class, task->submit_time);
+	if (task->io_class != COIO_CLASS_BULK)
+		return;
+	coio_manager.bulk_in_progress--;
+	if (rlist_empty(&coio_manager.bulk_queue))
+		return;
+	struct coio_task *next = rlist_shift_entry(&coio_manager.bulk_queue,
+						   struct coio_task, in_queue);
+	coio_manager.bulk_in_progress++;
+	eio_submit(&next->base);
+}
+
 static void
 coio_idle_cb(ev_loop *loop, struct ev_idle *w, int events)
 {
@@ -131,6 +257,10 @@ coio_init(void)
 {
 	eio_set_thread_on_start(coio_on_start, NULL);
 	eio_set_thread_on_stop(coio_on_stop, NULL);
+	for (int i = 0; i < coio_class_MAX; i++) {
+		if (latency_create(&coio_stats[i].latency) != 0)
+			panic("failed to initialize coio statistics");
+	}
 }
 
 /**
@@ -143,6 +273,8 @@ coio_enable(void)
 {
 	eio_init(&coio_manager, coio_want_poll_cb, coio_done_poll_cb);
 	coio_manager.loop = loop();
+	rlist_create(&coio_manager.bulk_queue);
+	coio_manager.bulk_in_progress = 0;
 
 	ev_idle_init(&coio_manager.coio_idle, coio_idle_cb);
 	ev_async_init(&coio_manager.coio_async, coio_async_cb);
@@ -174,6 +306,7 @@ static int
 coio_on_finish(eio_req *req)
 {
 	struct coio_task *task = (struct coio_task *) req;
+	coio_task_complete(task);
 	if (task->fiber == NULL) {
 		/*
 		 * Timed out. Resources will be freed by coio_on_destroy.
@@ -213,13 +346,13 @@ coio_task_create(struct coio_task *task,
 	task->base.feed = coio_on_feed;
 	task->base.finish = coio_on_finish;
 	task->base.destroy = coio_on_destroy;
-	/* task->base.pri = 0; */
 
 	task->fiber = fiber();
 	task->task_cb = func;
 	task->timeout_cb = on_timeout;
 	task->complete = 0;
 	diag_create(&task->diag);
+	coio_task_set_class(task, COIO_CLASS_DEFAULT);
 }
 
 void
@@ -233,7 +366,7 @@ coio_task_post(struct coio_task *task)
 {
 	assert(task->base.type == EIO_CUSTOM);
 	assert(task->fiber == fiber());
-	eio_submit(&task->base);
+	coio_task_submit(task);
 	task->fiber = NULL;
 }
 
@@ -243,7 +376,7 @@ coio_task_execute(struct coio_task *task, double timeout)
 	assert(task->base.type == EIO_CUSTOM);
 	assert(task->fiber == fiber());
 
-	eio_submit(&task->base);
+	coio_task_submit(task);
 	fiber_yield_timeout(timeout);
 	if (!task->complete) {
 		/* timed out or cancelled. */
@@ -266,8 +399,10 @@ coio_on_call(eio_req *req)
 		diag_move(diag_get(), &task->diag);
 }
 
-ssize_t
-coio_call(ssize_t (*func)(va_list ap), ...)
+/** Run a function as a task of the given class and wait for it. */
+static ssize_t
+coio_vcall(enum coio_class io_class, ssize_t (*func)(va_list ap),
+	   va_list ap)
 {
 	struct coio_task *task = (struct coio_task *) calloc(1, sizeof(*task));
 	if (task == NULL)
@@ -277,15 +412,15 @@ coio_call(ssize_t (*func)(va_list ap), ...)
 	task->base.feed = coio_on_call;
 	task->base.finish = coio_on_finish;
 	/* task->base.destroy = NULL; */
-	/* task->base.pri = 0; */
 
 	task->fiber = fiber();
 	task->call_cb = func;
 	task->complete = 0;
 	diag_create(&task->diag);
+	coio_task_set_class(task, io_class);
 
-	va_start(task->ap, func);
-	eio_submit(&task->base);
+	va_copy(task->ap, ap);
+	coio_task_submit(task);
 
 	do {
 		fiber_yield();
@@ -301,6 +436,26 @@ coio_call(ssize_t (*func)(va_list ap), ...)
 	return result;
 }
 
+ssize_t
+coio_call(ssize_t (*func)(va_list ap), ...)
+{
+	va_list ap;
+	va_start(ap, func);
+	ssize_t result = coio_vcall(COIO_CLASS_DEFAULT, func, ap);
+	va_end(ap);
+	return result;
+}
+
+ssize_t
+coio_call_ex(enum coio_class io_class, ssize_t (*func)(va_list ap), ...)
+{
+	va_list ap;
+	va_start(ap, func);
+	ssize_t result = coio_vcall(io_class, func, ap);
+	va_end(ap);
+	return result;
+}
+
 struct async_getaddrinfo_task {
 	struct coio_task base;
 	struct addrinfo *result;
@@ -372,6 +527,7 @@ coio_getaddrinfo(const char *host, const char *port,
 	}
 
 	coio_task_create(&task->base, getaddrinfo_cb, getaddrinfo_free_cb);
+	coio_task_set_class(&task->base, COIO_CLASS_INTERACTIVE);
 
 	/*
 	 * getaddrinfo() on osx upto osx 10.8 crashes when AI_NUMERICSERV is
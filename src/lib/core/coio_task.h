@@ -35,9 +35,11 @@
 
 #include <sys/types.h> /* ssize_t */
 #include <stdarg.h>
+#include <stdint.h>
 
 #include <tarantool_eio.h>
 #include "diag.h"
+#include "small/rlist.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -53,6 +55,74 @@ void coio_init(void);
 void coio_enable(void);
 void coio_shutdown(void);
 
+/**
+ * Priority classes of coio tasks. Worker threads take tasks of a
+ * higher class first, and bulk tasks may occupy at most half of
+ * the worker threads, so short calls a fiber waits for are not
+ * stuck behind long background operations.
+ */
+enum coio_class {
+	/** Short calls a fiber waits for: fio, getaddrinfo. */
+	COIO_CLASS_INTERACTIVE,
+	/** Tasks of unknown duration. */
+	COIO_CLASS_DEFAULT,
+	/** Long background operations: removal of old files, copying. */
+	COIO_CLASS_BULK,
+	coio_class_MAX,
+};
+
+extern const char *coio_class_strs[];
+
+/** libeio request priority of tasks of the given class. */
+static inline int
+coio_class_pri(enum coio_class io_class)
+{
+	switch (io_class) {
+	case COIO_CLASS_INTERACTIVE:
+		return EIO_PRI_MAX;
+	case COIO_CLASS_BULK:
+		return EIO_PRI_MIN;
+	default:
+		return EIO_PRI_DEFAULT;
+	}
+}
+
+/** Statistics of coio tasks of one class in the current thread. */
+struct coio_stat {
+	/** Number of tasks waiting for a worker thread or running. */
+	int64_t queue;
+	/** Number of completed tasks. */
+	int64_t count;
+	/** 50th, 90th and 99th percentiles of task latency. */
+	double latency_p50;
+	double latency_p90;
+	double latency_p99;
+};
+
+/** Get statistics of coio tasks of the given class. */
+void
+coio_stat(enum coio_class io_class, struct coio_stat *stat);
+
+/** Reset coio task statistics except for queue sizes. */
+void
+coio_reset_stat(void);
+
+/**
+ * Account a request of the given class submitted to the worker
+ * threads directly with libeio. Returns the submission time that
+ * should be passed to coio_stat_end() on completion.
+ */
+double
+coio_stat_begin(enum coio_class io_class);
+
+/** Account completion of a request started with coio_stat_begin(). */
+void
+coio_stat_end(enum coio_class io_class, double start);
+
+/** Set the number of worker threads. */
+void
+coio_set_worker_count(int count);
+
 struct coio_task;
 
 typedef ssize_t (*coio_call_cb)(va_list ap);
@@ -84,6 +154,12 @@ struct coio_task {
 	int complete;
 	/** Task diag **/
 	struct diag diag;
+	/** Priority class of the task. */
+	enum coio_class io_class;
+	/** Time when the task was submitted. */
+	double submit_time;
+	/** Link in the queue of bulk tasks waiting to be submitted. */
+	struct rlist in_queue;
 };
 
 /**
@@ -105,6 +181,14 @@ coio_task_create(struct coio_task *task, coio_task_cb func,
 void
 coio_task_destroy(struct coio_task *task);
 
+/** Set the priority class of a coio task, COIO_CLASS_DEFAULT if unset. */
+static inline void
+coio_task_set_class(struct coio_task *task, enum coio_class io_class)
+{
+	task->io_class = io_class;
+	task->base.pri = coio_class_pri(io_class);
+}
+
 /**
  * Execute a coio task in a worker thread.
  *
@@ -179,6 +263,10 @@ coio_getaddrinfo(const char *host, const char *port,
 		 double timeout);
 /** \endcond public */
 
+/** Same as coio_call(), but runs the function as a task of a class. */
+ssize_t
+coio_call_ex(enum coio_class io_class, ssize_t (*func)(va_list), ...);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -342,6 +342,8 @@ enum {
 	FIBER_STACK_SIZE_MINIMAL = 16384,
 	/* Stack size watermark in bytes. */
 	FIBER_STACK_SIZE_WATERMARK = 65536,
+	/* Max total size of stacks in a cord stack pool in bytes. */
+	FIBER_STACK_POOL_SIZE_MAX = 64 * 1024 * 1024,
 };
 
 /** Default fiber attributes */
@@ -1426,11 +1428,86 @@ fiber_stack_watermark_create(struct fiber *fiber,
 }
 #endif /* HAVE_MADV_DONTNEED */
 
+/**
+ * Size class of a fiber stack pool for stacks of the given size or
+ * -1 if stacks of this size are not pooled.
+ */
+static int
+fiber_stack_class(size_t stack_size)
+{
+	size_t class_size = FIBER_STACK_SIZE_MINIMAL;
+	for (int i = 0; i < FIBER_STACK_POOL_CLASS_COUNT; i++) {
+		if (stack_size <= class_size)
+			return i;
+		class_size <<= 1;
+	}
+	return -1;
+}
+
+/** Size of stacks of the given fiber stack pool class. */
+static inline size_t
+fiber_stack_class_size(int stack_class)
+{
+	assert(stack_class >= 0 &&
+	       stack_class < FIBER_STACK_POOL_CLASS_COUNT);
+	return (size_t)FIBER_STACK_SIZE_MINIMAL << stack_class;
+}
+
+/**
+ * Address of the guard page of a stack in the given slab. The stack
+ * size is the size of the slab minus the slab header.
+ */
+static void *
+fiber_stack_guard(struct slab *slab, size_t stack_size)
+{
+	if (stack_direction < 0)
+		return page_align_up(slab_data(slab));
+	return page_align_down(slab + stack_size) - page_size;
+}
+
+/** Make the guard page of a stack accessible and free the stack slab. */
 static void
-fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
+fiber_stack_free(struct slab_cache *slabc, struct slab *slab, void *guard,
+		 size_t stack_size)
 {
 	static const int mprotect_flags = PROT_READ | PROT_WRITE;
 
+	if (fiber_mprotect(guard, page_size, mprotect_flags) != 0) {
+		/*
+		 * FIXME: We need some intelligent handling:
+		 * say put this slab into a queue and retry
+		 * to setup the original protection back in
+		 * background.
+		 *
+		 * For now lets keep such slab referenced and
+		 * leaked: if mprotect failed we must not allow
+		 * to reuse such slab with PROT_NONE'ed page
+		 * inside.
+		 *
+		 * Note that in case if we're called from
+		 * fiber_stack_create() the @a mprotect_flags is
+		 * the same as the slab been created with, so
+		 * calling mprotect for VMA with same flags
+		 * won't fail.
+		 */
+		say_syserror("fiber: Can't put guard page to slab. "
+			     "Leak %zu bytes", stack_size);
+		/*
+		 * Suppress memory leak report for this object.
+		 *
+		 * Works even though it is not a beginning of
+		 * allocation (there is ASAN slab cache allocation
+		 * header).
+		 */
+		LSAN_IGNORE_OBJECT(slab);
+	} else {
+		slab_put(slabc, slab);
+	}
+}
+
+static void
+fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
+{
 	if (fiber->stack != NULL) {
 		VALGRIND_STACK_DEREGISTER(fiber->stack_id);
 		void *guard;
@@ -1438,54 +1515,73 @@ fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
 			guard = page_align_down(fiber->stack - page_size);
 		else
 			guard = page_align_up(fiber->stack + fiber->stack_size);
-
-		if (fiber_mprotect(guard, page_size, mprotect_flags) != 0) {
-			/*
-			 * FIXME: We need some intelligent handling:
-			 * say put this slab into a queue and retry
-			 * to setup the original protection back in
-			 * background.
-			 *
-			 * For now lets keep such slab referenced and
-			 * leaked: if mprotect failed we must not allow
-			 * to reuse such slab with PROT_NONE'ed page
-			 * inside.
-			 *
-			 * Note that in case if we're called from
-			 * fiber_stack_create() the @a mprotect_flags is
-			 * the same as the slab been created with, so
-			 * calling mprotect for VMA with same flags
-			 * won't fail.
-			 */
-			say_syserror("fiber: Can't put guard page to slab. "
-				     "Leak %zu bytes", (size_t)fiber->stack_size);
-			/*
-			 * Suppress memory leak report for this object.
-			 *
-			 * Works even though it is not a beginning of
-			 * allocation (there is ASAN slab cache allocation
-			 * header).
-			 */
-			LSAN_IGNORE_OBJECT(fiber->stack_slab);
-		} else {
-			slab_put(slabc, fiber->stack_slab);
-		}
+		fiber_stack_free(slabc, fiber->stack_slab, guard,
+				 fiber->stack_size);
 	}
 }
 
-static int
-fiber_stack_create(struct fiber *fiber, const struct fiber_attr *fiber_attr,
-		   struct slab_cache *slabc)
+/**
+ * Put the stack of a fiber that is being deleted to the stack pool
+ * of the cord. Returns false if the stack can't be pooled and must
+ * be destroyed.
+ */
+static bool
+fiber_stack_pool_put(struct cord *cord, struct fiber *fiber)
+{
+	if (fiber->stack == NULL)
+		return false;
+	char *end = (char *)fiber->stack + fiber->stack_size;
+	if (stack_direction > 0)
+		end += page_size;
+	size_t size = end - (char *)fiber->stack_slab;
+	int stack_class = fiber_stack_class(size);
+	/* Stacks of a non-class size are too large to be pooled. */
+	if (stack_class < 0 || fiber_stack_class_size(stack_class) != size)
+		return false;
+	struct fiber_stack_pool *pool = &cord->stack_pool;
+	if (pool->count[stack_class] == FIBER_STACK_POOL_CLASS_CAPACITY ||
+	    pool->stat.size + size > FIBER_STACK_POOL_SIZE_MAX)
+		return false;
+	VALGRIND_STACK_DEREGISTER(fiber->stack_id);
+	pool->slabs[stack_class][pool->count[stack_class]++] =
+		fiber->stack_slab;
+	pool->stat.count++;
+	pool->stat.size += size;
+	return true;
+}
+
+void
+fiber_stack_pool_stat(struct fiber_stack_pool_stat *stat)
 {
-	size_t stack_size = fiber_attr->stack_size - slab_sizeof();
-	fiber->stack_slab = slab_get(slabc, stack_size);
+	*stat = cord()->stack_pool.stat;
+}
 
-	if (fiber->stack_slab == NULL) {
-		diag_set(OutOfMemory, stack_size,
-			 "runtime arena", "fiber stack");
-		return -1;
+void
+cord_flush_stack_pool(struct cord *cord)
+{
+	struct fiber_stack_pool *pool = &cord->stack_pool;
+	for (int i = 0; i < FIBER_STACK_POOL_CLASS_COUNT; i++) {
+		size_t stack_size = fiber_stack_class_size(i) - slab_sizeof();
+		while (pool->count[i] > 0) {
+			struct slab *slab = pool->slabs[i][--pool->count[i]];
+			fiber_stack_free(&cord->slabc, slab,
+					 fiber_stack_guard(slab, stack_size),
+					 stack_size);
+		}
 	}
-	void *guard;
+	pool->stat.count = 0;
+	pool->stat.size = 0;
+}
+
+/**
+ * Set the stack of a fiber to the given slab, the stack size is the
+ * size of the slab minus the slab header.
+ */
+static void
+fiber_stack_setup(struct fiber *fiber, struct slab *slab, size_t stack_size)
+{
+	fiber->stack_slab = slab;
+	void *guard = fiber_stack_guard(slab, stack_size);
 	/* Adjust begin and size for stack memory chunk. */
 	if (stack_direction < 0) {
 		/*
@@ -1494,9 +1590,8 @@ fiber_stack_create(struct fiber *fiber, const struct fiber_attr *fiber_attr,
 		 * after protected page until end of memory chunk can be
 		 * used for coro stack usage.
 		 */
-		guard = page_align_up(slab_data(fiber->stack_slab));
 		fiber->stack = guard + page_size;
-		fiber->stack_size = slab_data(fiber->stack_slab) + stack_size -
+		fiber->stack_size = slab_data(slab) + stack_size -
 				    fiber->stack;
 	} else {
 		/*
@@ -1504,17 +1599,53 @@ fiber_stack_create(struct fiber *fiber, const struct fiber_attr *fiber_attr,
 		 * memory from begin of chunk until protected page can
 		 * be used for coro stack usage
 		 */
-		guard = page_align_down(fiber->stack_slab + stack_size) -
-			page_size;
-		fiber->stack = fiber->stack_slab + slab_sizeof();
+		fiber->stack = slab + slab_sizeof();
 		fiber->stack_size = guard - fiber->stack;
 	}
 
 	fiber->stack_id = VALGRIND_STACK_REGISTER(fiber->stack,
 						  (char *)fiber->stack +
 						  fiber->stack_size);
+}
+
+static int
+fiber_stack_create(struct fiber *fiber, const struct fiber_attr *fiber_attr,
+		   struct slab_cache *slabc)
+{
+	struct fiber_stack_pool *pool = &cord()->stack_pool;
+	size_t stack_size = fiber_attr->stack_size;
+	int stack_class = fiber_stack_class(stack_size);
+	if (stack_class >= 0) {
+		/*
+		 * The slab cache rounds the size up to a power of
+		 * two anyway, so let the stack use the whole slab.
+		 */
+		stack_size = fiber_stack_class_size(stack_class);
+		if (pool->count[stack_class] > 0) {
+			int i = --pool->count[stack_class];
+			struct slab *slab = pool->slabs[stack_class][i];
+			pool->stat.count--;
+			pool->stat.size -= stack_size;
+			pool->stat.hits++;
+			fiber_stack_setup(fiber, slab,
+					  stack_size - slab_sizeof());
+			fiber_stack_watermark_create(fiber, fiber_attr);
+			return 0;
+		}
+		pool->stat.misses++;
+	}
+	stack_size -= slab_sizeof();
+	struct slab *slab = slab_get(slabc, stack_size);
+
+	if (slab == NULL) {
+		diag_set(OutOfMemory, stack_size,
+			 "runtime arena", "fiber stack");
+		return -1;
+	}
+	fiber_stack_setup(fiber, slab, stack_size);
 
-	if (fiber_mprotect(guard, page_size, PROT_NONE)) {
+	if (fiber_mprotect(fiber_stack_guard(slab, stack_size), page_size,
+			   PROT_NONE)) {
 		/*
 		 * Write an error into the log since a guard
 		 * page is critical for functionality.
@@ -1664,7 +1795,8 @@ fiber_destroy(struct cord *cord, struct fiber *f)
 	region_set_callbacks(&f->gc, NULL, NULL, NULL);
 #endif
 	region_destroy(&f->gc);
-	fiber_stack_destroy(f, &cord->slabc);
+	if (!fiber_stack_pool_put(cord, f))
+		fiber_stack_destroy(f, &cord->slabc);
 	diag_destroy(&f->diag);
 	if (f->name != f->inline_name)
 		free(f->name);
@@ -1697,6 +1829,7 @@ fiber_delete_all(struct cord *cord)
 	cord_delete_fibers_in_list(cord, &cord->alive);
 	cord_delete_fibers_in_list(cord, &cord->dead);
 	cord_delete_fibers_in_list(cord, &cord->ready);
+	cord_flush_stack_pool(cord);
 }
 
 static void
@@ -1853,6 +1986,7 @@ cord_create(struct cord *cord, const char *name)
 	slab_cache_create(&cord->slabc, &runtime);
 	mempool_create(&cord->fiber_mempool, &cord->slabc,
 		       sizeof(struct fiber));
+	memset(&cord->stack_pool, 0, sizeof(cord->stack_pool));
 	rlist_create(&cord->alive);
 	rlist_create(&cord->ready);
 	rlist_create(&cord->dead);
@@ -751,6 +751,12 @@ struct fiber {
 		 */
 		struct {
 			uint64_t sync;
+			/**
+			 * Name of the type of the iproto request being
+			 * processed or NULL. Used to tag the samples of
+			 * the fiber profiler.
+			 */
+			const char *request_type;
 		} net;
 	} storage;
 	/** An object to wait for incoming message or a reader. */
@@ -775,6 +781,44 @@ fiber_on_stop(struct fiber *f);
 
 struct cord_on_exit;
 
+enum {
+	/** Number of stack size classes in a fiber stack pool. */
+	FIBER_STACK_POOL_CLASS_COUNT = 10,
+	/** Max number of stacks kept in one size class of a pool. */
+	FIBER_STACK_POOL_CLASS_CAPACITY = 64,
+};
+
+/** Statistics of a fiber stack pool. */
+struct fiber_stack_pool_stat {
+	/** Number of stacks in the pool. */
+	size_t count;
+	/** Total size of stacks in the pool, in bytes. */
+	size_t size;
+	/** Number of fiber stacks taken from the pool. */
+	uint64_t hits;
+	/** Number of fiber stacks allocated because the pool was empty. */
+	uint64_t misses;
+};
+
+/**
+ * A cache of stacks of deleted fibers. Stack sizes are rounded up
+ * to a power of two, which is what the slab cache allocates anyway,
+ * and the stacks are kept by size classes. A stack keeps its guard
+ * page protected and its pages faulted in while it is in the pool,
+ * so a new fiber gets it without syscalls.
+ *
+ * Fibers with the default stack are reused as a whole, see
+ * cord::dead, so the pool mostly serves fibers with a custom stack.
+ */
+struct fiber_stack_pool {
+	/** Stack slabs by size class. */
+	struct slab *slabs[FIBER_STACK_POOL_CLASS_COUNT]
+			  [FIBER_STACK_POOL_CLASS_CAPACITY];
+	/** Number of stacks in each size class. */
+	int count[FIBER_STACK_POOL_CLASS_COUNT];
+	struct fiber_stack_pool_stat stat;
+};
+
 /**
  * @brief An independent execution unit that can be managed by a separate OS
  * thread. Each cord consists of fibers to implement cooperative multitasking
@@ -839,6 +883,8 @@ struct cord {
 	struct mempool fiber_mempool;
 	/** A runtime slab cache for general use in this cord. */
 	struct slab_cache slabc;
+	/** A cache of stacks of deleted fibers. */
+	struct fiber_stack_pool stack_pool;
 	/** The "main" fiber of this cord, the scheduler. */
 	struct fiber sched;
 	/**
@@ -977,6 +1023,14 @@ cord_is_main(void);
 void
 cord_collect_garbage(struct cord *cord);
 
+/** Get statistics of the fiber stack pool of the current cord. */
+void
+fiber_stack_pool_stat(struct fiber_stack_pool_stat *stat);
+
+/** Free all stacks in the fiber stack pool of the given cord. */
+void
+cord_flush_stack_pool(struct cord *cord);
+
 /**
  * Return slab_cache suitable to use with tarantool/small library
  */
@@ -0,0 +1,293 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "fiber_prof.h"
+
+#ifdef ENABLE_BACKTRACE
+
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif /* defined(__linux__) */
+
+#include "diag.h"
+#include "say.h"
+#include "tt_sigaction.h"
+#include <pmatomic.h>
+
+enum {
+	/**
+	 * Number of frames of the signal handling to skip: the frame of
+	 * `backtrace_collect`, the handler, the signal dispatcher of
+	 * `tt_sigaction` and the signal trampoline.
+	 */
+	FIBER_PROF_SKIP_FRAMES = 4,
+};
+
+#if defined(__linux__) && !defined(sigev_notify_thread_id)
+/* Not defined by old glibc versions. */
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+static struct {
+	/** Ring buffer of samples. */
+	struct fiber_prof_sample *samples;
+	/** Number of samples the ring buffer can hold. */
+	size_t sample_count;
+	/**
+	 * Total number of samples written since the start. The sample
+	 * number i is stored at `samples[i % sample_count]`. Written
+	 * by the signal handler only after the sample is complete.
+	 */
+	uint64_t head;
+	/** Set if the profiler is running. */
+	bool is_running;
+#if defined(__linux__)
+	/** Timer counting CPU time of the main thread. */
+	timer_t timer;
+#endif /* defined(__linux__) */
+} fiber_prof;
+
+/**
+ * Copy the fiber name. The name may be changed by the interrupted
+ * code, so the copy is bounded and doesn't rely on the terminating
+ * zero.
+ */
+static void
+fiber_prof_copy_name(char *dst, const char *src, size_t size)
+{
+	size_t i;
+	for (i = 0; i < size - 1 && src[i] != '\0'; i++)
+		dst[i] = src[i];
+	dst[i] = '\0';
+}
+
+/**
+ * SIGPROF handler. It is always run in the main thread, because
+ * `tt_sigaction` forwards signals there, so it interrupts either the
+ * current fiber of the main cord or the main cord scheduler.
+ */
+static void
+fiber_prof_signal_cb(int signum)
+{
+	(void)signum;
+	if (fiber_prof.samples == NULL)
+		return;
+	int saved_errno = errno;
+	uint64_t head = pm_atomic_load_explicit(&fiber_prof.head,
+						pm_memory_order_relaxed);
+	struct fiber_prof_sample *sample =
+		&fiber_prof.samples[head % fiber_prof.sample_count];
+	struct fiber *f = fiber();
+	sample->fid = f->fid;
+	sample->request_type = f->storage.net.request_type;
+	fiber_prof_copy_name(sample->fiber_name, f->name,
+			     sizeof(sample->fiber_name));
+	backtrace_collect(&sample->bt, NULL, FIBER_PROF_SKIP_FRAMES);
+	pm_atomic_store(&fiber_prof.head, head + 1);
+	errno = saved_errno;
+}
+
+#if defined(__linux__)
+
+/**
+ * Start a timer sending SIGPROF to the main thread every given
+ * interval of its CPU time. The process-wide ITIMER_PROF would count
+ * the time of the other threads too, and the signal would be
+ * forwarded to the main thread, so their load would be attributed
+ * to whatever the main cord is doing, e.g. waiting for events.
+ */
+static int
+fiber_prof_timer_start(double interval)
+{
+	clockid_t clock;
+	int rc = pthread_getcpuclockid(pthread_self(), &clock);
+	if (rc != 0) {
+		errno = rc;
+		return -1;
+	}
+	struct sigevent sev;
+	memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = SIGPROF;
+	sev.sigev_notify_thread_id = syscall(SYS_gettid);
+	if (timer_create(clock, &sev, &fiber_prof.timer) != 0)
+		return -1;
+	struct itimerspec spec;
+	spec.it_interval.tv_sec = (time_t)interval;
+	spec.it_interval.tv_nsec =
+		(long)((interval - (time_t)interval) * 1e9);
+	if (spec.it_interval.tv_sec == 0 && spec.it_interval.tv_nsec == 0)
+		spec.it_interval.tv_nsec = 1;
+	spec.it_value = spec.it_interval;
+	if (timer_settime(fiber_prof.timer, 0, &spec, NULL) != 0) {
+		int saved_errno = errno;
+		timer_delete(fiber_prof.timer);
+		errno = saved_errno;
+		return -1;
+	}
+	return 0;
+}
+
+/** Stop the timer started by fiber_prof_timer_start(). */
+static int
+fiber_prof_timer_stop(void)
+{
+	return timer_delete(fiber_prof.timer);
+}
+
+#else /* !defined(__linux__) */
+
+/**
+ * Set the SIGPROF timer to the given interval, 0 disarms it. Thread
+ * CPU time timers aren't available, so the CPU time of the whole
+ * process is counted.
+ */
+static int
+fiber_prof_set_timer(double interval)
+{
+	struct itimerval timer;
+	timer.it_interval.tv_sec = (time_t)interval;
+	timer.it_interval.tv_usec =
+		(suseconds_t)((interval - (time_t)interval) * 1e6);
+	if (interval > 0 && timer.it_interval.tv_sec == 0 &&
+	    timer.it_interval.tv_usec == 0)
+		timer.it_interval.tv_usec = 1;
+	timer.it_value = timer.it_interval;
+	return setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+static int
+fiber_prof_timer_start(double interval)
+{
+	return fiber_prof_set_timer(interval);
+}
+
+static int
+fiber_prof_timer_stop(void)
+{
+	return fiber_prof_set_timer(0);
+}
+
+#endif /* !defined(__linux__) */
+
+int
+fiber_prof_start(double interval, size_t sample_count)
+{
+	assert(cord_is_main());
+	assert(interval > 0);
+	assert(sample_count > 0);
+	if (fiber_prof.is_running) {
+		diag_set(IllegalParams, "the profiler is already running");
+		return -1;
+	}
+	struct sigaction sa;
+	if (sigaction(SIGPROF, NULL, &sa) != 0) {
+		diag_set(SystemError, "failed to get the SIGPROF handler");
+		return -1;
+	}
+	if (sa.sa_handler != SIG_DFL && sa.sa_handler != SIG_IGN) {
+		diag_set(IllegalParams, "SIGPROF is used by another profiler");
+		return -1;
+	}
+	size_t size = sample_count * sizeof(*fiber_prof.samples);
+	struct fiber_prof_sample *samples = NULL;
+	if (sample_count <= SIZE_MAX / sizeof(*fiber_prof.samples))
+		samples = malloc(size);
+	if (samples == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "profiler samples");
+		return -1;
+	}
+	free(fiber_prof.samples);
+	fiber_prof.samples = samples;
+	fiber_prof.sample_count = sample_count;
+	pm_atomic_store(&fiber_prof.head, 0);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = fiber_prof_signal_cb;
+	sa.sa_flags = SA_RESTART;
+	if (tt_sigaction(SIGPROF, &sa, NULL) != 0) {
+		diag_set(SystemError, "failed to set the SIGPROF handler");
+		return -1;
+	}
+	if (fiber_prof_timer_start(interval) != 0) {
+		diag_set(SystemError, "failed to set the profiling timer");
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = SIG_IGN;
+		tt_sigaction(SIGPROF, &sa, NULL);
+		return -1;
+	}
+	fiber_prof.is_running = true;
+	return 0;
+}
+
+void
+fiber_prof_stop(void)
+{
+	assert(cord_is_main());
+	if (!fiber_prof.is_running)
+		return;
+	if (fiber_prof_timer_stop() != 0)
+		say_syserror("failed to reset the profiling timer");
+	/*
+	 * A signal may still be pending in another thread, so ignore it
+	 * rather than reset it to the default action, which terminates
+	 * the process.
+	 */
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = SIG_IGN;
+	if (tt_sigaction(SIGPROF, &sa, NULL) != 0)
+		say_syserror("failed to reset the SIGPROF handler");
+	fiber_prof.is_running = false;
+}
+
+bool
+fiber_prof_is_running(void)
+{
+	return fiber_prof.is_running;
+}
+
+int
+fiber_prof_foreach(fiber_prof_sample_f cb, void *arg)
+{
+	assert(cord_is_main());
+	if (fiber_prof.samples == NULL)
+		return 0;
+	size_t sample_count = fiber_prof.sample_count;
+	uint64_t head = pm_atomic_load(&fiber_prof.head);
+	uint64_t i = head > sample_count ? head - sample_count : 0;
+	struct fiber_prof_sample sample;
+	for (; i < head; i++) {
+		memcpy(&sample, &fiber_prof.samples[i % sample_count],
+		       sizeof(sample));
+		/*
+		 * The signal handler runs in this thread, so it either
+		 * has written a sample completely or not at all. If it
+		 * has written over the copied one, skip it and all the
+		 * older ones.
+		 */
+		uint64_t new_head = pm_atomic_load(&fiber_prof.head);
+		if (new_head > i + sample_count) {
+			i = new_head - sample_count - 1;
+			continue;
+		}
+		int rc = cb(&sample, arg);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+#endif /* ENABLE_BACKTRACE */
@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include "trivia/config.h"
+
+#ifdef ENABLE_BACKTRACE
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "backtrace.h"
+#include "fiber.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Sampling profiler of the main cord.
+ *
+ * A SIGPROF timer interrupts the main thread every given interval of
+ * its CPU time, so time spent by other threads isn't sampled. On
+ * systems other than Linux the CPU time of the whole process is
+ * counted. The signal handler collects the C backtrace of the fiber
+ * running in the main cord and stores it along with the fiber name
+ * and the type of the request the fiber is processing into a ring
+ * buffer. The buffer is written by the signal handler and read in
+ * the main cord without locks, so old samples are overwritten when
+ * the buffer is full.
+ *
+ * The profiler uses SIGPROF, so it can't run along with another
+ * profiler using it, e.g. the LuaJIT sysprof.
+ */
+
+enum {
+	/** Default number of samples kept by the profiler. */
+	FIBER_PROF_SAMPLE_COUNT_DEFAULT = 10000,
+};
+
+/** Default sampling interval, in seconds. */
+#define FIBER_PROF_INTERVAL_DEFAULT 0.01
+
+/** A sample collected by the profiler. */
+struct fiber_prof_sample {
+	/** Id of the fiber that was running. */
+	uint64_t fid;
+	/**
+	 * Type of the request the fiber was processing or NULL,
+	 * see `fiber::storage::net::request_type`.
+	 */
+	const char *request_type;
+	/** Name of the fiber, truncated if too long. */
+	char fiber_name[FIBER_NAME_INLINE];
+	/** Backtrace of the fiber, the innermost frame first. */
+	struct backtrace bt;
+};
+
+/**
+ * Callback for `fiber_prof_foreach`. Returning a non-zero value
+ * stops the iteration.
+ */
+typedef int
+(*fiber_prof_sample_f)(const struct fiber_prof_sample *sample, void *arg);
+
+/**
+ * Start the profiler, samples collected by the previous run are
+ * discarded.
+ *
+ * @param interval Sampling interval, in seconds of CPU time.
+ * @param sample_count Number of the most recent samples to keep.
+ * @retval 0 Success.
+ * @retval -1 Error, diag is set.
+ */
+int
+fiber_prof_start(double interval, size_t sample_count);
+
+/**
+ * Stop the profiler. The collected samples are kept until the next
+ * start. Does nothing if the profiler isn't running.
+ */
+void
+fiber_prof_stop(void);
+
+/** Check if the profiler is running. */
+bool
+fiber_prof_is_running(void);
+
+/**
+ * Call @a cb for each collected sample, oldest first. Can be called
+ * while the profiler is running, then samples overwritten during the
+ * iteration are skipped. Must be called from the main cord.
+ *
+ * @retval 0 All samples were visited.
+ * @retval non-zero The value returned by @a cb that stopped the
+ *         iteration.
+ */
+int
+fiber_prof_foreach(fiber_prof_sample_f cb, void *arg);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* ENABLE_BACKTRACE */
@@ -31,6 +31,8 @@
  * SUCH DAMAGE.
  */
 
+#include <stddef.h>
+
 struct histogram;
 
 /**
@@ -75,6 +77,13 @@ latency_collect(struct latency *latency, double value);
  * Returns @pct-th percentile of all observations.
  */
 double
-latency_get(struct latency *latency, int pct);
+latency_get(struct latency *latency, double pct);
+
+/**
+ * Get the number of observations collected since the counter
+ * was created or reset.
+ */
+size_t
+latency_count(struct latency *latency);
 
 #endif /* TARANTOOL_LATENCY_H_INCLUDED */
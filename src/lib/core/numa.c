@@ -0,0 +1,251 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "numa.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "diag.h"
+#include "fiber.h"
+#include "say.h"
+#include "trivia/util.h"
+
+const char *numa_policy_strs[] = {
+	/* [NUMA_POLICY_DEFAULT]    = */ "default",
+	/* [NUMA_POLICY_LOCAL]      = */ "local",
+	/* [NUMA_POLICY_INTERLEAVE] = */ "interleave",
+	/* [NUMA_POLICY_BIND]       = */ "bind",
+};
+
+static_assert(lengthof(numa_policy_strs) == numa_policy_MAX,
+	      "numa_policy_strs must be updated");
+
+/** The policy set with numa_set_policy(). */
+static enum numa_policy numa_policy = NUMA_POLICY_DEFAULT;
+/** Node mask of the policy, never zero unless the policy is default. */
+static uint64_t numa_nodes;
+
+int
+numa_nodes_parse(const char *str, uint64_t *nodes)
+{
+	uint64_t mask = 0;
+	const char *p = str;
+	while (true) {
+		char *end;
+		if (*p < '0' || *p > '9')
+			goto error;
+		unsigned long first = strtoul(p, &end, 10);
+		unsigned long last = first;
+		p = end;
+		if (*p == '-') {
+			p++;
+			if (*p < '0' || *p > '9')
+				goto error;
+			last = strtoul(p, &end, 10);
+			p = end;
+		}
+		if (first > last || last >= NUMA_NODE_MAX)
+			goto error;
+		for (unsigned long node = first; node <= last; node++)
+			mask |= (uint64_t)1 << node;
+		if (*p == '\0')
+			break;
+		if (*p != ',')
+			goto error;
+		p++;
+	}
+	*nodes = mask;
+	return 0;
+error:
+	diag_set(IllegalParams, "invalid NUMA node list '%s', expected "
+		 "node numbers less than %d, e.g. '0,2-3'", str, NUMA_NODE_MAX);
+	return -1;
+}
+
+/** Get the mask of online NUMA nodes. */
+static uint64_t
+numa_online_nodes(void)
+{
+	uint64_t nodes = 1;
+	FILE *f = fopen("/sys/devices/system/node/online", "r");
+	if (f == NULL)
+		return nodes;
+	char buf[256];
+	if (fgets(buf, sizeof(buf), f) != NULL) {
+		buf[strcspn(buf, "\n")] = '\0';
+		if (numa_nodes_parse(buf, &nodes) != 0) {
+			diag_log();
+			nodes = 1;
+		}
+	}
+	fclose(f);
+	return nodes;
+}
+
+void
+numa_set_policy(enum numa_policy policy, uint64_t nodes)
+{
+	assert(policy < numa_policy_MAX);
+	numa_policy = policy;
+	numa_nodes = 0;
+	if (policy == NUMA_POLICY_DEFAULT)
+		return;
+	numa_nodes = nodes != 0 ? nodes : numa_online_nodes();
+}
+
+enum numa_policy
+numa_get_policy(void)
+{
+	return numa_policy;
+}
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_set_mempolicy)
+
+/** Memory policy modes, see linux/mempolicy.h. */
+enum {
+	NUMA_MPOL_BIND = 2,
+	NUMA_MPOL_INTERLEAVE = 3,
+	NUMA_MPOL_LOCAL = 4,
+};
+
+/**
+ * Get the kernel memory policy mode of the current policy. The mode
+ * of the local policy takes no node mask.
+ */
+static int
+numa_mode(void)
+{
+	switch (numa_policy) {
+	case NUMA_POLICY_LOCAL:
+		return NUMA_MPOL_LOCAL;
+	case NUMA_POLICY_INTERLEAVE:
+		return NUMA_MPOL_INTERLEAVE;
+	case NUMA_POLICY_BIND:
+		return NUMA_MPOL_BIND;
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+int
+numa_bind_memory(void *addr, size_t size)
+{
+	if (numa_policy == NUMA_POLICY_DEFAULT)
+		return 0;
+	int mode = numa_mode();
+	const uint64_t *mask = mode != NUMA_MPOL_LOCAL ? &numa_nodes : NULL;
+	/* The kernel expects the number of mask bits plus one. */
+	unsigned long maxnode = mask != NULL ? NUMA_NODE_MAX + 1 : 0;
+	if (syscall(SYS_mbind, addr, size, mode, mask, maxnode, 0) != 0) {
+		diag_set(SystemError, "failed to set NUMA policy '%s'",
+			 numa_policy_strs[numa_policy]);
+		return -1;
+	}
+	return 0;
+}
+
+void
+numa_bind_thread(void)
+{
+	if (numa_policy == NUMA_POLICY_DEFAULT)
+		return;
+	int mode = numa_mode();
+	const uint64_t *mask = mode != NUMA_MPOL_LOCAL ? &numa_nodes : NULL;
+	unsigned long maxnode = mask != NULL ? NUMA_NODE_MAX + 1 : 0;
+	if (syscall(SYS_set_mempolicy, mode, mask, maxnode) != 0) {
+		say_warn("failed to set NUMA policy '%s' of thread %s: %s",
+			 numa_policy_strs[numa_policy], cord_name(cord()),
+			 strerror(errno));
+	}
+}
+
+int
+numa_memory_usage(const void *addr, size_t size,
+		  size_t usage[NUMA_NODE_MAX])
+{
+	memset(usage, 0, NUMA_NODE_MAX * sizeof(*usage));
+	FILE *f = fopen("/proc/self/numa_maps", "r");
+	if (f == NULL) {
+		diag_set(SystemError, "failed to open /proc/self/numa_maps");
+		return -1;
+	}
+	int node_count = 0;
+	/*
+	 * The lines of anonymous mappings are short, so a line that
+	 * doesn't fit the buffer is of no interest and skipped.
+	 */
+	char line[1024];
+	bool is_line_start = true;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		bool is_line_start_next = strchr(line, '\n') != NULL;
+		if (!is_line_start || !is_line_start_next) {
+			is_line_start = is_line_start_next;
+			continue;
+		}
+		/* The line starts with the address of a mapping. */
+		char *p;
+		uintptr_t start = strtoull(line, &p, 16);
+		if (start < (uintptr_t)addr || start >= (uintptr_t)addr + size)
+			continue;
+		size_t pages[NUMA_NODE_MAX] = {0};
+		size_t page_size = 4096;
+		char *saveptr;
+		for (char *tok = strtok_r(p, " \n", &saveptr); tok != NULL;
+		     tok = strtok_r(NULL, " \n", &saveptr)) {
+			unsigned node;
+			size_t count;
+			if (sscanf(tok, "N%u=%zu", &node, &count) == 2 &&
+			    node < NUMA_NODE_MAX) {
+				pages[node] += count;
+				if ((int)node >= node_count)
+					node_count = node + 1;
+			} else if (sscanf(tok, "kernelpagesize_kB=%zu",
+					  &count) == 1) {
+				page_size = count * 1024;
+			}
+		}
+		for (int i = 0; i < NUMA_NODE_MAX; i++)
+			usage[i] += pages[i] * page_size;
+	}
+	fclose(f);
+	return node_count;
+}
+
+#else /* !defined(__linux__) */
+
+int
+numa_bind_memory(void *addr, size_t size)
+{
+	(void)addr;
+	(void)size;
+	return 0;
+}
+
+void
+numa_bind_thread(void)
+{
+}
+
+int
+numa_memory_usage(const void *addr, size_t size,
+		  size_t usage[NUMA_NODE_MAX])
+{
+	(void)addr;
+	(void)size;
+	memset(usage, 0, NUMA_NODE_MAX * sizeof(*usage));
+	return 0;
+}
+
+#endif /* !defined(__linux__) */
@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * NUMA memory placement of the process memory: the memtx arena and
+ * the memory of the threads that keep their buffers close to them
+ * (iproto, WAL). Works on Linux only, elsewhere binding is a no-op.
+ */
+
+enum {
+	/** Max number of NUMA nodes supported, the size of a node mask. */
+	NUMA_NODE_MAX = 64,
+};
+
+enum numa_policy {
+	/** Don't change the policy inherited from the parent process. */
+	NUMA_POLICY_DEFAULT,
+	/** Allocate memory on the node of the CPU touching it first. */
+	NUMA_POLICY_LOCAL,
+	/** Spread memory over the given nodes page by page. */
+	NUMA_POLICY_INTERLEAVE,
+	/** Allocate memory on the given nodes only. */
+	NUMA_POLICY_BIND,
+	numa_policy_MAX,
+};
+
+/** Policy names, as they are set in the configuration. */
+extern const char *numa_policy_strs[];
+
+/**
+ * Parse a list of NUMA nodes, e.g. "0,2-3", into a node mask.
+ * Returns -1 and sets diag on error.
+ */
+int
+numa_nodes_parse(const char *str, uint64_t *nodes);
+
+/**
+ * Set the policy applied by numa_bind_memory() and
+ * numa_bind_thread(). Zero @a nodes stands for all online nodes.
+ */
+void
+numa_set_policy(enum numa_policy policy, uint64_t nodes);
+
+/** Get the policy set with numa_set_policy(). */
+enum numa_policy
+numa_get_policy(void);
+
+/**
+ * Apply the policy to a memory range that hasn't been touched yet.
+ * Returns -1 and sets diag on error.
+ */
+int
+numa_bind_memory(void *addr, size_t size);
+
+/**
+ * Apply the policy to the memory allocated by the calling thread
+ * from now on. Failures are logged.
+ */
+void
+numa_bind_thread(void);
+
+/**
+ * Get the amount of memory of a range resident on each NUMA node:
+ * @a usage[i] is set to the number of bytes on node i. Returns the
+ * number of nodes (max node + 1) or -1 with diag set on error.
+ */
+int
+numa_memory_usage(const void *addr, size_t size,
+		  size_t usage[NUMA_NODE_MAX]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -46,7 +46,9 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <coio_task.h>
+#include <pmatomic.h>
 
 pid_t log_pid = 0;
 /**
@@ -803,8 +805,10 @@ say_set_background(void)
 void
 say_logger_free(void)
 {
-	if (say_logger_initialized())
+	if (say_logger_initialized()) {
+		say_set_log_async(false, SAY_ASYNC_DROP);
 		log_destroy(&log_std);
+	}
 	log_default = &log_boot;
 }
 
@@ -1250,6 +1254,290 @@ write_to_syslog(struct log *log, int total)
 
 /** Loggers }}} */
 
+/** {{{ Asynchronous log */
+
+enum {
+	/** Size of the buffer of the asynchronous log. */
+	SAY_ASYNC_BUF_SIZE = 1024 * 1024,
+	/**
+	 * How long the log thread waits for a non-blocking log
+	 * descriptor to become writable before it drops the lines.
+	 */
+	SAY_ASYNC_POLL_TIMEOUT_MS = 1000,
+};
+
+/**
+ * The asynchronous mode of the default log. Formatted lines are
+ * appended to a ring buffer, and the log thread writes them out in
+ * batches. The mutex is held only to copy a line, so a thread that
+ * logs doesn't wait for the disk or the reader of the pipe unless
+ * the buffer is full and the overflow mode is SAY_ASYNC_BLOCK.
+ */
+static struct say_async {
+	/**
+	 * The log written asynchronously or NULL if the mode is
+	 * disabled. Read by log_vsay() without the mutex.
+	 */
+	struct log *log;
+	/** The descriptor the log thread writes to. */
+	int fd;
+	/** What to do with a line that doesn't fit the buffer. */
+	enum say_async_overflow overflow;
+	/** The log thread. */
+	pthread_t thread;
+	/** Protects the members below and the overflow mode. */
+	pthread_mutex_t mutex;
+	/** Signaled when a line is appended or the thread is stopped. */
+	pthread_cond_t data_cond;
+	/** Signaled when the log thread has written out some lines. */
+	pthread_cond_t space_cond;
+	/** The ring buffer, allocated when the mode is enabled first. */
+	char *buf;
+	/** Number of bytes ever appended to the buffer. */
+	uint64_t wpos;
+	/** Number of bytes ever written out by the log thread. */
+	uint64_t rpos;
+	/** Set to make the log thread exit once the buffer is empty. */
+	bool is_stopping;
+	/** True while the log thread accepts lines. */
+	bool is_running;
+	/** Number of dropped lines that haven't been reported yet. */
+	int64_t dropped;
+} say_async = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.data_cond = PTHREAD_COND_INITIALIZER,
+	.space_cond = PTHREAD_COND_INITIALIZER,
+};
+
+/**
+ * Write a chunk of the buffer to the log descriptor. Returns the
+ * number of bytes written or dropped on error: as in the synchronous
+ * mode, the lines that can't be written are lost.
+ */
+static size_t
+say_async_write(int fd, const char *data, size_t size)
+{
+	while (true) {
+		ssize_t n = write(fd, data, size);
+		if (n > 0)
+			return n;
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+			if (poll(&pfd, 1, SAY_ASYNC_POLL_TIMEOUT_MS) > 0)
+				continue;
+		}
+		return size;
+	}
+}
+
+/** The log thread function. */
+static void *
+say_async_f(void *arg)
+{
+	(void)arg;
+	tt_pthread_setname("log");
+	tt_pthread_mutex_lock(&say_async.mutex);
+	while (true) {
+		if (say_async.rpos == say_async.wpos) {
+			if (say_async.is_stopping)
+				break;
+			tt_pthread_cond_wait(&say_async.data_cond,
+					     &say_async.mutex);
+			continue;
+		}
+		size_t offset = say_async.rpos % SAY_ASYNC_BUF_SIZE;
+		size_t size = MIN(say_async.wpos - say_async.rpos,
+				  SAY_ASYNC_BUF_SIZE - offset);
+		tt_pthread_mutex_unlock(&say_async.mutex);
+		ERROR_INJECT_SLEEP(ERRINJ_LOG_ASYNC_DELAY);
+		size = say_async_write(say_async.fd, say_async.buf + offset,
+				       size);
+		tt_pthread_mutex_lock(&say_async.mutex);
+		say_async.rpos += size;
+		tt_pthread_cond_broadcast(&say_async.space_cond);
+	}
+	say_async.is_running = false;
+	tt_pthread_cond_broadcast(&say_async.space_cond);
+	tt_pthread_mutex_unlock(&say_async.mutex);
+	return NULL;
+}
+
+/**
+ * Append a formatted line to the buffer of the asynchronous log.
+ * A fatal line is waited for to be written out, because the process
+ * is likely to exit right after it.
+ *
+ * @param line		the line
+ * @param size		size of the line
+ * @param level		level of the line
+ * @param[out] dropped	number of the lines dropped before this one
+ *			that must be reported now
+ * @retval true		the line was appended or dropped
+ * @retval false	the log thread isn't running, the line must be
+ *			written synchronously
+ */
+static bool
+say_async_push(const char *line, int size, int level, int64_t *dropped)
+{
+	assert(size >= 0);
+	size_t len = MIN(size, SAY_BUF_LEN_MAX - 1);
+	tt_pthread_mutex_lock(&say_async.mutex);
+	while (say_async.is_running &&
+	       SAY_ASYNC_BUF_SIZE - (say_async.wpos - say_async.rpos) < len) {
+		if (say_async.overflow == SAY_ASYNC_DROP) {
+			say_async.dropped++;
+			tt_pthread_mutex_unlock(&say_async.mutex);
+			return true;
+		}
+		tt_pthread_cond_wait(&say_async.space_cond, &say_async.mutex);
+	}
+	if (!say_async.is_running) {
+		tt_pthread_mutex_unlock(&say_async.mutex);
+		return false;
+	}
+	size_t offset = say_async.wpos % SAY_ASYNC_BUF_SIZE;
+	size_t tail = MIN(len, SAY_ASYNC_BUF_SIZE - offset);
+	memcpy(say_async.buf + offset, line, tail);
+	memcpy(say_async.buf, line + tail, len - tail);
+	if (say_async.wpos == say_async.rpos)
+		tt_pthread_cond_signal(&say_async.data_cond);
+	say_async.wpos += len;
+	if (level == S_FATAL) {
+		while (say_async.is_running &&
+		       say_async.rpos != say_async.wpos)
+			tt_pthread_cond_wait(&say_async.space_cond,
+					     &say_async.mutex);
+	} else {
+		*dropped = say_async.dropped;
+		say_async.dropped = 0;
+	}
+	tt_pthread_mutex_unlock(&say_async.mutex);
+	return true;
+}
+
+/**
+ * Called before fork(). Writes out the buffer, so that the lines are
+ * written neither twice nor never, and keeps the mutex locked, so that
+ * the child gets the state consistent.
+ */
+static void
+say_async_atfork_prepare(void)
+{
+	tt_pthread_mutex_lock(&say_async.mutex);
+	while (say_async.is_running && say_async.rpos != say_async.wpos)
+		tt_pthread_cond_wait(&say_async.space_cond, &say_async.mutex);
+}
+
+/** Called in the parent after fork(). */
+static void
+say_async_atfork_parent(void)
+{
+	tt_pthread_mutex_unlock(&say_async.mutex);
+}
+
+/**
+ * Called in the child after fork(), e.g. when the process is
+ * daemonized. Only the forking thread exists in the child, so the
+ * log thread is restarted. If it fails, the lines are written
+ * synchronously.
+ */
+static void
+say_async_atfork_child(void)
+{
+	tt_pthread_mutex_unlock(&say_async.mutex);
+	/* The parent's log thread might have been waiting on them. */
+	tt_pthread_cond_init(&say_async.data_cond, NULL);
+	tt_pthread_cond_init(&say_async.space_cond, NULL);
+	struct log *log = say_async.log;
+	if (log == NULL || !say_async.is_running)
+		return;
+	pm_atomic_store(&say_async.log, NULL);
+	say_async.is_running = false;
+	if (tt_pthread_create(&say_async.thread, NULL, say_async_f,
+			      NULL) != 0)
+		return;
+	say_async.is_running = true;
+	pm_atomic_store(&say_async.log, log);
+}
+
+/** Start the log thread writing the given log. */
+static int
+say_async_start(struct log *log)
+{
+	if (say_async.buf == NULL) {
+		say_async.buf = malloc(SAY_ASYNC_BUF_SIZE);
+		if (say_async.buf == NULL) {
+			diag_set(OutOfMemory, SAY_ASYNC_BUF_SIZE, "malloc",
+				 "say_async.buf");
+			return -1;
+		}
+		tt_pthread_atfork(say_async_atfork_prepare,
+				  say_async_atfork_parent,
+				  say_async_atfork_child);
+	}
+	tt_pthread_mutex_lock(&say_async.mutex);
+	say_async.fd = log->fd;
+	say_async.wpos = say_async.rpos = 0;
+	say_async.is_stopping = false;
+	say_async.is_running = true;
+	tt_pthread_mutex_unlock(&say_async.mutex);
+	if (tt_pthread_create(&say_async.thread, NULL, say_async_f,
+			      NULL) != 0) {
+		say_async.is_running = false;
+		diag_set(SystemError, "failed to create thread");
+		return -1;
+	}
+	pm_atomic_store(&say_async.log, log);
+	return 0;
+}
+
+/**
+ * Stop the log thread after it writes out the buffer. The lines
+ * logged concurrently are written synchronously.
+ */
+static void
+say_async_stop(void)
+{
+	pm_atomic_store(&say_async.log, NULL);
+	tt_pthread_mutex_lock(&say_async.mutex);
+	say_async.is_stopping = true;
+	tt_pthread_cond_signal(&say_async.data_cond);
+	tt_pthread_mutex_unlock(&say_async.mutex);
+	tt_pthread_join(say_async.thread, NULL);
+	if (say_async.dropped > 0) {
+		say_warn("%lld log lines were dropped because the log "
+			 "buffer was full", (long long)say_async.dropped);
+		say_async.dropped = 0;
+	}
+}
+
+int
+say_set_log_async(bool enabled, enum say_async_overflow overflow)
+{
+	assert(overflow < say_async_overflow_MAX);
+	tt_pthread_mutex_lock(&say_async.mutex);
+	say_async.overflow = overflow;
+	/* Let blocked threads drop their lines if asked to. */
+	tt_pthread_cond_broadcast(&say_async.space_cond);
+	tt_pthread_mutex_unlock(&say_async.mutex);
+
+	struct log *log = NULL;
+	if (enabled && (log_default->type == SAY_LOGGER_FILE ||
+			log_default->type == SAY_LOGGER_PIPE))
+		log = log_default;
+	if (say_async.log == log)
+		return 0;
+	if (say_async.log != NULL)
+		say_async_stop();
+	if (log != NULL)
+		return say_async_start(log);
+	return 0;
+}
+
+/** Asynchronous log }}} */
+
 /*
  * Init string parser(s)
  */
@@ -1441,6 +1729,7 @@ log_vsay(struct log *log, int level, bool check_level, const char *module,
 {
 	int errsv = errno;
 	int total = 0;
+	int64_t dropped = 0;
 
 	assert(level >= 0 && level < say_level_MAX);
 
@@ -1455,6 +1744,9 @@ log_vsay(struct log *log, int level, bool check_level, const char *module,
 	switch (log->type) {
 	case SAY_LOGGER_FILE:
 	case SAY_LOGGER_PIPE:
+		if (log == pm_atomic_load(&say_async.log) &&
+		    say_async_push(say_buf, total, level, &dropped))
+			break;
 		write_to_file(log, total);
 		break;
 	case SAY_LOGGER_STDERR:
@@ -1482,6 +1774,12 @@ log_vsay(struct log *log, int level, bool check_level, const char *module,
 	default:
 		unreachable();
 	}
+	if (dropped > 0) {
+		/* The line has been copied, so say_buf can be reused. */
+		log_say(log, S_WARN, __FILE__, __LINE__, NULL,
+			"%lld log lines were dropped because the log buffer "
+			"was full", (long long)dropped);
+	}
 out:
 	errno = errsv; /* Preserve the errno. */
 	return total;
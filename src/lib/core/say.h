@@ -96,6 +96,18 @@ say_log_level_is_enabled(int level)
 
 extern enum say_format log_format;
 
+/**
+ * What to do with a line that doesn't fit the buffer of the
+ * asynchronous log.
+ */
+enum say_async_overflow {
+	/** Drop the line and report the number of dropped lines later. */
+	SAY_ASYNC_DROP,
+	/** Wait until the log thread frees space in the buffer. */
+	SAY_ASYNC_BLOCK,
+	say_async_overflow_MAX
+};
+
 enum say_syslog_server_type {
 	SAY_SYSLOG_DEFAULT,
 	SAY_SYSLOG_UNIX,
@@ -287,6 +299,23 @@ say_get_log_level(void);
 void
 say_set_log_format(enum say_format format);
 
+/**
+ * Enable or disable asynchronous writing of the default log. Only
+ * a log written to a file or a pipe can be asynchronous, for other
+ * loggers the call is ignored. Can be used dynamically.
+ *
+ * In the asynchronous mode formatted lines are appended to a buffer
+ * and written out by a dedicated thread, so a slow disk or reader
+ * of the pipe doesn't block the logging thread.
+ *
+ * @param enabled	true to enable the asynchronous mode
+ * @param overflow	what to do if the buffer is full
+ * @retval 0 success
+ * @retval -1 failed to start the log thread, diag is set
+ */
+int
+say_set_log_async(bool enabled, enum say_async_overflow overflow);
+
 /**
  * Set flight recorder log level.
  */
@@ -34,6 +34,7 @@
 #include "lua/utils.h"
 #include "lua/serializer.h"
 #include "lua/backtrace.h"
+#include "fiber_prof.h"
 #include "tt_static.h"
 #include "tnt_thread.h"
 
@@ -415,6 +416,106 @@ lbox_fiber_leak_backtrace_disable(struct lua_State *L)
 	fiber_leak_backtrace_enable = false;
 	return 0;
 }
+
+/**
+ * Start the fiber profiler.
+ *
+ * Usage: fiber.profile_start([{interval = <seconds>,
+ *                              samples = <count>}])
+ */
+static int
+lbox_fiber_profile_start(struct lua_State *L)
+{
+	double interval = FIBER_PROF_INTERVAL_DEFAULT;
+	lua_Integer sample_count = FIBER_PROF_SAMPLE_COUNT_DEFAULT;
+	if (lua_gettop(L) > 1 ||
+	    (!lua_isnoneornil(L, 1) && !lua_istable(L, 1))) {
+		return luaL_error(L, "Usage: fiber.profile_start([{interval = "
+				  "<number>, samples = <number>}])");
+	}
+	if (lua_istable(L, 1)) {
+		lua_getfield(L, 1, "interval");
+		if (!lua_isnil(L, -1)) {
+			if (!lua_isnumber(L, -1) || lua_tonumber(L, -1) <= 0) {
+				diag_set(IllegalParams,
+					 "interval must be a positive number");
+				luaT_error(L);
+			}
+			interval = lua_tonumber(L, -1);
+		}
+		lua_pop(L, 1);
+		lua_getfield(L, 1, "samples");
+		if (!lua_isnil(L, -1)) {
+			if (!lua_isnumber(L, -1) || lua_tointeger(L, -1) <= 0) {
+				diag_set(IllegalParams,
+					 "samples must be a positive number");
+				luaT_error(L);
+			}
+			sample_count = lua_tointeger(L, -1);
+		}
+		lua_pop(L, 1);
+	}
+	if (fiber_prof_start(interval, sample_count) != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_fiber_profile_stop(struct lua_State *L)
+{
+	(void)L;
+	fiber_prof_stop();
+	return 0;
+}
+
+/**
+ * Add a sample to the table of samples counts by stack at the top
+ * of the Lua stack. The stack is a string in the collapsed format:
+ * the fiber name, the request type if any and the function names
+ * starting from the outermost one, all separated by semicolons.
+ */
+static int
+lbox_fiber_profile_add_sample(const struct fiber_prof_sample *sample,
+			      void *arg)
+{
+	struct lua_State *L = (struct lua_State *)arg;
+	luaL_Buffer b;
+	luaL_buffinit(L, &b);
+	luaL_addstring(&b, sample->fiber_name);
+	if (sample->request_type != NULL) {
+		luaL_addchar(&b, ';');
+		luaL_addstring(&b, sample->request_type);
+	}
+	for (int i = sample->bt.frame_count - 1; i >= 0; i--) {
+		const struct backtrace_frame *frame = &sample->bt.frames[i];
+		uintptr_t offset;
+		const char *name = backtrace_frame_resolve(frame, &offset);
+		luaL_addchar(&b, ';');
+		if (name == NULL)
+			name = tt_sprintf("%p", frame->ip);
+		luaL_addstring(&b, name);
+	}
+	luaL_pushresult(&b);
+	lua_pushvalue(L, -1);
+	lua_rawget(L, -3);
+	lua_Integer count = lua_tointeger(L, -1);
+	lua_pop(L, 1);
+	lua_pushinteger(L, count + 1);
+	lua_rawset(L, -3);
+	return 0;
+}
+
+/**
+ * Return a table mapping each collected stack to the number of its
+ * samples. It is formatted by the wrapper in fiber.lua.
+ */
+static int
+lbox_fiber_profile_dump(struct lua_State *L)
+{
+	lua_newtable(L);
+	fiber_prof_foreach(lbox_fiber_profile_add_sample, L);
+	return 1;
+}
 #endif /* ENABLE_BACKTRACE */
 
 /**
@@ -1095,6 +1196,9 @@ static const struct luaL_Reg fiberlib[] = {
 	{"parent_backtrace_disable", lbox_fiber_parent_backtrace_disable},
 	{"leak_backtrace_enable", lbox_fiber_leak_backtrace_enable},
 	{"leak_backtrace_disable", lbox_fiber_leak_backtrace_disable},
+	{"profile_start", lbox_fiber_profile_start},
+	{"profile_stop", lbox_fiber_profile_stop},
+	{"profile_dump", lbox_fiber_profile_dump},
 #endif /* ENABLE_BACKTRACE */
 	{"sleep", lbox_fiber_sleep},
 	{"yield", lbox_fiber_yield},
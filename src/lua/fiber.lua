@@ -72,6 +72,21 @@ fiber.time64 = fiber_time64
 fiber.clock = fiber_clock
 fiber.clock64 = fiber_clock64
 
+-- Formats the stacks collected by the profiler in the collapsed
+-- format accepted by flamegraph.pl: one stack per line followed by
+-- the number of its samples.
+local profile_dump = fiber.profile_dump
+if profile_dump ~= nil then
+    fiber.profile_dump = function()
+        local lines = {}
+        for stack, count in pairs(profile_dump()) do
+            table.insert(lines, stack .. ' ' .. count)
+        end
+        table.sort(lines)
+        return table.concat(lines, '\n')
+    end
+end
+
 local stall = fiber.stall
 local fiber_set_system = fiber.set_system
 local fiber_set_managed_shutdown = fiber.set_managed_shutdown
@@ -24,6 +24,14 @@ ffi.cdef[[
     extern bool
     say_logger_initialized(void);
 
+    enum say_async_overflow {
+        SAY_ASYNC_DROP,
+        SAY_ASYNC_BLOCK
+    };
+
+    int
+    say_set_log_async(bool enabled, enum say_async_overflow overflow);
+
     extern void
     say_from_lua(int level, const char *module, const char *filename, int line,
                  const char *format, ...);
@@ -97,6 +105,12 @@ local fmt_str2num = {
     ["json"]            = ffi.C.SF_JSON,
 }
 
+-- Map async overflow mode string to number.
+local async_overflow_str2num = {
+    ["drop"]            = ffi.C.SAY_ASYNC_DROP,
+    ["block"]           = ffi.C.SAY_ASYNC_BLOCK,
+}
+
 -- Logging levels symbolic representation.
 local log_level_keys = {
     ['fatal']       = ffi.C.S_FATAL,
@@ -125,6 +139,8 @@ local default_cfg = {
     level           = S_INFO,
     modules         = nil,
     format          = fmt_num2str[ffi.C.SF_PLAIN],
+    async           = false,
+    async_overflow  = 'drop',
 }
 
 local log_cfg = table.copy(default_cfg)
@@ -138,6 +154,8 @@ local log2box_keys = {
     ['level']           = 'log_level',
     ['modules']         = 'log_modules',
     ['format']          = 'log_format',
+    ['async']           = 'log_async',
+    ['async_overflow']  = 'log_async_overflow',
 }
 
 -- Return level as a number, level must be valid.
@@ -262,6 +280,8 @@ local option_types = {
     level = 'number, string',
     modules = 'table',
     format = 'string',
+    async = 'boolean',
+    async_overflow = 'string',
 }
 
 local log_initialized = false
@@ -318,6 +338,12 @@ local function log_check_cfg(cfg)
     log_check_level(cfg.level, 'log_level')
     log_check_modules(cfg.modules)
 
+    if cfg.async_overflow ~= nil and
+       async_overflow_str2num[cfg.async_overflow] == nil then
+        box.error(box.error.CFG, 'log_async_overflow',
+                  "expected 'drop' or 'block'")
+    end
+
     if log_initialized then
         if log_cfg.log ~= cfg.log then
             box.error(box.error.RELOAD_CFG, 'log');
@@ -388,6 +414,11 @@ local function log_configure(self, cfg, box_api)
     ffi.C.say_logger_init(cfg_C.log, cfg_C.level,
                           cfg_C.nonblock, cfg_C.format)
     log_initialized = true
+    local async_overflow = async_overflow_str2num[cfg.async_overflow or
+                                                  default_cfg.async_overflow]
+    if ffi.C.say_set_log_async(cfg.async == true, async_overflow) ~= 0 then
+        box.error()
+    end
 
     for o in pairs(option_types) do
         log_cfg[o] = cfg[o]
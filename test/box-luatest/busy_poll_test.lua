@@ -0,0 +1,49 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_busy_poll = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.busy_poll_timeout, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'busy_poll_timeout': " ..
+            "the value must be >= 0",
+            box.cfg, {busy_poll_timeout = -1})
+
+        box.stat.reset()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local stat = box.stat.cbus()
+        t.assert_equals(stat.POLL_HITS.total, 0)
+        t.assert_equals(stat.POLL_MISSES.total, 0)
+
+        -- A WAL write is a round trip from tx to the WAL thread,
+        -- which tx waits for busy polling.
+        box.cfg{busy_poll_timeout = 0.01}
+        for i = 1, 100 do
+            s:replace({i})
+        end
+        t.assert_gt(box.stat.cbus().POLL_HITS.total, 0)
+        box.cfg{busy_poll_timeout = 0}
+        t.assert_equals(s:count(), 100)
+
+        box.stat.reset()
+        for i = 1, 10 do
+            s:replace({i})
+        end
+        stat = box.stat.cbus()
+        t.assert_equals(stat.POLL_HITS.total, 0)
+        t.assert_equals(stat.POLL_MISSES.total, 0)
+        s:drop()
+    end)
+end
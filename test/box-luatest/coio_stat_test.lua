@@ -0,0 +1,40 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_coio_stat = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        box.stat.reset()
+        local stat = box.stat.coio()
+        for _, class in ipairs({'interactive', 'default', 'bulk'}) do
+            t.assert_equals(stat[class].queue, 0)
+            t.assert_equals(stat[class].count, 0)
+        end
+
+        local dir = fio.tempdir()
+        local path = fio.pathjoin(dir, 'file')
+        local f = fio.open(path, {'O_CREAT', 'O_WRONLY'}, tonumber('644', 8))
+        f:write('data')
+        f:close()
+        t.assert(fio.copyfile(path, path .. '.copy'))
+        fio.rmtree(dir)
+
+        stat = box.stat.coio()
+        t.assert_ge(stat.interactive.count, 4)
+        t.assert_gt(stat.interactive.latency.p99, 0)
+        t.assert_equals(stat.interactive.queue, 0)
+        t.assert_equals(stat.bulk.count, 1)
+        t.assert_equals(stat.bulk.queue, 0)
+    end)
+end
@@ -1078,3 +1078,37 @@ g.test_downgrade_drop_gc_consumers = function(cg)
         end
     end)
 end
+
+-----------------------------
+-- Check downgrade from 3.5.0
+-----------------------------
+
+g.test_downgrade_drop_sql_stat = function(cg)
+    cg.server:exec(function()
+        local helper = require('test.box-luatest.downgrade_helper')
+        local space_id = box.schema.SQL_STAT_ID
+
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert{1}
+        s:analyze()
+        t.assert_not_equals(box.space._sql_stat, nil)
+        t.assert_equals(#box.space._sql_stat:select{}, 1)
+
+        -- Statistics are only a hint for the planner so there are no
+        -- downgrade issues and the space is dropped along with them.
+        local prev_version = helper.prev_version('3.5.0')
+        t.assert_equals(box.schema.downgrade_issues(prev_version), {})
+        t.assert_not_equals(box.space._sql_stat, nil)
+
+        -- Test 2 times for idempotence.
+        for _ = 1, 2 do
+            box.schema.downgrade(prev_version)
+            t.assert_equals(box.space._sql_stat, nil)
+            t.assert_equals(box.space._index:select{space_id}, {})
+        end
+
+        -- The planner works without statistics.
+        t.assert_equals(box.execute([[SELECT * FROM "test";]]).rows, {{1}})
+    end)
+end
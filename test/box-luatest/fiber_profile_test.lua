@@ -0,0 +1,89 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        t.skip_if(require('fiber').profile_start == nil,
+                  'requires backtrace feature')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.func.create('burn')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+        box.schema.user.grant('guest', 'execute', 'function', 'burn')
+        rawset(_G, 'burn', function(seconds)
+            local clock = require('clock')
+            local deadline = clock.proc() + seconds
+            while clock.proc() < deadline do
+                box.space.test:replace({1})
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        require('fiber').profile_stop()
+    end)
+end)
+
+g.test_profile = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        t.assert_error_msg_equals(
+            'interval must be a positive number',
+            fiber.profile_start, {interval = 0})
+        t.assert_error_msg_equals(
+            'samples must be a positive number',
+            fiber.profile_start, {samples = -1})
+        t.assert_equals(fiber.profile_dump(), '')
+
+        fiber.profile_start({interval = 0.001})
+        t.assert_error_msg_equals('the profiler is already running',
+                                  fiber.profile_start)
+    end)
+    cg.server.net_box:call('burn', {0.5})
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        fiber.profile_stop()
+        -- Stopping twice is fine.
+        fiber.profile_stop()
+        local dump = fiber.profile_dump()
+        local total = 0
+        local found = false
+        for line in dump:gmatch('[^\n]+') do
+            local stack, count = line:match('^(.+) (%d+)$')
+            t.assert(stack, line)
+            total = total + tonumber(count)
+            if stack:find('^[^;]+;CALL;') then
+                found = true
+            end
+        end
+        t.assert_gt(total, 0)
+        t.assert(found, dump)
+        -- The samples are kept after stop.
+        t.assert_equals(fiber.profile_dump(), dump)
+    end)
+end
+
+-- Only the most recent samples are kept.
+g.test_samples = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        fiber.profile_start({interval = 0.001, samples = 10})
+        _G.burn(0.5)
+        fiber.profile_stop()
+        local total = 0
+        for line in fiber.profile_dump():gmatch('[^\n]+') do
+            total = total + tonumber(line:match(' (%d+)$'))
+        end
+        t.assert_equals(total, 10)
+    end)
+end
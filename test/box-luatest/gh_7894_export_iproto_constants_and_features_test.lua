@@ -71,6 +71,7 @@ local reference_table = {
         SQL_BIND = 0x41,
         SQL_INFO = 0x42,
         STMT_ID = 0x43,
+        SQL_ARROW = 0x44,
         REPLICA_ANON = 0x50,
         ID_FILTER = 0x51,
         ERROR = 0x52,
@@ -173,7 +174,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 10,
+    protocol_version = 11,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -190,6 +191,7 @@ local reference_table = {
         fetch_snapshot_cursor = is_enterprise and true or nil,
         is_sync = true,
         insert_arrow = true,
+        sql_arrow = true,
     },
     feature = {
         streams = 0,
@@ -205,6 +207,7 @@ local reference_table = {
         fetch_snapshot_cursor = 10,
         is_sync = 11,
         insert_arrow = 12,
+        sql_arrow = 13,
     },
 }
 
@@ -0,0 +1,117 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+        box.stat.reset()
+    end)
+end)
+
+g.test_space = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 10 do
+            s:insert({i})
+        end
+        s:replace({1, 1})
+        s:update({1}, {{'=', 2, 2}})
+        s:upsert({11}, {{'=', 2, 2}})
+        s:delete({2})
+        s:get({1})
+        s:select()
+
+        local stat = box.stat.latency().spaces.test
+        t.assert_equals(stat.INSERT.count, 10)
+        t.assert_equals(stat.REPLACE.count, 1)
+        t.assert_equals(stat.UPDATE.count, 1)
+        t.assert_equals(stat.UPSERT.count, 1)
+        t.assert_equals(stat.DELETE.count, 1)
+        t.assert_equals(stat.SELECT.count, 2)
+        for _, v in pairs(stat) do
+            t.assert_le(v.p50, v.p99)
+            t.assert_le(v.p99, v.p999)
+        end
+
+        -- The statistics survive alter.
+        s:format({{'id', 'unsigned'}})
+        t.assert_equals(box.stat.latency().spaces.test.INSERT.count, 10)
+
+        box.stat.reset()
+        t.assert_equals(box.stat.latency().spaces.test, {})
+    end)
+end
+
+g.test_requests = function(cg)
+    local conn = cg.server.net_box
+    for i = 1, 5 do
+        conn.space.test:insert({i})
+    end
+    cg.server:exec(function()
+        local stat = box.stat.latency().requests
+        t.assert_equals(stat.INSERT.count, 5)
+        t.assert_gt(stat.INSERT.p50, 0)
+        t.assert_le(stat.INSERT.p50, stat.INSERT.p999)
+        t.assert_equals(stat.REPLACE, nil)
+    end)
+end
+
+-- A before_replace trigger returning the old tuple turns the request
+-- into NOP, it is accounted to the original request type.
+g.test_before_replace_nop = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1})
+        local trigger = s:before_replace(function(old) return old end)
+        s:replace({1, 1})
+        s:insert({2})
+        s:before_replace(nil, trigger)
+        t.assert_equals(s:select(), {{1}})
+
+        local stat = box.stat.latency().spaces.test
+        t.assert_equals(stat.INSERT.count, 2)
+        t.assert_equals(stat.REPLACE.count, 1)
+        t.assert_equals(stat.NOP, nil)
+    end)
+end
+
+-- MP_EXT of type MP_ARROW, column 'a', value 0.
+local mp_arrow_hex = [[
+    c8011008ffffffff70000000040000009effffff0400010004000000b6ffffff0c0000000400
+    0000000000000100000004000000daffffff140000000202000004000000f0ffffff40000000
+    01000000610000000600080004000c0010000400080009000c000c000c000000040000000800
+    0a000c00040006000800ffffffff88000000040000008affffff040003001000000008000000
+    0000000000000000acffffff0100000000000000340000000800000000000000020000000000
+    0000000000000000000000000000000000000000000008000000000000000000000001000000
+    010000000000000000000000000000000a00140004000c0010000c0014000400060008000c00
+    00000000000000000000
+]]
+
+-- Arrow inserts are not accounted per space.
+g.test_insert_arrow = function(cg)
+    cg.server:exec(function(mp_arrow_hex)
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        local arrow = msgpack.decode(
+            string.fromhex((mp_arrow_hex:gsub('%s+', ''))))
+        t.assert_error_msg_equals("memtx does not support arrow format",
+                                  s.insert_arrow, s, arrow)
+        t.assert_equals(box.stat.latency().spaces.test or {}, {})
+    end, {mp_arrow_hex})
+end
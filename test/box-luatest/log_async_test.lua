@@ -0,0 +1,94 @@
+local fio = require('fio')
+local popen = require('popen')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{log_async = false, log_async_overflow = 'drop'}
+    end)
+end)
+
+g.test_async = function(cg)
+    cg.server:exec(function()
+        local log = require('log')
+        t.assert_equals(box.cfg.log_async, false)
+        t.assert_equals(box.cfg.log_async_overflow, 'drop')
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'log_async_overflow': " ..
+            "expected 'drop' or 'block'",
+            box.cfg, {log_async_overflow = 'wait'})
+
+        box.cfg{log_async = true}
+        t.assert_equals(log.cfg.async, true)
+        log.info('async line 1')
+        log.cfg{async_overflow = 'block'}
+        t.assert_equals(box.cfg.log_async_overflow, 'block')
+        log.info('async line 2')
+    end)
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log('async line 1'))
+        t.assert(cg.server:grep_log('async line 2'))
+    end)
+end
+
+-- Lines that don't fit the buffer are dropped, and the number of
+-- dropped lines is reported in the log.
+g.test_drop = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local log = require('log')
+        box.cfg{log_async = true}
+        box.error.injection.set('ERRINJ_LOG_ASYNC_DELAY', true)
+        local line = string.rep('x', 1000)
+        for _ = 1, 2000 do
+            log.info(line)
+        end
+        box.error.injection.set('ERRINJ_LOG_ASYNC_DELAY', false)
+        -- Stopping the log thread writes out the buffer.
+        box.cfg{log_async = false}
+    end)
+    t.assert(cg.server:grep_log('[0-9]+ log lines were dropped because ' ..
+                                'the log buffer was full'))
+end
+
+-- The log thread is started by box.cfg before the process forks to
+-- go to the background, so the child must restart it.
+g.test_background = function()
+    local dir = fio.tempdir()
+    local log_path = fio.pathjoin(dir, 'tarantool.log')
+    local pid_path = fio.pathjoin(dir, 'tarantool.pid')
+    local script = string.format([[
+        box.cfg{background = true, work_dir = %q, log = %q,
+                pid_file = %q, log_async = true,
+                log_async_overflow = 'block'}
+        for i = 1, 10000 do
+            require('log').info('background line %%d', i)
+        end
+    ]], dir, log_path, pid_path)
+    local ph = popen.new({arg[-1], '-e', script})
+    t.assert_equals(ph:wait().exit_code, 0)
+    ph:close()
+    local s = server:new({alias = 'background'})
+    t.helpers.retrying({}, function()
+        t.assert(s:grep_log('background line 10000', nil,
+                            {filename = log_path}))
+    end)
+    local pid = tonumber(fio.open(pid_path):read())
+    t.assert_equals(os.execute('kill ' .. pid), 0)
+    t.helpers.retrying({}, function()
+        t.assert_not(fio.path.exists(pid_path))
+    end)
+    fio.rmtree(dir)
+end
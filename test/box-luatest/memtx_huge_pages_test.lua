@@ -0,0 +1,84 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local HUGE_PAGE_SIZE = 2 * 1024 * 1024
+local MEMTX_MEMORY = 32 * 1024 * 1024
+
+-- Returns the number of free pages in the 2M hugetlb pool.
+local function free_huge_pages()
+    local f = io.open('/sys/kernel/mm/hugepages/hugepages-2048kB/' ..
+                      'free_hugepages')
+    if f == nil then
+        return 0
+    end
+    local count = f:read('*n')
+    f:close()
+    return count or 0
+end
+
+g.before_all(function(cg)
+    -- The pool is checked before the server reserves its pages.
+    cg.huge_pages_available =
+        free_huge_pages() >= MEMTX_MEMORY / HUGE_PAGE_SIZE
+    cg.server = server:new({
+        box_cfg = {
+            memtx_memory = MEMTX_MEMORY,
+            memtx_huge_pages = '2M',
+            memtx_mlock = true,
+            memtx_prefault = true,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_dynamic = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_huge_pages, '2M')
+        t.assert_equals(box.cfg.memtx_mlock, true)
+        t.assert_equals(box.cfg.memtx_prefault, true)
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_huge_pages' dynamically",
+            box.cfg, {memtx_huge_pages = 'off'})
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_mlock' dynamically",
+            box.cfg, {memtx_mlock = false})
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_prefault' dynamically",
+            box.cfg, {memtx_prefault = false})
+    end)
+end
+
+g.test_huge_pages = function(cg)
+    t.skip_if(not cg.huge_pages_available,
+              'the 2M hugetlb pool is not available')
+    cg.server:exec(function(huge_page_size, memtx_memory)
+        local info = box.slab.info()
+        t.assert_equals(info.arena_huge_fallback, false)
+        -- Only the part of the arena aligned to the huge page size is
+        -- remapped.
+        t.assert_equals(info.arena_huge_size % huge_page_size, 0)
+        t.assert_gt(info.arena_huge_size,
+                    memtx_memory - 2 * huge_page_size)
+    end, {HUGE_PAGE_SIZE, MEMTX_MEMORY})
+end
+
+g.test_off = function()
+    local s = server:new()
+    s:start()
+    s:exec(function()
+        t.assert_equals(box.cfg.memtx_huge_pages, 'off')
+        t.assert_equals(box.cfg.memtx_mlock, false)
+        t.assert_equals(box.cfg.memtx_prefault, false)
+        local info = box.slab.info()
+        t.assert_equals(info.arena_huge_size, nil)
+        t.assert_equals(info.arena_huge_fallback, nil)
+        t.assert_equals(info.arena_locked_size, nil)
+    end)
+    s:drop()
+end
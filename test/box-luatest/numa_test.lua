@@ -0,0 +1,47 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {numa_policy = 'interleave', numa_nodes = '0'},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_numa = function(cg)
+    local f = io.open('/proc/self/numa_maps')
+    t.skip_if(f == nil, 'the kernel is built without NUMA support')
+    f:close()
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.numa_policy, 'interleave')
+        t.assert_equals(box.cfg.numa_nodes, '0')
+        t.assert_error_msg_equals(
+            "Can't set option 'numa_policy' dynamically",
+            box.cfg, {numa_policy = 'local'})
+
+        -- The policy is set with mbind(2) on the arena only, so it is
+        -- the only mapping interleaved over node 0, and all its pages
+        -- are resident on node 0.
+        local f = io.open('/proc/self/numa_maps')
+        local maps = f:read('*a')
+        f:close()
+        local pages = 0
+        for line in maps:gmatch('[^\n]+') do
+            if line:match('^%x+ interleave:0 ') then
+                t.assert_not(line:match(' N[1-9]%d*='), line)
+                pages = pages + tonumber(line:match(' N0=(%d+)') or 0)
+            end
+        end
+        t.assert_gt(pages, 0)
+
+        local used = box.slab.info().arena_numa_used
+        t.assert_gt(used[0], 0)
+        t.assert_equals(used, {[0] = used[0]})
+    end)
+end
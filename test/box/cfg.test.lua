@@ -176,3 +176,19 @@ test_run:cmd("start server cfg_tester9")
 test_run:wait_log('cfg_tester9', version_warning, nil, 1.0) == nil
 test_run:cmd("stop server cfg_tester9")
 test_run:cmd("cleanup server cfg_tester9")
+
+--
+-- Invalid values of the options that can be set only at startup are
+-- rejected by the first box.cfg() call.
+--
+test_run:cmd('create server cfg_tester10 with script = "box/lua/cfg_invalid.lua"')
+opts = {filename = 'cfg_invalid.log'}
+test_run:cmd('start server cfg_tester10 with args="numa_policy remote" with crash_expected=True')
+test_run:grep_log('cfg_tester10', "Incorrect value for option 'numa_policy': expected 'default', 'local', 'interleave' or 'bind'", nil, opts) ~= nil
+test_run:cmd('start server cfg_tester10 with args="numa_nodes 0-" with crash_expected=True')
+test_run:grep_log('cfg_tester10', "Incorrect value for option 'numa_nodes': invalid NUMA node list '0%-'", nil, opts) ~= nil
+test_run:cmd('start server cfg_tester10 with args="numa_policy bind" with crash_expected=True')
+test_run:grep_log('cfg_tester10', "Incorrect value for option 'numa_nodes': the nodes must be set for the 'bind' policy", nil, opts) ~= nil
+test_run:cmd('start server cfg_tester10 with args="memtx_huge_pages 4K" with crash_expected=True')
+test_run:grep_log('cfg_tester10', "Incorrect value for option 'memtx_huge_pages': expected 'off', 'transparent', '2M' or '1G'", nil, opts) ~= nil
+test_run:cmd("cleanup server cfg_tester10")
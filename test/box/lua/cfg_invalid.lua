@@ -0,0 +1,11 @@
+#!/usr/bin/env tarantool
+local os = require('os')
+
+-- The option and its value are passed in the arguments.
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    [arg[1]]            = arg[2],
+}
+
+require('console').listen(os.getenv('ADMIN'))
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
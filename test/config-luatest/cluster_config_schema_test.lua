@@ -214,6 +214,7 @@ end
 g.test_defaults = function()
     local exp = {
         fiber = {
+            busy_poll_timeout = 0,
             io_collect_interval = box.NULL,
             too_long_threshold = 0.5,
             worker_pool_threads = 4,
@@ -252,6 +253,8 @@ g.test_defaults = function()
             nonblock = false,
             level = 5,
             format = 'plain',
+            async = false,
+            async_overflow = 'drop',
         },
         snapshot = {
             dir = 'var/lib/{{ instance_name }}',
@@ -278,6 +281,8 @@ g.test_defaults = function()
             username = box.NULL,
             work_dir = box.NULL,
             pid_file = 'var/run/{{ instance_name }}/tarantool.pid',
+            numa_policy = 'default',
+            numa_nodes = box.NULL,
         },
         vinyl = {
             dir = 'var/lib/{{ instance_name }}',
@@ -293,6 +298,8 @@ g.test_defaults = function()
             defer_deletes = false,
             memory = 134217728,
             timeout = 60,
+            dump_io_rate_limit = box.NULL,
+            compaction_io_rate_limit = box.NULL,
         },
         quiver = is_enterprise and {
             dir = 'var/lib/{{ instance_name }}',
@@ -347,6 +354,9 @@ g.test_defaults = function()
         memtx = {
             memory = 268435456,
             allocator = 'small',
+            huge_pages = 'off',
+            mlock = false,
+            prefault = false,
             slab_alloc_granularity = 8,
             slab_alloc_factor = 1.05,
             min_tuple_size = 16,
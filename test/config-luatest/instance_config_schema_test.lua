@@ -195,6 +195,8 @@ g.test_process = function()
             username = 'two',
             work_dir = 'three',
             pid_file = 'four',
+            numa_policy = 'interleave',
+            numa_nodes = '0-1',
         },
     }
     instance_config:validate(iconfig)
@@ -208,6 +210,8 @@ g.test_process = function()
         username = box.NULL,
         work_dir = box.NULL,
         pid_file = 'var/run/{{ instance_name }}/tarantool.pid',
+        numa_policy = 'default',
+        numa_nodes = box.NULL,
     }
     local res = instance_config:apply_default({}).process
     t.assert_equals(res, exp)
@@ -234,6 +238,7 @@ end
 g.test_fiber = function()
     local iconfig = {
         fiber = {
+            busy_poll_timeout = 0.0001,
             io_collect_interval = 1,
             too_long_threshold = 1,
             worker_pool_threads = 1,
@@ -251,6 +256,7 @@ g.test_fiber = function()
     validate_fields(iconfig.fiber, instance_config.schema.fields.fiber)
 
     local exp = {
+        busy_poll_timeout = 0,
         io_collect_interval = box.NULL,
         too_long_threshold = 0.5,
         worker_pool_threads = 4,
@@ -281,6 +287,8 @@ g.test_log = function()
             nonblock = true,
             level = 'debug',
             format = 'json',
+            async = true,
+            async_overflow = 'block',
             modules = {
                 seven = 'debug',
             },
@@ -319,6 +327,8 @@ g.test_log = function()
         nonblock = false,
         level = 5,
         format = 'plain',
+        async = false,
+        async_overflow = 'drop',
     }
     local res = instance_config:apply_default({}).log
     t.assert_equals(res, exp)
@@ -983,6 +993,9 @@ g.test_memtx = function()
         memtx = {
             memory = 1,
             allocator = 'small',
+            huge_pages = '2M',
+            mlock = true,
+            prefault = true,
             slab_alloc_granularity = 1,
             slab_alloc_factor = 1,
             min_tuple_size = 1,
@@ -997,6 +1010,9 @@ g.test_memtx = function()
     local exp = {
         memory = 268435456,
         allocator = 'small',
+        huge_pages = 'off',
+        mlock = false,
+        prefault = false,
         slab_alloc_granularity = 8,
         slab_alloc_factor = 1.05,
         min_tuple_size = 16,
@@ -1024,6 +1040,8 @@ g.test_vinyl = function()
             defer_deletes = true,
             memory = 11,
             timeout = 5.5,
+            dump_io_rate_limit = 10.5,
+            compaction_io_rate_limit = 20.5,
         },
     }
     instance_config:validate(iconfig)
@@ -1043,6 +1061,8 @@ g.test_vinyl = function()
         defer_deletes = false,
         memory = 134217728,
         timeout = 60,
+        dump_io_rate_limit = box.NULL,
+        compaction_io_rate_limit = box.NULL,
     }
     local res = instance_config:apply_default({}).vinyl
     t.assert_equals(res, exp)
@@ -0,0 +1,95 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.execute([[DROP TABLE IF EXISTS "t";]])
+    end)
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "a" INT,
+                                        "b" INT);]])
+        box.execute([[CREATE INDEX "ab" ON "t" ("a", "b");]])
+        local s = box.space.t
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, i % 10, i % 100})
+        end
+        box.commit()
+        s:analyze()
+        local stat = box.space._sql_stat:get({s.id, 0})
+        t.assert_equals(stat.tuple_count, 1000)
+        t.assert_equals(stat.distinct, {1000})
+        t.assert_equals(#stat.bounds, 31)
+        stat = box.space._sql_stat:get({s.id, 1})
+        t.assert_equals(stat.tuple_count, 1000)
+        t.assert_equals(stat.distinct, {10, 100})
+        t.assert_equals(#stat.bounds, 31)
+        for i = 2, #stat.bounds do
+            t.assert_le(stat.bounds[i - 1][1], stat.bounds[i][1])
+        end
+
+        -- Statistics are dropped along with the index or space.
+        box.execute([[DROP INDEX "ab" ON "t";]])
+        t.assert_equals(box.space._sql_stat:get({s.id, 1}), nil)
+        t.assert_not_equals(box.space._sql_stat:get({s.id, 0}), nil)
+        box.execute([[DROP TABLE "t";]])
+        t.assert_equals(box.space._sql_stat:select({s.id}), {})
+    end)
+end
+
+g.test_read_only = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY);]])
+        box.space.t:insert({1})
+        -- _sql_stat is local so statistics can be collected on
+        -- a read-only replica.
+        box.cfg{read_only = true}
+        local ok, err = pcall(box.space.t.analyze, box.space.t)
+        box.cfg{read_only = false}
+        t.assert(ok, err)
+        local stat = box.space._sql_stat:get({box.space.t.id, 0})
+        t.assert_equals(stat.tuple_count, 1)
+    end)
+end
+
+g.test_planner = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "a" INT,
+                                        "b" INT);]])
+        box.execute([[CREATE INDEX "ia" ON "t" ("a");]])
+        box.execute([[CREATE INDEX "ib" ON "t" ("b");]])
+        local s = box.space.t
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, i % 2, i})
+        end
+        box.commit()
+        local sql = [[EXPLAIN QUERY PLAN
+                      SELECT * FROM "t" WHERE "a" = 1 AND "b" < 100;]]
+        local function plan()
+            return box.execute(sql).rows[1][4]
+        end
+        -- Without statistics an equality looks more selective.
+        t.assert_str_contains(plan(), 'INDEX ia ')
+        -- In fact, "a" has only two distinct values.
+        s:analyze()
+        t.assert_str_contains(plan(), 'INDEX ib ')
+        t.assert_equals(box.execute([[SELECT COUNT(*) FROM "t"
+                                      WHERE "a" = 1 AND "b" < 100;]]).rows,
+                        {{50}})
+    end)
+end
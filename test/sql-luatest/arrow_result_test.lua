@@ -0,0 +1,102 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "u" UNSIGNED,
+                                        "d" DOUBLE, "b" BOOLEAN,
+                                        "s" STRING, "v" VARBINARY,
+                                        "n" NUMBER);]])
+        local varbinary = require('varbinary')
+        box.begin()
+        for k = 1, 1000 do
+            local s = k % 7 == 0 and box.NULL or tostring(k)
+            local v = varbinary.new(string.char(k % 256))
+            box.space.t:insert({k, k * 2, k + 0.5, k % 2 == 0, s, v, k})
+        end
+        box.commit()
+        box.schema.user.grant('guest', 'super')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        rawset(_G, 'conn', net.connect(box.cfg.listen))
+        _G.conn:execute([[SET SESSION "sql_seq_scan" = true;]])
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        _G.conn:close()
+    end)
+end)
+
+-- Check that the result set is returned as an Arrow IPC stream
+-- along with the same metadata as the result set in rows.
+local function check(cg, sql, params)
+    cg.server:exec(function(sql, params)
+        local msgpack = require('msgpack')
+        local conn = _G.conn
+        local expected = conn:execute(sql, params)
+        local res = conn:execute(sql, params, {arrow = true})
+        t.assert_equals(res.rows, nil, sql)
+        t.assert_equals(res.metadata, expected.metadata, sql)
+        t.assert_type(res.arrow, 'string', sql)
+        for _, column in ipairs(res.metadata) do
+            t.assert_str_contains(res.arrow, column.name, false, sql)
+        end
+        -- MP_ARROW is validated when it is decoded.
+        local mp = string.fromhex(string.format('c9%08x08', #res.arrow)) ..
+                   res.arrow
+        t.assert_equals(msgpack.decode(mp), res.arrow, sql)
+    end, {sql, params})
+end
+
+g.test_arrow = function(cg)
+    check(cg, [[SELECT "id", "u", "d", "b", "s", "v" FROM "t";]])
+    check(cg, [[SELECT "id", "s" FROM "t" WHERE "id" > ?;]], {500})
+    check(cg, [[SELECT "s", COUNT(*) FROM "t" GROUP BY "s";]])
+    check(cg, [[SELECT "id" FROM "t" WHERE "id" < 0;]])
+end
+
+g.test_not_dql = function(cg)
+    cg.server:exec(function()
+        local conn = _G.conn
+        local res = conn:execute([[CREATE TABLE "c" ("id" INT PRIMARY KEY);]],
+                                 nil, {arrow = true})
+        t.assert_equals(res, {row_count = 1})
+        res = conn:execute([[INSERT INTO "c" VALUES (1), (2);]], nil,
+                           {arrow = true})
+        t.assert_equals(res, {row_count = 2})
+        conn:execute([[DROP TABLE "c";]])
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local conn = _G.conn
+        t.assert_error_msg_equals(
+            "Arrow format does not support column type 'number'",
+            conn.execute, conn, [[SELECT "id", "n" FROM "t";]], nil,
+            {arrow = true})
+        t.assert_error_msg_equals(
+            "options parameter 'arrow' should be of type boolean",
+            conn.execute, conn, [[SELECT 1;]], nil, {arrow = 1})
+        t.assert_error_msg_equals(
+            "unexpected option 'dry_run'",
+            conn.execute, conn, [[SELECT 1;]], nil, {dry_run = true})
+        -- The connection is still usable.
+        t.assert_equals(conn:execute([[SELECT 1;]]).rows, {{1}})
+    end)
+end
@@ -0,0 +1,87 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "i" INT);]])
+        box.begin()
+        for k = 1, 100 do
+            box.space.t:insert({k, k % 10})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_explain_analyze = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT "id" FROM "t" WHERE "id" > 10 AND "i" = 3;]]
+        local res = box.execute('EXPLAIN ANALYZE ' .. sql)
+        local names = {}
+        for _, column in ipairs(res.metadata) do
+            table.insert(names, column.name)
+        end
+        t.assert_equals(names, {'addr', 'opcode', 'p1', 'p2', 'p3', 'p4',
+                                'count', 'time'})
+        local plain = box.execute('EXPLAIN ' .. sql)
+        t.assert_equals(#res.rows, #plain.rows)
+        local count = {}
+        for k, row in ipairs(res.rows) do
+            t.assert_equals(row[1], plain.rows[k][1])
+            t.assert_equals(row[2], plain.rows[k][2])
+            t.assert_ge(row[8], 0)
+            count[row[2]] = (count[row[2]] or 0) + row[7]
+        end
+        t.assert_equals(count['Init'], 1)
+        t.assert_equals(count['ResultRow'], #box.execute(sql).rows)
+        t.assert_equals(count['ResultRow'], 9)
+        t.assert_equals(count['Next'], 90)
+
+        -- The statistics are collected anew on each run.
+        local s = box.prepare('EXPLAIN ANALYZE ' .. sql)
+        t.assert_equals(s:execute().rows[1][7], 1)
+        t.assert_equals(s:execute().rows[1][7], 1)
+        s:unprepare()
+    end)
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "c" ("id" INT PRIMARY KEY);]])
+        local res = box.execute([[EXPLAIN ANALYZE
+                                  INSERT INTO "c" VALUES (1), (2);]])
+        t.assert_not_equals(#res.rows, 0)
+        t.assert_equals(box.space.c:select(), {{1}, {2}})
+        local _, err = box.execute([[EXPLAIN ANALYZE
+                                     INSERT INTO "c" VALUES (3), (1);]])
+        t.assert_str_contains(err.message, 'Duplicate key exists')
+        t.assert_equals(box.space.c:select(), {{1}, {2}})
+        box.execute([[DROP TABLE "c";]])
+    end)
+end
+
+-- A sampled run of a statement that takes more than
+-- too_long_threshold is logged with its hottest instructions.
+g.test_profile = function(cg)
+    cg.server:exec(function()
+        local threshold = box.cfg.too_long_threshold
+        box.cfg{too_long_threshold = 0}
+        box.execute([[SET SESSION "sql_profile" = true;]])
+        for _ = 1, 100 do
+            box.execute([[SELECT COUNT(*) FROM "t" WHERE "i" = 5;]])
+        end
+        box.execute([[SET SESSION "sql_profile" = false;]])
+        box.cfg{too_long_threshold = threshold}
+    end)
+    t.assert(cg.server:grep_log('too long SQL statement: [0-9.]+ sec: ' ..
+                                'SELECT COUNT'))
+    t.assert(cg.server:grep_log('  [0-9]+ [A-Za-z]+: [0-9]+ times'))
+end
@@ -0,0 +1,92 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "l" ("id" INT PRIMARY KEY, "i" INT,
+                                        "s" STRING COLLATE "unicode_ci",
+                                        "d" DOUBLE);]])
+        box.execute([[CREATE TABLE "r" ("id" INT PRIMARY KEY, "i" INT,
+                                        "s" STRING COLLATE "unicode_ci",
+                                        "d" DOUBLE, "n" NUMBER);]])
+        local letters = {'a', 'B', 'c', 'D'}
+        box.begin()
+        for k = 1, 300 do
+            local i = k % 13 == 0 and box.NULL or k % 600 - 50
+            local s = letters[k % 4 + 1]:upper() .. k % 50
+            box.space.l:insert({k, i, s, k / 2})
+        end
+        for k = 1, 10240 do
+            local i = k % 17 == 0 and box.NULL or k % 500
+            local s = letters[k % 4 + 1] .. k % 50
+            box.space.r:insert({k, i, s, k % 300 / 2, k % 100})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that the join is done by a hash join and yields the same
+-- result as nested loops over full scans.
+local function check(cg, on, join, plan)
+    cg.server:exec(function(on, join, plan)
+        local function sql(l, r)
+            return 'SELECT "l"."id", "r"."id", "r"."d" FROM "l"' .. l ..
+                   ' ' .. join .. ' "r"' .. r .. ' ON ' .. on ..
+                   ' ORDER BY 1, 2'
+        end
+        local q = sql('', '')
+        local details = {}
+        for _, row in ipairs(box.execute('EXPLAIN QUERY PLAN ' .. q).rows) do
+            table.insert(details, row[4])
+        end
+        t.assert_str_contains(table.concat(details, '\n'), plan, false, q)
+        local expected = box.execute(sql(' NOT INDEXED', ' NOT INDEXED'))
+        local res = box.execute(q)
+        t.assert_equals(res.rows, expected.rows, q)
+        t.assert_not_equals(#res.rows, 0, q)
+    end, {on, join or 'JOIN', plan or 'HASH JOIN'})
+end
+
+local function check_all(cg)
+    check(cg, '"l"."i" = "r"."i"')
+    check(cg, '"l"."s" = "r"."s"')
+    check(cg, '"l"."d" = "r"."d"')
+    check(cg, '"l"."i" = "r"."d"')
+    check(cg, '"l"."i" = "r"."i" AND "r"."s" = "l"."s"')
+    check(cg, '"l"."i" = "r"."i" AND "r"."d" > 10')
+    check(cg, '"l"."i" = "r"."i"', 'LEFT JOIN')
+end
+
+g.test_hash_join = function(cg)
+    check_all(cg)
+end
+
+-- Numbers of different types can be equal in spite of different
+-- encodings, so such keys are left to the tree ephemeral index.
+g.test_not_hashable = function(cg)
+    check(cg, '"l"."i" = "r"."n"', 'JOIN', 'EPHEMERAL INDEX')
+    check(cg, '"l"."i" = "r"."n" AND "l"."i" = "r"."i"', 'JOIN',
+          'HASH JOIN (i=?)')
+end
+
+g.test_spill = function(cg)
+    t.tarantool.skip_if_not_debug()
+    for _, size in ipairs({0, 4096}) do
+        cg.server:exec(function(size)
+            box.error.injection.set('ERRINJ_SQL_HASH_JOIN_MEMORY', size)
+        end, {size})
+        check_all(cg)
+    end
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_SQL_HASH_JOIN_MEMORY', -1)
+    end)
+end
@@ -0,0 +1,179 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "i" INT,
+                                        "s" STRING);]])
+        box.execute([[CREATE INDEX "i" ON "t" ("i");]])
+        local s = box.space.t
+        box.begin()
+        for k = 1, 1000 do
+            local i = k <= 900 and k % 3 or k
+            s:insert({k, i, tostring(k % 7)})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that the statement yields the same result with the plan
+-- cache as without it.
+local function check(cg, sql)
+    cg.server:exec(function(sql)
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+        local expected, expected_err = box.execute(sql)
+        box.execute([[SET SESSION "sql_plan_cache" = true;]])
+        local res, err = box.execute(sql)
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+        if expected_err ~= nil then
+            t.assert_equals(tostring(err), tostring(expected_err), sql)
+            return
+        end
+        t.assert_equals(err, nil, sql)
+        t.assert_equals(res, expected, sql)
+    end, {sql})
+end
+
+g.test_plan_cache = function(cg)
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_plan_cache" = true;]])
+        local res = box.execute([[SELECT "id" FROM "t"
+                                  WHERE "id" BETWEEN 10 AND 12;]])
+        t.assert_equals(res.rows, {{10}, {11}, {12}})
+        local size = box.info.sql().cache.size
+        t.assert_gt(size, 0)
+        res = box.execute([[SELECT "id" FROM "t"
+                            WHERE "id" BETWEEN 20 AND 21;]])
+        t.assert_equals(res.rows, {{20}, {21}})
+        t.assert_equals(box.info.sql().cache.size, size)
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+    end)
+    check(cg, [[SELECT * FROM "t" WHERE "i" = 1 AND "s" = '3' LIMIT 5;]])
+    check(cg, [[SELECT * FROM "t" WHERE "i" = 2 AND "s" = '4' LIMIT 2;]])
+    check(cg, [[SELECT "s", COUNT(*) FROM "t" WHERE "id" > 500
+                GROUP BY 1 HAVING COUNT(*) > 70 ORDER BY 2 DESC, 1;]])
+    check(cg, [[SELECT 1, 'a', "id" + 1 FROM "t" WHERE "id" < 3;]])
+    check(cg, [[SELECT "id" FROM "t" WHERE "s" = 'it''s' OR "id" = 1.5;]])
+    check(cg, [[SELECT "id" FROM "t" WHERE "id" < 1e1 LIMIT 2 OFFSET 3;]])
+    check(cg, [[SELECT * FROM "t" WHERE "s" LIKE '1%' AND "id" < 30;]])
+    check(cg, [[SELECT * FROM "t" WHERE "i" = 'a';]])
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "d" ("id" INT PRIMARY KEY, "s" STRING,
+                                        "b" VARBINARY);]])
+        box.execute([[SET SESSION "sql_plan_cache" = true;]])
+        box.execute([[INSERT INTO "d" VALUES (1, 'a''b', X'01');]])
+        box.execute([[INSERT INTO "d" VALUES (2, 'c', X'0203');]])
+        box.execute([[UPDATE "d" SET "s" = 'x' WHERE "id" = 2;]])
+        box.execute([[DELETE FROM "d" WHERE "id" = 3;]])
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+        t.assert_equals(box.space.d:select(),
+                        {{1, "a'b", '\x01'}, {2, 'x', '\x02\x03'}})
+        box.execute([[DROP TABLE "d";]])
+    end)
+end
+
+-- A cached plan survives changes of other spaces and is rebuilt
+-- when the space it reads is altered.
+g.test_schema_change = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "c" ("id" INT PRIMARY KEY, "a" INT);]])
+        box.execute([[INSERT INTO "c" VALUES (1, 10), (2, 20);]])
+        box.execute([[SET SESSION "sql_plan_cache" = true;]])
+        local sql = [[SELECT * FROM "c" WHERE "id" = 1;]]
+        t.assert_equals(box.execute(sql).rows, {{1, 10}})
+        box.schema.space.create('other'):drop()
+        t.assert_equals(box.execute(sql).rows, {{1, 10}})
+        box.execute([[ALTER TABLE "c" ADD COLUMN "b" INT;]])
+        box.execute([[UPDATE "c" SET "b" = 100 WHERE "id" = 2;]])
+        t.assert_equals(box.execute(sql).rows, {{1, 10, box.NULL}})
+        t.assert_equals(box.execute([[SELECT * FROM "c"
+                                      WHERE "id" = 2;]]).rows,
+                        {{2, 20, 100}})
+        box.execute([[DROP TABLE "c";]])
+        local _, err = box.execute(sql)
+        t.assert_equals(err.message, "Space 'c' does not exist")
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+    end)
+end
+
+-- The plan of a prepared statement is rebuilt if the selectivity
+-- of its parameters differs much from the one it was built for.
+g.test_reoptimize = function(cg)
+    cg.server:exec(function()
+        box.space.t:analyze()
+        local s = box.prepare([[SELECT COUNT(*) FROM "t"
+                                WHERE "i" > ? AND "id" > ?;]])
+        local pk = box.space.t.index[0].name
+        local cases = {{1000, 0}, {-1, 990}, {0, 0}, {950, 10}, {2, 899}}
+        for _, args in ipairs(cases) do
+            local expected = box.execute('SELECT COUNT(*) FROM "t" ' ..
+                                         'INDEXED BY "' .. pk .. '" ' ..
+                                         'WHERE "i" > ? AND "id" > ?;',
+                                         args)
+            t.assert_equals(s:execute(args).rows, expected.rows)
+        end
+        s:unprepare()
+    end)
+end
+
+-- A statement using a LIKE pattern bound to a parameter is rebuilt
+-- if the prefix of the pattern differs from the one it was built for.
+g.test_like_prefix = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "l" ("id" INT PRIMARY KEY, "s" STRING);]])
+        box.execute([[CREATE INDEX "s" ON "l" ("s");]])
+        for i = 1, 100 do
+            box.space.l:insert({i, tostring(i)})
+        end
+        box.space.l:analyze()
+        local sql = [[SELECT "id" FROM "l" WHERE "s" LIKE ? AND "s" > ?
+                      ORDER BY 1;]]
+        local s = box.prepare(sql)
+        local cases = {{'1%', ''}, {'2%', ''}, {'2_', ''}, {'%', '5'},
+                       {'3%', '0'}, {1, ''}}
+        for _, args in ipairs(cases) do
+            local expected, expected_err = box.execute(sql, args)
+            local res, err = s:execute(args)
+            t.assert_equals(tostring(err), tostring(expected_err))
+            if expected_err == nil then
+                t.assert_equals(res.rows, expected.rows)
+            end
+        end
+        s:unprepare()
+        box.execute([[DROP TABLE "l";]])
+    end)
+end
+
+-- Compiled statements refer to collations directly, so they expire
+-- when a collation is dropped.
+g.test_collation_drop = function(cg)
+    cg.server:exec(function()
+        box.internal.collation.create('c', 'ICU', 'ru-RU',
+                                      {strength = 'primary'})
+        local sql = [[SELECT "id" FROM "t" WHERE "s" COLLATE "c" = '1'
+                      AND "id" < 20;]]
+        local s = box.prepare(sql)
+        t.assert_equals(s:execute().rows, {{1}, {8}, {15}})
+        box.execute([[SET SESSION "sql_plan_cache" = true;]])
+        t.assert_equals(box.execute(sql).rows, {{1}, {8}, {15}})
+        box.internal.collation.drop('c')
+        local _, err = s:execute()
+        t.assert_equals(err.message, "statement has expired")
+        _, err = box.execute(sql)
+        t.assert_equals(err.message, "Collation 'c' does not exist")
+        box.execute([[SET SESSION "sql_plan_cache" = false;]])
+        s:unprepare()
+    end)
+end
@@ -0,0 +1,108 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "i" INT,
+                                        "s" STRING, "pad" STRING);]])
+        local pad = string.rep('x', 200)
+        box.begin()
+        for k = 1, 20000 do
+            local i = k % 11 == 0 and box.NULL or (k * 7919) % 1000 - 500
+            box.space.t:insert({k, i, tostring(k % 37), pad})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that the rows are sorted by "i" DESC, "s", "id" and that
+-- no row is lost. The rows don't fit into memory of the sorter if
+-- "pad" is selected, so they are merged from several runs then.
+local function check(cg, columns)
+    cg.server:exec(function(columns)
+        local function less(a, b)
+            local x, y = a[1], b[1]
+            if x == nil or y == nil then
+                if (x == nil) ~= (y == nil) then
+                    return y == nil
+                end
+            elseif x ~= y then
+                return x > y
+            end
+            if a[2] ~= b[2] then
+                return a[2] < b[2]
+            end
+            return a[3] < b[3]
+        end
+        local sql = 'SELECT "i", "s", "id"' .. columns .. ' FROM "t" ' ..
+                    'ORDER BY "i" DESC, "s", "id"'
+        local rows = box.execute(sql).rows
+        t.assert_equals(#rows, box.space.t:count(), sql)
+        for k = 2, #rows do
+            t.assert(less(rows[k - 1], rows[k]), sql)
+        end
+    end, {columns})
+end
+
+g.test_order_by = function(cg)
+    check(cg, '')
+    check(cg, ', "pad"')
+end
+
+g.test_group_by = function(cg)
+    cg.server:exec(function()
+        local expected = {}
+        for _, tuple in box.space.t:pairs() do
+            local s = tuple[3]
+            expected[s] = (expected[s] or 0) + 1
+        end
+        local res = box.execute([[SELECT "s", COUNT(*), MAX("pad")
+                                  FROM "t" GROUP BY "s";]])
+        t.assert_equals(#res.rows, 37)
+        for k, row in ipairs(res.rows) do
+            t.assert_equals(row[2], expected[row[1]], row[1])
+            if k > 1 then
+                t.assert_lt(res.rows[k - 1][1], row[1])
+            end
+        end
+    end)
+end
+
+-- A large sort is done in sort worker threads and lets other fibers
+-- run meanwhile. A transaction that can't yield isn't aborted.
+g.test_yield = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local count = 0
+        local f = fiber.new(function()
+            while true do
+                count = count + 1
+                fiber.yield()
+            end
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        count = 0
+        box.execute([[SELECT "id" FROM "t" ORDER BY "s", "id";]])
+        t.assert_gt(count, 0)
+        f:cancel()
+        f:join()
+
+        box.begin()
+        box.space.t:replace({1, 0, '0', ''})
+        local res = box.execute([[SELECT "id" FROM "t" ORDER BY "s", "id";]])
+        t.assert_equals(#res.rows, box.space.t:count())
+        box.commit()
+        t.assert_equals(box.space.t:get(1)[4], '')
+    end)
+    check(cg, ', "pad"')
+end
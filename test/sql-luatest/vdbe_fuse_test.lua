@@ -0,0 +1,83 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "i" INT,
+                                        "s" STRING COLLATE "unicode_ci",
+                                        "d" DOUBLE);]])
+        box.execute([[CREATE TABLE "u" ("id" INT PRIMARY KEY, "i" INT);]])
+        local letters = {'a', 'B', 'c'}
+        box.begin()
+        for k = 1, 100 do
+            local i = k % 9 == 0 and box.NULL or k % 10
+            box.space.t:insert({k, i, letters[k % 3 + 1], k / 4})
+            if k % 2 == 0 then
+                box.space.u:insert({k, k % 5})
+            end
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that a prepared statement yields the same result before
+-- and after its program is fused, which happens after it has been
+-- executed many times.
+local function check(cg, sql, params)
+    cg.server:exec(function(sql, params)
+        local expected = {}
+        for k, args in ipairs(params) do
+            expected[k] = box.execute(sql, args).rows
+        end
+        local s = box.prepare(sql)
+        for _ = 1, 3 do
+            for k, args in ipairs(params) do
+                t.assert_equals(s:execute(args).rows, expected[k], sql)
+            end
+            for _ = 1, 64 do
+                s:execute(params[1])
+            end
+        end
+        s:unprepare()
+    end, {sql, params})
+end
+
+g.test_fuse = function(cg)
+    check(cg, [[SELECT "id", "i", "s", "d" FROM "t" WHERE "id" = ?;]],
+          {{1}, {9}, {50}, {101}})
+    check(cg, [[SELECT "id", "d" FROM "t" WHERE "i" > ? AND "s" = ?;]],
+          {{5, 'A'}, {0, 'b'}, {box.NULL, 'c'}})
+    check(cg, [[SELECT "id" FROM "t" WHERE "i" = ? OR "d" <= ?;]],
+          {{3, 2}, {box.NULL, 5.5}, {7, box.NULL}})
+    check(cg, [[SELECT "s", COUNT(*), SUM("i") FROM "t" WHERE "i" <> ?
+                GROUP BY "s" ORDER BY 1;]], {{1}, {box.NULL}})
+    check(cg, [[SELECT "t"."id", "u"."i", "t"."i" FROM "t" LEFT JOIN "u"
+                ON "t"."id" = "u"."id" WHERE "t"."id" < ?
+                ORDER BY "u"."i", 1;]], {{10}, {30}})
+    check(cg, [[SELECT "id", CASE WHEN "i" >= ? THEN "s" ELSE 'x' END
+                FROM "t" WHERE "id" < 20;]], {{4}, {box.NULL}})
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "c" ("id" INT PRIMARY KEY, "n" INT);]])
+        box.space.c:insert({1, 0})
+        local s = box.prepare([[UPDATE "c" SET "n" = "n" + 1
+                                WHERE "id" = ? AND "n" >= 0;]])
+        for _ = 1, 200 do
+            s:execute({1})
+        end
+        s:unprepare()
+        t.assert_equals(box.space.c:get(1), {1, 200})
+        box.execute([[DROP TABLE "c";]])
+    end)
+end
@@ -0,0 +1,224 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE "t" ("id" INT PRIMARY KEY, "i" INT,
+                                        "u" UNSIGNED, "d" DOUBLE,
+                                        "s" STRING);]])
+        local s = box.space.t
+        box.begin()
+        for k = 1, 3000 do
+            local i = k % 7 == 0 and box.NULL or (k % 100) - 50
+            local d = k % 11 == 0 and box.NULL or k / 8
+            s:insert({k, i, k % 13, d, tostring(k % 5)})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that the query is computed in batches and yields the same
+-- result as the row-at-a-time code, which is used if the index is
+-- given explicitly.
+local function check(cg, aggs, where, ...)
+    cg.server:exec(function(aggs, where, params)
+        local function sql(from)
+            local q = 'SELECT ' .. table.concat(aggs, ', ') .. ' FROM ' ..
+                      from
+            return where and q .. ' WHERE ' .. where or q
+        end
+        local vec = sql('"t"')
+        local res = box.execute('EXPLAIN ' .. vec, params)
+        local opcodes = {}
+        for _, row in ipairs(res.rows) do
+            opcodes[row[2]] = true
+        end
+        t.assert(opcodes.VecAggregate, vec)
+        local pk = box.space.t.index[0].name
+        local expected = box.execute(sql('"t" INDEXED BY "' .. pk .. '"'),
+                                     params)
+        t.assert_equals(box.execute(vec, params).rows, expected.rows, vec)
+    end, {aggs, where or false, {...}})
+end
+
+g.test_aggregates = function(cg)
+    check(cg, {'COUNT(*)', 'COUNT("i")', 'SUM("i")', 'TOTAL("i")',
+               'AVG("i")', 'MIN("i")', 'MAX("i")'})
+    check(cg, {'COUNT("d")', 'SUM("d")', 'TOTAL("d")', 'AVG("d")',
+               'MIN("d")', 'MAX("d")'})
+    check(cg, {'SUM("u")', 'AVG("u")', 'MIN("u")', 'MAX("u")'})
+    check(cg, {'COUNT("s")', 'COUNT(*)'}, '"i" > 0')
+end
+
+g.test_filters = function(cg)
+    check(cg, {'SUM("d")', 'COUNT(*)'}, '"i" > ?', 10)
+    check(cg, {'SUM("d")', 'COUNT(*)'}, '"i" <= ?', 10.5)
+    check(cg, {'SUM("d")', 'COUNT(*)'}, '"i" = ?', -10.5)
+    check(cg, {'SUM("d")', 'COUNT(*)'}, '"i" <> ?', -10)
+    check(cg, {'SUM("i")', 'COUNT(*)'}, '"d" >= ?', 100)
+    check(cg, {'SUM("i")', 'COUNT(*)'}, '? > "d" AND "u" = 3', 200.25)
+    check(cg, {'SUM("i")', 'COUNT(*)'}, '"i" > ?', 1e100)
+    check(cg, {'SUM("i")', 'COUNT(*)'}, '"u" < ?', 18446744073709551615ULL)
+    check(cg, {'SUM("i")', 'COUNT(*)', 'MAX("d")'}, '"i" > ?', box.NULL)
+    check(cg, {'SUM("i")', 'COUNT(*)'}, '"i" > 1000')
+end
+
+-- Results the batch loops can't reproduce are left to the
+-- row-at-a-time code.
+g.test_fallback = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "big" ("id" INT PRIMARY KEY, "i" INT);]])
+        box.execute([[INSERT INTO "big" VALUES (1, 9223372036854775807),
+                                               (2, 9223372036854775807);]])
+        local res = box.execute([[SELECT SUM("i") FROM "big";]])
+        t.assert_equals(res.rows, {{18446744073709551614ULL}})
+        box.execute([[INSERT INTO "big" VALUES (3, 9223372036854775807);]])
+        local _, err = box.execute([[SELECT SUM("i") FROM "big";]])
+        t.assert_equals(err.message, 'Failed to execute SQL statement: ' ..
+                                     'integer is overflowed')
+        _, err = box.execute([[SELECT COUNT(*) FROM "big" WHERE "i" > ?;]],
+                             {'a'})
+        t.assert_str_contains(err.message, 'Type mismatch')
+        -- Values above INT64_MAX aren't skipped by the filters.
+        box.execute([[INSERT INTO "big" VALUES (4, 18446744073709551615);]])
+        res = box.execute([[SELECT COUNT(*), SUM("i") FROM "big"
+                            WHERE "i" > 9223372036854775813;]])
+        t.assert_equals(res.rows, {{1, 18446744073709551615ULL}})
+        res = box.execute([[SELECT COUNT(*) FROM "big" WHERE "i" >= ?;]],
+                          {1e19})
+        t.assert_equals(res.rows, {{1}})
+        box.execute([[DROP TABLE "big";]])
+    end)
+end
+
+-- Counts of rows in a range of the first part of a TREE index are
+-- taken from the index instead of scanning the range.
+g.test_range_count = function(cg)
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE "r" ("id" INT PRIMARY KEY, "i" INT,
+                                        "u" UNSIGNED, "d" DOUBLE);]])
+        box.execute([[CREATE INDEX "ri" ON "r" ("i", "id");]])
+        box.execute([[CREATE INDEX "ru" ON "r" ("u");]])
+        box.execute([[CREATE INDEX "rd" ON "r" ("d");]])
+        local s = box.space.r
+        box.begin()
+        for k = 1, 2000 do
+            local i = k % 7 == 0 and box.NULL or (k % 300) - 150
+            local d = k % 11 == 0 and box.NULL or k / 8
+            s:insert({k, i, k % 13 == 0 and box.NULL or k, d})
+        end
+        s:insert({2001, 0, 18446744073709551615ULL, 0})
+        box.commit()
+        local pk = s.index[0].name
+        local function check(aggs, where, ...)
+            local params = {...}
+            local q = 'SELECT ' .. aggs .. ' FROM "r" WHERE ' .. where
+            local res = box.execute('EXPLAIN ' .. q, params)
+            local p4
+            for _, row in ipairs(res.rows) do
+                if row[2] == 'VecAggregate' then
+                    p4 = row[6]
+                end
+            end
+            t.assert_str_contains(p4, 'count_index=', false, q)
+            local expected = box.execute('SELECT ' .. aggs .. ' FROM "r" ' ..
+                                         'INDEXED BY "' .. pk .. '" ' ..
+                                         'WHERE ' .. where, params)
+            t.assert_equals(box.execute(q, params).rows, expected.rows, q)
+        end
+        check('COUNT(*)', '"i" > ? AND "i" <= ?', -10, 20)
+        check('COUNT(*), COUNT("i")', '"i" BETWEEN ? AND ?', -200, 200)
+        check('COUNT(*)', '"i" = ?', 7)
+        check('COUNT(*)', '"i" < ?', 0)
+        check('COUNT(*)', '"i" >= ? AND "i" > ? AND "i" < ?', 5, 5, 8)
+        check('COUNT(*)', '"i" > ? AND "i" < ?', 10, -10)
+        check('COUNT(*)', '"i" > ?', 1.5)
+        check('COUNT(*)', '"i" < ?', -1e100)
+        check('COUNT(*)', '"i" > ?', box.NULL)
+        check('COUNT(*)', '"u" >= ?', -5)
+        check('COUNT(*)', '"u" < ?', -5)
+        check('COUNT(*)', '"u" > ?', 1000)
+        check('COUNT(*)', '"u" > ?', 9223372036854775807ULL)
+        check('COUNT(*)', '"u" > 1e19')
+        check('COUNT("d")', '"d" > ? AND "d" < 100', 10)
+        check('COUNT(*)', '"d" <= ?', 3)
+        -- Other aggregates over a range are computed by a scan.
+        local q = [[EXPLAIN SELECT COUNT(*), SUM("i") FROM "r"
+                    WHERE "i" > ?;]]
+        for _, row in ipairs(box.execute(q, {0}).rows) do
+            t.assert_not_str_contains(tostring(row[6]), 'count_index=')
+        end
+        box.execute([[DROP TABLE "r";]])
+    end)
+end
+
+-- A large memtx space is scanned by worker threads if the session
+-- setting is enabled. The calling fiber yields meanwhile.
+g.test_parallel_scan = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        box.execute([[CREATE TABLE "p" ("id" INT PRIMARY KEY, "i" INT,
+                                        "u" UNSIGNED, "d" DOUBLE);]])
+        local s = box.space.p
+        box.begin()
+        for k = 1, 50000 do
+            local i = k % 7 == 0 and box.NULL or (k * 7919) % 1000 - 500
+            local d = k % 11 == 0 and box.NULL or k / 8
+            s:insert({k, i, k % 13, d})
+        end
+        box.commit()
+        local queries = {
+            [[SELECT COUNT(*), COUNT("i"), SUM("i"), AVG("i"), MIN("i"),
+                     MAX("i") FROM "p";]],
+            [[SELECT MIN("d"), MAX("d"), SUM("u") FROM "p"
+              WHERE "i" > 100 AND "u" <> 3;]],
+            [[SELECT SUM("d"), TOTAL("i") FROM "p" WHERE "d" < 1000;]],
+        }
+        local expected = {}
+        for k, q in ipairs(queries) do
+            expected[k] = box.execute(q).rows
+        end
+        box.execute([[SET SESSION "sql_parallel_scan" = true;]])
+        local count = 0
+        local f = fiber.new(function()
+            while true do
+                count = count + 1
+                fiber.yield()
+            end
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        count = 0
+        for k, q in ipairs(queries) do
+            t.assert_equals(box.execute(q).rows, expected[k], q)
+        end
+        t.assert_gt(count, 0)
+        f:cancel()
+        f:join()
+
+        box.begin()
+        s:replace({1, 1000000, 0, 0})
+        local res = box.execute([[SELECT MAX("i") FROM "p";]])
+        t.assert_equals(res.rows, {{1000000}})
+        box.rollback()
+
+        -- Sums overflowing in a worker are left to the row-at-a-time
+        -- code.
+        s:replace({1, 9223372036854775807, 0, 0})
+        s:replace({2, 9223372036854775807, 0, 0})
+        local q = [[SELECT SUM("i"), COUNT(*) FROM "p";]]
+        res = box.execute(q)
+        box.execute([[SET SESSION "sql_parallel_scan" = false;]])
+        t.assert_equals(res.rows, box.execute(q).rows)
+        box.execute([[DROP TABLE "p";]])
+    end)
+end
@@ -230,15 +230,19 @@ unprepare(s2.stmt_id)
 unprepare(s1.stmt_id)
 
 -- Prepare call re-compiles statement if it is expired
--- after schema change.
+-- after schema change. A change of a space the statement
+-- doesn't refer to doesn't expire it.
 --
 s = prepare("SELECT a FROM test WHERE b = ?;")
 sp = box.schema.create_space("s")
 sp:drop()
 execute(s.stmt_id)
+_ = box.space.test:create_index('i1', {parts = {'b'}})
+execute(s.stmt_id)
 _ = prepare("SELECT a FROM test WHERE b = ?;")
 execute(s.stmt_id)
 unprepare(s.stmt_id)
+box.space.test.index.i1:drop()
 
 -- Setting cache size to 0 is possible only in case if
 -- there's no any prepared statements right now .
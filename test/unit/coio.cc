@@ -3,6 +3,7 @@
 #include "coio.h"
 #include "coio_task.h"
 #include "fio.h"
+#include "clock.h"
 #include "unit.h"
 #include "iostream.h"
 
@@ -121,6 +122,52 @@ test_getaddrinfo(void)
 	footer();
 }
 
+static ssize_t
+coio_test_sleep(va_list ap)
+{
+	usleep(va_arg(ap, int));
+	return 0;
+}
+
+static int
+test_bulk_call_f(va_list ap)
+{
+	(void)ap;
+	return coio_call_ex(COIO_CLASS_BULK, coio_test_sleep, 200000);
+}
+
+static void
+test_call_class(void)
+{
+	header();
+	plan(4);
+	/* Bulk tasks may occupy only one of two worker threads. */
+	coio_set_worker_count(2);
+	coio_reset_stat();
+	struct fiber *bulk[2];
+	for (int i = 0; i < 2; i++) {
+		bulk[i] = fiber_new_xc("bulk", test_bulk_call_f);
+		fiber_set_joinable(bulk[i], true);
+		fiber_start(bulk[i]);
+	}
+	struct coio_stat stat;
+	coio_stat(COIO_CLASS_BULK, &stat);
+	is(stat.queue, 2, "bulk tasks are queued");
+	double start = clock_monotonic();
+	coio_call_ex(COIO_CLASS_INTERACTIVE, coio_test_sleep, 1000);
+	ok(clock_monotonic() - start < 0.1,
+	   "interactive task is not stuck behind bulk tasks");
+	for (int i = 0; i < 2; i++)
+		fiber_join(bulk[i]);
+	coio_stat(COIO_CLASS_BULK, &stat);
+	ok(stat.queue == 0 && stat.count == 2, "bulk tasks are complete");
+	coio_stat(COIO_CLASS_INTERACTIVE, &stat);
+	ok(stat.count >= 1 && stat.latency_p99 > 0,
+	   "interactive task latency is accounted");
+	check_plan();
+	footer();
+}
+
 static void
 test_connect(void)
 {
@@ -300,6 +347,7 @@ main_f(va_list ap)
 	fiber_join(call_fiber);
 
 	test_getaddrinfo();
+	test_call_class();
 	test_connect();
 
 	read_write_test();
@@ -35,9 +35,9 @@ main_f(va_list ap)
 
 	header();
 #ifdef NDEBUG
-	plan(1);
+	plan(5);
 #else
-	plan(11);
+	plan(15);
 #endif
 
 	/*
@@ -61,6 +61,36 @@ main_f(va_list ap)
 	   "fiber_attr: the default stack size is %ld, but %d is set via CMake",
 	   default_attr.stack_size, FIBER_STACK_SIZE_DEFAULT);
 
+	/*
+	 * Check that the stack of a fiber with a custom stack is put
+	 * to the stack pool on deletion and is taken from it by a new
+	 * fiber with a stack of the same size class.
+	 */
+	struct fiber_stack_pool_stat pool_stat;
+	cord_flush_stack_pool(cord());
+	fiber_stack_pool_stat(&pool_stat);
+	ok(pool_stat.count == 0 && pool_stat.size == 0,
+	   "stack pool: empty after flush");
+	uint64_t hits = pool_stat.hits;
+	fiber_attr_setstacksize(fiber_attr, (128 << 10) - 128);
+	fiber = fiber_new_ex("test_pool", fiber_attr, noop_f);
+	fiber_set_joinable(fiber, true);
+	fiber_start(fiber);
+	fiber_join(fiber);
+	fiber_stack_pool_stat(&pool_stat);
+	ok(pool_stat.count == 1 && pool_stat.size == 128 << 10,
+	   "stack pool: the stack is pooled");
+	fiber_attr_setstacksize(fiber_attr, 100 << 10);
+	fiber = fiber_new_ex("test_pool", fiber_attr, noop_f);
+	fiber_stack_pool_stat(&pool_stat);
+	ok(pool_stat.count == 0 && pool_stat.hits == hits + 1,
+	   "stack pool: the stack is reused");
+	ok(fiber->stack_size > (100 << 10),
+	   "stack pool: the stack is rounded up to the size class");
+	fiber_set_joinable(fiber, true);
+	fiber_start(fiber);
+	fiber_join(fiber);
+
 #ifndef NDEBUG
 	/*
 	 * Set non-default stack size to prevent reusing of an
@@ -116,6 +146,8 @@ main_f(va_list ap)
 
 	diag_clear(diag_get());
 
+	/* Make the fiber allocate a new stack. */
+	cord_flush_stack_pool(cord());
 	used_before = slab_cache_used(slabc);
 
 	fiber = fiber_new_ex("test_madvise", fiber_attr, noop_f);
@@ -128,6 +160,8 @@ main_f(va_list ap)
 
 	fiber_start(fiber);
 	fiber_join(fiber);
+	/* The stack of the fiber is pooled, free it. */
+	cord_flush_stack_pool(cord());
 	inj->iparam = -1;
 
 	used_after = slab_cache_used(slabc);
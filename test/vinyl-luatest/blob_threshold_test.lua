@@ -0,0 +1,140 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {checkpoint_count = 1}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.blob_threshold, nil)
+        i:alter({blob_threshold = 1000})
+        t.assert_equals(s.index.pk.options.blob_threshold, 1000)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "blob_threshold is only supported by primary index",
+            s.create_index, s, 'sk', {parts = {2, 'unsigned'},
+                                      blob_threshold = 1000})
+    end)
+end
+
+g.test_blob_threshold = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {blob_threshold = 500,
+                                        run_count_per_level = 10})
+        box.begin()
+        for k = 1, 100 do
+            local v = k % 2 == 0 and string.rep('x', 1000) or 'small'
+            s:replace({k, 0, v})
+        end
+        box.commit()
+        box.snapshot()
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, i.id)
+        t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.blob', '*')), 1)
+        -- Large tuples are not stored in the run file.
+        t.assert_lt(i:stat().disk.bytes, 50 * 1000)
+
+        -- Compaction does not copy tuples stored in blob files.
+        box.begin()
+        for k = 1, 100 do
+            s:update({k}, {{'=', 2, 1}})
+        end
+        box.commit()
+        box.snapshot()
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+        t.assert_lt(i:stat().disk.compaction.output.bytes, 50 * 1000)
+
+        for k = 1, 100 do
+            local v = k % 2 == 0 and string.rep('x', 1000) or 'small'
+            t.assert_equals(s:get(k), {k, 1, v})
+        end
+        t.assert_equals(s:count(), 100)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        for k = 1, 100 do
+            local v = k % 2 == 0 and string.rep('x', 1000) or 'small'
+            t.assert_equals(s:get(k), {k, 1, v})
+        end
+        t.assert_equals(s:select({}, {iterator = 'LE', limit = 1}),
+                        {{100, 1, string.rep('x', 1000)}})
+    end)
+end
+
+g.test_blob_gc = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {blob_threshold = 500,
+                                        run_count_per_level = 10})
+        for _, v in ipairs({'x', 'y'}) do
+            box.begin()
+            for k = 1, 100 do
+                s:replace({k, string.rep(v, 1000)})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+        -- Overwritten tuples are gone along with the old blob files.
+        box.snapshot()
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, i.id)
+        t.helpers.retrying({}, function()
+            t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.blob', '*')),
+                            1)
+        end)
+        for k = 1, 100 do
+            t.assert_equals(s:get(k), {k, string.rep('y', 1000)})
+        end
+
+        -- Blob files that are mostly garbage are rewritten. Garbage
+        -- is accounted when the runs referencing the file are
+        -- compacted so it takes two compactions to reclaim it.
+        box.begin()
+        for k = 1, 80 do
+            s:delete({k})
+        end
+        box.commit()
+        for k = 1, 2 do
+            s:replace({1000 + k, 'small'})
+            box.snapshot()
+            i:compact()
+            t.helpers.retrying({}, function()
+                t.assert_equals(i:stat().run_count, 1)
+            end)
+        end
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            local files = fio.glob(fio.pathjoin(dir, '*.blob', '*'))
+            t.assert_equals(#files, 1)
+            t.assert_equals(fio.stat(files[1]).size, 20 * 1005)
+        end)
+        t.assert_equals(s:count(), 22)
+    end)
+end
@@ -0,0 +1,131 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        -- Creates the given number of runs of the same size.
+        rawset(_G, 'dump', function(s, count)
+            for _ = 1, count do
+                box.begin()
+                for k = 1, 100 do
+                    s:replace({k, string.rep('x', 100)})
+                end
+                box.commit()
+                box.snapshot()
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options: compaction_policy must be either " ..
+            "'leveled', 'tiered' or 'time_window'",
+            s.create_index, s, 'pk', {compaction_policy = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options: compaction_window must be greater than 0",
+            s.create_index, s, 'pk', {compaction_window = 0})
+        t.assert_error_msg_content_equals(
+            "options parameter 'compaction_policy' should be of type string",
+            s.create_index, s, 'pk', {compaction_policy = 1})
+    end)
+end
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.compaction_policy, nil)
+        t.assert_equals(i.options.compaction_window, nil)
+        i:alter({compaction_policy = 'TIERED'})
+        t.assert_equals(s.index.pk.options.compaction_policy, 'tiered')
+        i:alter({compaction_policy = 'time_window',
+                 compaction_window = 60})
+        t.assert_equals(s.index.pk.options.compaction_policy, 'time_window')
+        t.assert_equals(s.index.pk.options.compaction_window, 60)
+    end)
+end
+
+g.test_leveled = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {compaction_policy = 'leveled',
+                                        run_count_per_level = 2})
+        -- The last level never has more than one run.
+        _G.dump(s, 2)
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+    end)
+end
+
+g.test_tiered = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {compaction_policy = 'tiered',
+                                        run_count_per_level = 2})
+        -- Runs of the same size are kept until there are too many.
+        _G.dump(s, 2)
+        t.assert_equals(i:stat().run_count, 2)
+        t.assert_equals(i:stat().disk.compaction.queue.bytes, 0)
+        _G.dump(s, 2)
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+        local amp = i:stat().amplification
+        t.assert_gt(amp.write, 1)
+        t.assert_equals(amp.read, 1)
+        t.assert_equals(amp.space, 1)
+    end)
+end
+
+g.after_test('test_time_window', function(cg)
+    cg.server:exec(function()
+        if box.error.injection.info().ERRINJ_VY_COMPACTION_TIME ~= nil then
+            box.error.injection.set('ERRINJ_VY_COMPACTION_TIME', 0)
+        end
+    end)
+end)
+
+g.test_time_window = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local errinj = box.error.injection
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {compaction_policy = 'time_window',
+                                        compaction_window = 2,
+                                        run_count_per_level = 2})
+        -- Freeze the clock at the beginning of a window.
+        errinj.set('ERRINJ_VY_COMPACTION_TIME', 1000)
+        -- Runs of the current window are compacted as tiered.
+        _G.dump(s, 2)
+        t.assert_equals(i:stat().run_count, 2)
+        t.assert_equals(i:stat().disk.compaction.queue.bytes, 0)
+        -- Runs of a window that is over are merged.
+        errinj.set('ERRINJ_VY_COMPACTION_TIME', 1002)
+        _G.dump(s, 1)
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().disk.compaction.count, 1)
+            t.assert_equals(i:stat().run_count, 2)
+        end)
+        t.assert_equals(i:stat().disk.compaction.queue.bytes, 0)
+    end)
+end
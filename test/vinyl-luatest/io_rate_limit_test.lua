@@ -0,0 +1,103 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_dump_io_rate_limit = 0,
+                 vinyl_compaction_io_rate_limit = 0})
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local io = box.stat.vinyl().disk.io
+        t.assert_equals(io.read.rate_limit, 0)
+        t.assert_equals(io.dump.rate_limit, 0)
+        t.assert_equals(io.compaction.rate_limit, 0)
+        box.cfg({vinyl_dump_io_rate_limit = 1,
+                 vinyl_compaction_io_rate_limit = 0.5})
+        io = box.stat.vinyl().disk.io
+        t.assert_equals(io.dump.rate_limit, 1024 * 1024)
+        t.assert_equals(io.compaction.rate_limit, 512 * 1024)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'vinyl_dump_io_rate_limit': " ..
+            "should be of type number",
+            box.cfg, {vinyl_dump_io_rate_limit = 'foo'})
+    end)
+end
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 10})
+        box.stat.reset()
+        for _ = 1, 2 do
+            for k = 1, 100 do
+                s:replace({k, string.rep('x', 100)})
+            end
+            box.snapshot()
+        end
+        local io = box.stat.vinyl().disk.io
+        t.assert_gt(io.dump.bytes, 0)
+        t.assert_gt(io.dump.count, 0)
+        t.assert_equals(io.dump.throttle_time, 0)
+        t.assert_equals(io.compaction.bytes, 0)
+
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        io = box.stat.vinyl().disk.io
+        t.assert_gt(io.compaction.bytes, 0)
+        t.assert_gt(io.compaction.count, 0)
+
+        t.assert_equals(io.read.count, 0)
+        t.assert_equals(s:get(1), {1, string.rep('x', 100)})
+        io = box.stat.vinyl().disk.io
+        t.assert_gt(io.read.count, 0)
+        t.assert_gt(io.read.bytes, 0)
+        t.assert_ge(io.read.latency.p99, io.read.latency.p50)
+
+        box.stat.reset()
+        io = box.stat.vinyl().disk.io
+        for _, name in ipairs({'read', 'dump', 'compaction'}) do
+            t.assert_equals(io[name].bytes, 0)
+            t.assert_equals(io[name].count, 0)
+        end
+    end)
+end
+
+g.test_throttle = function(cg)
+    cg.server:exec(function()
+        local clock = require('clock')
+        local digest = require('digest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 16 * 1024})
+        box.stat.reset()
+        box.cfg({vinyl_dump_io_rate_limit = 0.1})
+        box.begin()
+        for k = 1, 200 do
+            s:replace({k, digest.urandom(1000)})
+        end
+        box.commit()
+        -- About 200 KB of incompressible data written at 100 KB/s.
+        local start = clock.monotonic()
+        box.snapshot()
+        t.assert_ge(clock.monotonic() - start, 1)
+        t.assert_gt(box.stat.vinyl().disk.io.dump.throttle_time, 0)
+    end)
+end
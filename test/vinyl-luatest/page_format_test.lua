@@ -0,0 +1,126 @@
+local fio = require('fio')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.page_restart_interval, nil)
+        t.assert_equals(i.options.page_dict_size, nil)
+        i:alter({page_restart_interval = 16, page_dict_size = 4096})
+        t.assert_equals(s.index.pk.options.page_restart_interval, 16)
+        t.assert_equals(s.index.pk.options.page_dict_size, 4096)
+        t.assert_error_msg_equals(
+            "Wrong index options: " ..
+            "page_dict_size must be 0 or greater than or equal to 256",
+            i.alter, i, {page_dict_size = 100})
+    end)
+end
+
+-- Creates a space with prefix- and dictionary-compressed pages and
+-- compacts it into a single run.
+local function fill()
+    local s = box.schema.space.create('test', {engine = 'vinyl'})
+    s:create_index('pk', {page_restart_interval = 4,
+                          page_dict_size = 1024,
+                          page_size = 1024,
+                          run_count_per_level = 10})
+    s:create_index('sk', {parts = {2, 'string'},
+                          page_restart_interval = 4,
+                          page_size = 1024,
+                          run_count_per_level = 10})
+    for _ = 1, 2 do
+        box.begin()
+        for k = 1, 1000 do
+            s:replace({k, string.format('name%05d', k),
+                       string.rep('abc', 20)})
+        end
+        box.commit()
+        box.snapshot()
+    end
+    s.index.pk:compact()
+    s.index.sk:compact()
+    t.helpers.retrying({}, function()
+        t.assert_equals(s.index.pk:stat().run_count, 1)
+        t.assert_equals(s.index.sk:stat().run_count, 1)
+    end)
+end
+
+local function check()
+    local s = box.space.test
+    local function tuple(k)
+        return {k, string.format('name%05d', k), string.rep('abc', 20)}
+    end
+    for k = 1, 1000, 7 do
+        t.assert_equals(s:get(k), tuple(k))
+        t.assert_equals(s.index.sk:get(string.format('name%05d', k)),
+                        tuple(k))
+        t.assert_equals(s:select({k}, {iterator = 'GE', limit = 1}),
+                        {tuple(k)})
+        t.assert_equals(s:select({k}, {iterator = 'GT', limit = 1}),
+                        k < 1000 and {tuple(k + 1)} or {})
+        t.assert_equals(s:select({k}, {iterator = 'LE', limit = 1}),
+                        {tuple(k)})
+        t.assert_equals(s:select({k}, {iterator = 'LT', limit = 1}),
+                        k > 1 and {tuple(k - 1)} or {})
+    end
+    t.assert_equals(s:get(1001), nil)
+    t.assert_equals(s:count(), 1000)
+    t.assert_equals(s.index.sk:count(), 1000)
+    local result = s:select({}, {iterator = 'LE'})
+    t.assert_equals(#result, 1000)
+    t.assert_equals(result[1], tuple(1000))
+    t.assert_equals(result[1000], tuple(1))
+end
+
+g.test_page_format = function(cg)
+    cg.server:exec(fill)
+    cg.server:exec(check)
+    cg.server:restart()
+    cg.server:exec(check)
+end
+
+g.test_rebuild_index = function(cg)
+    cg.server:exec(fill)
+    local space_id = cg.server:exec(function()
+        return box.space.test.id
+    end)
+    local pattern = fio.pathjoin(cg.server.workdir, tostring(space_id),
+                                 '*', '*.index')
+    cg.server:stop()
+    local files = fio.glob(pattern)
+    t.assert_not_equals(files, {})
+    for _, f in ipairs(files) do
+        t.assert(fio.unlink(f))
+    end
+    -- Missing index files are rebuilt from run files on recovery.
+    cg.server.box_cfg = {force_recovery = true}
+    cg.server:start()
+    t.assert(cg.server:grep_log('rebuilding index for'))
+    cg.server:exec(check)
+    t.assert_not_equals(fio.glob(pattern), {})
+    -- The rebuilt index files are read on the next restart.
+    cg.server.box_cfg = nil
+    cg.server:restart()
+    cg.server:exec(check)
+end
@@ -0,0 +1,107 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {vinyl_write_threads = 4}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.error.injection ~= nil then
+            box.error.injection.set('ERRINJ_VY_RUN_WRITE', false)
+        end
+    end)
+end)
+
+g.test_subcompaction = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {page_size = 1024,
+                                        range_size = 16 * 1024,
+                                        run_count_per_level = 100})
+        for _ = 1, 2 do
+            box.begin()
+            for k = 1, 1000 do
+                s:replace({k, string.rep('x', 100)})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        t.assert_equals(i:stat().range_count, 1)
+        t.assert_equals(i:stat().run_count, 2)
+
+        -- The range is much larger than range_size so its compaction
+        -- is split between all (three) compaction threads.
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(i:stat().range_count, 3)
+        t.assert_equals(i:stat().run_count, 3)
+        t.assert_equals(i:stat().disk.compaction.queue.bytes, 0)
+        t.assert_equals(s:count(), 1000)
+        t.assert_equals(s:get(1), {1, string.rep('x', 100)})
+        t.assert_equals(s:get(1000), {1000, string.rep('x', 100)})
+    end)
+
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        local i = s.index.pk
+        t.assert_equals(i:stat().range_count, 3)
+        t.assert_equals(i:stat().run_count, 3)
+        local k = 0
+        for _, tuple in s:pairs() do
+            k = k + 1
+            t.assert_equals(tuple, {k, string.rep('x', 100)})
+        end
+        t.assert_equals(k, 1000)
+    end)
+end
+
+g.test_subcompaction_error = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {page_size = 1024,
+                                        range_size = 16 * 1024,
+                                        run_count_per_level = 100})
+        for _ = 1, 2 do
+            box.begin()
+            for k = 1, 1000 do
+                s:replace({k, string.rep('x', 100)})
+            end
+            box.commit()
+            box.snapshot()
+        end
+
+        -- Failure of any part aborts compaction of the whole range.
+        box.stat.reset()
+        box.error.injection.set('ERRINJ_VY_RUN_WRITE', true)
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_ge(box.stat.vinyl().scheduler.tasks_failed, 1)
+        end)
+        t.assert_equals(i:stat().range_count, 1)
+        t.assert_equals(i:stat().run_count, 2)
+        t.assert_equals(s:count(), 1000)
+
+        box.error.injection.set('ERRINJ_VY_RUN_WRITE', false)
+        i:compact()
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(i:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(i:stat().range_count, 3)
+        t.assert_equals(s:count(), 1000)
+    end)
+end